@@ -3,3 +3,5 @@ if (-not (Test-Path -Path "shaders" -PathType Container)) {
 }
 & "${env:VULKAN_SDK}\Bin\glslc.exe" four-engine\src\renderer\shaders\simpleShader.vert -o shaders\simpleShader.vert.spv
 & "${env:VULKAN_SDK}\Bin\glslc.exe" four-engine\src\renderer\shaders\simpleShader.frag -o shaders\simpleShader.frag.spv
+& "${env:VULKAN_SDK}\Bin\glslc.exe" four-engine\src\renderer\shaders\cull.comp -o shaders\cull.comp.spv
+& "${env:VULKAN_SDK}\Bin\glslc.exe" four-engine\src\renderer\shaders\simpleShaderBindless.frag -o shaders\simpleShaderBindless.frag.spv
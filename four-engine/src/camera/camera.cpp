@@ -133,9 +133,20 @@ void Camera::OnMouseMove(f32 xPos, f32 yPos)
 void Camera::Update([[maybe_unused]] f32 deltaTime)
 {
   const glm::mat4 cameraRotation = GetRotationMatrix();
-  m_Position += glm::vec3(cameraRotation * glm::vec4(m_Velocety * deltaTime, 0.0F));
+  m_Position += glm::vec3(cameraRotation * glm::vec4(m_Velocety * (CameraSpeed * deltaTime), 0.0F));
   LOG_CORE_INFO("camera event: {}, {}", m_Position.z, m_Position.x);
 }
 
+//==============================================================================
+Camera Camera::Interpolate(const Camera& previous, const Camera& current, f32 alpha)
+{
+  Camera camera = current;
+
+  camera.m_Position = glm::mix(previous.m_Position, current.m_Position, alpha);
+  camera.m_Yaw      = glm::mix(previous.m_Yaw, current.m_Yaw, alpha);
+  camera.m_Pitch    = glm::mix(previous.m_Pitch, current.m_Pitch, alpha);
+  return camera;
+}
+
 //==============================================================================
 } // namespace four
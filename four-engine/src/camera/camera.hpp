@@ -7,6 +7,8 @@
 namespace four
 {
 
+constexpr f32 CameraSpeed = 12.0F; // units per second at full velocity
+
 class FOUR_ENGINE_API Camera
 {
 public:
@@ -28,6 +30,13 @@ public:
   void OnMouseMove(f32 xPos, f32 yPos);
   void Update(f32 deltaTime);
 
+  /**
+   * @brief camera between two simulation states, position and angles are blended linearly
+   *
+   * @param alpha 0 returns previous, 1 returns current
+   */
+  [[nodiscard]] static Camera Interpolate(const Camera& previous, const Camera& current, f32 alpha);
+
   [[nodiscard]] glm::vec3 GetPosition() const
   {
     return m_Position;
@@ -0,0 +1,53 @@
+#include "four-pch.hpp"
+
+#include "component/component.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace four
+{
+
+namespace
+{
+// infos never move once registered, GetComponentInfo reads them without the lock
+struct ComponentRegistry
+{
+  std::mutex                                    mutex;
+  std::array<ComponentInfo, ECS_MAX_COMPONENTS> infos{};
+  std::atomic<u32>                              count{0};
+};
+
+ComponentRegistry& GetRegistry()
+{
+  static ComponentRegistry registry;
+  return registry;
+}
+} // namespace
+
+//===============================================================================
+ComponentId RegisterComponent(ComponentInfo info)
+{
+  auto&                  registry = GetRegistry();
+  const std::scoped_lock lock(registry.mutex);
+
+  const u32 id = registry.count.load(std::memory_order_relaxed);
+  if (id == ECS_MAX_COMPONENTS)
+  {
+    LOG_CORE_ERROR("more than {} component types registered", ECS_MAX_COMPONENTS);
+    throw std::length_error("too many component types");
+  }
+
+  info.id            = id;
+  registry.infos[id] = info;
+  registry.count.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+//===============================================================================
+const ComponentInfo& GetComponentInfo(ComponentId id)
+{
+  return GetRegistry().infos[id];
+}
+
+} // namespace four
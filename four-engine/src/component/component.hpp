@@ -1,9 +1,62 @@
 #pragma once
 
+#include "core/core.hpp"
+
 namespace four
 {
-class Component
+
+constexpr u32 ECS_MAX_COMPONENTS = 64; // component types, one bit each in ComponentMask
+constexpr u32 ECS_MAX_ALIGNMENT  = 64; // strictest component alignment, chunks and payloads are aligned to it
+
+using ComponentId   = u32;
+using ComponentMask = u64;
+
+/**
+ * @brief components are plain data, stored by value in archetype columns and moved when entities change archetype
+ */
+template <typename T>
+concept ComponentType = std::is_object_v<T> && !std::is_const_v<T> && std::is_nothrow_move_constructible_v<T> &&
+                        std::is_nothrow_destructible_v<T> && alignof(T) <= ECS_MAX_ALIGNMENT;
+
+/**
+ * @brief type erased operations of one component type
+ */
+struct ComponentInfo
 {
-public:
-  virtual ~Component() = default;
+  ComponentId id{0};
+  u32         size{0};
+  u32         alignment{0};
+  void (*moveConstruct)(void* destination, void* source){nullptr}; // source is left moved-from
+  void (*destroy)(void* component){nullptr};
 };
+
+/**
+ * @brief register a component type, ids are handed out in first use order
+ * throws std::length_error when more than ECS_MAX_COMPONENTS types are used
+ */
+FOUR_ENGINE_API ComponentId RegisterComponent(ComponentInfo info);
+
+/**
+ * @brief info of a registered component, any thread
+ */
+FOUR_ENGINE_API const ComponentInfo& GetComponentInfo(ComponentId id);
+
+template <ComponentType T>
+[[nodiscard]] ComponentId GetComponentId()
+{
+  static const ComponentId id = RegisterComponent({
+    .size          = sizeof(T),
+    .alignment     = alignof(T),
+    .moveConstruct = [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); },
+    .destroy       = [](void* component) { static_cast<T*>(component)->~T(); },
+  });
+  return id;
+}
+
+template <ComponentType... Ts>
+[[nodiscard]] ComponentMask GetComponentMask()
+{
+  return ((ComponentMask{1} << GetComponentId<Ts>()) | ... | ComponentMask{0});
+}
+
+} // namespace four
@@ -5,18 +5,15 @@
 namespace four
 {
 
-class CLifeSpan : public Component
+struct CLifeSpan
 {
-public:
-  explicit CLifeSpan(int totalLifeSpan) : m_TotalLifeSpan{totalLifeSpan}, m_RemainingLifeSpan{totalLifeSpan}
+  i32 total{0};
+  i32 remaining{0};
+
+  CLifeSpan() = default;
+  explicit CLifeSpan(i32 totalLifeSpan) : total{totalLifeSpan}, remaining{totalLifeSpan}
   {
   }
-  CShape()  = default;
-  ~CShape() = default;
-
-
-private:
-  int m_TotalLifeSpan{0};
-  int m_RemainingLifeSpan{0};
 };
+
 } // namespace four
@@ -1,18 +1,22 @@
 #pragma once
 
 #include "component/component.hpp"
-#include <SFML/Graphics.hpp>
+
+#include "glm/glm.hpp"
 
 namespace four
 {
 
-class CShape : public Component
+/**
+ * @brief regular polygon, a circle with enough points
+ */
+struct CShape
 {
-public:
-  CShape()  = default;
-  ~CShape() = default;
-
-private:
-  sf::CircleShape m_Shape{};
+  f32       radius{1.0F};
+  u32       pointCount{30};
+  glm::vec4 fillColor{1.0F, 1.0F, 1.0F, 1.0F};
+  glm::vec4 outlineColor{0.0F, 0.0F, 0.0F, 1.0F};
+  f32       outlineThickness{0.0F};
 };
+
 } // namespace four
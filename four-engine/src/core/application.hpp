@@ -18,6 +18,15 @@ public:
   virtual void Init()                    = 0;
   virtual void OnUpdate(float deltaTime) = 0;
 
+  /**
+   * @brief simulation tick, called zero or more times per frame with a constant step
+   *
+   * @param step tick duration in seconds, see Engine::GetTimestep
+   */
+  virtual void OnFixedUpdate([[maybe_unused]] float step)
+  {
+  }
+
   Engine* GetEngine()
   {
     return m_Engine;
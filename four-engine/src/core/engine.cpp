@@ -4,6 +4,8 @@
 #include "core/application.hpp"
 #include "imgui.h"
 
+#include <thread>
+
 namespace four
 {
 
@@ -11,10 +13,14 @@ std::unique_ptr<Engine> Engine::sm_Instance = nullptr;
 
 //====================================================================================================
 Engine::Engine(std::string_view title, u32 width, u32 height) :
+m_JobSystem{JobSystem::DefaultThreadCount()},
 m_Window{WindowType::CreateWindow(title, width, height)},
 m_Renderer{m_Window},
+m_FramePacer{DefaultTargetFps},
+m_Timestep{DefaultTickRate, MaxTicksPerFrame},
 m_Application{nullptr}
 {
+  m_FramePacer.SetPresentWait([this] { return m_Renderer.IsPresentWaitSupported() && m_Renderer.WaitForRenderedFrame(); });
 }
 
 //====================================================================================================
@@ -25,44 +31,84 @@ void Engine::Run()
 {
   try
   {
-    auto lastFrameTimePoint = std::chrono::high_resolution_clock::now();
-    u32  fps                = 0;
+    // render thread records and submits frame N while this thread simulates frame N + 1
+    std::jthread renderThread(
+      [this](const std::stop_token& stopToken)
+      {
+        try
+        {
+          while (m_Renderer.WaitForFramePacket(stopToken))
+          {
+            m_Renderer.Render();
+          }
+        } catch (const std::exception& e)
+        {
+          LOG_CORE_ERROR("Render thread exception: {}", e.what());
+        }
+      });
+
+    auto lastFrameTimePoint = std::chrono::steady_clock::now();
+    u64  frameNumber        = 0;
     while (!m_Window.ShouldClose())
     {
-      const auto startTime     = std::chrono::high_resolution_clock::now();
-      const auto frameDuration = std::chrono::duration_cast<std::chrono::milliseconds>(startTime - lastFrameTimePoint);
+      const auto startTime     = std::chrono::steady_clock::now();
+      const auto frameDuration = std::chrono::duration<f64>(startTime - lastFrameTimePoint);
       lastFrameTimePoint       = startTime;
 
-      m_Window.OnUpdate();
-      if (m_Application != nullptr)
+      // gpu timings of this frame are published under the same number once they are read back
+      ProfileFrameRecord record{.frameNumber = frameNumber++, .start = Profiler::Now()};
       {
-        m_Application->OnUpdate(static_cast<f32>(frameDuration.count()) / 1000.0F);
-      }
+        FOUR_PROFILE_SCOPE("Update");
+        m_Window.OnUpdate();
+        m_JobSystem.RunMainThreadJobs();
 
-      const auto renderTime = std::chrono::high_resolution_clock::now();
-      m_Renderer.Render();
-      const auto renderTimeDuration = std::chrono::duration_cast<std::chrono::microseconds>(
-        std::chrono::high_resolution_clock::now() - renderTime);
-
-      const auto realTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                              std::chrono::high_resolution_clock::now() - startTime)
-                              .count();
+        // simulation runs in equal steps whatever the frame rate, rendering blends the last two steps
+        const u32 ticks = m_Timestep.Advance(frameDuration.count());
+        for (u32 tick = 0; tick < ticks; ++tick)
+        {
+          FOUR_PROFILE_SCOPE("FixedUpdate");
+          m_Renderer.FixedUpdate(m_Timestep.GetStep());
+          if (m_Systems.GetSystemCount() != 0)
+          {
+            m_Systems.Run(m_Scene, m_JobSystem, m_Timestep.GetStep());
+          }
+          if (m_Application != nullptr)
+          {
+            m_Application->OnFixedUpdate(m_Timestep.GetStep());
+          }
+        }
+        // only subtrees whose local transforms changed are recomputed, nothing when the scene is static
+        m_Scene.GetTransformGraph().Update(m_JobSystem);
+        m_Renderer.SetInterpolationAlpha(m_Timestep.GetAlpha());
 
-      if (FrameCapEnabled)
-      {
-        if (const auto sleepTime = TargetFrameTime - static_cast<f32>(realTime); sleepTime > 0.0F)
+        if (m_Application != nullptr)
         {
-          std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<i32>(sleepTime)));
+          m_Application->OnUpdate(static_cast<f32>(frameDuration.count()));
         }
       }
-      fps = static_cast<u32>(1000.0F / static_cast<float>(frameDuration.count()));
-      // LOG_CORE_INFO("FPS: {}, time: {}ms, realtime: {}ms, renderTime: {}us",
-      //               fps,
-      //               frameDuration.count(),
-      //               realTime,
-      //               renderTimeDuration.count());
+
+      const ProfileTime renderStart = Profiler::Now();
+      m_Renderer.SetPresentPacing(m_FramePacer.GetMode() == FramePacingMode::Present);
+      m_Renderer.PublishFramePacket(record.frameNumber);
+      const ProfileTime renderEnd = Profiler::Now();
+
+      {
+        FOUR_PROFILE_SCOPE("FramePacer");
+        m_FramePacer.Wait();
+      }
+
+      constexpr f32     nsToMs   = 1e-6F;
+      const ProfileTime frameEnd = Profiler::Now();
+      record.frameMs  = static_cast<f32>(frameEnd - record.start) * nsToMs;
+      record.updateMs = static_cast<f32>(renderStart - record.start) * nsToMs;
+      record.renderMs = static_cast<f32>(renderEnd - renderStart) * nsToMs;
+      Profiler::Get().PushFrame(record);
+      Profiler::Get().PushZone("Frame", record.start, frameEnd);
     }
+    renderThread.request_stop();
+    renderThread.join();
     m_Renderer.StopRender();
+    ReportProfile();
     Shutdown();
   } catch (const std::exception& e)
   {
@@ -76,6 +122,48 @@ void Engine::OnResize(u32 width, u32 height)
   LOG_CORE_INFO("resize: w: {}, h {}", width, height);
 }
 
+//====================================================================================================
+void Engine::ReportProfile() const
+{
+  const ProfileStats stats = Profiler::Get().GetStats();
+  LOG_CORE_INFO("last {} frames, frame ms avg {:.2f} p50 {:.2f} p95 {:.2f} p99 {:.2f} max {:.2f}",
+                stats.frameCount,
+                stats.frame.average,
+                stats.frame.p50,
+                stats.frame.p95,
+                stats.frame.p99,
+                stats.frame.max);
+  LOG_CORE_INFO("update ms p95 {:.2f}, render ms p95 {:.2f}, gpu ms p50 {:.2f} p95 {:.2f} p99 {:.2f}",
+                stats.update.p95,
+                stats.render.p95,
+                stats.gpu.p50,
+                stats.gpu.p95,
+                stats.gpu.p99);
+
+  const FramePacerStats pacing = m_FramePacer.GetStats();
+  LOG_CORE_INFO("{} fixed updates at {:.0f} Hz, {:.3f} s dropped by catch-up cap",
+                m_Timestep.GetTickCount(),
+                m_Timestep.GetTickRate(),
+                m_Timestep.GetDroppedTime());
+  LOG_CORE_INFO("pacing at {:.1f} fps, interval mean {:.3f} ms stddev {:.3f} ms max {:.3f} ms, {} missed of {} frames",
+                m_FramePacer.GetTargetFps(),
+                pacing.meanMs,
+                pacing.stdDevMs,
+                pacing.maxMs,
+                pacing.missedDeadlines,
+                pacing.frameCount);
+
+  if (m_Systems.GetSystemCount() != 0)
+  {
+    LOG_CORE_INFO("{}", m_Systems.DumpSchedule());
+  }
+
+  if (ProfilerTraceEnabled)
+  {
+    Profiler::Get().ExportChromeTrace(ProfilerTracePath);
+  }
+}
+
 //====================================================================================================
 void Engine::Shutdown()
 {
@@ -2,20 +2,30 @@
 
 #include "core/core.hpp"
 
+#include "core/fixedTimestep.hpp"
+#include "core/framePacer.hpp"
 #include "core/imgui/imguiLayer.hpp"
+#include "core/jobSystem.hpp"
 #include "core/layerStack.hpp"
+#include "core/profiler.hpp"
 
 // renderer
 #include "renderer/vulkan/vulkanRenderer.hpp"
 
+#include "scene/scene.hpp"
+#include "system/systemScheduler.hpp"
+
 #include "window/glfw/glfwWindow.hpp"
 
 namespace four
 {
 
-constexpr bool FrameCapEnabled = true;
-constexpr u32  TargetFPS       = 60;
-constexpr f32  TargetFrameTime = 1000.0F / static_cast<f32>(TargetFPS);
+constexpr f32 DefaultTargetFps = 60.0F;  // initial rate of the frame pacer, can be changed at runtime
+constexpr f32 DefaultTickRate  = 120.0F; // fixed updates per second
+constexpr u32 MaxTicksPerFrame = 8;      // fixed updates one frame may run before time is dropped
+
+constexpr bool             ProfilerTraceEnabled = false; // write chrome trace of the last frames on exit
+constexpr std::string_view ProfilerTracePath    = "profile/trace.json";
 
 class Application;
 
@@ -70,11 +80,51 @@ public:
    */
   void Run();
 
+  /**
+   * @brief job scheduler shared by the engine, renderer, asset loaders and systems
+   */
+  [[nodiscard]] JobSystem* GetJobSystem() noexcept
+  {
+    return &m_JobSystem;
+  }
+
+  /**
+   * @brief entities of the running game, updated by the systems every fixed tick
+   */
+  [[nodiscard]] Scene* GetScene() noexcept
+  {
+    return &m_Scene;
+  }
+
+  /**
+   * @brief systems run on the scene every fixed tick, in parallel where their components allow
+   */
+  [[nodiscard]] SystemScheduler* GetSystemScheduler() noexcept
+  {
+    return &m_Systems;
+  }
+
   [[nodiscard]] auto* GetWindow() noexcept
   {
     return &m_Window;
   }
 
+  /**
+   * @brief frame rate limiter of the main loop, target rate and pacing mode can be changed at any time
+   */
+  [[nodiscard]] FramePacer* GetFramePacer() noexcept
+  {
+    return &m_FramePacer;
+  }
+
+  /**
+   * @brief fixed timestep of the simulation, tick rate can be changed at any time
+   */
+  [[nodiscard]] FixedTimestep* GetTimestep() noexcept
+  {
+    return &m_Timestep;
+  }
+
   /**
    * @brief Shutdown and free resources of Engine
    */
@@ -133,16 +183,36 @@ private:
    */
   void OnResize(u32 width, u32 height);
 
+  /**
+   * @brief log frame time percentiles, pacing variance and write chrome trace when enabled
+   */
+  void ReportProfile() const;
+
 private:
   /** singletone instance of Engine */
   static std::unique_ptr<Engine> sm_Instance;
 
+  /** worker threads, created first so everything after it can submit jobs while it is constructed */
+  JobSystem m_JobSystem;
+
   /** main window of the Engine */
   WindowType m_Window;
 
   /** renderer */
   RendererType m_Renderer;
 
+  /** paces the main loop to the target frame rate */
+  FramePacer m_FramePacer;
+
+  /** splits frame time into fixed simulation steps */
+  FixedTimestep m_Timestep;
+
+  /** entities and components of the game */
+  Scene m_Scene;
+
+  /** systems updating m_Scene */
+  SystemScheduler m_Systems;
+
   /** imgui layer stacks for UI */
   LayerStack<ImGuiLayer> m_ImGuiLayer;
 
@@ -0,0 +1,43 @@
+#include "four-pch.hpp"
+
+#include "core/fixedTimestep.hpp"
+
+namespace four
+{
+
+//===============================================================================
+FixedTimestep::FixedTimestep(f32 tickRate, u32 maxTicksPerFrame)
+{
+  SetTickRate(tickRate);
+  SetMaxTicksPerFrame(maxTicksPerFrame);
+}
+
+//===============================================================================
+void FixedTimestep::SetTickRate(f32 tickRate)
+{
+  // a tick rate below one per second is not a real time simulation
+  m_Step        = 1.0 / static_cast<f64>(std::max(tickRate, 1.0F));
+  m_Accumulator = std::min(m_Accumulator, m_Step);
+}
+
+//===============================================================================
+u32 FixedTimestep::Advance(f64 frameSeconds)
+{
+  m_Accumulator += std::max(frameSeconds, 0.0);
+
+  auto ticks = static_cast<u64>(m_Accumulator / m_Step);
+  if (ticks > m_MaxTicksPerFrame)
+  {
+    // keep the fraction of a tick so interpolation stays continuous, drop the rest
+    const f64 excess = static_cast<f64>(ticks - m_MaxTicksPerFrame) * m_Step;
+    m_DroppedTime += excess;
+    m_Accumulator -= excess;
+    ticks = m_MaxTicksPerFrame;
+  }
+
+  m_Accumulator -= static_cast<f64>(ticks) * m_Step;
+  m_TickCount += ticks;
+  return static_cast<u32>(ticks);
+}
+
+} // namespace four
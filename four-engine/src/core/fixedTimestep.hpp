@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/core.hpp"
+
+namespace four
+{
+
+/**
+ * @brief Fixed timestep accumulator
+ * frame time is accumulated and consumed in ticks of a fixed step, so simulation runs the same number of equal
+ * steps for the same elapsed time whatever the frame rate. rendering interpolates between the last two ticks
+ * with GetAlpha. ticks per frame are capped, time beyond the cap is dropped instead of simulated, so a slow
+ * frame can not make the next one slower ( spiral of death ).
+ */
+class FOUR_ENGINE_API FixedTimestep
+{
+public:
+  /**
+   * @param tickRate simulation ticks per second
+   * @param maxTicksPerFrame most ticks one frame may run, excess time is dropped
+   */
+  explicit FixedTimestep(f32 tickRate, u32 maxTicksPerFrame);
+
+  /**
+   * @brief add frame time to the accumulator
+   *
+   * @param frameSeconds wall time since previous call
+   * @return number of ticks to simulate this frame
+   */
+  [[nodiscard]] u32 Advance(f64 frameSeconds);
+
+  /**
+   * @brief how far rendering is between previous and current tick, [0, 1)
+   */
+  [[nodiscard]] f32 GetAlpha() const
+  {
+    return static_cast<f32>(m_Accumulator / m_Step);
+  }
+
+  /**
+   * @brief duration of one tick in seconds
+   */
+  [[nodiscard]] f32 GetStep() const
+  {
+    return static_cast<f32>(m_Step);
+  }
+
+  void SetTickRate(f32 tickRate);
+
+  [[nodiscard]] f32 GetTickRate() const
+  {
+    return static_cast<f32>(1.0 / m_Step);
+  }
+
+  void SetMaxTicksPerFrame(u32 maxTicksPerFrame)
+  {
+    m_MaxTicksPerFrame = std::max(maxTicksPerFrame, 1U);
+  }
+
+  [[nodiscard]] u64 GetTickCount() const
+  {
+    return m_TickCount;
+  }
+
+  /**
+   * @brief wall time that was dropped by the catch-up cap, seconds
+   */
+  [[nodiscard]] f64 GetDroppedTime() const
+  {
+    return m_DroppedTime;
+  }
+
+private:
+  f64 m_Step{0.0};
+  f64 m_Accumulator{0.0};
+  u32 m_MaxTicksPerFrame{1};
+  u64 m_TickCount{0};
+  f64 m_DroppedTime{0.0};
+};
+
+} // namespace four
@@ -0,0 +1,138 @@
+#include "four-pch.hpp"
+
+#include "core/framePacer.hpp"
+
+#include <cmath>
+#include <thread>
+
+namespace four
+{
+
+namespace
+{
+using namespace std::chrono_literals;
+
+constexpr FramePacer::Clock::duration InitialSleepOvershoot = 1ms;   // assumed until sleeps were measured
+constexpr FramePacer::Clock::duration MaxSleepOvershoot     = 4ms;   // bound of the estimate, coarse timers
+constexpr FramePacer::Clock::duration SleepSlice            = 1ms;   // longest single sleep, overshoot is per sleep
+constexpr i64                         OvershootDecayShift   = 4;     // estimate decays by 1/16 per sleep
+} // namespace
+
+//===============================================================================
+FramePacer::FramePacer(f32 targetFps, FramePacingMode mode) : m_Mode{mode}, m_SleepOvershoot{InitialSleepOvershoot}
+{
+  SetTargetFps(targetFps);
+}
+
+//===============================================================================
+void FramePacer::SetTargetFps(f32 targetFps)
+{
+  m_TargetFps = std::max(targetFps, 0.0F);
+  m_Interval  = m_TargetFps > 0.0F
+                  ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(1.0 / static_cast<f64>(m_TargetFps)))
+                  : Clock::duration::zero();
+
+  // start a new schedule, the old deadline belongs to the old interval
+  m_NextDeadline = {};
+}
+
+//===============================================================================
+void FramePacer::SetMode(FramePacingMode mode)
+{
+  m_Mode         = mode;
+  m_NextDeadline = {};
+}
+
+//===============================================================================
+void FramePacer::Wait()
+{
+  if (m_Mode == FramePacingMode::Present && m_PresentWait && m_PresentWait())
+  {
+    // presentation engine paced the frame, timed schedule restarts if present wait stops working
+    m_NextDeadline = {};
+    RecordFrame(Clock::now());
+    return;
+  }
+
+  if (m_Mode == FramePacingMode::Unlimited || m_Interval == Clock::duration::zero())
+  {
+    RecordFrame(Clock::now());
+    return;
+  }
+
+  const auto now = Clock::now();
+  if (m_NextDeadline == Clock::time_point{})
+  {
+    m_NextDeadline = now + m_Interval;
+  }
+  else if (now > m_NextDeadline + m_Interval)
+  {
+    // too late to pay the debt back, running faster to catch up would only show as a burst of short frames
+    ++m_MissedDeadlines;
+    m_NextDeadline = now;
+  }
+
+  WaitUntil(m_NextDeadline);
+  RecordFrame(Clock::now());
+  m_NextDeadline += m_Interval;
+}
+
+//===============================================================================
+void FramePacer::WaitUntil(Clock::time_point deadline)
+{
+  // sleep while the deadline is safely away, each sleep refines the overshoot estimate
+  for (auto remaining = deadline - Clock::now(); remaining > m_SleepOvershoot; remaining = deadline - Clock::now())
+  {
+    const auto request = std::min(remaining - m_SleepOvershoot, SleepSlice);
+    const auto before  = Clock::now();
+    std::this_thread::sleep_for(request);
+    const auto overshoot = (Clock::now() - before) - request;
+
+    m_SleepOvershoot -= m_SleepOvershoot / (1 << OvershootDecayShift);
+    m_SleepOvershoot = std::clamp(std::max(m_SleepOvershoot, overshoot), Clock::duration::zero(), MaxSleepOvershoot);
+  }
+
+  // spin the last stretch, sleeping would wake up too late
+  while (Clock::now() < deadline)
+  {
+    std::this_thread::yield();
+  }
+}
+
+//===============================================================================
+void FramePacer::RecordFrame(Clock::time_point now)
+{
+  if (m_LastFrame != Clock::time_point{})
+  {
+    const f64 intervalMs = std::chrono::duration<f64, std::milli>(now - m_LastFrame).count();
+    ++m_FrameCount;
+    const f64 delta = intervalMs - m_MeanMs;
+    m_MeanMs += delta / static_cast<f64>(m_FrameCount);
+    m_M2 += delta * (intervalMs - m_MeanMs);
+    m_MaxMs = std::max(m_MaxMs, intervalMs);
+  }
+  m_LastFrame = now;
+}
+
+//===============================================================================
+FramePacerStats FramePacer::GetStats() const
+{
+  return {.frameCount      = m_FrameCount,
+          .missedDeadlines = m_MissedDeadlines,
+          .meanMs          = m_MeanMs,
+          .stdDevMs        = m_FrameCount > 1 ? std::sqrt(m_M2 / static_cast<f64>(m_FrameCount - 1)) : 0.0,
+          .maxMs           = m_MaxMs};
+}
+
+//===============================================================================
+void FramePacer::ResetStats()
+{
+  m_LastFrame       = {};
+  m_FrameCount      = 0;
+  m_MissedDeadlines = 0;
+  m_MeanMs          = 0.0;
+  m_M2              = 0.0;
+  m_MaxMs           = 0.0;
+}
+
+} // namespace four
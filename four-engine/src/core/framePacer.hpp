@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include <chrono>
+#include <functional>
+
+namespace four
+{
+
+enum class FramePacingMode : u8
+{
+  Unlimited, // never waits
+  Timed,     // sleep then spin until the next deadline of the target rate
+  Present,   // wait for the presentation engine, timed when present wait is not available
+};
+
+/**
+ * @brief interval between consecutive frames, as seen by FramePacer::Wait
+ */
+struct FramePacerStats
+{
+  u64 frameCount{0};
+  u64 missedDeadlines{0}; // frames that ended later than one full interval after their deadline
+  f64 meanMs{0.0};
+  f64 stdDevMs{0.0};
+  f64 maxMs{0.0};
+};
+
+/**
+ * @brief Frame rate limiter
+ * deadlines advance by a fixed interval from the previous deadline, not from when the wait returned, so wake-up
+ * error of one frame is paid back by the next and the average rate does not drift.
+ * the wait sleeps while the deadline is further than the observed sleep overshoot and spins for the rest, which
+ * keeps the cpu mostly idle and still wakes up within microseconds of the deadline.
+ */
+class FOUR_ENGINE_API FramePacer
+{
+public:
+  using Clock       = std::chrono::steady_clock;
+  using PresentWait = std::function<bool()>; // blocks until presentation is due, false when not available
+
+  explicit FramePacer(f32 targetFps, FramePacingMode mode = FramePacingMode::Timed);
+
+  /**
+   * @brief change target rate, applied from the next frame
+   *
+   * @param targetFps frames per second, 0 or less waits never
+   */
+  void SetTargetFps(f32 targetFps);
+
+  [[nodiscard]] f32 GetTargetFps() const
+  {
+    return m_TargetFps;
+  }
+
+  void SetMode(FramePacingMode mode);
+
+  [[nodiscard]] FramePacingMode GetMode() const
+  {
+    return m_Mode;
+  }
+
+  /**
+   * @brief function used by FramePacingMode::Present
+   */
+  void SetPresentWait(PresentWait presentWait)
+  {
+    m_PresentWait = std::move(presentWait);
+  }
+
+  /**
+   * @brief block until the next frame is due, call once per frame after it was submitted
+   */
+  void Wait();
+
+  [[nodiscard]] FramePacerStats GetStats() const;
+
+  /**
+   * @brief deadline the next Wait sleeps until in timed mode, default constructed when no schedule is running
+   */
+  [[nodiscard]] Clock::time_point GetNextDeadline() const
+  {
+    return m_NextDeadline;
+  }
+
+  [[nodiscard]] Clock::duration GetInterval() const
+  {
+    return m_Interval;
+  }
+
+  void ResetStats();
+
+private:
+  void WaitUntil(Clock::time_point deadline);
+  void RecordFrame(Clock::time_point now);
+
+private:
+  f32             m_TargetFps{0.0F};
+  FramePacingMode m_Mode{FramePacingMode::Timed};
+  Clock::duration m_Interval{};
+  PresentWait     m_PresentWait;
+
+  Clock::time_point m_NextDeadline{};
+  Clock::duration   m_SleepOvershoot; // worst recent oversleep, spinning starts this long before the deadline
+
+  // running mean and variance of the frame interval, Welford
+  Clock::time_point m_LastFrame{};
+  u64               m_FrameCount{0};
+  u64               m_MissedDeadlines{0};
+  f64               m_MeanMs{0.0};
+  f64               m_M2{0.0};
+  f64               m_MaxMs{0.0};
+};
+
+} // namespace four
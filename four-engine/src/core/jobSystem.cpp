@@ -0,0 +1,368 @@
+#include "four-pch.hpp"
+
+#include "core/jobSystem.hpp"
+
+namespace four
+{
+
+namespace
+{
+// worker of the calling thread, workers of several systems may exist in tests
+thread_local const JobSystem* t_System      = nullptr;
+thread_local u32              t_WorkerIndex = 0;
+} // namespace
+
+//===============================================================================
+bool JobCounter::IsDone() const
+{
+  if (m_Pending.load(std::memory_order_acquire) != 0)
+  {
+    return false;
+  }
+
+  // the last Finish may still hold the mutex, the counter can only be destroyed once it let go
+  const std::scoped_lock lock(m_Mutex);
+  return m_Pending.load(std::memory_order_relaxed) == 0;
+}
+
+//===============================================================================
+std::vector<Job*> JobCounter::Finish()
+{
+  std::vector<Job*>      ready;
+  const std::scoped_lock lock(m_Mutex);
+  if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    ready.swap(m_Continuations);
+  }
+  return ready;
+}
+
+//===============================================================================
+JobSystem::JobSystem(u32 threadCount) : m_MainThreadId{std::this_thread::get_id()}
+{
+  threadCount = std::max(threadCount, 1U);
+  m_Workers.reserve(threadCount);
+  for (u32 i = 0; i < threadCount; ++i)
+  {
+    m_Workers.push_back(std::make_unique<Worker>());
+  }
+
+  t_System      = this;
+  t_WorkerIndex = 0;
+
+  // threads start once every queue exists, they steal from all of them
+  for (u32 i = 1; i < threadCount; ++i)
+  {
+    m_Workers[i]->thread = std::jthread([this, i](const std::stop_token& stopToken) { WorkerLoop(i, stopToken); });
+  }
+
+  LOG_CORE_INFO("job system with {} threads", threadCount);
+}
+
+//===============================================================================
+JobSystem::~JobSystem()
+{
+  for (auto& worker : m_Workers)
+  {
+    worker->thread.request_stop();
+  }
+  m_WorkSignal.fetch_add(1, std::memory_order_release);
+  m_WorkSignal.notify_all();
+
+  // workers drain every queue before they exit
+  for (auto& worker : m_Workers)
+  {
+    if (worker->thread.joinable())
+    {
+      worker->thread.join();
+    }
+  }
+
+  const std::scoped_lock lock(m_MainThreadMutex);
+  if (!m_MainThreadJobs.empty())
+  {
+    LOG_CORE_WARN("job system destroyed with {} main thread jobs that never ran", m_MainThreadJobs.size());
+  }
+  for (Job* job : m_MainThreadJobs)
+  {
+    delete job;
+  }
+
+  if (t_System == this)
+  {
+    t_System = nullptr;
+  }
+}
+
+//===============================================================================
+u32 JobSystem::DefaultThreadCount()
+{
+  const u32 hardwareThreads = std::thread::hardware_concurrency();
+  return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+//===============================================================================
+void JobSystem::Submit(JobFunction function, JobCounter* counter)
+{
+  if (counter != nullptr)
+  {
+    counter->Add();
+  }
+  Enqueue(new Job{.function = std::move(function), .counter = counter});
+}
+
+//===============================================================================
+void JobSystem::SubmitAfter(JobCounter& dependency, JobFunction function, JobCounter* counter)
+{
+  if (counter != nullptr)
+  {
+    counter->Add();
+  }
+
+  Job* job = new Job{.function = std::move(function), .counter = counter};
+  {
+    // Finish takes the continuations under the same lock, the job is either stored before or queued here
+    const std::scoped_lock lock(dependency.m_Mutex);
+    if (dependency.m_Pending.load(std::memory_order_relaxed) != 0)
+    {
+      dependency.m_Continuations.push_back(job);
+      return;
+    }
+  }
+  Enqueue(job);
+}
+
+//===============================================================================
+void JobSystem::SubmitMainThread(JobFunction function, JobCounter* counter)
+{
+  if (counter != nullptr)
+  {
+    counter->Add();
+  }
+
+  const std::scoped_lock lock(m_MainThreadMutex);
+  m_MainThreadJobs.push_back(new Job{.function = std::move(function), .counter = counter});
+}
+
+//===============================================================================
+u32 JobSystem::RunMainThreadJobs()
+{
+  if (!IsMainThread())
+  {
+    LOG_CORE_ERROR("main thread jobs can only run on the main thread");
+    return 0;
+  }
+
+  // jobs queued by the jobs that run now wait for the next call, a job resubmitting itself can not stall the frame
+  std::deque<Job*> jobs;
+  {
+    const std::scoped_lock lock(m_MainThreadMutex);
+    jobs.swap(m_MainThreadJobs);
+  }
+  for (Job* job : jobs)
+  {
+    Execute(job, 0);
+  }
+  return static_cast<u32>(jobs.size());
+}
+
+//===============================================================================
+void JobSystem::Wait(const JobCounter& counter)
+{
+  const u32  workerIndex = GetWorkerIndex();
+  const bool mainThread  = workerIndex == 0;
+  while (!counter.IsDone())
+  {
+    Job* job = FindJob(workerIndex);
+    if (job == nullptr && mainThread)
+    {
+      // group may wait on a main thread job, the main thread is the only one that can run it
+      job = PopMainThreadJob();
+    }
+
+    if (job != nullptr)
+    {
+      Execute(job, workerIndex);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+//===============================================================================
+void JobSystem::ParallelFor(u32 begin, u32 end, u32 grainSize, const std::function<void(u32, u32)>& function)
+{
+  if (end <= begin)
+  {
+    return;
+  }
+
+  const u32 count      = end - begin;
+  const u32 maxChunks  = GetThreadCount() * JOB_CHUNKS_PER_THREAD;
+  const u32 chunkCount = std::clamp((count + std::max(grainSize, 1U) - 1) / std::max(grainSize, 1U), 1U, maxChunks);
+  const u32 chunkSize  = (count + chunkCount - 1) / chunkCount;
+
+  JobCounter counter;
+  u32        chunkBegin = begin + chunkSize;
+  for (; chunkBegin < end; chunkBegin += chunkSize)
+  {
+    const u32 chunkEnd = std::min(chunkBegin + chunkSize, end);
+    Submit([&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); }, &counter);
+  }
+
+  // first chunk runs here, it is the one least likely to be stolen
+  function(begin, std::min(begin + chunkSize, end));
+  Wait(counter);
+}
+
+//===============================================================================
+JobSystemStats JobSystem::GetStats() const
+{
+  JobSystemStats stats;
+  for (const auto& worker : m_Workers)
+  {
+    stats.executed += worker->executed.load(std::memory_order_relaxed);
+    stats.stolen += worker->stolen.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+//===============================================================================
+void JobSystem::WorkerLoop(u32 index, const std::stop_token& stopToken)
+{
+  t_System      = this;
+  t_WorkerIndex = index;
+
+  u32 idleCount = 0;
+  while (true)
+  {
+    // read before searching, a job submitted after the search changes the signal and wakes the wait below
+    const u32 signal = m_WorkSignal.load(std::memory_order_acquire);
+    if (Job* job = FindJob(index))
+    {
+      Execute(job, index);
+      idleCount = 0;
+      continue;
+    }
+
+    if (stopToken.stop_requested())
+    {
+      break;
+    }
+
+    if (++idleCount < JOB_IDLE_SPIN_COUNT)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    m_WorkSignal.wait(signal, std::memory_order_acquire);
+  }
+
+  t_System = nullptr;
+}
+
+//===============================================================================
+u32 JobSystem::GetWorkerIndex() const
+{
+  return t_System == this ? t_WorkerIndex : NoWorker;
+}
+
+//===============================================================================
+void JobSystem::Enqueue(Job* job)
+{
+  const u32 workerIndex = GetWorkerIndex();
+  if (workerIndex != NoWorker)
+  {
+    if (!m_Workers[workerIndex]->queue.Push(job))
+    {
+      // queue is full, running the job now is what a worker would do with it next anyway
+      Execute(job, workerIndex);
+      return;
+    }
+  }
+  else
+  {
+    const std::scoped_lock lock(m_SharedMutex);
+    m_SharedJobs.push_back(job);
+    m_SharedCount.fetch_add(1, std::memory_order_release);
+  }
+
+  m_WorkSignal.fetch_add(1, std::memory_order_release);
+  m_WorkSignal.notify_one();
+}
+
+//===============================================================================
+void JobSystem::Execute(Job* job, u32 workerIndex)
+{
+  job->function();
+
+  if (job->counter != nullptr)
+  {
+    for (Job* continuation : job->counter->Finish())
+    {
+      Enqueue(continuation);
+    }
+  }
+  delete job;
+
+  if (workerIndex != NoWorker)
+  {
+    m_Workers[workerIndex]->executed.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//===============================================================================
+Job* JobSystem::FindJob(u32 workerIndex)
+{
+  Job* job = nullptr;
+  if (workerIndex != NoWorker && m_Workers[workerIndex]->queue.Pop(job))
+  {
+    return job;
+  }
+
+  if (m_SharedCount.load(std::memory_order_acquire) != 0)
+  {
+    const std::scoped_lock lock(m_SharedMutex);
+    if (!m_SharedJobs.empty())
+    {
+      job = m_SharedJobs.front();
+      m_SharedJobs.pop_front();
+      m_SharedCount.fetch_sub(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+
+  // start at the next worker, so thieves spread over victims instead of all hitting worker 0
+  const u32 workerCount = GetThreadCount();
+  const u32 first       = workerIndex != NoWorker ? workerIndex + 1 : 0;
+  for (u32 i = 0; i < workerCount; ++i)
+  {
+    const u32 victim = (first + i) % workerCount;
+    if (victim != workerIndex && m_Workers[victim]->queue.Steal(job))
+    {
+      if (workerIndex != NoWorker)
+      {
+        m_Workers[workerIndex]->stolen.fetch_add(1, std::memory_order_relaxed);
+      }
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+//===============================================================================
+Job* JobSystem::PopMainThreadJob()
+{
+  const std::scoped_lock lock(m_MainThreadMutex);
+  if (m_MainThreadJobs.empty())
+  {
+    return nullptr;
+  }
+  Job* job = m_MainThreadJobs.front();
+  m_MainThreadJobs.pop_front();
+  return job;
+}
+
+} // namespace four
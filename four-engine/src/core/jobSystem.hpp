@@ -0,0 +1,206 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "core/workStealingQueue.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace four
+{
+
+constexpr u32 JOB_QUEUE_CAPACITY    = 4096; // jobs one thread can have queued, a full queue runs new jobs inline
+constexpr u32 JOB_CHUNKS_PER_THREAD = 4;    // ParallelFor splits a range in at most this many chunks per thread
+constexpr u32 JOB_IDLE_SPIN_COUNT   = 64;   // failed searches before an idle worker goes to sleep
+
+using JobFunction = std::function<void()>;
+
+class JobCounter;
+
+/**
+ * @brief unit of work, owned by the job system from submit until it ran
+ */
+struct Job
+{
+  JobFunction function;
+  JobCounter* counter{nullptr}; // finished when the job ran, may be null
+};
+
+/**
+ * @brief Number of unfinished jobs of a group
+ * jobs submitted with a counter increment it and decrement it once they ran. the counter can be waited on, or
+ * used as the dependency of jobs that should only start once the whole group finished.
+ * the counter must outlive every job that references it, waiting on it before it goes out of scope is enough.
+ */
+class FOUR_ENGINE_API JobCounter
+{
+public:
+  JobCounter()                             = default;
+  ~JobCounter()                            = default;
+  JobCounter(const JobCounter&)            = delete;
+  JobCounter(JobCounter&&)                 = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+  JobCounter& operator=(JobCounter&&)      = delete;
+
+  /**
+   * @brief true when every job of the group ran, any thread
+   */
+  [[nodiscard]] bool IsDone() const;
+
+  [[nodiscard]] u32 GetPending() const
+  {
+    return m_Pending.load(std::memory_order_acquire);
+  }
+
+private:
+  friend class JobSystem;
+
+  void Add()
+  {
+    m_Pending.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief one job of the group ran
+   *
+   * @return jobs that depended on the group when it just finished
+   */
+  [[nodiscard]] std::vector<Job*> Finish();
+
+private:
+  std::atomic<u32>   m_Pending{0};
+  mutable std::mutex m_Mutex;         // last decrement and continuations, keeps IsDone true only once Finish left
+  std::vector<Job*>  m_Continuations; // jobs submitted with this counter as dependency
+};
+
+struct JobSystemStats
+{
+  u64 executed{0}; // jobs ran by worker and main threads
+  u64 stolen{0};   // jobs taken from the queue of another thread
+};
+
+/**
+ * @brief Work-stealing job scheduler
+ * the thread creating the system is its main thread and worker 0, every other worker gets its own thread. each
+ * worker owns a Chase-Lev deque, jobs it submits go to its own deque and it runs them newest first, idle workers
+ * steal the oldest jobs of the others. threads that are not workers ( render thread, loaders ) submit through a
+ * shared locked queue.
+ * jobs are plain functions without fibers, a job that waits on a counter runs other jobs until the counter finished.
+ * jobs submitted with SubmitMainThread only run on the main thread, for calls like glfw that are not thread safe.
+ */
+class FOUR_ENGINE_API JobSystem
+{
+public:
+  static constexpr u32 NoWorker = std::numeric_limits<u32>::max();
+
+  /**
+   * @param threadCount threads that run jobs, main thread included
+   */
+  explicit JobSystem(u32 threadCount = DefaultThreadCount());
+  ~JobSystem();
+
+  JobSystem(const JobSystem&)            = delete;
+  JobSystem(JobSystem&&)                 = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+  JobSystem& operator=(JobSystem&&)      = delete;
+
+  /**
+   * @brief one thread per hardware thread, less one the render thread keeps for itself
+   */
+  [[nodiscard]] static u32 DefaultThreadCount();
+
+  /**
+   * @brief queue job to run on any thread, any thread
+   *
+   * @param counter incremented now and decremented once the job ran, may be null
+   */
+  void Submit(JobFunction function, JobCounter* counter = nullptr);
+
+  /**
+   * @brief queue job once every job of dependency ran, any thread
+   * dependency must outlive the job, it is submitted right away when dependency already finished
+   */
+  void SubmitAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+  /**
+   * @brief queue job that only runs on the main thread, in RunMainThreadJobs or while the main thread waits
+   */
+  void SubmitMainThread(JobFunction function, JobCounter* counter = nullptr);
+
+  /**
+   * @brief run main thread jobs queued so far, main thread only
+   *
+   * @return number of jobs ran
+   */
+  u32 RunMainThreadJobs();
+
+  /**
+   * @brief block until every job of counter ran, calling thread runs queued jobs meanwhile, any thread
+   */
+  void Wait(const JobCounter& counter);
+
+  /**
+   * @brief call function over [begin, end) split in chunks run in parallel, returns when all chunks ran
+   * calling thread runs a chunk itself, so it is safe to call from inside a job
+   *
+   * @param grainSize smallest chunk, ranges not worth a job should not be split further
+   * @param function called with [chunkBegin, chunkEnd) of each chunk
+   */
+  void ParallelFor(u32 begin, u32 end, u32 grainSize, const std::function<void(u32, u32)>& function);
+
+  [[nodiscard]] u32 GetThreadCount() const
+  {
+    return static_cast<u32>(m_Workers.size());
+  }
+
+  [[nodiscard]] bool IsMainThread() const
+  {
+    return std::this_thread::get_id() == m_MainThreadId;
+  }
+
+  /**
+   * @brief worker index of the calling thread, 0 is the main thread, NoWorker when it does not belong to this system
+   */
+  [[nodiscard]] u32 GetWorkerIndex() const;
+
+  [[nodiscard]] JobSystemStats GetStats() const;
+
+private:
+  struct Worker
+  {
+    WorkStealingQueue<Job*> queue{JOB_QUEUE_CAPACITY};
+    std::atomic<u64>        executed{0};
+    std::atomic<u64>        stolen{0};
+    std::jthread            thread; // empty for the main thread
+  };
+
+  void WorkerLoop(u32 index, const std::stop_token& stopToken);
+
+  void Enqueue(Job* job);
+  void Execute(Job* job, u32 workerIndex);
+
+  /**
+   * @brief own queue, then the shared queue, then the queues of other workers
+   */
+  [[nodiscard]] Job* FindJob(u32 workerIndex);
+  [[nodiscard]] Job* PopMainThreadJob();
+
+private:
+  std::thread::id                      m_MainThreadId;
+  std::vector<std::unique_ptr<Worker>> m_Workers; // [0] main thread
+
+  std::mutex       m_SharedMutex;
+  std::deque<Job*> m_SharedJobs; // submitted by threads that are not workers
+  std::atomic<u32> m_SharedCount{0};
+
+  std::mutex       m_MainThreadMutex;
+  std::deque<Job*> m_MainThreadJobs;
+
+  std::atomic<u32> m_WorkSignal{0}; // bumped on every submit, idle workers wait for it to change
+};
+
+} // namespace four
@@ -0,0 +1,321 @@
+#include "four-pch.hpp"
+
+#include "core/profiler.hpp"
+
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace four
+{
+
+namespace
+{
+ProfileStat ComputeStat(std::vector<f32> values)
+{
+  if (values.empty())
+  {
+    return {};
+  }
+
+  // nearest rank percentile
+  std::ranges::sort(values);
+  const auto percentile = [&values](f32 p)
+  {
+    const auto rank = static_cast<size_t>(std::ceil(p * static_cast<f32>(values.size())));
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+  };
+
+  f32 sum = 0.0F;
+  for (const f32 value : values)
+  {
+    sum += value;
+  }
+  return {.average = sum / static_cast<f32>(values.size()),
+          .p50     = percentile(0.50F),
+          .p95     = percentile(0.95F),
+          .p99     = percentile(0.99F),
+          .max     = values.back()};
+}
+
+// chrome trace wants microseconds
+double ToTraceUs(ProfileTime time)
+{
+  return static_cast<double>(time) / 1000.0;
+}
+
+// names are user strings, quotes, backslashes and control characters would end or break the json string
+std::string EscapeJson(std::string_view text)
+{
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const char c : text)
+  {
+    switch (c)
+    {
+      case '"':
+        escaped += R"(\")";
+        break;
+      case '\\':
+        escaped += R"(\\)";
+        break;
+      case '\n':
+        escaped += R"(\n)";
+        break;
+      case '\r':
+        escaped += R"(\r)";
+        break;
+      case '\t':
+        escaped += R"(\t)";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+        }
+        else
+        {
+          escaped += c;
+        }
+        break;
+    }
+  }
+  return escaped;
+}
+} // namespace
+
+//===============================================================================
+template <typename T>
+void Profiler::Ring<T>::Push(const T& value)
+{
+  const u64 index = written.load(std::memory_order_relaxed);
+  Slot&     slot  = slots[index % slots.size()];
+
+  const u64 sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.value = value;
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+
+  written.store(index + 1, std::memory_order_release);
+}
+
+//===============================================================================
+template <typename T>
+std::vector<T> Profiler::Ring<T>::Snapshot() const
+{
+  const u64 end   = written.load(std::memory_order_acquire);
+  const u64 count = std::min<u64>(end, slots.size());
+
+  std::vector<T> values;
+  values.reserve(count);
+  for (u64 i = end - count; i < end; ++i)
+  {
+    const Slot& slot = slots[i % slots.size()];
+
+    // a slot the writer laps while it is copied is dropped, the frame is gone from the history anyway
+    const u64 before = slot.sequence.load(std::memory_order_acquire);
+    T         value  = slot.value;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (const u64 after = slot.sequence.load(std::memory_order_relaxed); before == after && before % 2 == 0)
+    {
+      values.push_back(value);
+    }
+  }
+  return values;
+}
+
+//===============================================================================
+Profiler::Profiler() = default;
+
+//===============================================================================
+Profiler& Profiler::Get()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+//===============================================================================
+ProfileTime Profiler::Now()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return static_cast<ProfileTime>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+//===============================================================================
+void Profiler::PushFrame(const ProfileFrameRecord& record)
+{
+  m_Frames.Push(record);
+}
+
+//===============================================================================
+void Profiler::PushGpuFrame(const ProfileGpuFrame& gpuFrame)
+{
+  m_GpuFrames.Push(gpuFrame);
+}
+
+//===============================================================================
+void Profiler::PushZone(std::string_view name, ProfileTime start, ProfileTime end)
+{
+  ZoneBuffer& buffer = GetThreadBuffer();
+  const u64   index  = buffer.written.load(std::memory_order_relaxed);
+
+  buffer.zones[index % buffer.zones.size()] = {.name = name, .start = start, .end = end};
+  buffer.written.store(index + 1, std::memory_order_release);
+}
+
+//===============================================================================
+Profiler::ZoneBuffer& Profiler::GetThreadBuffer()
+{
+  thread_local ZoneBuffer* buffer = nullptr;
+  if (buffer == nullptr)
+  {
+    const std::scoped_lock lock(m_ThreadMutex);
+    auto& created     = m_ZoneBuffers.emplace_back(std::make_unique<ZoneBuffer>());
+    created->threadId = static_cast<u32>(m_ZoneBuffers.size());
+    buffer            = created.get();
+  }
+  return *buffer;
+}
+
+//===============================================================================
+std::vector<ProfileFrameRecord> Profiler::GetFrames() const
+{
+  return m_Frames.Snapshot();
+}
+
+//===============================================================================
+std::vector<ProfileGpuFrame> Profiler::GetGpuFrames() const
+{
+  return m_GpuFrames.Snapshot();
+}
+
+//===============================================================================
+ProfileStats Profiler::GetStats() const
+{
+  const auto frames    = GetFrames();
+  const auto gpuFrames = GetGpuFrames();
+
+  std::vector<f32> frameMs;
+  std::vector<f32> updateMs;
+  std::vector<f32> renderMs;
+  std::vector<f32> gpuMs;
+  for (const auto& frame : frames)
+  {
+    frameMs.push_back(frame.frameMs);
+    updateMs.push_back(frame.updateMs);
+    renderMs.push_back(frame.renderMs);
+  }
+  for (const auto& gpuFrame : gpuFrames)
+  {
+    gpuMs.push_back(gpuFrame.gpuMs);
+  }
+
+  ProfileStats stats{.frameCount    = static_cast<u32>(frames.size()),
+                     .gpuFrameCount = static_cast<u32>(gpuFrames.size()),
+                     .fps           = 0.0F,
+                     .frame         = ComputeStat(std::move(frameMs)),
+                     .update        = ComputeStat(std::move(updateMs)),
+                     .render        = ComputeStat(std::move(renderMs)),
+                     .gpu           = ComputeStat(std::move(gpuMs))};
+  if (stats.frame.average > 0.0F)
+  {
+    stats.fps = 1000.0F / stats.frame.average;
+  }
+  return stats;
+}
+
+//===============================================================================
+bool Profiler::ExportChromeTrace(const std::filesystem::path& path) const
+{
+  std::error_code errorCode;
+  if (path.has_parent_path())
+  {
+    std::filesystem::create_directories(path.parent_path(), errorCode);
+  }
+
+  std::ofstream file(path, std::ios::trunc);
+  if (!file)
+  {
+    LOG_CORE_ERROR("failed to open profiler trace file {}", path.string());
+    return false;
+  }
+
+  file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  bool first = true;
+  auto event = [&file, &first](std::string_view name, u32 pid, u32 tid, double startUs, double durationUs)
+  {
+    file << (first ? "" : ",") << '\n'
+         << std::format(R"({{"name":"{}","ph":"X","pid":{},"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                        EscapeJson(name),
+                        pid,
+                        tid,
+                        startUs,
+                        durationUs);
+    first = false;
+  };
+  auto metadata = [&file, &first](std::string_view kind, u32 pid, u32 tid, std::string_view name)
+  {
+    file << (first ? "" : ",") << '\n'
+         << std::format(R"({{"name":"{}","ph":"M","pid":{},"tid":{},"args":{{"name":"{}"}}}})",
+                        kind,
+                        pid,
+                        tid,
+                        EscapeJson(name));
+    first = false;
+  };
+
+  constexpr u32 cpuProcess = 0;
+  constexpr u32 gpuProcess = 1;
+  metadata("process_name", cpuProcess, 0, "CPU");
+  metadata("process_name", gpuProcess, 0, "GPU");
+
+  {
+    const std::scoped_lock lock(m_ThreadMutex);
+    for (const auto& buffer : m_ZoneBuffers)
+    {
+      metadata("thread_name", cpuProcess, buffer->threadId, std::format("thread {}", buffer->threadId));
+
+      // keep clear of the slots the owning thread may be overwriting right now
+      constexpr u64 writerMargin = PROFILER_ZONE_HISTORY / 8;
+      const u64     end          = buffer->written.load(std::memory_order_acquire);
+      const u64     count        = std::min<u64>(end, PROFILER_ZONE_HISTORY - writerMargin);
+      for (u64 i = end - count; i < end; ++i)
+      {
+        const Zone& zone = buffer->zones[i % buffer->zones.size()];
+        event(zone.name, cpuProcess, buffer->threadId, ToTraceUs(zone.start), ToTraceUs(zone.end - zone.start));
+      }
+    }
+  }
+
+  // gpu clock is not calibrated against the cpu one, passes start at the cpu start of their frame
+  std::unordered_map<u64, ProfileTime> frameStarts;
+  for (const auto& frame : GetFrames())
+  {
+    frameStarts.emplace(frame.frameNumber, frame.start);
+  }
+  metadata("thread_name", gpuProcess, 0, "graphics queue");
+  for (const auto& gpuFrame : GetGpuFrames())
+  {
+    const auto it = frameStarts.find(gpuFrame.frameNumber);
+    if (it == frameStarts.end())
+    {
+      continue;
+    }
+    for (u32 pass = 0; pass < gpuFrame.passCount; ++pass)
+    {
+      event(gpuFrame.names[pass],
+            gpuProcess,
+            0,
+            ToTraceUs(it->second) + static_cast<double>(gpuFrame.startMs[pass]) * 1000.0,
+            static_cast<double>(gpuFrame.durationMs[pass]) * 1000.0);
+    }
+  }
+
+  file << "\n]}\n";
+  LOG_CORE_INFO("profiler trace written to {}", path.string());
+  return static_cast<bool>(file);
+}
+
+} // namespace four
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+
+namespace four
+{
+
+constexpr u32 PROFILER_FRAME_HISTORY  = 512;       // frame records kept for stats
+constexpr u32 PROFILER_ZONE_HISTORY   = 16 * 1024; // zones kept per thread for trace export
+constexpr u32 PROFILER_MAX_GPU_PASSES = 16;        // gpu passes recorded per frame
+
+/** time in nanoseconds since profiler start */
+using ProfileTime = u64;
+
+/**
+ * @brief cpu timings of one frame
+ */
+struct ProfileFrameRecord
+{
+  u64         frameNumber{0};
+  ProfileTime start{0};
+  f32         frameMs{0.0F};  // whole frame, frame pacer wait included
+  f32         updateMs{0.0F}; // application update
+  f32         renderMs{0.0F}; // publishing the frame packet, render thread work shows up as its zones
+};
+
+/**
+ * @brief gpu passes of one frame, read back once the fence of that frame signaled
+ */
+struct ProfileGpuFrame
+{
+  u64                                                   frameNumber{0};
+  u32                                                   passCount{0};
+  f32                                                   gpuMs{0.0F}; // first to last timestamp of the frame
+  std::array<std::string_view, PROFILER_MAX_GPU_PASSES> names{};     // string literals
+  std::array<f32, PROFILER_MAX_GPU_PASSES>              startMs{};   // relative to first timestamp of the frame
+  std::array<f32, PROFILER_MAX_GPU_PASSES>              durationMs{};
+};
+
+/**
+ * @brief percentiles of one value over the frame history
+ */
+struct ProfileStat
+{
+  f32 average{0.0F};
+  f32 p50{0.0F};
+  f32 p95{0.0F};
+  f32 p99{0.0F};
+  f32 max{0.0F};
+};
+
+struct ProfileStats
+{
+  u32         frameCount{0};
+  u32         gpuFrameCount{0};
+  f32         fps{0.0F};
+  ProfileStat frame;
+  ProfileStat update;
+  ProfileStat render;
+  ProfileStat gpu;
+};
+
+/**
+ * @brief Frame timing and CPU zone profiler
+ * the main thread publishes one record per frame into a lock-free ring, the render thread publishes gpu timings into
+ * another one, readers on any thread take a consistent snapshot for percentile stats without stalling the frame.
+ * scoped zones are written to a lock-free ring owned by the recording thread, only registering a thread takes a lock.
+ * zones and gpu passes of the kept history can be exported as chrome trace json ( chrome://tracing, perfetto ).
+ */
+class FOUR_ENGINE_API Profiler
+{
+public:
+  Profiler(const Profiler&)            = delete;
+  Profiler(Profiler&&)                 = delete;
+  Profiler& operator=(const Profiler&) = delete;
+  Profiler& operator=(Profiler&&)      = delete;
+
+  static Profiler& Get();
+
+  [[nodiscard]] static ProfileTime Now();
+
+  /**
+   * @brief publish a finished frame record, single writer: main thread
+   */
+  void PushFrame(const ProfileFrameRecord& record);
+
+  /**
+   * @brief publish gpu timings read back for an earlier frame, single writer: render thread
+   * gpu and cpu clocks are not calibrated, the trace places the passes at the cpu start of their frame
+   */
+  void PushGpuFrame(const ProfileGpuFrame& gpuFrame);
+
+  /**
+   * @brief record a cpu zone of the calling thread, use FOUR_PROFILE_SCOPE instead
+   *
+   * @param name zone name, string literal
+   */
+  void PushZone(std::string_view name, ProfileTime start, ProfileTime end);
+
+  /**
+   * @brief copy of at most PROFILER_FRAME_HISTORY latest frames, oldest first, any thread
+   */
+  [[nodiscard]] std::vector<ProfileFrameRecord> GetFrames() const;
+  [[nodiscard]] std::vector<ProfileGpuFrame>    GetGpuFrames() const;
+
+  /**
+   * @brief percentile stats over the kept frame history, any thread
+   */
+  [[nodiscard]] ProfileStats GetStats() const;
+
+  /**
+   * @brief write kept zones and gpu passes as chrome trace json
+   * zones recorded while exporting may be missing
+   *
+   * @return true if file was written
+   */
+  bool ExportChromeTrace(const std::filesystem::path& path) const;
+
+private:
+  Profiler();
+
+  struct Zone
+  {
+    std::string_view name;
+    ProfileTime      start{0};
+    ProfileTime      end{0};
+  };
+
+  // single writer ring guarded by a sequence lock per slot, readers retry or skip a slot the writer is in
+  template <typename T>
+  struct Ring
+  {
+    struct Slot
+    {
+      std::atomic<u64> sequence{0}; // odd while written
+      T                value;
+    };
+
+    std::array<Slot, PROFILER_FRAME_HISTORY> slots;
+    std::atomic<u64>                         written{0};
+
+    void           Push(const T& value);
+    std::vector<T> Snapshot() const;
+  };
+
+  // zones of one thread, only that thread writes
+  struct ZoneBuffer
+  {
+    u32                                     threadId{0};
+    std::atomic<u64>                        written{0};
+    std::array<Zone, PROFILER_ZONE_HISTORY> zones;
+  };
+
+  ZoneBuffer& GetThreadBuffer();
+
+private:
+  Ring<ProfileFrameRecord> m_Frames;
+  Ring<ProfileGpuFrame>    m_GpuFrames;
+
+  mutable std::mutex                       m_ThreadMutex;
+  std::vector<std::unique_ptr<ZoneBuffer>> m_ZoneBuffers;
+};
+
+/**
+ * @brief measure lifetime of the scope as a cpu zone
+ */
+class FOUR_ENGINE_API ProfileScope
+{
+public:
+  explicit ProfileScope(std::string_view name) : m_Name{name}, m_Start{Profiler::Now()}
+  {
+  }
+
+  ~ProfileScope()
+  {
+    Profiler::Get().PushZone(m_Name, m_Start, Profiler::Now());
+  }
+
+  ProfileScope(const ProfileScope&)            = delete;
+  ProfileScope(ProfileScope&&)                 = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+  ProfileScope& operator=(ProfileScope&&)      = delete;
+
+private:
+  std::string_view m_Name;
+  ProfileTime      m_Start;
+};
+
+} // namespace four
+
+// ======================================================================
+// Profile macros
+// ======================================================================
+#ifdef FOUR_DISABLE_PROFILER
+
+#define FOUR_PROFILE_SCOPE(name)
+#define FOUR_PROFILE_FUNCTION()
+
+#else // NOT FOUR_DISABLE_PROFILER
+
+#define FOUR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FOUR_PROFILE_CONCAT(a, b)      FOUR_PROFILE_CONCAT_IMPL(a, b)
+#define FOUR_PROFILE_SCOPE(name)       const four::ProfileScope FOUR_PROFILE_CONCAT(profileScope, __LINE__){name}
+#define FOUR_PROFILE_FUNCTION()        FOUR_PROFILE_SCOPE(__func__)
+
+#endif // NOT FOUR_DISABLE_PROFILER
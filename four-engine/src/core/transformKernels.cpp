@@ -0,0 +1,301 @@
+#include "four-pch.hpp"
+
+#include "core/transformKernels.hpp"
+#include "core/transformKernelsDetail.hpp"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FOUR_SIMD_X86
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace four
+{
+
+static_assert(sizeof(CTransform) == 4 * sizeof(f32) && std::is_standard_layout_v<CTransform>,
+              "the kernels read CTransform as [position.x, position.y, velocity.x, velocity.y]");
+
+namespace
+{
+//===============================================================================
+// scalar, the reference every other level matches
+//===============================================================================
+void SinCosScalar(f32 angle, f32& sine, f32& cosine)
+{
+  using namespace detail;
+
+  const f32 quadrant = std::nearbyint(angle * SINCOS_TWO_OVER_PI);
+  const i32 index    = static_cast<i32>(quadrant);
+  f32       r        = angle - quadrant * SINCOS_PI_2_HIGH;
+  r                  = r - quadrant * SINCOS_PI_2_MID;
+  r                  = r - quadrant * SINCOS_PI_2_LOW;
+
+  const f32 r2  = r * r;
+  const f32 sin = r + r * r2 * (SINCOS_S0 + r2 * (SINCOS_S1 + r2 * SINCOS_S2));
+  const f32 cos = 1.0F - 0.5F * r2 + r2 * r2 * (SINCOS_C0 + r2 * (SINCOS_C1 + r2 * SINCOS_C2));
+
+  // sin(r + j pi/2) cycles through sin, cos, -sin, -cos
+  const bool swap = (index & 1) != 0;
+  sine            = (index & 2) != 0 ? -(swap ? cos : sin) : (swap ? cos : sin);
+  cosine          = ((index + 1) & 2) != 0 ? -(swap ? sin : cos) : (swap ? sin : cos);
+}
+
+void SinCosScalar(const f32* angles, f32* sines, f32* cosines, u32 count)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    SinCosScalar(angles[i], sines[i], cosines[i]);
+  }
+}
+
+void IntegrateTransformsScalar(CTransform* transforms, u32 count, f32 deltaTime)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    transforms[i].position += transforms[i].velocity * deltaTime;
+  }
+}
+
+void UpdateTransformsScalar(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime, u32 first)
+{
+  for (u32 i = first; i < batch.count; ++i)
+  {
+    const f32 x = batch.positionX[i] + batch.velocityX[i] * deltaTime;
+    const f32 y = batch.positionY[i] + batch.velocityY[i] * deltaTime;
+    f32       sin{};
+    f32       cos{};
+    SinCosScalar(batch.rotation[i], sin, cos);
+
+    batch.positionX[i] = x;
+    batch.positionY[i] = y;
+    matrices.c0x[i]    = cos * batch.scaleX[i];
+    matrices.c0y[i]    = sin * batch.scaleX[i];
+    matrices.c1x[i]    = -sin * batch.scaleY[i];
+    matrices.c1y[i]    = cos * batch.scaleY[i];
+    matrices.tx[i]     = x;
+    matrices.ty[i]     = y;
+  }
+}
+
+#if defined(FOUR_SIMD_X86)
+//===============================================================================
+// SSE2, part of every x86-64 cpu
+//===============================================================================
+void SinCosSse2(__m128 angle, __m128& sine, __m128& cosine)
+{
+  using namespace detail;
+
+  // cvtps rounds to nearest even like nearbyint in the scalar path
+  const __m128i index    = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(SINCOS_TWO_OVER_PI)));
+  const __m128  quadrant = _mm_cvtepi32_ps(index);
+  __m128        r        = _mm_sub_ps(angle, _mm_mul_ps(quadrant, _mm_set1_ps(SINCOS_PI_2_HIGH)));
+  r                      = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(SINCOS_PI_2_MID)));
+  r                      = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(SINCOS_PI_2_LOW)));
+
+  const __m128 r2 = _mm_mul_ps(r, r);
+  __m128       sin = _mm_add_ps(_mm_set1_ps(SINCOS_S1), _mm_mul_ps(r2, _mm_set1_ps(SINCOS_S2)));
+  sin              = _mm_add_ps(_mm_set1_ps(SINCOS_S0), _mm_mul_ps(r2, sin));
+  sin              = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sin));
+  __m128 cos       = _mm_add_ps(_mm_set1_ps(SINCOS_C1), _mm_mul_ps(r2, _mm_set1_ps(SINCOS_C2)));
+  cos              = _mm_add_ps(_mm_set1_ps(SINCOS_C0), _mm_mul_ps(r2, cos));
+  cos              = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0F), _mm_mul_ps(_mm_set1_ps(0.5F), r2)),
+                   _mm_mul_ps(_mm_mul_ps(r2, r2), cos));
+
+  // odd quadrants swap sin and cos, bit 1 of the quadrant moves into the sign bit
+  const __m128i one     = _mm_set1_epi32(1);
+  const __m128i two     = _mm_set1_epi32(2);
+  const __m128  swap    = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(index, one), one));
+  const __m128  sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(index, two), 30));
+  const __m128  cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(index, one), two), 30));
+  sine   = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cos), _mm_andnot_ps(swap, sin)), sinSign);
+  cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sin), _mm_andnot_ps(swap, cos)), cosSign);
+}
+
+u32 SinCosSse2(const f32* angles, f32* sines, f32* cosines, u32 count)
+{
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 sin{};
+    __m128 cos{};
+    SinCosSse2(_mm_loadu_ps(angles + i), sin, cos);
+    _mm_storeu_ps(sines + i, sin);
+    _mm_storeu_ps(cosines + i, cos);
+  }
+  return i;
+}
+
+u32 IntegrateTransformsSse2(CTransform* transforms, u32 count, f32 deltaTime)
+{
+  // one transform per register, [vx, vy, vx, vy] * [dt, dt, 0, 0] leaves the velocity untouched
+  const __m128 step = _mm_setr_ps(deltaTime, deltaTime, 0.0F, 0.0F);
+  auto*        data = reinterpret_cast<f32*>(transforms);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const __m128 transform = _mm_loadu_ps(data + static_cast<size_t>(i) * 4);
+    const __m128 velocity  = _mm_movehl_ps(transform, transform);
+    _mm_storeu_ps(data + static_cast<size_t>(i) * 4, _mm_add_ps(transform, _mm_mul_ps(velocity, step)));
+  }
+  return count;
+}
+
+u32 UpdateTransformsSse2(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime, u32 first)
+{
+  const __m128 step = _mm_set1_ps(deltaTime);
+  u32          i    = first;
+  for (; i + 4 <= batch.count; i += 4)
+  {
+    const __m128 x = _mm_add_ps(_mm_loadu_ps(batch.positionX + i), _mm_mul_ps(_mm_loadu_ps(batch.velocityX + i), step));
+    const __m128 y = _mm_add_ps(_mm_loadu_ps(batch.positionY + i), _mm_mul_ps(_mm_loadu_ps(batch.velocityY + i), step));
+    __m128       sin{};
+    __m128       cos{};
+    SinCosSse2(_mm_loadu_ps(batch.rotation + i), sin, cos);
+    const __m128 scaleX = _mm_loadu_ps(batch.scaleX + i);
+    const __m128 scaleY = _mm_loadu_ps(batch.scaleY + i);
+
+    _mm_storeu_ps(batch.positionX + i, x);
+    _mm_storeu_ps(batch.positionY + i, y);
+    _mm_storeu_ps(matrices.c0x + i, _mm_mul_ps(cos, scaleX));
+    _mm_storeu_ps(matrices.c0y + i, _mm_mul_ps(sin, scaleX));
+    _mm_storeu_ps(matrices.c1x + i, _mm_mul_ps(_mm_xor_ps(sin, _mm_set1_ps(-0.0F)), scaleY));
+    _mm_storeu_ps(matrices.c1y + i, _mm_mul_ps(cos, scaleY));
+    _mm_storeu_ps(matrices.tx + i, x);
+    _mm_storeu_ps(matrices.ty + i, y);
+  }
+  return i;
+}
+
+//===============================================================================
+bool CpuHasAvx2()
+{
+#if defined(_MSC_VER)
+  std::array<int, 4> info{};
+  __cpuid(info.data(), 1);
+  const bool fma     = (info[2] & (1 << 12)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  // the os has to save the ymm registers on context switches
+  if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6)
+  {
+    return false;
+  }
+  __cpuidex(info.data(), 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  // also checks that the os saves the ymm registers
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif // FOUR_SIMD_X86
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(FOUR_SIMD_X86) && defined(FOUR_ENABLE_AVX2)
+  return CpuHasAvx2() ? SimdLevel::Avx2 : SimdLevel::Sse2;
+#elif defined(FOUR_SIMD_X86)
+  return SimdLevel::Sse2;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<SimdLevel>& CurrentSimdLevel()
+{
+  static std::atomic<SimdLevel> level{GetSupportedSimdLevel()};
+  return level;
+}
+} // namespace
+
+//===============================================================================
+SimdLevel GetSupportedSimdLevel()
+{
+  static const SimdLevel supported = DetectSimdLevel();
+  return supported;
+}
+
+//===============================================================================
+SimdLevel GetSimdLevel()
+{
+  return CurrentSimdLevel().load(std::memory_order_relaxed);
+}
+
+//===============================================================================
+SimdLevel SetSimdLevel(SimdLevel level)
+{
+  level = std::min(level, GetSupportedSimdLevel());
+  CurrentSimdLevel().store(level, std::memory_order_relaxed);
+  return level;
+}
+
+// each level handles what it can from the start, lower levels finish the tail
+//===============================================================================
+void SinCos(std::span<const f32> angles, std::span<f32> sines, std::span<f32> cosines)
+{
+  const u32 count = static_cast<u32>(std::min({angles.size(), sines.size(), cosines.size()}));
+  u32       done  = 0;
+  switch (GetSimdLevel())
+  {
+  case SimdLevel::Avx2:
+#if defined(FOUR_ENABLE_AVX2)
+    done = detail::SinCosAvx2(angles.data(), sines.data(), cosines.data(), count);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Sse2:
+#if defined(FOUR_SIMD_X86)
+    done += SinCosSse2(angles.data() + done, sines.data() + done, cosines.data() + done, count - done);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Scalar:
+    SinCosScalar(angles.data() + done, sines.data() + done, cosines.data() + done, count - done);
+  }
+}
+
+//===============================================================================
+void IntegrateTransforms(std::span<CTransform> transforms, f32 deltaTime)
+{
+  const u32 count = static_cast<u32>(transforms.size());
+  u32       done  = 0;
+  switch (GetSimdLevel())
+  {
+  case SimdLevel::Avx2:
+#if defined(FOUR_ENABLE_AVX2)
+    done = detail::IntegrateTransformsAvx2(transforms.data(), count, deltaTime);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Sse2:
+#if defined(FOUR_SIMD_X86)
+    done += IntegrateTransformsSse2(transforms.data() + done, count - done, deltaTime);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Scalar:
+    IntegrateTransformsScalar(transforms.data() + done, count - done, deltaTime);
+  }
+}
+
+//===============================================================================
+void UpdateTransforms(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime)
+{
+  u32 done = 0;
+  switch (GetSimdLevel())
+  {
+  case SimdLevel::Avx2:
+#if defined(FOUR_ENABLE_AVX2)
+    done = detail::UpdateTransformsAvx2(batch, matrices, deltaTime);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Sse2:
+#if defined(FOUR_SIMD_X86)
+    done = UpdateTransformsSse2(batch, matrices, deltaTime, done);
+#endif
+    [[fallthrough]];
+  case SimdLevel::Scalar:
+    UpdateTransformsScalar(batch, matrices, deltaTime, done);
+  }
+}
+
+} // namespace four
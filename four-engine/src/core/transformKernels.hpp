@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "component/transform.hpp"
+
+#include <span>
+
+namespace four
+{
+
+/**
+ * @brief instruction set used by the batch kernels
+ */
+enum class SimdLevel : u8
+{
+  Scalar,
+  Sse2,
+  Avx2, // AVX2 and FMA, only when built with FOUR_ENABLE_AVX2
+};
+
+/**
+ * @brief 2D transforms of a batch in SoA layout, every array holds count elements
+ */
+struct TransformBatch
+{
+  f32*       positionX{nullptr};
+  f32*       positionY{nullptr};
+  const f32* velocityX{nullptr};
+  const f32* velocityY{nullptr};
+  const f32* rotation{nullptr}; // radians
+  const f32* scaleX{nullptr};
+  const f32* scaleY{nullptr};
+  u32        count{0};
+};
+
+/**
+ * @brief world matrices of a batch in SoA layout, column major 2x2 rotation * scale plus translation
+ *
+ *   | c0x c1x tx |
+ *   | c0y c1y ty |
+ */
+struct WorldMatrixBatch
+{
+  f32* c0x{nullptr};
+  f32* c0y{nullptr};
+  f32* c1x{nullptr};
+  f32* c1y{nullptr};
+  f32* tx{nullptr};
+  f32* ty{nullptr};
+};
+
+/**
+ * @brief largest |angle| SinCos is accurate for, range reduction loses precision beyond it
+ */
+constexpr f32 SINCOS_MAX_ANGLE = 8192.0F;
+
+/**
+ * @brief largest absolute error of SinCos against the exact result for |angle| <= SINCOS_MAX_ANGLE, about 2^-23
+ * every level measures 9.3e-8, at 65536 range reduction error grows to 1e-6
+ */
+constexpr f32 SINCOS_MAX_ERROR = 1.2e-7F;
+
+/**
+ * @brief best level the cpu supports and the build enabled, detected once
+ */
+[[nodiscard]] FOUR_ENGINE_API SimdLevel GetSupportedSimdLevel();
+
+/**
+ * @brief level the kernels currently use, the supported level unless overridden
+ */
+[[nodiscard]] FOUR_ENGINE_API SimdLevel GetSimdLevel();
+
+/**
+ * @brief force a level for benchmarks and tests, clamped to the supported level
+ *
+ * @return level actually used
+ */
+FOUR_ENGINE_API SimdLevel SetSimdLevel(SimdLevel level);
+
+/**
+ * @brief sine and cosine of every angle, vectorized polynomial approximation
+ * accuracy bound: SINCOS_MAX_ERROR for |angle| <= SINCOS_MAX_ANGLE
+ */
+FOUR_ENGINE_API void SinCos(std::span<const f32> angles, std::span<f32> sines, std::span<f32> cosines);
+
+/**
+ * @brief position += velocity * deltaTime for transforms stored as components
+ */
+FOUR_ENGINE_API void IntegrateTransforms(std::span<CTransform> transforms, f32 deltaTime);
+
+/**
+ * @brief integrate positions and build the world matrix of every transform of the batch in one pass
+ * matrices use the integrated position
+ */
+FOUR_ENGINE_API void UpdateTransforms(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime);
+
+} // namespace four
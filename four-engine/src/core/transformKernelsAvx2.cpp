@@ -0,0 +1,109 @@
+#include "four-pch.hpp"
+
+#include "core/transformKernelsDetail.hpp"
+
+// built with AVX2 and FMA enabled, see FOUR_ENABLE_AVX2 in CMakeLists.txt, nothing here runs before the cpu check
+#if defined(FOUR_ENABLE_AVX2)
+
+#include <immintrin.h>
+
+namespace four::detail
+{
+
+namespace
+{
+void SinCos8(__m256 angle, __m256& sine, __m256& cosine)
+{
+  const __m256i index    = _mm256_cvtps_epi32(_mm256_mul_ps(angle, _mm256_set1_ps(SINCOS_TWO_OVER_PI)));
+  const __m256  quadrant = _mm256_cvtepi32_ps(index);
+  __m256        r        = _mm256_fnmadd_ps(quadrant, _mm256_set1_ps(SINCOS_PI_2_HIGH), angle);
+  r                      = _mm256_fnmadd_ps(quadrant, _mm256_set1_ps(SINCOS_PI_2_MID), r);
+  r                      = _mm256_fnmadd_ps(quadrant, _mm256_set1_ps(SINCOS_PI_2_LOW), r);
+
+  const __m256 r2  = _mm256_mul_ps(r, r);
+  __m256       sin = _mm256_fmadd_ps(r2, _mm256_set1_ps(SINCOS_S2), _mm256_set1_ps(SINCOS_S1));
+  sin              = _mm256_fmadd_ps(r2, sin, _mm256_set1_ps(SINCOS_S0));
+  sin              = _mm256_fmadd_ps(_mm256_mul_ps(r, r2), sin, r);
+  __m256 cos       = _mm256_fmadd_ps(r2, _mm256_set1_ps(SINCOS_C2), _mm256_set1_ps(SINCOS_C1));
+  cos              = _mm256_fmadd_ps(r2, cos, _mm256_set1_ps(SINCOS_C0));
+  cos = _mm256_fmadd_ps(_mm256_mul_ps(r2, r2), cos, _mm256_fnmadd_ps(_mm256_set1_ps(0.5F), r2, _mm256_set1_ps(1.0F)));
+
+  // odd quadrants swap sin and cos, bit 1 of the quadrant moves into the sign bit
+  const __m256i one     = _mm256_set1_epi32(1);
+  const __m256i two     = _mm256_set1_epi32(2);
+  const __m256  swap    = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(index, one), one));
+  const __m256  sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(index, two), 30));
+  const __m256  cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(index, one), two), 30));
+  sine   = _mm256_xor_ps(_mm256_blendv_ps(sin, cos, swap), sinSign);
+  cosine = _mm256_xor_ps(_mm256_blendv_ps(cos, sin, swap), cosSign);
+}
+} // namespace
+
+//===============================================================================
+u32 SinCosAvx2(const f32* angles, f32* sines, f32* cosines, u32 count)
+{
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 sin{};
+    __m256 cos{};
+    SinCos8(_mm256_loadu_ps(angles + i), sin, cos);
+    _mm256_storeu_ps(sines + i, sin);
+    _mm256_storeu_ps(cosines + i, cos);
+  }
+  return i;
+}
+
+//===============================================================================
+u32 IntegrateTransformsAvx2(CTransform* transforms, u32 count, f32 deltaTime)
+{
+  // two transforms per register, the permute copies each velocity over its position lanes
+  const __m256 step = _mm256_setr_ps(deltaTime, deltaTime, 0.0F, 0.0F, deltaTime, deltaTime, 0.0F, 0.0F);
+  auto*        data = reinterpret_cast<f32*>(transforms);
+  u32          i    = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    f32* const   block = data + static_cast<size_t>(i) * 4;
+    const __m256 a     = _mm256_loadu_ps(block);
+    const __m256 b     = _mm256_loadu_ps(block + 8);
+    const __m256 c     = _mm256_loadu_ps(block + 16);
+    const __m256 d     = _mm256_loadu_ps(block + 24);
+    _mm256_storeu_ps(block, _mm256_fmadd_ps(_mm256_permute_ps(a, 0xEE), step, a));
+    _mm256_storeu_ps(block + 8, _mm256_fmadd_ps(_mm256_permute_ps(b, 0xEE), step, b));
+    _mm256_storeu_ps(block + 16, _mm256_fmadd_ps(_mm256_permute_ps(c, 0xEE), step, c));
+    _mm256_storeu_ps(block + 24, _mm256_fmadd_ps(_mm256_permute_ps(d, 0xEE), step, d));
+  }
+  return i;
+}
+
+//===============================================================================
+u32 UpdateTransformsAvx2(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime)
+{
+  const __m256 step     = _mm256_set1_ps(deltaTime);
+  const __m256 signMask = _mm256_set1_ps(-0.0F);
+  u32          i        = 0;
+  for (; i + 8 <= batch.count; i += 8)
+  {
+    const __m256 x = _mm256_fmadd_ps(_mm256_loadu_ps(batch.velocityX + i), step, _mm256_loadu_ps(batch.positionX + i));
+    const __m256 y = _mm256_fmadd_ps(_mm256_loadu_ps(batch.velocityY + i), step, _mm256_loadu_ps(batch.positionY + i));
+    __m256       sin{};
+    __m256       cos{};
+    SinCos8(_mm256_loadu_ps(batch.rotation + i), sin, cos);
+    const __m256 scaleX = _mm256_loadu_ps(batch.scaleX + i);
+    const __m256 scaleY = _mm256_loadu_ps(batch.scaleY + i);
+
+    _mm256_storeu_ps(batch.positionX + i, x);
+    _mm256_storeu_ps(batch.positionY + i, y);
+    _mm256_storeu_ps(matrices.c0x + i, _mm256_mul_ps(cos, scaleX));
+    _mm256_storeu_ps(matrices.c0y + i, _mm256_mul_ps(sin, scaleX));
+    _mm256_storeu_ps(matrices.c1x + i, _mm256_mul_ps(_mm256_xor_ps(sin, signMask), scaleY));
+    _mm256_storeu_ps(matrices.c1y + i, _mm256_mul_ps(cos, scaleY));
+    _mm256_storeu_ps(matrices.tx + i, x);
+    _mm256_storeu_ps(matrices.ty + i, y);
+  }
+  return i;
+}
+
+} // namespace four::detail
+
+#endif // FOUR_ENABLE_AVX2
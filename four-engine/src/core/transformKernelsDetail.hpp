@@ -0,0 +1,35 @@
+#pragma once
+
+#include "core/transformKernels.hpp"
+
+// shared by the kernel translation units, not part of the engine interface
+namespace four::detail
+{
+
+// pi/2 split in three so j * pi/2 is exact in the first terms (Cody-Waite range reduction)
+constexpr f32 SINCOS_TWO_OVER_PI = 0.636619772367581343F;
+constexpr f32 SINCOS_PI_2_HIGH   = 1.5703125F;
+constexpr f32 SINCOS_PI_2_MID    = 4.837512969970703125e-4F;
+constexpr f32 SINCOS_PI_2_LOW    = 7.54978995489188216e-8F;
+
+// minimax polynomials on [-pi/4, pi/4]
+// sin(r) = r + r^3 * (S0 + r^2 * (S1 + r^2 * S2))
+// cos(r) = 1 - r^2 / 2 + r^4 * (C0 + r^2 * (C1 + r^2 * C2))
+constexpr f32 SINCOS_S0 = -1.6666654611e-1F;
+constexpr f32 SINCOS_S1 = 8.3321608736e-3F;
+constexpr f32 SINCOS_S2 = -1.9515295891e-4F;
+constexpr f32 SINCOS_C0 = 4.166664568298827e-2F;
+constexpr f32 SINCOS_C1 = -1.388731625493765e-3F;
+constexpr f32 SINCOS_C2 = 2.443315711809948e-5F;
+
+#if defined(FOUR_ENABLE_AVX2)
+/**
+ * @brief AVX2 and FMA kernels, built with those instructions enabled, only called when the cpu has them
+ * each one processes a multiple of 8 elements from the start and returns how many, the caller does the rest
+ */
+u32 SinCosAvx2(const f32* angles, f32* sines, f32* cosines, u32 count);
+u32 IntegrateTransformsAvx2(CTransform* transforms, u32 count, f32 deltaTime);
+u32 UpdateTransformsAvx2(const TransformBatch& batch, const WorldMatrixBatch& matrices, f32 deltaTime);
+#endif
+
+} // namespace four::detail
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include <atomic>
+
+namespace four
+{
+
+/**
+ * @brief Lock-free single producer, single consumer triple buffer
+ * producer fills the write buffer and publishes it, consumer takes the latest published buffer. both sides own
+ * one buffer and swap it with the shared middle one through a single atomic exchange, neither ever waits on the
+ * other. buffers published while the consumer was busy are overwritten, consumer always sees the newest one.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+  /**
+   * @brief buffer the producer fills, producer thread only
+   */
+  [[nodiscard]] T& GetWriteBuffer()
+  {
+    return m_Buffers[m_WriteIndex];
+  }
+
+  /**
+   * @brief hand write buffer to the consumer and take the shared one to write next, producer thread only
+   */
+  void Publish()
+  {
+    const u8 previous = m_Shared.exchange(m_WriteIndex | FreshBit, std::memory_order_acq_rel);
+    m_WriteIndex      = previous & IndexMask;
+  }
+
+  /**
+   * @brief true when a buffer was published since the last Consume, any thread
+   */
+  [[nodiscard]] bool HasFresh() const
+  {
+    return (m_Shared.load(std::memory_order_acquire) & FreshBit) != 0;
+  }
+
+  /**
+   * @brief take the latest published buffer, consumer thread only
+   *
+   * @return false when nothing was published since last call, read buffer is unchanged then
+   */
+  bool Consume()
+  {
+    if (!HasFresh())
+    {
+      return false;
+    }
+    const u8 previous = m_Shared.exchange(m_ReadIndex, std::memory_order_acq_rel);
+    m_ReadIndex       = previous & IndexMask;
+    return true;
+  }
+
+  /**
+   * @brief buffer taken by the last successful Consume, consumer thread only
+   */
+  [[nodiscard]] const T& GetReadBuffer() const
+  {
+    return m_Buffers[m_ReadIndex];
+  }
+
+private:
+  static constexpr u8 IndexMask = 0b011;
+  static constexpr u8 FreshBit  = 0b100;
+
+  std::array<T, 3> m_Buffers{};
+
+  // producer and consumer indices live on their own cache lines, only m_Shared is touched by both
+  alignas(64) std::atomic<u8> m_Shared{1};
+  alignas(64) u8 m_WriteIndex{0};
+  alignas(64) u8 m_ReadIndex{2};
+};
+
+} // namespace four
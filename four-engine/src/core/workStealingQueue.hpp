@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include <atomic>
+#include <bit>
+
+namespace four
+{
+
+/**
+ * @brief Bounded Chase-Lev work-stealing deque
+ * the owner thread pushes and pops at the bottom ( LIFO, cache warm ), any other thread steals from the top ( FIFO,
+ * oldest and usually largest work ). only the last element is contended, owner and thieves settle it with one CAS
+ * on top. memory orders follow Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (PPoPP 2013).
+ *
+ * @tparam T trivially copyable element, usually a pointer
+ */
+template <typename T>
+class WorkStealingQueue
+{
+public:
+  /**
+   * @param capacity rounded up to a power of two
+   */
+  explicit WorkStealingQueue(u32 capacity) :
+  m_Mask{std::bit_ceil(capacity) - 1},
+  m_Buffer{std::make_unique<std::atomic<T>[]>(m_Mask + 1)}
+  {
+  }
+
+  WorkStealingQueue(const WorkStealingQueue&)            = delete;
+  WorkStealingQueue(WorkStealingQueue&&)                 = delete;
+  WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+  WorkStealingQueue& operator=(WorkStealingQueue&&)      = delete;
+  ~WorkStealingQueue()                                   = default;
+
+  /**
+   * @brief add element at the bottom, owner thread only
+   *
+   * @return false when the queue is full
+   */
+  bool Push(T value)
+  {
+    const i64 bottom = m_Bottom.load(std::memory_order_relaxed);
+    const i64 top    = m_Top.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<i64>(m_Mask))
+    {
+      return false;
+    }
+
+    m_Buffer[bottom & m_Mask].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief take the newest element, owner thread only
+   *
+   * @return false when the queue is empty or a thief took the last element
+   */
+  bool Pop(T& value)
+  {
+    const i64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    i64 top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    value = m_Buffer[bottom & m_Mask].load(std::memory_order_relaxed);
+    if (top < bottom)
+    {
+      return true;
+    }
+
+    // last element, race thieves for it
+    const bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  /**
+   * @brief take the oldest element, any thread
+   *
+   * @return false when the queue is empty or another thread won the element, caller may try elsewhere
+   */
+  bool Steal(T& value)
+  {
+    i64 top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const i64 bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+      return false;
+    }
+
+    value = m_Buffer[top & m_Mask].load(std::memory_order_relaxed);
+    return m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief approximate element count, any thread
+   */
+  [[nodiscard]] u32 Size() const
+  {
+    const i64 bottom = m_Bottom.load(std::memory_order_relaxed);
+    const i64 top    = m_Top.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<u32>(bottom - top) : 0;
+  }
+
+  [[nodiscard]] u32 Capacity() const
+  {
+    return m_Mask + 1;
+  }
+
+private:
+  u32                               m_Mask;
+  std::unique_ptr<std::atomic<T>[]> m_Buffer;
+
+  // thieves hammer top, keep the owner's bottom off their cache line
+  alignas(64) std::atomic<i64> m_Top{0};
+  alignas(64) std::atomic<i64> m_Bottom{0};
+};
+
+} // namespace four
@@ -1,33 +1,35 @@
-pragma once
+#pragma once
 
-#include "component/component.hpp"
+#include "core/core.hpp"
 
-  namespace four
+namespace four
 {
-  class Entity
+
+/**
+ * @brief Generational entity handle
+ * index selects the slot of the entity in its scene, generation is bumped every time the slot is freed, so a
+ * handle kept after its entity was destroyed never refers to the entity that reuses the slot.
+ */
+struct Entity
+{
+  static constexpr u32 InvalidIndex = std::numeric_limits<u32>::max();
+
+  u32 index{InvalidIndex};
+  u32 generation{0};
+
+  [[nodiscard]] bool IsNull() const
   {
-  public:
-    Entity();
-    ~Entity();
-
-    template <typename T, typename... Args>
-    T& AddComponent(Args&&... args);
-    template <typename T>
-    void                         RemoveComponent(); // get<T>() = T();
-    tempate<typename T> T&       GetComponent();
-    tempate<typename T> const T& GetComponent() const;
-    template <typename T>
-    bool               HasComponent() const;
-    bool               IsAlive() const;
-    void               Destroy();
-    const std::string& GetName() const;
-    size_t             GetID() const;
-
-
-  private:
-    std::vector<Component*> m_Components{};
-    std::string             m_Name{"Default"};
-    size_t                  m_ID{0};
-    bool                    m_Alive{true};
-  };
+    return index == InvalidIndex;
+  }
+
+  [[nodiscard]] u64 GetId() const
+  {
+    return (static_cast<u64>(generation) << 32U) | index;
+  }
+
+  bool operator==(const Entity&) const = default;
+};
+
+constexpr Entity NullEntity{};
+
 } // namespace four
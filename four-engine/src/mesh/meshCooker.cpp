@@ -0,0 +1,626 @@
+#include "four-pch.hpp"
+
+#include "mesh/meshCooker.hpp"
+
+#include "mesh/meshOptimizer.hpp"
+
+#include "glm/gtc/packing.hpp"
+
+#include <charconv>
+#include <fstream>
+
+namespace four
+{
+
+namespace
+{
+constexpr u32 Unused = std::numeric_limits<u32>::max();
+
+constexpr f32 HALF_MAX = 65504.0F;
+
+// position, texture coordinate and normal index of a face corner
+using CornerKey = std::array<u32, 3>;
+
+struct CornerKeyHash
+{
+  std::size_t operator()(const CornerKey& key) const noexcept
+  {
+    const u64 hash = ((static_cast<u64>(key[0]) << 32) | key[1]) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(hash ^ (hash >> 29) ^ (static_cast<u64>(key[2]) * 0xC2B2AE3D27D4EB4FULL));
+  }
+};
+
+constexpr u64 AlignUp(u64 value, u64 alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// next whitespace separated token of line, line is advanced past it
+std::string_view NextToken(std::string_view& line)
+{
+  const auto begin = line.find_first_not_of(" \t\r");
+  if (begin == std::string_view::npos)
+  {
+    line = {};
+    return {};
+  }
+  const auto end   = line.find_first_of(" \t\r", begin);
+  const auto token = line.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+  line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+  return token;
+}
+
+bool ParseFloat(std::string_view token, f32& value)
+{
+  return std::from_chars(token.data(), token.data() + token.size(), value).ec == std::errc{};
+}
+
+// 1 based obj index, negative counts back from the last element, returns Unused when out of range
+u32 ParseIndex(std::string_view token, std::size_t count)
+{
+  i64 value = 0;
+  if (token.empty() || std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc{})
+  {
+    return Unused;
+  }
+  const i64 index = value < 0 ? static_cast<i64>(count) + value : value - 1;
+  return index >= 0 && index < static_cast<i64>(count) ? static_cast<u32>(index) : Unused;
+}
+
+// sphere around the box of the points, not minimal but cheap and stable
+template <typename GetPosition>
+glm::vec4 ComputeBoundingSphere(std::size_t count, GetPosition&& getPosition)
+{
+  if (count == 0)
+  {
+    return glm::vec4{0.0F};
+  }
+  glm::vec3 min{std::numeric_limits<f32>::max()};
+  glm::vec3 max{std::numeric_limits<f32>::lowest()};
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    min = glm::min(min, getPosition(i));
+    max = glm::max(max, getPosition(i));
+  }
+  const glm::vec3 center = (min + max) * 0.5F;
+  f32             radius = 0.0F;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    radius = std::max(radius, glm::length(getPosition(i) - center));
+  }
+  return glm::vec4{center, radius};
+}
+
+// cone around the triangle normals, cutoff 1 when they spread too far for the cone to ever cull
+glm::vec4 ComputeNormalCone(const MeshData& mesh, std::span<const u32> vertices, std::span<const u8> triangles)
+{
+  std::vector<glm::vec3> normals;
+  glm::vec3              sum{0.0F};
+  for (std::size_t i = 0; i + 2 < triangles.size(); i += 3)
+  {
+    const glm::vec3 a      = mesh.vertices[vertices[triangles[i]]].position;
+    const glm::vec3 b      = mesh.vertices[vertices[triangles[i + 1]]].position;
+    const glm::vec3 c      = mesh.vertices[vertices[triangles[i + 2]]].position;
+    const glm::vec3 normal = glm::cross(b - a, c - a);
+    const f32       length = glm::length(normal);
+    if (length > 0.0F)
+    {
+      normals.push_back(normal / length);
+      sum += normal / length;
+    }
+  }
+
+  const f32 sumLength = glm::length(sum);
+  if (sumLength == 0.0F)
+  {
+    return {0.0F, 0.0F, 1.0F, 1.0F};
+  }
+  const glm::vec3 axis   = sum / sumLength;
+  f32             minDot = 1.0F;
+  for (const glm::vec3& normal : normals)
+  {
+    minDot = std::min(minDot, glm::dot(axis, normal));
+  }
+
+  // wider than about 84 degrees the cone is visible from nearly everywhere
+  if (minDot <= 0.1F)
+  {
+    return glm::vec4{axis, 1.0F};
+  }
+  return glm::vec4{axis, std::sqrt(1.0F - minDot * minDot)};
+}
+
+// area weighted normals of the adjacent triangles for every vertex without a normal
+void GenerateNormals(MeshData& mesh)
+{
+  std::vector<glm::vec3> generated(mesh.vertices.size(), glm::vec3{0.0F});
+  for (const MeshSubmesh& submesh : mesh.submeshes)
+  {
+    for (u32 i = submesh.firstIndex; i + 2 < submesh.firstIndex + submesh.indexCount; i += 3)
+    {
+      const std::array<u32, 3> triangle{static_cast<u32>(static_cast<i64>(mesh.indices[i]) + submesh.vertexOffset),
+                                        static_cast<u32>(static_cast<i64>(mesh.indices[i + 1]) + submesh.vertexOffset),
+                                        static_cast<u32>(static_cast<i64>(mesh.indices[i + 2]) + submesh.vertexOffset)};
+      const glm::vec3 a      = mesh.vertices[triangle[0]].position;
+      const glm::vec3 b      = mesh.vertices[triangle[1]].position;
+      const glm::vec3 c      = mesh.vertices[triangle[2]].position;
+      const glm::vec3 normal = glm::cross(b - a, c - a); // length is twice the area
+      for (const u32 vertex : triangle)
+      {
+        generated[vertex] += normal;
+      }
+    }
+  }
+
+  mesh.normals.resize(mesh.vertices.size(), glm::vec3{0.0F});
+  for (std::size_t vertex = 0; vertex < mesh.vertices.size(); ++vertex)
+  {
+    glm::vec3& normal = mesh.normals[vertex];
+    normal            = glm::dot(normal, normal) > 0.0F ? normal : generated[vertex];
+    normal            = glm::dot(normal, normal) > 0.0F ? glm::normalize(normal) : glm::vec3{0.0F, 0.0F, 1.0F};
+  }
+}
+
+// false when the mesh does not fit the ranges of the quantized format
+bool QuantizeVertices(const MeshData& mesh, std::vector<QuantizedMeshVertex>& vertices)
+{
+  for (const MeshVertex& vertex : mesh.vertices)
+  {
+    const bool position = glm::all(glm::lessThanEqual(glm::abs(vertex.position), glm::vec3{HALF_MAX}));
+    const bool texCoord = glm::all(glm::greaterThanEqual(vertex.texCoord, glm::vec2{0.0F})) &&
+                          glm::all(glm::lessThanEqual(vertex.texCoord, glm::vec2{1.0F}));
+    if (!position || !texCoord)
+    {
+      return false;
+    }
+  }
+
+  vertices.resize(mesh.vertices.size());
+  for (std::size_t i = 0; i < mesh.vertices.size(); ++i)
+  {
+    const MeshVertex&    vertex = mesh.vertices[i];
+    const glm::vec2      normal = EncodeOctahedral(mesh.normals[i]);
+    QuantizedMeshVertex& result = vertices[i];
+    result.position             = {glm::packHalf1x16(vertex.position.x),
+                                   glm::packHalf1x16(vertex.position.y),
+                                   glm::packHalf1x16(vertex.position.z),
+                                   glm::packHalf1x16(1.0F)};
+    result.texCoord             = {glm::packUnorm1x16(vertex.texCoord.x), glm::packUnorm1x16(vertex.texCoord.y)};
+    result.color                = {glm::packUnorm1x8(vertex.color.x),
+                                   glm::packUnorm1x8(vertex.color.y),
+                                   glm::packUnorm1x8(vertex.color.z),
+                                   glm::packUnorm1x8(1.0F)};
+    result.normal               = {std::bit_cast<i16>(glm::packSnorm1x16(normal.x)),
+                                   std::bit_cast<i16>(glm::packSnorm1x16(normal.y))};
+  }
+  return true;
+}
+
+// lod 0 of every submesh is its own range, coarser ones are appended to the index stream
+std::vector<MeshLod> BuildLods(MeshData& mesh, u32 lodCount, bool optimize)
+{
+  const u32            levelCount = std::clamp(lodCount, 1U, MESH_MAX_LODS) - 1;
+  std::vector<MeshLod> lods;
+  for (MeshSubmesh& submesh : mesh.submeshes)
+  {
+    submesh.firstLod = static_cast<u32>(lods.size());
+    lods.push_back({.firstIndex = submesh.firstIndex, .indexCount = submesh.indexCount});
+
+    // simplified in the vertex stream, the submesh offset is taken out again afterwards
+    std::vector<u32> indices(mesh.indices.begin() + submesh.firstIndex,
+                             mesh.indices.begin() + submesh.firstIndex + submesh.indexCount);
+    for (u32& index : indices)
+    {
+      index = static_cast<u32>(static_cast<i64>(index) + submesh.vertexOffset);
+    }
+    for (MeshLodLevel& level : SimplifyMesh(indices, mesh.vertices, levelCount))
+    {
+      if (optimize)
+      {
+        OptimizeVertexCache(level.indices, static_cast<u32>(mesh.vertices.size()));
+      }
+      lods.push_back({.firstIndex = static_cast<u32>(mesh.indices.size()),
+                      .indexCount = static_cast<u32>(level.indices.size()),
+                      .error      = level.error});
+      for (const u32 index : level.indices)
+      {
+        mesh.indices.push_back(static_cast<u32>(static_cast<i64>(index) - submesh.vertexOffset));
+      }
+    }
+    submesh.lodCount = static_cast<u32>(lods.size()) - submesh.firstLod;
+  }
+  return lods;
+}
+
+template <typename T>
+MeshStream PlaceStream(u64& offset, const std::vector<T>& data)
+{
+  const MeshStream stream{.offset = offset, .size = data.size() * sizeof(T)};
+  offset = AlignUp(offset + stream.size, MESH_STREAM_ALIGNMENT);
+  return stream;
+}
+
+template <typename T>
+void WriteStream(std::ofstream& file, const MeshStream& stream, const std::vector<T>& data)
+{
+  // zero padding up to the aligned start of the stream
+  static constexpr std::array<char, MESH_STREAM_ALIGNMENT> padding{};
+  const auto                                               position = static_cast<u64>(file.tellp());
+  file.write(padding.data(), static_cast<std::streamsize>(stream.offset - position));
+  file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(stream.size));
+}
+} // namespace
+
+//===============================================================================
+bool ImportObj(const std::filesystem::path& path, MeshData& mesh)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+  {
+    LOG_CORE_ERROR("failed to open {}", path.string());
+    return false;
+  }
+  std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(text.data(), static_cast<std::streamsize>(text.size()));
+
+  std::vector<glm::vec3>                            positions;
+  std::vector<glm::vec3>                            colors;
+  std::vector<glm::vec2>                            texCoords;
+  std::vector<glm::vec3>                            normals;
+  std::unordered_map<CornerKey, u32, CornerKeyHash> vertexIds;
+  std::unordered_map<std::string_view, u32>         materials;
+  std::vector<u32>                                  polygon;
+  u32                                               material   = 0;
+  bool                                              hasNormals = false;
+
+  mesh = {};
+  const auto closeSubmesh = [&]
+  {
+    const u32 firstIndex =
+      mesh.submeshes.empty() ? 0 : mesh.submeshes.back().firstIndex + mesh.submeshes.back().indexCount;
+    const u32 indexCount = static_cast<u32>(mesh.indices.size()) - firstIndex;
+    if (indexCount > 0)
+    {
+      mesh.submeshes.push_back({.firstIndex = firstIndex, .indexCount = indexCount, .material = material});
+    }
+  };
+
+  u32              lineNumber = 0;
+  std::string_view rest{text};
+  while (!rest.empty())
+  {
+    const auto       end  = rest.find('\n');
+    std::string_view line = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    ++lineNumber;
+
+    const std::string_view keyword = NextToken(line);
+    if (keyword == "v")
+    {
+      glm::vec3 position{0.0F};
+      if (!ParseFloat(NextToken(line), position.x) || !ParseFloat(NextToken(line), position.y) ||
+          !ParseFloat(NextToken(line), position.z))
+      {
+        LOG_CORE_ERROR("{}:{}: invalid vertex position", path.string(), lineNumber);
+        return false;
+      }
+      // optional vertex color extension, all three or nothing
+      glm::vec3 color{1.0F};
+      f32       red   = 0.0F;
+      f32       green = 0.0F;
+      f32       blue  = 0.0F;
+      if (ParseFloat(NextToken(line), red) && ParseFloat(NextToken(line), green) && ParseFloat(NextToken(line), blue))
+      {
+        color = {red, green, blue};
+      }
+      positions.push_back(position);
+      colors.push_back(color);
+    }
+    else if (keyword == "vt")
+    {
+      glm::vec2 texCoord{0.0F};
+      if (!ParseFloat(NextToken(line), texCoord.x) || !ParseFloat(NextToken(line), texCoord.y))
+      {
+        LOG_CORE_ERROR("{}:{}: invalid texture coordinate", path.string(), lineNumber);
+        return false;
+      }
+      // obj puts v = 0 at the bottom of the image, vulkan samples row 0 at the top
+      texCoords.emplace_back(texCoord.x, 1.0F - texCoord.y);
+    }
+    else if (keyword == "vn")
+    {
+      glm::vec3 normal{0.0F};
+      if (!ParseFloat(NextToken(line), normal.x) || !ParseFloat(NextToken(line), normal.y) ||
+          !ParseFloat(NextToken(line), normal.z))
+      {
+        LOG_CORE_ERROR("{}:{}: invalid vertex normal", path.string(), lineNumber);
+        return false;
+      }
+      normals.push_back(normal);
+    }
+    else if (keyword == "f")
+    {
+      polygon.clear();
+      for (std::string_view corner = NextToken(line); !corner.empty(); corner = NextToken(line))
+      {
+        // v, v/vt, v//vn or v/vt/vn
+        const auto       slash       = corner.find('/');
+        const u32        position    = ParseIndex(corner.substr(0, slash), positions.size());
+        std::string_view texCoordRef = slash == std::string_view::npos ? std::string_view{} : corner.substr(slash + 1);
+        const auto       normalSlash = texCoordRef.find('/');
+        std::string_view normalRef   = normalSlash == std::string_view::npos ? std::string_view{}
+                                                                             : texCoordRef.substr(normalSlash + 1);
+        texCoordRef                  = texCoordRef.substr(0, normalSlash);
+        const u32 texCoord           = texCoordRef.empty() ? Unused : ParseIndex(texCoordRef, texCoords.size());
+        const u32 normal             = normalRef.empty() ? Unused : ParseIndex(normalRef, normals.size());
+        if (position == Unused || (!texCoordRef.empty() && texCoord == Unused) ||
+            (!normalRef.empty() && normal == Unused))
+        {
+          LOG_CORE_ERROR("{}:{}: face references a missing vertex", path.string(), lineNumber);
+          return false;
+        }
+
+        const CornerKey key{position, texCoord, normal};
+        const auto      inserted = vertexIds.try_emplace(key, static_cast<u32>(mesh.vertices.size()));
+        if (inserted.second)
+        {
+          mesh.vertices.push_back({.position = positions[position],
+                                   .color    = colors[position],
+                                   .texCoord = texCoord == Unused ? glm::vec2{0.0F} : texCoords[texCoord]});
+          // corners without a normal get a zero one, the cooker generates it when it needs normals
+          mesh.normals.push_back(normal == Unused ? glm::vec3{0.0F} : normals[normal]);
+          hasNormals = hasNormals || normal != Unused;
+        }
+        polygon.push_back(inserted.first->second);
+      }
+
+      for (std::size_t i = 2; i < polygon.size(); ++i)
+      {
+        mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+      }
+    }
+    else if (keyword == "o" || keyword == "g")
+    {
+      closeSubmesh();
+    }
+    else if (keyword == "usemtl")
+    {
+      closeSubmesh();
+      material = materials.try_emplace(NextToken(line), static_cast<u32>(materials.size())).first->second;
+    }
+  }
+  closeSubmesh();
+  if (!hasNormals)
+  {
+    mesh.normals.clear();
+  }
+
+  if (mesh.indices.empty())
+  {
+    LOG_CORE_ERROR("{} has no faces", path.string());
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+MeshletData BuildMeshlets(MeshData& mesh)
+{
+  MeshletData      result;
+  std::vector<u32> localIndex(mesh.vertices.size(), Unused); // vertex to its index in the open meshlet
+
+  Meshlet    meshlet{};
+  const auto flush = [&]
+  {
+    if (meshlet.triangleCount == 0)
+    {
+      return;
+    }
+    const std::span<const u32> vertices{result.vertices.data() + meshlet.vertexOffset, meshlet.vertexCount};
+    const std::span<const u8>  triangles{result.triangles.data() + meshlet.triangleOffset, meshlet.triangleCount * 3};
+    meshlet.boundingSphere =
+      ComputeBoundingSphere(vertices.size(), [&](std::size_t i) { return mesh.vertices[vertices[i]].position; });
+    meshlet.cone = ComputeNormalCone(mesh, vertices, triangles);
+    for (const u32 vertex : vertices)
+    {
+      localIndex[vertex] = Unused;
+    }
+    result.meshlets.push_back(meshlet);
+
+    // every meshlet starts its triangles on a 4 byte boundary, shaders read them as packed u32
+    result.triangles.resize(AlignUp(result.triangles.size(), 4));
+    meshlet = {.vertexOffset   = static_cast<u32>(result.vertices.size()),
+               .triangleOffset = static_cast<u32>(result.triangles.size())};
+  };
+
+  for (MeshSubmesh& submesh : mesh.submeshes)
+  {
+    submesh.firstMeshlet = static_cast<u32>(result.meshlets.size());
+    for (u32 i = submesh.firstIndex; i + 2 < submesh.firstIndex + submesh.indexCount; i += 3)
+    {
+      const std::array<u32, 3> triangle{static_cast<u32>(static_cast<i64>(mesh.indices[i]) + submesh.vertexOffset),
+                                        static_cast<u32>(static_cast<i64>(mesh.indices[i + 1]) + submesh.vertexOffset),
+                                        static_cast<u32>(static_cast<i64>(mesh.indices[i + 2]) + submesh.vertexOffset)};
+      u32 newVertices = 0;
+      for (u32 corner = 0; corner < 3; ++corner)
+      {
+        const bool repeated = std::find(triangle.begin(), triangle.begin() + corner, triangle[corner]) !=
+                              triangle.begin() + corner;
+        newVertices += localIndex[triangle[corner]] == Unused && !repeated ? 1 : 0;
+      }
+      if (meshlet.vertexCount + newVertices > MESHLET_MAX_VERTICES || meshlet.triangleCount == MESHLET_MAX_TRIANGLES)
+      {
+        flush();
+      }
+
+      for (const u32 vertex : triangle)
+      {
+        if (localIndex[vertex] == Unused)
+        {
+          localIndex[vertex] = meshlet.vertexCount++;
+          result.vertices.push_back(vertex);
+        }
+        result.triangles.push_back(static_cast<u8>(localIndex[vertex]));
+      }
+      ++meshlet.triangleCount;
+    }
+    // meshlets never span submeshes, they are culled and drawn with the material of their submesh
+    flush();
+    submesh.meshletCount = static_cast<u32>(result.meshlets.size()) - submesh.firstMeshlet;
+  }
+  return result;
+}
+
+//===============================================================================
+std::vector<u32> ExpandMeshletIndices(std::span<const Meshlet> meshlets,
+                                      std::span<const u32>     vertices,
+                                      std::span<const u8>      triangles)
+{
+  std::size_t count = 0;
+  for (const Meshlet& meshlet : meshlets)
+  {
+    count += meshlet.triangleCount * 3;
+  }
+
+  std::vector<u32> indices;
+  indices.reserve(count);
+  for (const Meshlet& meshlet : meshlets)
+  {
+    for (u32 i = 0; i < meshlet.triangleCount * 3; ++i)
+    {
+      indices.push_back(vertices[meshlet.vertexOffset + triangles[meshlet.triangleOffset + i]]);
+    }
+  }
+  return indices;
+}
+
+//===============================================================================
+bool CookMesh(MeshData& mesh, const std::filesystem::path& path, const MeshCookOptions& options)
+{
+  if (mesh.indices.empty() || mesh.submeshes.empty())
+  {
+    LOG_CORE_ERROR("refusing to cook an empty mesh into {}", path.string());
+    return false;
+  }
+  for (const MeshSubmesh& submesh : mesh.submeshes)
+  {
+    for (u32 i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+    {
+      const i64 vertex = static_cast<i64>(mesh.indices[i]) + submesh.vertexOffset;
+      if (vertex < 0 || vertex >= static_cast<i64>(mesh.vertices.size()))
+      {
+        LOG_CORE_ERROR("index {} of the mesh is out of range, {} not cooked", i, path.string());
+        return false;
+      }
+    }
+  }
+
+  if (options.optimize)
+  {
+    const MeshOptimizeStats stats = OptimizeMesh(mesh);
+    LOG_CORE_INFO("optimized {}: acmr {:.3f} -> {:.3f}, atvr {:.3f} -> {:.3f}, {} duplicate vertices removed",
+                  path.string(),
+                  stats.before.acmr,
+                  stats.after.acmr,
+                  stats.before.atvr,
+                  stats.after.atvr,
+                  stats.duplicates);
+  }
+
+  MeshVertexFormat                 format = options.vertexFormat;
+  std::vector<QuantizedMeshVertex> quantized;
+  if (format == MeshVertexFormat::Quantized)
+  {
+    GenerateNormals(mesh);
+    if (!QuantizeVertices(mesh, quantized))
+    {
+      LOG_CORE_WARN("{} exceeds the half position or unorm texture coordinate range, cooked unquantized",
+                    path.string());
+      format = MeshVertexFormat::Full;
+    }
+  }
+
+  for (MeshSubmesh& submesh : mesh.submeshes)
+  {
+    const auto vertexAt = [&](std::size_t i)
+    {
+      return mesh.vertices[static_cast<std::size_t>(mesh.indices[submesh.firstIndex + i] + submesh.vertexOffset)].position;
+    };
+    submesh.boundingSphere = ComputeBoundingSphere(submesh.indexCount, vertexAt);
+  }
+  const MeshletData          meshlets = BuildMeshlets(mesh);
+  const std::vector<MeshLod> lods     = BuildLods(mesh, options.lodCount, options.optimize);
+
+  MeshFileHeader header{
+    .vertexStride   = GetVertexStride(format),
+    .vertexFormat   = static_cast<u32>(format),
+    .vertexCount    = static_cast<u32>(mesh.vertices.size()),
+    .indexCount     = static_cast<u32>(mesh.indices.size()),
+    .submeshCount   = static_cast<u32>(mesh.submeshes.size()),
+    .lodCount       = static_cast<u32>(lods.size()),
+    .meshletCount   = static_cast<u32>(meshlets.meshlets.size()),
+    .boundingSphere = ComputeBoundingSphere(mesh.vertices.size(), [&](std::size_t i) { return mesh.vertices[i].position; }),
+  };
+  u64 offset              = AlignUp(sizeof(MeshFileHeader), MESH_STREAM_ALIGNMENT);
+  header.vertices         = format == MeshVertexFormat::Quantized ? PlaceStream(offset, quantized)
+                                                                 : PlaceStream(offset, mesh.vertices);
+  header.indices          = PlaceStream(offset, mesh.indices);
+  header.submeshes        = PlaceStream(offset, mesh.submeshes);
+  header.lods             = PlaceStream(offset, lods);
+  header.meshlets         = PlaceStream(offset, meshlets.meshlets);
+  header.meshletVertices  = PlaceStream(offset, meshlets.vertices);
+  header.meshletTriangles = PlaceStream(offset, meshlets.triangles);
+  header.fileSize         = header.meshletTriangles.offset + header.meshletTriangles.size;
+
+  try
+  {
+    if (path.has_parent_path())
+    {
+      std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      if (format == MeshVertexFormat::Quantized)
+      {
+        WriteStream(file, header.vertices, quantized);
+      }
+      else
+      {
+        WriteStream(file, header.vertices, mesh.vertices);
+      }
+      WriteStream(file, header.indices, mesh.indices);
+      WriteStream(file, header.submeshes, mesh.submeshes);
+      WriteStream(file, header.lods, lods);
+      WriteStream(file, header.meshlets, meshlets.meshlets);
+      WriteStream(file, header.meshletVertices, meshlets.vertices);
+      WriteStream(file, header.meshletTriangles, meshlets.triangles);
+      if (!file.good())
+      {
+        LOG_CORE_ERROR("failed to write cooked mesh to {}", tempPath.string());
+        return false;
+      }
+    }
+    std::filesystem::rename(tempPath, path);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to cook mesh!, exception: {0}", e.what());
+    return false;
+  }
+
+  LOG_CORE_INFO("cooked {}: {} vertices, {} triangles, {} submeshes, {} lods, {} meshlets, {} bytes",
+                path.string(),
+                header.vertexCount,
+                header.indexCount / 3,
+                header.submeshCount,
+                header.lodCount,
+                header.meshletCount,
+                header.fileSize);
+  return true;
+}
+
+} // namespace four
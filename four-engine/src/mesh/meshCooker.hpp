@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "mesh/meshFormat.hpp"
+
+#include <span>
+
+namespace four
+{
+
+/**
+ * @brief mesh in memory, what an importer produces and the cooker consumes
+ * submeshes only need firstIndex, indexCount, vertexOffset and material, the cooker computes the rest
+ */
+struct MeshData
+{
+  std::vector<MeshVertex>  vertices;
+  std::vector<glm::vec3>   normals; // one per vertex, or empty when the source has none
+  std::vector<u32>         indices;
+  std::vector<MeshSubmesh> submeshes;
+};
+
+struct MeshCookOptions
+{
+  bool             optimize{true}; // run OptimizeMesh before building meshlets
+  MeshVertexFormat vertexFormat{MeshVertexFormat::Full};
+  u32              lodCount{1}; // lods per submesh up to MESH_MAX_LODS, 1 cooks only the full detail one
+};
+
+/**
+ * @brief meshlets of a mesh, streams laid out as in the cooked file
+ */
+struct MeshletData
+{
+  std::vector<Meshlet> meshlets;
+  std::vector<u32>     vertices;
+  std::vector<u8>      triangles;
+};
+
+/**
+ * @brief read a Wavefront OBJ file
+ * positions, normals, texture coordinates and the optional vertex colors of "v x y z r g b" are kept. polygons are
+ * fan triangulated, corners sharing all attribute indices share a vertex, every object, group or material change
+ * starts a submesh
+ *
+ * @param path file to read
+ * @param mesh filled on success
+ * @return true if the file was read and has at least one triangle
+ */
+[[nodiscard]] FOUR_ENGINE_API bool ImportObj(const std::filesystem::path& path, MeshData& mesh);
+
+/**
+ * @brief split every submesh into meshlets in index order and fill submesh firstMeshlet and meshletCount
+ */
+[[nodiscard]] FOUR_ENGINE_API MeshletData BuildMeshlets(MeshData& mesh);
+
+/**
+ * @brief expand meshlets into plain triangle lists into the vertex stream, meshlet after meshlet
+ * every meshlet becomes a range of triangleCount * 3 indices that is drawn on its own, no mesh shader needed
+ */
+[[nodiscard]] FOUR_ENGINE_API std::vector<u32> ExpandMeshletIndices(std::span<const Meshlet> meshlets,
+                                                                    std::span<const u32>     vertices,
+                                                                    std::span<const u8>      triangles);
+
+/**
+ * @brief optimize mesh, compute bounds, meshlets and lods and write it as a cooked mesh file
+ * lod indices are appended to the indices of mesh, the full detail submesh ranges stay where they are. written to a
+ * temporary file and renamed over path, so a failed cook never leaves half a file. a quantized
+ * format generates missing normals and falls back to the full format when the mesh does not fit its ranges
+ *
+ * @return true if the file was written
+ */
+[[nodiscard]] FOUR_ENGINE_API bool CookMesh(MeshData&                    mesh,
+                                            const std::filesystem::path& path,
+                                            const MeshCookOptions&       options = {});
+
+} // namespace four
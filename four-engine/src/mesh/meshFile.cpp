@@ -0,0 +1,238 @@
+#include "four-pch.hpp"
+
+#include "mesh/meshFile.hpp"
+
+#ifdef FOUR_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace four
+{
+
+//===============================================================================
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+//===============================================================================
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+//===============================================================================
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    Close();
+    m_Data = std::exchange(other.m_Data, nullptr);
+    m_Size = std::exchange(other.m_Size, 0);
+#ifdef FOUR_PLATFORM_WINDOWS
+    m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+  }
+  return *this;
+}
+
+#ifdef FOUR_PLATFORM_WINDOWS
+
+//===============================================================================
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+  Close();
+
+  HANDLE file = CreateFileW(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER size{};
+  if (GetFileSizeEx(file, &size) == 0 || size.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  // the mapping object keeps the file open
+  m_Mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (m_Mapping == nullptr)
+  {
+    return false;
+  }
+
+  m_Data = static_cast<const std::byte*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_Data == nullptr)
+  {
+    CloseHandle(m_Mapping);
+    m_Mapping = nullptr;
+    return false;
+  }
+  m_Size = static_cast<std::size_t>(size.QuadPart);
+  return true;
+}
+
+//===============================================================================
+void MappedFile::Close()
+{
+  if (m_Data != nullptr)
+  {
+    UnmapViewOfFile(m_Data);
+    CloseHandle(m_Mapping);
+  }
+  m_Data    = nullptr;
+  m_Size    = 0;
+  m_Mapping = nullptr;
+}
+
+#else // FOUR_PLATFORM_WINDOWS
+
+//===============================================================================
+bool MappedFile::Open(const std::filesystem::path& path)
+{
+  Close();
+
+  const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+  {
+    return false;
+  }
+
+  struct stat status{};
+  if (::fstat(file, &status) != 0 || status.st_size == 0)
+  {
+    ::close(file);
+    return false;
+  }
+
+  // the mapping keeps the file open
+  void* data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+  ::close(file);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+
+  // the whole file is read front to back once, let the kernel read ahead aggressively
+  ::madvise(data, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+  ::madvise(data, static_cast<std::size_t>(status.st_size), MADV_WILLNEED);
+  m_Data = static_cast<const std::byte*>(data);
+  m_Size = static_cast<std::size_t>(status.st_size);
+  return true;
+}
+
+//===============================================================================
+void MappedFile::Close()
+{
+  if (m_Data != nullptr)
+  {
+    ::munmap(const_cast<std::byte*>(m_Data), m_Size);
+  }
+  m_Data = nullptr;
+  m_Size = 0;
+}
+
+#endif // FOUR_PLATFORM_WINDOWS
+
+//===============================================================================
+bool MeshFile::Open(const std::filesystem::path& path)
+{
+  Close();
+  if (!m_File.Open(path))
+  {
+    LOG_CORE_WARN("failed to map mesh {}", path.string());
+    return false;
+  }
+
+  const std::span<const std::byte> data   = m_File.GetData();
+  const auto*                      header = reinterpret_cast<const MeshFileHeader*>(data.data());
+  if (data.size() < sizeof(MeshFileHeader) || header->magic != MESH_FILE_MAGIC)
+  {
+    LOG_CORE_ERROR("{} is not a cooked mesh", path.string());
+    m_File.Close();
+    return false;
+  }
+  if (header->version != MESH_FILE_VERSION || header->indexSize != sizeof(u32))
+  {
+    LOG_CORE_ERROR("{} was cooked with version {}, expected {}, cook it again",
+                   path.string(),
+                   header->version,
+                   MESH_FILE_VERSION);
+    m_File.Close();
+    return false;
+  }
+  const auto format = static_cast<MeshVertexFormat>(header->vertexFormat);
+  if ((format != MeshVertexFormat::Full && format != MeshVertexFormat::Quantized) ||
+      header->vertexStride != GetVertexStride(format))
+  {
+    LOG_CORE_ERROR("{} has unknown vertex format {} with stride {}",
+                   path.string(),
+                   header->vertexFormat,
+                   header->vertexStride);
+    m_File.Close();
+    return false;
+  }
+
+  // a truncated or corrupt file must not hand out views past the end of the mapping
+  const auto fits = [&](const MeshStream& stream, u64 count, u64 elementSize)
+  {
+    return stream.offset % MESH_STREAM_ALIGNMENT == 0 && stream.size == count * elementSize &&
+           stream.offset <= data.size() && stream.size <= data.size() - stream.offset;
+  };
+  const bool valid = header->fileSize == data.size() &&
+                     fits(header->vertices, header->vertexCount, header->vertexStride) &&
+                     fits(header->indices, header->indexCount, sizeof(u32)) &&
+                     fits(header->submeshes, header->submeshCount, sizeof(MeshSubmesh)) &&
+                     fits(header->lods, header->lodCount, sizeof(MeshLod)) &&
+                     fits(header->meshlets, header->meshletCount, sizeof(Meshlet)) &&
+                     fits(header->meshletVertices, header->meshletVertices.size / sizeof(u32), sizeof(u32)) &&
+                     fits(header->meshletTriangles, header->meshletTriangles.size, 1);
+  if (!valid)
+  {
+    LOG_CORE_ERROR("{} is truncated or corrupt", path.string());
+    m_File.Close();
+    return false;
+  }
+
+  // submesh and lod ranges are drawn without further checks, they must stay inside the streams
+  const std::span submeshes{reinterpret_cast<const MeshSubmesh*>(data.data() + header->submeshes.offset),
+                            header->submeshCount};
+  const std::span lods{reinterpret_cast<const MeshLod*>(data.data() + header->lods.offset), header->lodCount};
+  const auto      inRange = [&](const MeshSubmesh& submesh)
+  {
+    return submesh.firstIndex <= header->indexCount && submesh.indexCount <= header->indexCount - submesh.firstIndex &&
+           submesh.firstMeshlet <= header->meshletCount &&
+           submesh.meshletCount <= header->meshletCount - submesh.firstMeshlet &&
+           submesh.firstLod <= header->lodCount &&
+           submesh.lodCount <= std::min(header->lodCount - submesh.firstLod, MESH_MAX_LODS);
+  };
+  const auto lodInRange = [&](const MeshLod& lod)
+  { return lod.firstIndex <= header->indexCount && lod.indexCount <= header->indexCount - lod.firstIndex; };
+  if (!std::ranges::all_of(submeshes, inRange) || !std::ranges::all_of(lods, lodInRange))
+  {
+    LOG_CORE_ERROR("{} has submeshes outside of its streams", path.string());
+    m_File.Close();
+    return false;
+  }
+
+  m_Header = header;
+  return true;
+}
+
+} // namespace four
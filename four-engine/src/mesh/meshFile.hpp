@@ -0,0 +1,173 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "mesh/meshFormat.hpp"
+
+#include <span>
+
+namespace four
+{
+
+/**
+ * @brief Read only memory mapping of a whole file
+ * pages are read by the os on first touch, the mapping is a hint for sequential access. not copyable
+ */
+class FOUR_ENGINE_API MappedFile
+{
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /**
+   * @brief map path, the previous mapping is released first
+   *
+   * @return true if mapped, empty files are not mapped
+   */
+  [[nodiscard]] bool Open(const std::filesystem::path& path);
+
+  void Close();
+
+  [[nodiscard]] std::span<const std::byte> GetData() const
+  {
+    return {m_Data, m_Size};
+  }
+
+  [[nodiscard]] bool IsOpen() const
+  {
+    return m_Data != nullptr;
+  }
+
+private:
+  const std::byte* m_Data{nullptr};
+  std::size_t      m_Size{0};
+#ifdef FOUR_PLATFORM_WINDOWS
+  void* m_Mapping{nullptr}; // file mapping object, the file handle is closed once it exists
+#endif
+};
+
+/**
+ * @brief Cooked mesh file mapped into memory, see meshFormat.hpp
+ * Open only validates the header and the stream ranges, nothing is parsed or copied: the streams are views into
+ * the mapping, valid until Close. vertex and index bytes go straight from the mapping into gpu staging memory
+ */
+class FOUR_ENGINE_API MeshFile
+{
+public:
+  /**
+   * @brief map path and check it is a cooked mesh of MESH_FILE_VERSION
+   *
+   * @return true if the file can be used, a missing, stale or truncated file is logged and closed
+   */
+  [[nodiscard]] bool Open(const std::filesystem::path& path);
+
+  void Close()
+  {
+    m_File.Close();
+    m_Header = nullptr;
+  }
+
+  [[nodiscard]] bool IsOpen() const
+  {
+    return m_Header != nullptr;
+  }
+
+  [[nodiscard]] const MeshFileHeader& GetHeader() const
+  {
+    return *m_Header;
+  }
+
+  [[nodiscard]] MeshVertexFormat GetVertexFormat() const
+  {
+    return static_cast<MeshVertexFormat>(m_Header->vertexFormat);
+  }
+
+  /**
+   * @brief vertex stream as bytes in the layout of GetVertexFormat, ready for a vertex buffer
+   */
+  [[nodiscard]] std::span<const std::byte> GetVertexData() const
+  {
+    return GetBytes(m_Header->vertices);
+  }
+
+  /**
+   * @brief index stream as bytes, u32 indices, ready for an index buffer
+   */
+  [[nodiscard]] std::span<const std::byte> GetIndexData() const
+  {
+    return GetBytes(m_Header->indices);
+  }
+
+  /**
+   * @brief vertices of a MeshVertexFormat::Full file, empty for other formats
+   */
+  [[nodiscard]] std::span<const MeshVertex> GetVertices() const
+  {
+    return GetVertexFormat() == MeshVertexFormat::Full ? GetStream<MeshVertex>(m_Header->vertices)
+                                                        : std::span<const MeshVertex>{};
+  }
+
+  /**
+   * @brief vertices of a MeshVertexFormat::Quantized file, empty for other formats
+   */
+  [[nodiscard]] std::span<const QuantizedMeshVertex> GetQuantizedVertices() const
+  {
+    return GetVertexFormat() == MeshVertexFormat::Quantized ? GetStream<QuantizedMeshVertex>(m_Header->vertices)
+                                                             : std::span<const QuantizedMeshVertex>{};
+  }
+
+  [[nodiscard]] std::span<const u32> GetIndices() const
+  {
+    return GetStream<u32>(m_Header->indices);
+  }
+
+  [[nodiscard]] std::span<const MeshSubmesh> GetSubmeshes() const
+  {
+    return GetStream<MeshSubmesh>(m_Header->submeshes);
+  }
+
+  [[nodiscard]] std::span<const MeshLod> GetLods() const
+  {
+    return GetStream<MeshLod>(m_Header->lods);
+  }
+
+  [[nodiscard]] std::span<const Meshlet> GetMeshlets() const
+  {
+    return GetStream<Meshlet>(m_Header->meshlets);
+  }
+
+  [[nodiscard]] std::span<const u32> GetMeshletVertices() const
+  {
+    return GetStream<u32>(m_Header->meshletVertices);
+  }
+
+  [[nodiscard]] std::span<const u8> GetMeshletTriangles() const
+  {
+    return GetStream<u8>(m_Header->meshletTriangles);
+  }
+
+private:
+  [[nodiscard]] std::span<const std::byte> GetBytes(const MeshStream& stream) const
+  {
+    return m_File.GetData().subspan(stream.offset, stream.size);
+  }
+
+  // streams are aligned in the file and the mapping starts on a page, so they can be read in place
+  template <typename T>
+  [[nodiscard]] std::span<const T> GetStream(const MeshStream& stream) const
+  {
+    return {reinterpret_cast<const T*>(m_File.GetData().data() + stream.offset), stream.size / sizeof(T)};
+  }
+
+private:
+  MappedFile            m_File;
+  const MeshFileHeader* m_Header{nullptr};
+};
+
+} // namespace four
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "glm/glm.hpp"
+
+#include <bit>
+#include <span>
+
+namespace four
+{
+
+// cooked mesh file, written by the mesh cooker and mapped as is by MeshFile
+//
+//   | MeshFileHeader | vertices | indices | submeshes | lods | meshlets | meshlet vertices | meshlet triangles |
+//
+// every stream starts at a multiple of MESH_STREAM_ALIGNMENT, so the mapped bytes are copied to the gpu as they are
+// and the struct streams are read in place. little endian, the loader rejects files of another version.
+constexpr u32 MESH_FILE_MAGIC       = 0x48534D46; // "FMSH"
+constexpr u32 MESH_FILE_VERSION     = 3;
+constexpr u64 MESH_STREAM_ALIGNMENT = 256; // largest minStorageBufferOffsetAlignment of current devices
+constexpr u32 MESHLET_MAX_VERTICES  = 64;
+constexpr u32 MESHLET_MAX_TRIANGLES = 124; // 64 vertices and 124 triangles fit the mesh shader limits of every vendor
+constexpr u32 MESH_MAX_LODS         = 8;   // levels of detail per submesh, the full detail one included
+
+static_assert(std::endian::native == std::endian::little, "cooked meshes are little endian");
+
+/**
+ * @brief vertex of a full vertex stream, same layout as the Vertex of the renderer, has no normal
+ */
+struct MeshVertex
+{
+  glm::vec3 position{0.0F};
+  glm::vec3 color{1.0F};
+  glm::vec2 texCoord{0.0F};
+};
+
+/**
+ * @brief vertex of a quantized vertex stream, 20 bytes instead of 32 and carries a normal
+ * half float position, unorm16 texture coordinates in [0, 1], unorm8 color and an octahedral snorm16 normal,
+ * the vertex input unit expands every attribute to float, shaders read it like a full vertex
+ */
+struct QuantizedMeshVertex
+{
+  std::array<u16, 4> position{}; // xyz, w is 1
+  std::array<u16, 2> texCoord{};
+  std::array<u8, 4>  color{};    // rgb, a is 255
+  std::array<i16, 2> normal{};
+};
+
+enum class MeshVertexFormat : u32
+{
+  Full      = 0, // MeshVertex
+  Quantized = 1, // QuantizedMeshVertex
+};
+
+[[nodiscard]] constexpr u32 GetVertexStride(MeshVertexFormat format)
+{
+  return format == MeshVertexFormat::Quantized ? sizeof(QuantizedMeshVertex) : sizeof(MeshVertex);
+}
+
+/**
+ * @brief map a unit vector onto the octahedron unfolded into [-1, 1]^2, the lower half folded over the corners
+ */
+[[nodiscard]] inline glm::vec2 EncodeOctahedral(const glm::vec3& normal)
+{
+  const glm::vec3 n = normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+  if (n.z >= 0.0F)
+  {
+    return {n.x, n.y};
+  }
+  return {(1.0F - std::abs(n.y)) * (n.x >= 0.0F ? 1.0F : -1.0F), (1.0F - std::abs(n.x)) * (n.y >= 0.0F ? 1.0F : -1.0F)};
+}
+
+[[nodiscard]] inline glm::vec3 DecodeOctahedral(const glm::vec2& encoded)
+{
+  glm::vec3 n{encoded.x, encoded.y, 1.0F - std::abs(encoded.x) - std::abs(encoded.y)};
+  if (n.z < 0.0F)
+  {
+    n.x = (1.0F - std::abs(encoded.y)) * (encoded.x >= 0.0F ? 1.0F : -1.0F);
+    n.y = (1.0F - std::abs(encoded.x)) * (encoded.y >= 0.0F ? 1.0F : -1.0F);
+  }
+  return glm::normalize(n);
+}
+
+static_assert(sizeof(MeshVertex) == 32);
+static_assert(sizeof(QuantizedMeshVertex) == 20);
+
+/**
+ * @brief byte range of a stream in the file
+ */
+struct MeshStream
+{
+  u64 offset{0};
+  u64 size{0};
+};
+
+struct MeshFileHeader
+{
+  u32        magic{MESH_FILE_MAGIC};
+  u32        version{MESH_FILE_VERSION};
+  u32        vertexStride{sizeof(MeshVertex)};
+  u32        indexSize{sizeof(u32)};
+  u32        vertexFormat{0}; // MeshVertexFormat
+  u32        vertexCount{0};
+  u32        indexCount{0}; // full detail and lod indices
+  u32        submeshCount{0};
+  u32        lodCount{0};
+  u32        meshletCount{0};
+  MeshStream vertices;
+  MeshStream indices;
+  MeshStream submeshes;        // MeshSubmesh
+  MeshStream lods;             // MeshLod
+  MeshStream meshlets;         // Meshlet
+  MeshStream meshletVertices;  // u32 index into the vertex stream per meshlet vertex
+  MeshStream meshletTriangles; // three u8 indices into the meshlet vertices per triangle
+  glm::vec4  boundingSphere{0.0F}; // xyz center, w radius, of the whole mesh
+  u64        fileSize{0};
+};
+
+/**
+ * @brief range of the index stream drawn with one material, one object or group of the source file
+ */
+struct MeshSubmesh
+{
+  u32       firstIndex{0};
+  u32       indexCount{0};
+  i32       vertexOffset{0};
+  u32       firstMeshlet{0};
+  u32       meshletCount{0};
+  u32       material{0}; // index of the material name in the order of first use in the source file
+  u32       firstLod{0};
+  u32       lodCount{0}; // the first lod is the submesh range itself
+  glm::vec4 boundingSphere{0.0F};
+};
+
+/**
+ * @brief index range of one level of detail of a submesh, sorted from full detail to coarsest
+ * lods index the vertices of the full detail range, error is how far the simplified surface may be off it in the
+ * units of the mesh
+ */
+struct MeshLod
+{
+  u32 firstIndex{0};
+  u32 indexCount{0};
+  f32 error{0.0F};
+  u32 padding{0};
+};
+
+/**
+ * @brief up to MESHLET_MAX_TRIANGLES triangles over up to MESHLET_MAX_VERTICES vertices
+ * the cone bounds the normals of the triangles, the meshlet faces away from a camera at position p when
+ * dot(center - p, axis) >= cutoff * length(center - p) + radius, a cutoff of 1 never culls
+ */
+struct Meshlet
+{
+  u32       vertexOffset{0};   // first entry in the meshlet vertex stream
+  u32       triangleOffset{0}; // first byte in the meshlet triangle stream, a multiple of 4
+  u32       vertexCount{0};
+  u32       triangleCount{0};
+  glm::vec4 boundingSphere{0.0F}; // xyz center, w radius
+  glm::vec4 cone{0.0F, 0.0F, 1.0F, 1.0F}; // xyz axis, w cutoff
+};
+
+/**
+ * @brief true when every triangle of meshlet faces away from viewPosition, both in the space of the mesh
+ * the same test as the meshlet cull pass, which runs it in world space
+ */
+[[nodiscard]] inline bool IsMeshletBackfacing(const Meshlet& meshlet, const glm::vec3& viewPosition)
+{
+  const glm::vec3 toCenter = glm::vec3{meshlet.boundingSphere} - viewPosition;
+  return glm::dot(toCenter, glm::vec3{meshlet.cone}) >= meshlet.cone.w * glm::length(toCenter) + meshlet.boundingSphere.w;
+}
+
+/**
+ * @brief pixels covered by one unit of the mesh at distance 1 of a perspective projection
+ *
+ * @param projectionY proj[1][1] of the projection, the cotangent of half the vertical field of view
+ * @param viewportHeight height of the viewport in pixels
+ */
+[[nodiscard]] inline f32 GetLodErrorScale(f32 projectionY, f32 viewportHeight)
+{
+  return 0.5F * std::abs(projectionY) * viewportHeight;
+}
+
+/**
+ * @brief coarsest lod whose error projects to at most threshold pixels, moving on from current
+ * a finer lod is taken as soon as the current one exceeds threshold, a coarser one only once it fits
+ * threshold * (1 - hysteresis), so an object at the switching distance does not pop back and forth
+ *
+ * @param pixelsPerUnit pixels covered by one unit of the mesh at the object, see GetLodErrorScale
+ */
+[[nodiscard]] inline u32 SelectLod(std::span<const MeshLod> lods,
+                                   f32                      pixelsPerUnit,
+                                   u32                      current,
+                                   f32                      threshold,
+                                   f32                      hysteresis)
+{
+  if (lods.empty())
+  {
+    return 0;
+  }
+  u32 lod = std::min(current, static_cast<u32>(lods.size()) - 1);
+  while (lod > 0 && lods[lod].error * pixelsPerUnit > threshold)
+  {
+    --lod;
+  }
+  while (lod + 1 < lods.size() && lods[lod + 1].error * pixelsPerUnit <= threshold * (1.0F - hysteresis))
+  {
+    ++lod;
+  }
+  return lod;
+}
+
+static_assert(sizeof(MeshFileHeader) <= MESH_STREAM_ALIGNMENT);
+static_assert(sizeof(MeshSubmesh) == 48);
+static_assert(sizeof(MeshLod) == 16);
+static_assert(sizeof(Meshlet) == 48);
+
+} // namespace four
@@ -0,0 +1,830 @@
+#include "four-pch.hpp"
+
+#include "mesh/meshOptimizer.hpp"
+
+#include "core/profiler.hpp"
+
+#include <numeric>
+
+namespace four
+{
+
+namespace
+{
+constexpr u32 Unused   = std::numeric_limits<u32>::max();
+constexpr f32 Infinity = std::numeric_limits<f32>::infinity();
+
+/**
+ * @brief fifo post transform cache, a vertex is cached while fewer than size misses happened since it was loaded
+ */
+class FifoCache
+{
+public:
+  FifoCache(u32 vertexCount, u32 size) : m_Stamps(vertexCount, 0), m_Size(size), m_Time(size + 1) {}
+
+  // 1 when vertex was not in the cache
+  u32 Touch(u32 vertex)
+  {
+    if (m_Time - m_Stamps[vertex] <= m_Size)
+    {
+      return 0;
+    }
+    m_Stamps[vertex] = m_Time++;
+    return 1;
+  }
+
+  u32 TouchTriangle(const u32* triangle)
+  {
+    return Touch(triangle[0]) + Touch(triangle[1]) + Touch(triangle[2]);
+  }
+
+  // everything loaded so far is older than the cache, without touching the stamps
+  void Flush()
+  {
+    m_Time += m_Size + 1;
+  }
+
+private:
+  std::vector<u32> m_Stamps;
+  u32              m_Size;
+  u32              m_Time;
+};
+
+void FoldVertexOffsets(MeshData& mesh)
+{
+  for (MeshSubmesh& submesh : mesh.submeshes)
+  {
+    for (u32 i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; ++i)
+    {
+      mesh.indices[i] = static_cast<u32>(static_cast<i64>(mesh.indices[i]) + submesh.vertexOffset);
+    }
+    submesh.vertexOffset = 0;
+  }
+}
+
+// every vertex with its new index in remap, Unused ones are dropped
+void RemapVertices(MeshData& mesh, std::span<const u32> remap, u32 newCount)
+{
+  std::vector<MeshVertex> vertices(newCount);
+  std::vector<glm::vec3>  normals(mesh.normals.empty() ? 0 : newCount);
+  for (u32 vertex = 0; vertex < remap.size(); ++vertex)
+  {
+    if (remap[vertex] == Unused)
+    {
+      continue;
+    }
+    vertices[remap[vertex]] = mesh.vertices[vertex];
+    if (!normals.empty())
+    {
+      normals[remap[vertex]] = mesh.normals[vertex];
+    }
+  }
+  mesh.vertices = std::move(vertices);
+  mesh.normals  = std::move(normals);
+  for (u32& index : mesh.indices)
+  {
+    index = remap[index];
+  }
+}
+
+/**
+ * @brief sum of squared distances to planes, each weighted by the area of its triangle
+ * stored as the upper half of the symmetric 4x4 matrix, in double so sums of many planes keep their precision
+ */
+struct Quadric
+{
+  f64 a00{0.0};
+  f64 a01{0.0};
+  f64 a02{0.0};
+  f64 a11{0.0};
+  f64 a12{0.0};
+  f64 a22{0.0};
+  f64 b0{0.0};
+  f64 b1{0.0};
+  f64 b2{0.0};
+  f64 c{0.0};
+  f64 weight{0.0};
+
+  // plane through point with unit normal
+  static Quadric FromPlane(const glm::vec3& normal, const glm::vec3& point, f64 weight)
+  {
+    const f64 x = normal.x;
+    const f64 y = normal.y;
+    const f64 z = normal.z;
+    const f64 d = -glm::dot(normal, point);
+    return {.a00    = weight * x * x,
+            .a01    = weight * x * y,
+            .a02    = weight * x * z,
+            .a11    = weight * y * y,
+            .a12    = weight * y * z,
+            .a22    = weight * z * z,
+            .b0     = weight * x * d,
+            .b1     = weight * y * d,
+            .b2     = weight * z * d,
+            .c      = weight * d * d,
+            .weight = weight};
+  }
+
+  Quadric& operator+=(const Quadric& other)
+  {
+    a00 += other.a00;
+    a01 += other.a01;
+    a02 += other.a02;
+    a11 += other.a11;
+    a12 += other.a12;
+    a22 += other.a22;
+    b0 += other.b0;
+    b1 += other.b1;
+    b2 += other.b2;
+    c += other.c;
+    weight += other.weight;
+    return *this;
+  }
+
+  // root of the weighted mean squared distance of point to the planes
+  [[nodiscard]] f32 GetError(const glm::vec3& point) const
+  {
+    const f64 x   = point.x;
+    const f64 y   = point.y;
+    const f64 z   = point.z;
+    const f64 sum = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                    2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    return weight > 0.0 ? static_cast<f32>(std::sqrt(std::max(sum, 0.0) / weight)) : 0.0F;
+  }
+};
+
+/**
+ * @brief edge collapse state of one triangle list, vertices are the ones the list references, numbered locally
+ * quadrics, adjacency and locks are kept per position, so the attribute copies of a seam vertex act as one
+ */
+class EdgeCollapser
+{
+public:
+  EdgeCollapser(std::span<const u32> indices, std::span<const MeshVertex> vertices)
+  {
+    // local vertices in the order of the vertex stream
+    m_Vertices.assign(indices.begin(), indices.end());
+    std::ranges::sort(m_Vertices);
+    const auto duplicates = std::ranges::unique(m_Vertices);
+    m_Vertices.erase(duplicates.begin(), duplicates.end());
+    std::vector<u32> local(m_Vertices.back() + 1, Unused);
+    for (u32 vertex = 0; vertex < m_Vertices.size(); ++vertex)
+    {
+      local[m_Vertices[vertex]] = vertex;
+    }
+
+    // copies of a position share one position id, ordered by position so equal ones are neighbours
+    const auto       vertexCount = static_cast<u32>(m_Vertices.size());
+    std::vector<u32> byPosition(vertexCount);
+    std::iota(byPosition.begin(), byPosition.end(), 0);
+    const auto position = [&](u32 vertex) -> const glm::vec3& { return vertices[m_Vertices[vertex]].position; };
+    const auto less     = [&](u32 a, u32 b)
+    {
+      const glm::vec3& pa = position(a);
+      const glm::vec3& pb = position(b);
+      return std::tie(pa.x, pa.y, pa.z) < std::tie(pb.x, pb.y, pb.z);
+    };
+    std::ranges::sort(byPosition, less);
+    m_PositionIds.resize(vertexCount);
+    for (u32 i = 0; i < vertexCount; ++i)
+    {
+      if (i == 0 || position(byPosition[i]) != m_Positions.back())
+      {
+        m_Positions.push_back(position(byPosition[i]));
+        m_Locked.push_back(0);
+      }
+      else
+      {
+        m_Locked.back() = 1; // attribute seam
+      }
+      m_PositionIds[byPosition[i]] = static_cast<u32>(m_Positions.size() - 1);
+    }
+
+    const std::size_t positionCount = m_Positions.size();
+    m_Quadrics.resize(positionCount);
+    m_Triangles.reserve(indices.size() / 3);
+    std::vector<u64> edges;
+    edges.reserve(indices.size());
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      const std::array<u32, 3> triangle{local[indices[i]], local[indices[i + 1]], local[indices[i + 2]]};
+      const std::array<u32, 3> ids{GetId(triangle[0]), GetId(triangle[1]), GetId(triangle[2])};
+      if (ids[0] == ids[1] || ids[1] == ids[2] || ids[2] == ids[0])
+      {
+        continue; // degenerate triangles cover nothing, they are dropped from every lod
+      }
+      const glm::vec3& corner = m_Positions[ids[0]];
+      const glm::vec3  normal = glm::cross(m_Positions[ids[1]] - corner, m_Positions[ids[2]] - corner);
+      const f32        length = glm::length(normal); // twice the area
+      for (u32 k = 0; k < 3; ++k)
+      {
+        if (length > 0.0F)
+        {
+          m_Quadrics[ids[k]] += Quadric::FromPlane(normal / length, corner, 0.5 * length);
+        }
+        const u32 a = ids[k];
+        const u32 b = ids[(k + 1) % 3];
+        edges.push_back(static_cast<u64>(std::min(a, b)) << 32 | std::max(a, b));
+      }
+      m_Triangles.push_back(triangle);
+    }
+    m_Alive.assign(m_Triangles.size(), 1);
+    m_AliveCount = static_cast<u32>(m_Triangles.size());
+
+    // an edge of one triangle is on the border, of more than two on a non manifold fin, both keep their vertices
+    std::ranges::sort(edges);
+    for (std::size_t first = 0; first < edges.size();)
+    {
+      std::size_t last = first + 1;
+      while (last < edges.size() && edges[last] == edges[first])
+      {
+        ++last;
+      }
+      if (last - first != 2)
+      {
+        m_Locked[edges[first] >> 32]        = 1;
+        m_Locked[edges[first] & 0xFFFFFFFF] = 1;
+      }
+      first = last;
+    }
+
+    m_Adjacency.resize(positionCount);
+    m_Marks.resize(positionCount, 0);
+    for (u32 triangle = 0; triangle < m_Triangles.size(); ++triangle)
+    {
+      for (const u32 vertex : m_Triangles[triangle])
+      {
+        m_Adjacency[GetId(vertex)].push_back(triangle);
+      }
+    }
+  }
+
+  [[nodiscard]] u32 GetTriangleCount() const
+  {
+    return m_AliveCount;
+  }
+
+  [[nodiscard]] f32 GetError() const
+  {
+    return m_Error;
+  }
+
+  /**
+   * @brief collapse edges until at most targetTriangles are left or no edge can collapse
+   * every pass sorts all edges by cost and collapses the cheapest ones that share no position with another
+   * collapse of the pass, so their costs are still the ones they were sorted by
+   */
+  void Simplify(u32 targetTriangles)
+  {
+    struct Collapse
+    {
+      u32 from{0};
+      u32 to{0};
+      f32 error{0.0F};
+    };
+    std::vector<Collapse> collapses;
+    std::vector<u8>       touched(m_Positions.size(), 0);
+    while (m_AliveCount > targetTriangles)
+    {
+      collapses.clear();
+      for (u32 triangle = 0; triangle < m_Triangles.size(); ++triangle)
+      {
+        if (m_Alive[triangle] == 0)
+        {
+          continue;
+        }
+        // an inner edge runs the other way in its second triangle, it is taken once in the cheaper direction
+        for (u32 k = 0; k < 3; ++k)
+        {
+          const u32 a = m_Triangles[triangle][k];
+          const u32 b = m_Triangles[triangle][(k + 1) % 3];
+          if (GetId(a) > GetId(b) || (m_Locked[GetId(a)] != 0 && m_Locked[GetId(b)] != 0))
+          {
+            continue;
+          }
+          Quadric quadric = m_Quadrics[GetId(a)];
+          quadric += m_Quadrics[GetId(b)];
+          const f32 toA = m_Locked[GetId(b)] == 0 ? quadric.GetError(m_Positions[GetId(a)]) : Infinity;
+          const f32 toB = m_Locked[GetId(a)] == 0 ? quadric.GetError(m_Positions[GetId(b)]) : Infinity;
+          collapses.push_back(toB <= toA ? Collapse{.from = a, .to = b, .error = toB}
+                                         : Collapse{.from = b, .to = a, .error = toA});
+        }
+      }
+      std::ranges::sort(collapses, {}, &Collapse::error);
+
+      std::ranges::fill(touched, 0);
+      u32 collapsed = 0;
+      for (const Collapse& collapse : collapses)
+      {
+        if (m_AliveCount <= targetTriangles)
+        {
+          break;
+        }
+        const u32 from = GetId(collapse.from);
+        const u32 to   = GetId(collapse.to);
+        if (touched[from] != 0 || touched[to] != 0 || !CanCollapse(from, to))
+        {
+          continue;
+        }
+        Apply(collapse.from, collapse.to);
+        touched[from] = 1;
+        touched[to]   = 1;
+        m_Error       = std::max(m_Error, collapse.error);
+        ++collapsed;
+      }
+      if (collapsed == 0)
+      {
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief indices of the triangles left, into the vertex stream the collapser was built from
+   */
+  [[nodiscard]] std::vector<u32> GetIndices() const
+  {
+    std::vector<u32> indices;
+    indices.reserve(static_cast<std::size_t>(m_AliveCount) * 3);
+    for (u32 triangle = 0; triangle < m_Triangles.size(); ++triangle)
+    {
+      if (m_Alive[triangle] != 0)
+      {
+        for (const u32 vertex : m_Triangles[triangle])
+        {
+          indices.push_back(m_Vertices[vertex]);
+        }
+      }
+    }
+    return indices;
+  }
+
+private:
+  [[nodiscard]] u32 GetId(u32 vertex) const
+  {
+    return m_PositionIds[vertex];
+  }
+
+  [[nodiscard]] bool Contains(u32 triangle, u32 id) const
+  {
+    return std::ranges::any_of(m_Triangles[triangle], [&](u32 vertex) { return GetId(vertex) == id; });
+  }
+
+  // positions around to that are around from as well, counted up to limit
+  u32 CountSharedNeighbours(u32 from, u32 to, u32 limit)
+  {
+    const u32 around = ++m_Stamp;
+    const u32 shared = ++m_Stamp;
+    for (const u32 triangle : m_Adjacency[from])
+    {
+      if (m_Alive[triangle] == 0)
+      {
+        continue;
+      }
+      for (const u32 vertex : m_Triangles[triangle])
+      {
+        if (GetId(vertex) != from)
+        {
+          m_Marks[GetId(vertex)] = around;
+        }
+      }
+    }
+    u32 count = 0;
+    for (const u32 triangle : m_Adjacency[to])
+    {
+      if (m_Alive[triangle] == 0)
+      {
+        continue;
+      }
+      for (const u32 vertex : m_Triangles[triangle])
+      {
+        if (GetId(vertex) != to && m_Marks[GetId(vertex)] == around)
+        {
+          m_Marks[GetId(vertex)] = shared;
+          if (++count >= limit)
+          {
+            return count;
+          }
+        }
+      }
+    }
+    return count;
+  }
+
+  bool CanCollapse(u32 from, u32 to)
+  {
+    // an edge between two triangles shares exactly their two opposite corners, more would pinch the surface
+    if (CountSharedNeighbours(from, to, 3) > 2)
+    {
+      return false;
+    }
+
+    // triangles that keep from and only move it must not turn over or become slivers
+    const glm::vec3& target = m_Positions[to];
+    for (const u32 triangle : m_Adjacency[from])
+    {
+      if (m_Alive[triangle] == 0 || Contains(triangle, to))
+      {
+        continue;
+      }
+      std::array<glm::vec3, 3> corners{};
+      for (u32 k = 0; k < 3; ++k)
+      {
+        corners[k] = m_Positions[GetId(m_Triangles[triangle][k])];
+      }
+      const glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+      for (glm::vec3& corner : corners)
+      {
+        corner = corner == m_Positions[from] ? target : corner;
+      }
+      const glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+      if (glm::dot(before, after) <= 0.25F * glm::length(before) * glm::length(after))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // from is no seam, so every triangle around its position uses the vertex from itself
+  void Apply(u32 from, u32 to)
+  {
+    const u32 fromId = GetId(from);
+    const u32 toId   = GetId(to);
+    m_Quadrics[toId] += m_Quadrics[fromId];
+    for (const u32 triangle : m_Adjacency[fromId])
+    {
+      if (m_Alive[triangle] == 0)
+      {
+        continue;
+      }
+      if (Contains(triangle, toId))
+      {
+        m_Alive[triangle] = 0;
+        --m_AliveCount;
+        continue;
+      }
+      std::ranges::replace(m_Triangles[triangle], from, to);
+      m_Adjacency[toId].push_back(triangle);
+    }
+    m_Adjacency[fromId].clear();
+  }
+
+private:
+  std::vector<u32>                m_Vertices;    // vertex stream index of every local vertex
+  std::vector<u32>                m_PositionIds; // position of every local vertex
+  std::vector<glm::vec3>          m_Positions;
+  std::vector<u8>                 m_Locked; // per position
+  std::vector<Quadric>            m_Quadrics;
+  std::vector<std::vector<u32>>   m_Adjacency; // triangles around every position, dead ones included
+  std::vector<std::array<u32, 3>> m_Triangles; // local vertices
+  std::vector<u8>                 m_Alive;
+  u32                             m_AliveCount{0};
+  f32                             m_Error{0.0F};
+  std::vector<u32>                m_Marks; // per position, stamps of CountSharedNeighbours
+  u32                             m_Stamp{0};
+};
+} // namespace
+
+//===============================================================================
+VertexCacheStats AnalyzeVertexCache(std::span<const u32> indices, u32 vertexCount, u32 cacheSize)
+{
+  VertexCacheStats stats{.triangles = static_cast<u32>(indices.size() / 3)};
+  FifoCache        cache(vertexCount, cacheSize);
+  std::vector<u8>  referenced(vertexCount, 0);
+  for (const u32 index : indices)
+  {
+    stats.transformed += cache.Touch(index);
+    stats.vertices += referenced[index] == 0 ? 1 : 0;
+    referenced[index] = 1;
+  }
+  stats.acmr = stats.triangles == 0 ? 0.0F : static_cast<f32>(stats.transformed) / static_cast<f32>(stats.triangles);
+  stats.atvr = stats.vertices == 0 ? 0.0F : static_cast<f32>(stats.transformed) / static_cast<f32>(stats.vertices);
+  return stats;
+}
+
+//===============================================================================
+u32 DeduplicateVertices(MeshData& mesh)
+{
+  FOUR_PROFILE_FUNCTION();
+  FoldVertexOffsets(mesh);
+
+  // equal vertices become neighbours once sorted by their bits, the first of them in vertex order is kept
+  using Key = std::array<u32, 11>;
+  const auto       vertexCount = static_cast<u32>(mesh.vertices.size());
+  std::vector<Key> keys(vertexCount);
+  for (u32 vertex = 0; vertex < vertexCount; ++vertex)
+  {
+    const MeshVertex& v      = mesh.vertices[vertex];
+    const glm::vec3   normal = mesh.normals.empty() ? glm::vec3{0.0F} : mesh.normals[vertex];
+    keys[vertex]             = {std::bit_cast<u32>(v.position.x),
+                                std::bit_cast<u32>(v.position.y),
+                                std::bit_cast<u32>(v.position.z),
+                                std::bit_cast<u32>(v.color.x),
+                                std::bit_cast<u32>(v.color.y),
+                                std::bit_cast<u32>(v.color.z),
+                                std::bit_cast<u32>(v.texCoord.x),
+                                std::bit_cast<u32>(v.texCoord.y),
+                                std::bit_cast<u32>(normal.x),
+                                std::bit_cast<u32>(normal.y),
+                                std::bit_cast<u32>(normal.z)};
+  }
+  std::vector<u32> order(vertexCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::stable_sort(order, [&](u32 a, u32 b) { return keys[a] < keys[b]; });
+
+  std::vector<u32> canonical(vertexCount);
+  for (u32 i = 0; i < vertexCount; ++i)
+  {
+    canonical[order[i]] = i > 0 && keys[order[i]] == keys[order[i - 1]] ? canonical[order[i - 1]] : order[i];
+  }
+
+  // kept vertices stay in their order
+  std::vector<u32> remap(vertexCount, Unused);
+  u32              kept = 0;
+  for (u32 vertex = 0; vertex < vertexCount; ++vertex)
+  {
+    remap[vertex] = canonical[vertex] == vertex ? kept++ : remap[canonical[vertex]];
+  }
+  RemapVertices(mesh, remap, kept);
+  return vertexCount - kept;
+}
+
+//===============================================================================
+void OptimizeVertexCache(std::span<u32> indices, u32 vertexCount, u32 cacheSize)
+{
+  FOUR_PROFILE_FUNCTION();
+  const auto triangleCount = static_cast<u32>(indices.size() / 3);
+  if (triangleCount == 0)
+  {
+    return;
+  }
+  const std::vector<u32> input(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount) * 3);
+
+  // triangles of every vertex
+  std::vector<u32> adjacencyBegin(vertexCount + 1, 0);
+  for (const u32 index : input)
+  {
+    ++adjacencyBegin[index + 1];
+  }
+  std::inclusive_scan(adjacencyBegin.begin(), adjacencyBegin.end(), adjacencyBegin.begin());
+  std::vector<u32> adjacency(input.size());
+  std::vector<u32> fill(adjacencyBegin.begin(), adjacencyBegin.end() - 1);
+  for (u32 i = 0; i < input.size(); ++i)
+  {
+    adjacency[fill[input[i]]++] = i / 3;
+  }
+
+  std::vector<u32> live(vertexCount); // triangles of the vertex not emitted yet
+  for (u32 vertex = 0; vertex < vertexCount; ++vertex)
+  {
+    live[vertex] = adjacencyBegin[vertex + 1] - adjacencyBegin[vertex];
+  }
+  std::vector<u32> stamps(vertexCount, 0);
+  u32              time = cacheSize + 1;
+  std::vector<u8>  emitted(triangleCount, 0);
+  std::vector<u32> deadEnd; // recently used vertices, where to continue when the fan runs out of candidates
+  std::vector<u32> candidates;
+  u32              cursor = 0; // input position of the next fallback vertex
+  u32              out    = 0;
+
+  u32 fan = input[0];
+  while (fan != Unused)
+  {
+    // emit every remaining triangle around the fanning vertex
+    candidates.clear();
+    for (u32 i = adjacencyBegin[fan]; i < adjacencyBegin[fan + 1]; ++i)
+    {
+      const u32 triangle = adjacency[i];
+      if (emitted[triangle] != 0)
+      {
+        continue;
+      }
+      emitted[triangle] = 1;
+      for (u32 corner = 0; corner < 3; ++corner)
+      {
+        const u32 vertex = input[triangle * 3 + corner];
+        indices[out++]   = vertex;
+        deadEnd.push_back(vertex);
+        candidates.push_back(vertex);
+        --live[vertex];
+        if (time - stamps[vertex] > cacheSize)
+        {
+          stamps[vertex] = time++;
+        }
+      }
+    }
+
+    // next fan is the candidate that stays cached longest and still has its triangles in the cache when fanned
+    fan              = Unused;
+    u32 bestPriority = 0;
+    for (const u32 vertex : candidates)
+    {
+      if (live[vertex] == 0)
+      {
+        continue;
+      }
+      const u32 age      = time - stamps[vertex];
+      const u32 priority = age + 2 * live[vertex] <= cacheSize ? age + 1 : 1;
+      if (fan == Unused || priority > bestPriority)
+      {
+        fan          = vertex;
+        bestPriority = priority;
+      }
+    }
+
+    // dead end, the most recent vertex with triangles left, then the first one in input order
+    while (fan == Unused && !deadEnd.empty())
+    {
+      fan = live[deadEnd.back()] > 0 ? deadEnd.back() : Unused;
+      deadEnd.pop_back();
+    }
+    while (fan == Unused && cursor < input.size())
+    {
+      fan = live[input[cursor]] > 0 ? input[cursor] : Unused;
+      ++cursor;
+    }
+  }
+}
+
+//===============================================================================
+void OptimizeOverdraw(std::span<u32> indices, std::span<const MeshVertex> vertices, f32 threshold, u32 cacheSize)
+{
+  FOUR_PROFILE_FUNCTION();
+  const auto triangleCount = static_cast<u32>(indices.size() / 3);
+  if (triangleCount < 2)
+  {
+    return;
+  }
+  const auto vertexCount = static_cast<u32>(vertices.size());
+
+  // hard boundaries, a triangle that misses the cache with all three vertices starts a new patch anyway
+  std::vector<u32> hard;
+  {
+    FifoCache cache(vertexCount, cacheSize);
+    for (u32 triangle = 0; triangle < triangleCount; ++triangle)
+    {
+      if (cache.TouchTriangle(&indices[triangle * 3]) == 3 || triangle == 0)
+      {
+        hard.push_back(triangle);
+      }
+    }
+    hard.push_back(triangleCount);
+  }
+
+  // soft boundaries, a patch is cut whenever the run since the last cut is as cache efficient as the whole patch
+  std::vector<u32> clusters;
+  FifoCache        cache(vertexCount, cacheSize);
+  for (u32 patch = 0; patch + 1 < hard.size(); ++patch)
+  {
+    const u32 begin  = hard[patch];
+    const u32 end    = hard[patch + 1];
+    u32       misses = 0;
+    cache.Flush();
+    for (u32 triangle = begin; triangle < end; ++triangle)
+    {
+      misses += cache.TouchTriangle(&indices[triangle * 3]);
+    }
+    const f32 limit = threshold * static_cast<f32>(misses) / static_cast<f32>(end - begin);
+
+    clusters.push_back(begin);
+    const std::size_t firstCut    = clusters.size();
+    u32               runMisses   = 0;
+    u32               runTriangle = 0;
+    cache.Flush();
+    for (u32 triangle = begin; triangle < end; ++triangle)
+    {
+      runMisses += cache.TouchTriangle(&indices[triangle * 3]);
+      ++runTriangle;
+      if (static_cast<f32>(runMisses) <= limit * static_cast<f32>(runTriangle))
+      {
+        clusters.push_back(triangle + 1);
+        cache.Flush();
+        runMisses   = 0;
+        runTriangle = 0;
+      }
+    }
+    // the rest after the last cut did not reach the limit, it stays with the cluster before it
+    if (clusters.size() > firstCut)
+    {
+      clusters.pop_back();
+    }
+  }
+  clusters.push_back(triangleCount);
+
+  // clusters facing away from the center are more likely to occlude the rest, they go first
+  glm::vec3 meshCenter{0.0F};
+  for (const u32 index : indices.first(static_cast<std::size_t>(triangleCount) * 3))
+  {
+    meshCenter += vertices[index].position;
+  }
+  meshCenter /= static_cast<f32>(triangleCount * 3);
+
+  const auto       clusterCount = static_cast<u32>(clusters.size() - 1);
+  std::vector<f32> sortKeys(clusterCount);
+  for (u32 cluster = 0; cluster < clusterCount; ++cluster)
+  {
+    glm::vec3 center{0.0F};
+    glm::vec3 normal{0.0F};
+    f32       area = 0.0F;
+    for (u32 triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle)
+    {
+      const glm::vec3 a            = vertices[indices[triangle * 3]].position;
+      const glm::vec3 b            = vertices[indices[triangle * 3 + 1]].position;
+      const glm::vec3 c            = vertices[indices[triangle * 3 + 2]].position;
+      const glm::vec3 areaNormal   = glm::cross(b - a, c - a);
+      const f32       triangleArea = glm::length(areaNormal);
+      center += (a + b + c) * (triangleArea / 3.0F);
+      normal += areaNormal;
+      area += triangleArea;
+    }
+    const f32 normalLength = glm::length(normal);
+    sortKeys[cluster] = area > 0.0F && normalLength > 0.0F ? glm::dot(center / area - meshCenter, normal / normalLength)
+                                                          : 0.0F;
+  }
+
+  std::vector<u32> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::stable_sort(order, [&](u32 a, u32 b) { return sortKeys[a] > sortKeys[b]; });
+
+  const std::vector<u32> input(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount) * 3);
+  u32                    out = 0;
+  for (const u32 cluster : order)
+  {
+    for (u32 i = clusters[cluster] * 3; i < clusters[cluster + 1] * 3; ++i)
+    {
+      indices[out++] = input[i];
+    }
+  }
+}
+
+//===============================================================================
+void OptimizeVertexFetch(MeshData& mesh)
+{
+  FOUR_PROFILE_FUNCTION();
+  FoldVertexOffsets(mesh);
+
+  std::vector<u32> remap(mesh.vertices.size(), Unused);
+  u32              next = 0;
+  for (const u32 index : mesh.indices)
+  {
+    if (remap[index] == Unused)
+    {
+      remap[index] = next++;
+    }
+  }
+  RemapVertices(mesh, remap, next);
+}
+
+//===============================================================================
+std::vector<MeshLodLevel> SimplifyMesh(std::span<const u32>        indices,
+                                       std::span<const MeshVertex> vertices,
+                                       u32                         levelCount,
+                                       f32                         ratio)
+{
+  FOUR_PROFILE_FUNCTION();
+  std::vector<MeshLodLevel> levels;
+  if (indices.size() < 3 || levelCount == 0)
+  {
+    return levels;
+  }
+
+  EdgeCollapser collapser(indices, vertices);
+  u32           triangles = collapser.GetTriangleCount();
+  for (u32 level = 0; level < levelCount; ++level)
+  {
+    collapser.Simplify(static_cast<u32>(static_cast<f32>(triangles) * ratio));
+    const u32 simplified = collapser.GetTriangleCount();
+    if (simplified == 0 || static_cast<f32>(simplified) > static_cast<f32>(triangles) * (1.0F - LOD_MIN_REDUCTION))
+    {
+      break;
+    }
+    levels.push_back({.indices = collapser.GetIndices(), .error = collapser.GetError()});
+    triangles = simplified;
+  }
+  return levels;
+}
+
+//===============================================================================
+MeshOptimizeStats OptimizeMesh(MeshData& mesh)
+{
+  FOUR_PROFILE_FUNCTION();
+  FoldVertexOffsets(mesh);
+
+  MeshOptimizeStats stats{.before = AnalyzeVertexCache(mesh.indices, static_cast<u32>(mesh.vertices.size()))};
+  stats.duplicates = DeduplicateVertices(mesh);
+
+  // submeshes are drawn separately, triangles never move between them
+  for (const MeshSubmesh& submesh : mesh.submeshes)
+  {
+    const std::span<u32> indices = std::span{mesh.indices}.subspan(submesh.firstIndex, submesh.indexCount);
+    OptimizeVertexCache(indices, static_cast<u32>(mesh.vertices.size()));
+    OptimizeOverdraw(indices, mesh.vertices);
+  }
+  OptimizeVertexFetch(mesh);
+
+  stats.after = AnalyzeVertexCache(mesh.indices, static_cast<u32>(mesh.vertices.size()));
+  return stats;
+}
+
+} // namespace four
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "mesh/meshCooker.hpp"
+
+#include <span>
+
+namespace four
+{
+
+constexpr u32 VERTEX_CACHE_SIZE  = 16;    // fifo entries of the post transform cache that is simulated and targeted
+constexpr f32 OVERDRAW_THRESHOLD = 1.05F; // overdraw ordering may raise the acmr of a submesh by this factor
+constexpr f32 LOD_TRIANGLE_RATIO = 0.5F;  // triangles a lod keeps of the one before
+constexpr f32 LOD_MIN_REDUCTION  = 0.1F;  // the lod chain ends when a level removes fewer of the triangles before
+
+/**
+ * @brief post transform cache efficiency of an index buffer on a fifo cache
+ * acmr is transformed vertices per triangle, 0.5 is ideal for regular grids and 3 is no reuse at all
+ * atvr is transformed vertices per referenced vertex, 1 means every vertex is shaded once
+ */
+struct VertexCacheStats
+{
+  u32 triangles{0};
+  u32 vertices{0}; // distinct vertices referenced
+  u32 transformed{0};
+  f32 acmr{0.0F};
+  f32 atvr{0.0F};
+};
+
+struct MeshLodLevel
+{
+  std::vector<u32> indices;
+  f32              error{0.0F}; // distance estimated by the quadrics, in the units of the mesh
+};
+
+struct MeshOptimizeStats
+{
+  VertexCacheStats before;
+  VertexCacheStats after;
+  u32              duplicates{0}; // vertices removed by deduplication
+};
+
+/**
+ * @brief simulate a fifo cache of cacheSize entries over indices
+ */
+[[nodiscard]] FOUR_ENGINE_API VertexCacheStats AnalyzeVertexCache(std::span<const u32> indices,
+                                                                  u32                  vertexCount,
+                                                                  u32                  cacheSize = VERTEX_CACHE_SIZE);
+
+/**
+ * @brief merge vertices whose attributes are bitwise equal and remap indices
+ *
+ * @return number of vertices removed
+ */
+FOUR_ENGINE_API u32 DeduplicateVertices(MeshData& mesh);
+
+/**
+ * @brief reorder triangles for the post transform cache, Tipsify of Sander, Nehab and Barczak
+ * fans around the vertex that stays longest in the cache, linear in the number of triangles
+ */
+FOUR_ENGINE_API void OptimizeVertexCache(std::span<u32> indices, u32 vertexCount, u32 cacheSize = VERTEX_CACHE_SIZE);
+
+/**
+ * @brief reorder clusters of a cache optimized index buffer so outward facing ones draw first
+ * clusters are cut where the cache restarts anyway and where their acmr stays within threshold, so the order of
+ * triangles inside a cluster is kept and the cache efficiency drops by at most threshold
+ */
+FOUR_ENGINE_API void OptimizeOverdraw(std::span<u32>              indices,
+                                      std::span<const MeshVertex> vertices,
+                                      f32                         threshold = OVERDRAW_THRESHOLD,
+                                      u32                         cacheSize = VERTEX_CACHE_SIZE);
+
+/**
+ * @brief reorder vertices in the order the index buffer first uses them and drop unused ones
+ * the vertex fetch then walks memory mostly forward. submesh vertex offsets are folded into the indices
+ */
+FOUR_ENGINE_API void OptimizeVertexFetch(MeshData& mesh);
+
+/**
+ * @brief simplify a triangle list into a chain of lods by quadric error edge collapse, Garland and Heckbert
+ * cheapest collapses go first and every level continues from the one before, so errors only grow. a vertex only
+ * collapses onto a neighbour, levels index the same vertices as the input; border and attribute seam vertices are
+ * kept, collapses that flip a triangle or pinch the surface are skipped
+ *
+ * @param levelCount levels to build after the full detail one, each keeping about ratio of the triangles before
+ * @return the levels, fewer when simplification stalls, see LOD_MIN_REDUCTION
+ */
+[[nodiscard]] FOUR_ENGINE_API std::vector<MeshLodLevel> SimplifyMesh(std::span<const u32>        indices,
+                                                                     std::span<const MeshVertex> vertices,
+                                                                     u32                         levelCount,
+                                                                     f32 ratio = LOD_TRIANGLE_RATIO);
+
+/**
+ * @brief deduplicate, then optimize every submesh for the vertex cache and overdraw, then the vertex fetch
+ *
+ * @return cache stats of the whole index buffer before and after
+ */
+FOUR_ENGINE_API MeshOptimizeStats OptimizeMesh(MeshData& mesh);
+
+} // namespace four
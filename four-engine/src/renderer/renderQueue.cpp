@@ -0,0 +1,89 @@
+#include "four-pch.hpp"
+
+#include "renderer/renderQueue.hpp"
+
+#include "core/profiler.hpp"
+
+namespace four
+{
+
+//===============================================================================
+void RenderQueue::Sort()
+{
+  FOUR_PROFILE_FUNCTION();
+
+  const auto count = static_cast<u32>(m_Entries.size());
+  if (count < RENDER_QUEUE_RADIX_MIN)
+  {
+    std::ranges::stable_sort(m_Entries, {}, &RenderQueueEntry::key);
+    return;
+  }
+
+  // histograms of all eight bytes in one pass over the keys
+  constexpr u32                                passes  = sizeof(u64);
+  constexpr u32                                buckets = 256;
+  std::array<std::array<u32, buckets>, passes> histograms{};
+  for (const RenderQueueEntry& entry : m_Entries)
+  {
+    for (u32 pass = 0; pass < passes; ++pass)
+    {
+      ++histograms[pass][(entry.key >> (pass * 8)) & 0xFF];
+    }
+  }
+
+  m_Scratch.resize(count);
+  for (u32 pass = 0; pass < passes; ++pass)
+  {
+    auto& histogram = histograms[pass];
+
+    // every key has the same byte, the pass would not move anything
+    if (histogram[(m_Entries[0].key >> (pass * 8)) & 0xFF] == count)
+    {
+      continue;
+    }
+
+    u32 offset = 0;
+    for (u32& bucket : histogram)
+    {
+      const u32 size = bucket;
+      bucket         = offset;
+      offset += size;
+    }
+
+    // forward scatter keeps equal bytes in order, which makes the whole sort stable
+    for (const RenderQueueEntry& entry : m_Entries)
+    {
+      m_Scratch[histogram[(entry.key >> (pass * 8)) & 0xFF]++] = entry;
+    }
+    m_Entries.swap(m_Scratch);
+  }
+}
+
+//===============================================================================
+void RenderQueue::Build()
+{
+  Sort();
+
+  m_Batches.clear();
+  m_Stats = {.requests = static_cast<u32>(m_Entries.size())};
+  for (u32 i = 0; i < m_Entries.size(); ++i)
+  {
+    const u64 key = m_Entries[i].key & RenderKey::BatchMask;
+    if (!m_Batches.empty() && m_Batches.back().key == key)
+    {
+      ++m_Batches.back().count;
+      continue;
+    }
+
+    if (!m_Batches.empty())
+    {
+      const u64 previous = m_Batches.back().key;
+      m_Stats.pipelineChanges += RenderKey::GetPipeline(previous) != RenderKey::GetPipeline(key) ? 1 : 0;
+      m_Stats.materialChanges += RenderKey::GetMaterial(previous) != RenderKey::GetMaterial(key) ? 1 : 0;
+    }
+    m_Batches.push_back({.key = key, .first = i, .count = 1});
+  }
+  m_Stats.batches = static_cast<u32>(m_Batches.size());
+}
+
+} // namespace four
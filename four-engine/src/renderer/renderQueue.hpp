@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include <span>
+
+namespace four
+{
+
+constexpr u32 RENDER_QUEUE_RADIX_MIN = 256; // smaller queues are sorted with std::stable_sort
+
+/**
+ * @brief 64-bit sort key of a draw, most significant field first
+ *
+ *   | pipeline 12 | material 20 | mesh 20 | order 12 |
+ *
+ * sorting the keys groups draws by pipeline, then material, then mesh, so state changes happen once per group.
+ * order is free for the caller (front to back depth, layer), it sorts within a mesh and is ignored for batching.
+ */
+struct RenderKey
+{
+  static constexpr u32 PipelineBits = 12;
+  static constexpr u32 MaterialBits = 20;
+  static constexpr u32 MeshBits     = 20;
+  static constexpr u32 OrderBits    = 12;
+
+  static constexpr u32 MeshShift     = OrderBits;
+  static constexpr u32 MaterialShift = MeshShift + MeshBits;
+  static constexpr u32 PipelineShift = MaterialShift + MaterialBits;
+
+  // draws whose keys are equal under the mask can be one instanced draw
+  static constexpr u64 BatchMask = ~((u64{1} << OrderBits) - 1);
+
+  static_assert(PipelineShift + PipelineBits == 64);
+
+  /**
+   * @brief fields wider than their bits are truncated
+   */
+  [[nodiscard]] static constexpr u64 Make(u32 pipeline, u32 material, u32 mesh, u32 order = 0)
+  {
+    return (static_cast<u64>(pipeline & Mask(PipelineBits)) << PipelineShift) |
+           (static_cast<u64>(material & Mask(MaterialBits)) << MaterialShift) |
+           (static_cast<u64>(mesh & Mask(MeshBits)) << MeshShift) | (order & Mask(OrderBits));
+  }
+
+  [[nodiscard]] static constexpr u32 GetPipeline(u64 key)
+  {
+    return static_cast<u32>(key >> PipelineShift) & Mask(PipelineBits);
+  }
+
+  [[nodiscard]] static constexpr u32 GetMaterial(u64 key)
+  {
+    return static_cast<u32>(key >> MaterialShift) & Mask(MaterialBits);
+  }
+
+  [[nodiscard]] static constexpr u32 GetMesh(u64 key)
+  {
+    return static_cast<u32>(key >> MeshShift) & Mask(MeshBits);
+  }
+
+private:
+  [[nodiscard]] static constexpr u32 Mask(u32 bits)
+  {
+    return (1U << bits) - 1;
+  }
+};
+
+/**
+ * @brief draw request, item is the index of the draw in the caller's own list
+ */
+struct RenderQueueEntry
+{
+  u64 key{0};
+  u32 item{0};
+};
+
+/**
+ * @brief run of sorted entries with the same key under RenderKey::BatchMask, drawn as one instanced draw
+ * the instances are the sorted entries [first, first + count), write instance data in sorted order and use
+ * first as firstInstance
+ */
+struct RenderBatch
+{
+  u64 key{0};
+  u32 first{0};
+  u32 count{0};
+};
+
+/**
+ * @brief numbers of the last Build, state changes are counted between consecutive batches
+ */
+struct RenderQueueStats
+{
+  u32 requests{0};
+  u32 batches{0};
+  u32 pipelineChanges{0};
+  u32 materialChanges{0};
+};
+
+/**
+ * @brief Collects draw requests of a frame, sorts them by key and merges runs of the same mesh into batches
+ * keys are sorted with a stable LSD radix sort, one counting pass for all eight bytes, passes whose byte is the same
+ * for every key are skipped, so unused high key bits cost nothing. not thread safe, one queue per recording thread.
+ */
+class FOUR_ENGINE_API RenderQueue
+{
+public:
+  void Clear()
+  {
+    m_Entries.clear();
+    m_Batches.clear();
+  }
+
+  void Push(u64 key, u32 item)
+  {
+    m_Entries.push_back({.key = key, .item = item});
+  }
+
+  [[nodiscard]] u32 GetSize() const
+  {
+    return static_cast<u32>(m_Entries.size());
+  }
+
+  /**
+   * @brief sort the entries by key, entries with equal keys keep their push order
+   */
+  void Sort();
+
+  /**
+   * @brief sort, then merge equal keys under RenderKey::BatchMask into batches
+   */
+  void Build();
+
+  /**
+   * @brief entries in key order after Sort or Build
+   */
+  [[nodiscard]] std::span<const RenderQueueEntry> GetEntries() const
+  {
+    return m_Entries;
+  }
+
+  /**
+   * @brief batches of the last Build in key order
+   */
+  [[nodiscard]] std::span<const RenderBatch> GetBatches() const
+  {
+    return m_Batches;
+  }
+
+  [[nodiscard]] const RenderQueueStats& GetStats() const
+  {
+    return m_Stats;
+  }
+
+private:
+  std::vector<RenderQueueEntry> m_Entries;
+  std::vector<RenderQueueEntry> m_Scratch; // radix passes ping-pong between the two
+  std::vector<RenderBatch>      m_Batches;
+  RenderQueueStats              m_Stats;
+};
+
+} // namespace four
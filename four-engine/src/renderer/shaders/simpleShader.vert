@@ -1,10 +1,27 @@
-#version 450
+#version 460
 
-layout (binding = 0) uniform UniformBufferObject {
-  mat4 model;
+layout (set = 0, binding = 0) uniform CameraUniforms {
   mat4 view;
   mat4 proj;
-} ubo;
+  mat4 viewProj;
+} camera;
+
+struct ObjectData {
+  mat4 model;
+  vec4 boundingSphere;
+  uint indexCount;
+  uint firstIndex;
+  int  vertexOffset;
+  uint textureIndex;
+  uint firstMeshlet;
+  uint meshletCount;
+};
+
+// set 1 is the bindless table, set 2 the objects of the frame in draw order
+// the cpu path draws object i with firstInstance i, the gpu driven path gets it from cull.comp
+layout(std430, set = 2, binding = 0) readonly buffer ObjectBuffer {
+  ObjectData objects[];
+};
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
@@ -12,9 +29,11 @@ layout(location = 2) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTextureIndex;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = camera.viewProj * objects[gl_InstanceIndex].model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    fragTextureIndex = objects[gl_InstanceIndex].textureIndex;
 }
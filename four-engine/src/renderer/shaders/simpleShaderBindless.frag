@@ -0,0 +1,15 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTextureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+// bindless table, every registered texture, indexed by the draw
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+void main() {
+    outColor = vec4(fragColor * texture(textures[nonuniformEXT(fragTextureIndex)], fragTexCoord).rgb, 1.0);
+}
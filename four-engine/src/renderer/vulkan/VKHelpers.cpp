@@ -1,6 +1,7 @@
 #include "renderer/vulkan/VKHelpers.hpp"
 
 #include <fstream>
+#include <utility>
 
 namespace four::vkUtils
 {
@@ -32,4 +33,96 @@ vk::PipelineShaderStageCreateInfo PipelineShaderStageCreateInfo(vk::ShaderStageF
 {
   return {.stage = stage, .module = shaderModule, .pName = entry};
 }
+
+VKDeviceProperties QueryDeviceProperties(vk::PhysicalDevice physicalDevice)
+{
+  static_assert(sizeof(VKDeviceLimits) == sizeof(VkPhysicalDeviceLimits), "VKDeviceLimits must mirror VkPhysicalDeviceLimits");
+
+  const auto properties = physicalDevice.getProperties();
+
+  VKDeviceProperties result{};
+  result.vulkan_api_version = properties.apiVersion;
+  result.driver_version     = properties.driverVersion;
+  result.vendor_id          = properties.vendorID;
+  result.device_id          = properties.deviceID;
+  result.device_type        = static_cast<VKDeviceType>(properties.deviceType);
+  result.device_name        = properties.deviceName.data();
+
+  // uuid as hex, so it can be compared and written as plain text
+  constexpr std::string_view hexDigits = "0123456789abcdef";
+  result.pipeline_cache_uuid.reserve(2 * VK_UUID_SIZE);
+  for (const u8 byte : properties.pipelineCacheUUID)
+  {
+    result.pipeline_cache_uuid.push_back(hexDigits[byte >> 4]);
+    result.pipeline_cache_uuid.push_back(hexDigits[byte & 0xF]);
+  }
+
+  const VkPhysicalDeviceLimits& limits = properties.limits;
+  memcpy(&result.limits, &limits, sizeof(VKDeviceLimits));
+
+  for (const auto& family : physicalDevice.getQueueFamilyProperties())
+  {
+    if ((family.queueFlags & vk::QueueFlagBits::eCompute) && !(family.queueFlags & vk::QueueFlagBits::eGraphics))
+    {
+      result.compute_queue_count += family.queueCount;
+    }
+    if ((family.queueFlags & vk::QueueFlagBits::eTransfer) &&
+        !(family.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)))
+    {
+      result.transfer_queue_count += family.queueCount;
+    }
+  }
+
+  // mesh shader limits, only filled when the device exposes VK_EXT_mesh_shader with the mesh stage enabled
+  const auto extensions = physicalDevice.enumerateDeviceExtensionProperties();
+  if (std::ranges::any_of(extensions,
+                          [](const vk::ExtensionProperties& extension)
+                          { return std::string_view{extension.extensionName} == VK_EXT_MESH_SHADER_EXTENSION_NAME; }))
+  {
+    vk::PhysicalDeviceMeshShaderFeaturesEXT meshFeatures{};
+    vk::PhysicalDeviceFeatures2             features{.pNext = &meshFeatures};
+    physicalDevice.getFeatures2(&features);
+
+    vk::PhysicalDeviceMeshShaderPropertiesEXT mesh{};
+    vk::PhysicalDeviceProperties2             properties2{.pNext = &mesh};
+    physicalDevice.getProperties2(&properties2);
+    if (meshFeatures.meshShader == VK_TRUE)
+    {
+      const auto toBool = [](vk::Bool32 value) { return value == VK_TRUE ? b8{1} : b8{0}; };
+      result.mesh_shader_properties = VKMeshShaderProperties{
+        .max_task_work_group_total_count           = mesh.maxTaskWorkGroupTotalCount,
+        .max_task_work_group_count                 = mesh.maxTaskWorkGroupCount,
+        .max_task_work_group_invocations           = mesh.maxTaskWorkGroupInvocations,
+        .max_task_work_group_size                  = mesh.maxTaskWorkGroupSize,
+        .max_task_payload_size                     = mesh.maxTaskPayloadSize,
+        .max_task_shared_memory_size               = mesh.maxTaskSharedMemorySize,
+        .max_task_payload_and_shared_memory_size   = mesh.maxTaskPayloadAndSharedMemorySize,
+        .max_mesh_work_group_total_count           = mesh.maxMeshWorkGroupTotalCount,
+        .max_mesh_work_group_count                 = mesh.maxMeshWorkGroupCount,
+        .max_mesh_work_group_invocations           = mesh.maxMeshWorkGroupInvocations,
+        .max_mesh_work_group_size                  = mesh.maxMeshWorkGroupSize,
+        .max_mesh_shared_memory_size               = mesh.maxMeshSharedMemorySize,
+        .max_mesh_payload_and_shared_memory_size   = mesh.maxMeshPayloadAndSharedMemorySize,
+        .max_mesh_output_memory_size               = mesh.maxMeshOutputMemorySize,
+        .max_mesh_payload_and_output_memory_size   = mesh.maxMeshPayloadAndOutputMemorySize,
+        .max_mesh_output_components                = mesh.maxMeshOutputComponents,
+        .max_mesh_output_vertices                  = mesh.maxMeshOutputVertices,
+        .max_mesh_output_primitives                = mesh.maxMeshOutputPrimitives,
+        .max_mesh_output_layers                    = mesh.maxMeshOutputLayers,
+        .max_mesh_multiview_view_count             = mesh.maxMeshMultiviewViewCount,
+        .mesh_output_per_vertex_granularity        = mesh.meshOutputPerVertexGranularity,
+        .mesh_output_per_primitive_granularity     = mesh.meshOutputPerPrimitiveGranularity,
+        .max_preferred_task_work_group_invocations = mesh.maxPreferredTaskWorkGroupInvocations,
+        .max_preferred_mesh_work_group_invocations = mesh.maxPreferredMeshWorkGroupInvocations,
+        .prefers_local_invocation_vertex_output    = toBool(mesh.prefersLocalInvocationVertexOutput),
+        .prefers_local_invocation_primitive_output = toBool(mesh.prefersLocalInvocationPrimitiveOutput),
+        .prefers_compact_vertex_output             = toBool(mesh.prefersCompactVertexOutput),
+        .prefers_compact_primitive_output          = toBool(mesh.prefersCompactPrimitiveOutput)};
+      // flags enum has no operators, combine through the underlying type so other implicit features are kept
+      result.implicit_features = static_cast<VKImplicitFeatureFlags>(
+        std::to_underlying(result.implicit_features) | std::to_underlying(VKImplicitFeatureFlags::Mesh_shader));
+    }
+  }
+  return result;
+}
 } // namespace four::vkUtils
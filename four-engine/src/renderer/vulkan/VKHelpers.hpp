@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include "renderer/vulkan/VKTypes.hpp"
+
 namespace four::vkUtils
 {
 //===============================================================================
@@ -14,4 +16,7 @@ vk::PipelineShaderStageCreateInfo PipelineShaderStageCreateInfo(vk::ShaderStageF
                                                                 vk::ShaderModule        shaderModule,
                                                                 const char*             entry = "main");
 
+// fill engine side properties of a physical device, optional extension properties are left empty
+VKDeviceProperties QueryDeviceProperties(vk::PhysicalDevice physicalDevice);
+
 } // namespace four::vkUtils
@@ -3,6 +3,10 @@
 #include "core/type.hpp"
 #include <vulkan/vulkan.hpp>
 
+#include <array>
+#include <limits>
+#include <optional>
+
 namespace four
 {
 enum class VKDeviceType : u8
@@ -321,58 +325,6 @@ constexpr VKQueue VKCompute_7{.family = VKQueueFamily::Compute, .index = 7};
 constexpr VKQueue VKTransfer_0{.family = VKQueueFamily::Transfer, .index = 0};
 constexpr VKQueue VKTransfer_1{.family = VKQueueFamily::Transfer, .index = 1};
 
-struct VKCommandSubmitInfo
-{
-  VKQueue                        queue;
-  vk::PipelineStageFlags         wait_stages;
-  VKExecutableCommandList const* command_lists;
-  u64                            command_list_count;
-  VKBinarySemaphore const*       wait_binary_semaphores;
-  u64                            wait_binary_semaphore_count;
-  VKBinarySemaphore const*       signal_binary_semaphores;
-  u64                            signal_binary_semaphore_count;
-  VKTimelinePair const*          wait_timeline_semaphores;
-  u64                            wait_timeline_semaphore_count;
-  VKTimelinePair const*          signal_timeline_semaphores;
-  u64                            signal_timeline_semaphore_count;
-};
-
-typedef struct VKPresentInfo
-{
-  VKBinarySemaphore const* wait_binary_semaphores;
-  u64                      wait_binary_semaphore_count;
-  VKSwapchain              swapchain;
-  VKQueue                  queue;
-};
-
-struct VKMemoryBlockBufferInfo
-{
-  VKBufferInfo   buffer_info;
-  VKMemoryBlock* memory_block;
-  std::size_t    offset;
-};
-
-struct VKMemoryBlockImageInfo
-{
-  VKImageInfo    image_info;
-  VKMemoryBlock* memory_block;
-  std::size_t    offset;
-};
-
-struct VKBufferTlasInfo
-{
-  VKTlasInfo tlas_info;
-  VKBufferId buffer_id;
-  u64        offset;
-};
-
-struct VKBufferBlasInfo
-{
-  VKBlasInfo blas_info;
-  VKBufferId buffer_id;
-  u64        offset;
-};
-
 struct VKAccelerationStructureBuildSizesInfo
 {
   u64 acceleration_structure_size;
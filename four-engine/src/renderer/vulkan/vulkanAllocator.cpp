@@ -0,0 +1,209 @@
+#include "four-pch.hpp"
+
+#define VMA_IMPLEMENTATION
+#include "renderer/vulkan/vulkanAllocator.hpp"
+
+namespace four
+{
+
+//===============================================================================
+VulkanAllocator::~VulkanAllocator()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanAllocator::Init(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device)
+{
+  const VmaAllocatorCreateInfo createInfo{
+    .physicalDevice   = static_cast<VkPhysicalDevice>(physicalDevice),
+    .device           = static_cast<VkDevice>(device),
+    .instance         = static_cast<VkInstance>(instance),
+    .vulkanApiVersion = VK_API_VERSION_1_3,
+  };
+  if (vmaCreateAllocator(&createInfo, &m_Allocator) != VK_SUCCESS)
+  {
+    LOG_CORE_ERROR("failed to create vulkan memory allocator!");
+    return false;
+  }
+
+  for (u8 usage = 0; usage < static_cast<u8>(MemoryUsage::Count); ++usage)
+  {
+    if (!CreatePool(static_cast<MemoryUsage>(usage)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//===============================================================================
+void VulkanAllocator::Shutdown()
+{
+  if (m_Allocator == nullptr)
+  {
+    return;
+  }
+
+  for (auto& pool : m_BufferPools)
+  {
+    if (pool != nullptr)
+    {
+      vmaDestroyPool(m_Allocator, pool);
+      pool = nullptr;
+    }
+  }
+  vmaDestroyAllocator(m_Allocator);
+  m_Allocator = nullptr;
+}
+
+//===============================================================================
+VmaAllocationCreateInfo VulkanAllocator::GetAllocationCreateInfo(MemoryUsage memoryUsage)
+{
+  switch (memoryUsage)
+  {
+    case MemoryUsage::Upload:
+      return {.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+              .usage = VMA_MEMORY_USAGE_AUTO,
+              .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+    case MemoryUsage::Readback:
+      return {.flags          = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+              .usage          = VMA_MEMORY_USAGE_AUTO,
+              .requiredFlags  = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+              .preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+    case MemoryUsage::GpuOnly:
+    default:
+      return {.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE};
+  }
+}
+
+//===============================================================================
+bool VulkanAllocator::CreatePool(MemoryUsage memoryUsage)
+{
+  // representative buffer to find memory type of the pool
+  constexpr auto commonUsage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst |
+                               vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer |
+                               vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
+                               vk::BufferUsageFlagBits::eIndirectBuffer;
+  const VkBufferCreateInfo sampleBufferInfo = vk::BufferCreateInfo{
+    .size        = 1024,
+    .usage       = commonUsage,
+    .sharingMode = vk::SharingMode::eExclusive,
+  };
+  const VmaAllocationCreateInfo allocInfo = GetAllocationCreateInfo(memoryUsage);
+
+  u32 memoryTypeIndex{0};
+  if (vmaFindMemoryTypeIndexForBufferInfo(m_Allocator, &sampleBufferInfo, &allocInfo, &memoryTypeIndex) != VK_SUCCESS)
+  {
+    LOG_CORE_ERROR("failed to find memory type for memory pool: {}", static_cast<u8>(memoryUsage));
+    return false;
+  }
+
+  // readback buffers are rare and small, no need for the default 256MB blocks
+  const VmaPoolCreateInfo poolInfo{
+    .memoryTypeIndex = memoryTypeIndex,
+    .blockSize       = memoryUsage == MemoryUsage::Readback ? 16ULL * 1024 * 1024 : 0,
+  };
+  if (vmaCreatePool(m_Allocator, &poolInfo, &m_BufferPools[static_cast<std::size_t>(memoryUsage)]) != VK_SUCCESS)
+  {
+    LOG_CORE_ERROR("failed to create memory pool: {}", static_cast<u8>(memoryUsage));
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+AllocatedBuffer VulkanAllocator::CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, MemoryUsage memoryUsage)
+{
+  const VkBufferCreateInfo bufferInfo = vk::BufferCreateInfo{
+    .size        = size,
+    .usage       = usage,
+    .sharingMode = vk::SharingMode::eExclusive,
+  };
+  VmaAllocationCreateInfo allocInfo = GetAllocationCreateInfo(memoryUsage);
+  allocInfo.pool                    = m_BufferPools[static_cast<std::size_t>(memoryUsage)];
+
+  VkBuffer          buffer{VK_NULL_HANDLE};
+  AllocatedBuffer   result{.size = size};
+  VmaAllocationInfo resultInfo{};
+  VkResult          vkResult = vmaCreateBuffer(m_Allocator, &bufferInfo, &allocInfo, &buffer, &result.allocation, &resultInfo);
+  if (vkResult != VK_SUCCESS)
+  {
+    // buffer usage may not be compatible with memory type of the pool, let VMA pick one
+    allocInfo.pool = nullptr;
+    vkResult       = vmaCreateBuffer(m_Allocator, &bufferInfo, &allocInfo, &buffer, &result.allocation, &resultInfo);
+  }
+  if (vkResult != VK_SUCCESS)
+  {
+    LOG_CORE_ERROR("failed to allocate buffer memory!");
+    throw std::runtime_error("failed to allocate buffer memory!");
+  }
+
+  result.buffer = vk::Buffer{buffer};
+  result.mapped = resultInfo.pMappedData;
+  return result;
+}
+
+//===============================================================================
+void VulkanAllocator::DestroyBuffer(AllocatedBuffer& buffer)
+{
+  if (buffer.allocation != nullptr)
+  {
+    vmaDestroyBuffer(m_Allocator, static_cast<VkBuffer>(buffer.buffer), buffer.allocation);
+  }
+  buffer = {};
+}
+
+//===============================================================================
+AllocatedImage VulkanAllocator::CreateImage(const vk::ImageCreateInfo& createInfo, MemoryUsage memoryUsage)
+{
+  const VkImageCreateInfo       imageInfo = createInfo;
+  const VmaAllocationCreateInfo allocInfo = GetAllocationCreateInfo(memoryUsage);
+
+  VkImage        image{VK_NULL_HANDLE};
+  AllocatedImage result{};
+  if (vmaCreateImage(m_Allocator, &imageInfo, &allocInfo, &image, &result.allocation, nullptr) != VK_SUCCESS)
+  {
+    LOG_CORE_ERROR("failed to allocate image memory!");
+    throw std::runtime_error("failed to allocate image memory!");
+  }
+  result.image = vk::Image{image};
+  return result;
+}
+
+//===============================================================================
+void VulkanAllocator::DestroyImage(AllocatedImage& image)
+{
+  if (image.allocation != nullptr)
+  {
+    vmaDestroyImage(m_Allocator, static_cast<VkImage>(image.image), image.allocation);
+  }
+  image.image      = nullptr;
+  image.allocation = nullptr;
+}
+
+//===============================================================================
+void VulkanAllocator::Flush(const AllocatedBuffer& buffer, vk::DeviceSize offset, vk::DeviceSize size) const
+{
+  vmaFlushAllocation(m_Allocator, buffer.allocation, offset, size);
+}
+
+//===============================================================================
+void VulkanAllocator::Invalidate(const AllocatedBuffer& buffer, vk::DeviceSize offset, vk::DeviceSize size) const
+{
+  vmaInvalidateAllocation(m_Allocator, buffer.allocation, offset, size);
+}
+
+//===============================================================================
+void VulkanAllocator::LogStatistics() const
+{
+  VmaTotalStatistics stats{};
+  vmaCalculateStatistics(m_Allocator, &stats);
+  LOG_CORE_INFO("vma: {} blocks, {} allocations, {} bytes used of {} bytes reserved",
+                stats.total.statistics.blockCount,
+                stats.total.statistics.allocationCount,
+                stats.total.statistics.allocationBytes,
+                stats.total.statistics.blockBytes);
+}
+
+} // namespace four
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include <vk_mem_alloc.h>
+
+namespace four
+{
+
+/**
+ * @brief how a resource memory is going to be accessed
+ * each usage is backed by its own VMA pool so resources of the same kind share memory blocks
+ */
+enum class MemoryUsage : u8
+{
+  GpuOnly  = 0, // device local, never touched by host (vertex, index, textures, render targets)
+  Upload   = 1, // host visible, sequential writes from cpu (staging, uniforms)
+  Readback = 2, // host visible and cached, written by gpu and read back on cpu
+  Count    = 3,
+};
+
+struct AllocatedBuffer
+{
+  vk::Buffer     buffer;
+  VmaAllocation  allocation{nullptr};
+  vk::DeviceSize size{0};
+  void*          mapped{nullptr}; // persistently mapped pointer, only for Upload and Readback usage
+};
+
+struct AllocatedImage
+{
+  vk::Image     image;
+  VmaAllocation allocation{nullptr};
+  vk::ImageView ImageView;
+};
+
+/**
+ * @brief Allocator layer on top of VulkanMemoryAllocator
+ * every buffer and image of the renderer get sub-allocated from large memory blocks
+ * instead of calling vkAllocateMemory per resource
+ */
+class FOUR_ENGINE_API VulkanAllocator
+{
+public:
+  VulkanAllocator() = default;
+  ~VulkanAllocator();
+
+  VulkanAllocator(const VulkanAllocator&)            = delete;
+  VulkanAllocator(VulkanAllocator&&)                 = delete;
+  VulkanAllocator& operator=(const VulkanAllocator&) = delete;
+  VulkanAllocator& operator=(VulkanAllocator&&)      = delete;
+
+  /**
+   * @brief create VMA allocator and per usage pools
+   *
+   * @param instance vulkan instance
+   * @param physicalDevice physical device used by the renderer
+   * @param device logical device
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device);
+
+  /**
+   * @brief destroy pools and allocator, all resources should be destroyed before calling this
+   */
+  void Shutdown();
+
+  /**
+   * @brief create buffer and sub-allocate memory for it from the pool of requested usage
+   * exception on failure
+   *
+   * @param size size of the buffer in bytes
+   * @param usage vulkan usage of the buffer
+   * @param memoryUsage memory usage class, Upload and Readback buffers are persistently mapped
+   * @return created buffer
+   */
+  [[nodiscard]] AllocatedBuffer CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, MemoryUsage memoryUsage);
+
+  /**
+   * @brief destroy buffer and free its allocation
+   *
+   * @param buffer buffer to destroy, reset to empty after call
+   */
+  void DestroyBuffer(AllocatedBuffer& buffer);
+
+  /**
+   * @brief create image and sub-allocate memory for it
+   * exception on failure
+   *
+   * @param createInfo image create info
+   * @param memoryUsage memory usage class
+   * @return created image ( image view is not created )
+   */
+  [[nodiscard]] AllocatedImage CreateImage(const vk::ImageCreateInfo& createInfo, MemoryUsage memoryUsage = MemoryUsage::GpuOnly);
+
+  /**
+   * @brief destroy image and free its allocation ( image view is not destroyed )
+   *
+   * @param image image to destroy, reset to empty after call
+   */
+  void DestroyImage(AllocatedImage& image);
+
+  /**
+   * @brief flush host writes of mapped buffer, no-op on coherent memory
+   */
+  void Flush(const AllocatedBuffer& buffer, vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+  /**
+   * @brief invalidate mapped buffer before reading gpu writes, no-op on coherent memory
+   */
+  void Invalidate(const AllocatedBuffer& buffer, vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+  /**
+   * @brief log block and allocation count of each heap
+   */
+  void LogStatistics() const;
+
+  [[nodiscard]] VmaAllocator GetHandle() const
+  {
+    return m_Allocator;
+  }
+
+private:
+  [[nodiscard]] bool CreatePool(MemoryUsage memoryUsage);
+
+  [[nodiscard]] static VmaAllocationCreateInfo GetAllocationCreateInfo(MemoryUsage memoryUsage);
+
+private:
+  VmaAllocator                                                      m_Allocator{nullptr};
+  std::array<VmaPool, static_cast<std::size_t>(MemoryUsage::Count)> m_BufferPools{};
+};
+
+} // namespace four
@@ -0,0 +1,218 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanBindlessTable.hpp"
+
+namespace four
+{
+
+//===============================================================================
+u32 VulkanBindlessTable::Slots::Acquire()
+{
+  if (!free.empty())
+  {
+    const u32 index = free.back();
+    free.pop_back();
+    return index;
+  }
+  return next < capacity ? next++ : InvalidIndex;
+}
+
+//===============================================================================
+VulkanBindlessTable::~VulkanBindlessTable()
+{
+  Shutdown();
+}
+
+//===============================================================================
+VKMissingFeatureFlags VulkanBindlessTable::FindMissingFeature(const vk::PhysicalDeviceVulkan12Features& supported)
+{
+  using enum VKMissingFeatureFlags;
+  const std::array<std::pair<vk::Bool32, VKMissingFeatureFlags>, 7> required{{
+    {supported.shaderSampledImageArrayNonUniformIndexing, Shader_sampled_image_array_non_uniform_indexing},
+    {supported.shaderStorageBufferArrayNonUniformIndexing, Shader_storage_buffer_array_non_uniform_indexing},
+    {supported.descriptorBindingSampledImageUpdateAfterBind, Descriptor_binding_sampled_image_update_after_bind},
+    {supported.descriptorBindingStorageBufferUpdateAfterBind, Descriptor_binding_storage_buffer_update_after_bind},
+    {supported.descriptorBindingUpdateUnusedWhilePending, Descriptor_binding_update_unused_while_pending},
+    {supported.descriptorBindingPartiallyBound, Descriptor_binding_partially_bound},
+    {supported.runtimeDescriptorArray, Runtime_descriptor_array},
+  }};
+
+  for (const auto& [enabled, feature] : required)
+  {
+    if (enabled != VK_TRUE)
+    {
+      return feature;
+    }
+  }
+  return None;
+}
+
+//===============================================================================
+void VulkanBindlessTable::EnableFeatures(vk::PhysicalDeviceVulkan12Features& features)
+{
+  features.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+  features.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+  features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+  features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+  features.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+  features.descriptorBindingPartiallyBound               = VK_TRUE;
+  features.runtimeDescriptorArray                        = VK_TRUE;
+}
+
+//===============================================================================
+bool VulkanBindlessTable::Init(vk::Device         device,
+                               vk::PhysicalDevice physicalDevice,
+                               u32                maxTextures,
+                               u32                maxBuffers,
+                               u32                frameCount)
+{
+  m_Device = device;
+
+  vk::PhysicalDeviceDescriptorIndexingProperties indexing{};
+  vk::PhysicalDeviceProperties2                  properties{.pNext = &indexing};
+  physicalDevice.getProperties2(&properties);
+
+  m_Textures = {.capacity = std::min({maxTextures,
+                                      indexing.maxDescriptorSetUpdateAfterBindSampledImages,
+                                      indexing.maxPerStageDescriptorUpdateAfterBindSampledImages})};
+  m_Buffers  = {.capacity = std::min({maxBuffers,
+                                      indexing.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                      indexing.maxPerStageDescriptorUpdateAfterBindStorageBuffers})};
+  m_Textures.released.resize(frameCount);
+  m_Buffers.released.resize(frameCount);
+
+  // slots are written while the set is bound by frames in flight, and most of them are never written at all
+  constexpr vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                      vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                      vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+  const std::array flags{bindingFlags, bindingFlags};
+
+  using DSLB = vk::DescriptorSetLayoutBinding;
+  const std::array bindings{
+    DSLB{.binding         = TextureBinding,
+         .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+         .descriptorCount = m_Textures.capacity,
+         .stageFlags      = vk::ShaderStageFlagBits::eAll},
+    DSLB{.binding         = BufferBinding,
+         .descriptorType  = vk::DescriptorType::eStorageBuffer,
+         .descriptorCount = m_Buffers.capacity,
+         .stageFlags      = vk::ShaderStageFlagBits::eAll},
+  };
+  const std::array poolSizes{
+    vk::DescriptorPoolSize{.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = m_Textures.capacity},
+    vk::DescriptorPoolSize{.type = vk::DescriptorType::eStorageBuffer, .descriptorCount = m_Buffers.capacity},
+  };
+
+  try
+  {
+    const vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{.bindingCount  = static_cast<u32>(flags.size()),
+                                                                  .pBindingFlags = flags.data()};
+    m_SetLayout = m_Device.createDescriptorSetLayout({.pNext        = &flagsInfo,
+                                                      .flags        = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+                                                      .bindingCount = static_cast<u32>(bindings.size()),
+                                                      .pBindings    = bindings.data()});
+    m_Pool      = m_Device.createDescriptorPool({.flags         = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+                                                 .maxSets       = 1,
+                                                 .poolSizeCount = static_cast<u32>(poolSizes.size()),
+                                                 .pPoolSizes    = poolSizes.data()});
+    m_Set       = m_Device.allocateDescriptorSets({.descriptorPool     = m_Pool,
+                                                   .descriptorSetCount = 1,
+                                                   .pSetLayouts        = &m_SetLayout})[0];
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create bindless descriptor set!, exception: {0}", e.what());
+    return false;
+  }
+
+  LOG_CORE_INFO("bindless table with {} textures and {} storage buffers", m_Textures.capacity, m_Buffers.capacity);
+  return true;
+}
+
+//===============================================================================
+void VulkanBindlessTable::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  // set is freed with its pool
+  m_Device.destroyDescriptorPool(m_Pool);
+  m_Device.destroyDescriptorSetLayout(m_SetLayout);
+  m_Textures = {};
+  m_Buffers  = {};
+  m_Device   = nullptr;
+}
+
+//===============================================================================
+void VulkanBindlessTable::BeginFrame(u32 frameIndex)
+{
+  const std::scoped_lock lock(m_Mutex);
+  m_FrameIndex = frameIndex;
+  for (Slots* slots : {&m_Textures, &m_Buffers})
+  {
+    auto& released = slots->released[frameIndex];
+    slots->free.insert(slots->free.end(), released.begin(), released.end());
+    released.clear();
+  }
+}
+
+//===============================================================================
+u32 VulkanBindlessTable::RegisterTexture(vk::ImageView imageView, vk::Sampler sampler, vk::ImageLayout layout)
+{
+  const std::scoped_lock lock(m_Mutex);
+  const u32              index = m_Textures.Acquire();
+  if (index == InvalidIndex)
+  {
+    LOG_CORE_ERROR("bindless table is out of texture slots ( {} )", m_Textures.capacity);
+    return InvalidIndex;
+  }
+
+  const vk::DescriptorImageInfo imageInfo{.sampler = sampler, .imageView = imageView, .imageLayout = layout};
+  const vk::WriteDescriptorSet  write{.dstSet          = m_Set,
+                                      .dstBinding      = TextureBinding,
+                                      .dstArrayElement = index,
+                                      .descriptorCount = 1,
+                                      .descriptorType  = vk::DescriptorType::eCombinedImageSampler,
+                                      .pImageInfo      = &imageInfo};
+  m_Device.updateDescriptorSets(write, {});
+  return index;
+}
+
+//===============================================================================
+u32 VulkanBindlessTable::RegisterBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range)
+{
+  const std::scoped_lock lock(m_Mutex);
+  const u32              index = m_Buffers.Acquire();
+  if (index == InvalidIndex)
+  {
+    LOG_CORE_ERROR("bindless table is out of storage buffer slots ( {} )", m_Buffers.capacity);
+    return InvalidIndex;
+  }
+
+  const vk::DescriptorBufferInfo bufferInfo{.buffer = buffer, .offset = offset, .range = range};
+  const vk::WriteDescriptorSet   write{.dstSet          = m_Set,
+                                       .dstBinding      = BufferBinding,
+                                       .dstArrayElement = index,
+                                       .descriptorCount = 1,
+                                       .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                                       .pBufferInfo     = &bufferInfo};
+  m_Device.updateDescriptorSets(write, {});
+  return index;
+}
+
+//===============================================================================
+void VulkanBindlessTable::ReleaseTexture(u32 index)
+{
+  const std::scoped_lock lock(m_Mutex);
+  m_Textures.released[m_FrameIndex].push_back(index);
+}
+
+//===============================================================================
+void VulkanBindlessTable::ReleaseBuffer(u32 index)
+{
+  const std::scoped_lock lock(m_Mutex);
+  m_Buffers.released[m_FrameIndex].push_back(index);
+}
+
+} // namespace four
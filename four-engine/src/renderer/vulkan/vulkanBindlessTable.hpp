@@ -0,0 +1,130 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/VKTypes.hpp"
+
+#include <mutex>
+
+namespace four
+{
+
+/**
+ * @brief Bindless resource table built on descriptor indexing
+ * one update-after-bind descriptor set holds a partially bound runtime array of textures and one of storage buffers.
+ * resources are registered once and shaders reach them through the returned index, usually passed in push constants,
+ * so draws never switch descriptor sets and pools are never rebuilt when materials are added.
+ * released slots are recycled only after every frame in flight that could still read them has finished.
+ */
+class FOUR_ENGINE_API VulkanBindlessTable
+{
+public:
+  static constexpr u32 TextureBinding = 0; // sampler2D textures[]
+  static constexpr u32 BufferBinding  = 1; // buffer buffers[]
+  static constexpr u32 InvalidIndex   = std::numeric_limits<u32>::max();
+
+  VulkanBindlessTable() = default;
+  ~VulkanBindlessTable();
+
+  VulkanBindlessTable(const VulkanBindlessTable&)            = delete;
+  VulkanBindlessTable(VulkanBindlessTable&&)                 = delete;
+  VulkanBindlessTable& operator=(const VulkanBindlessTable&) = delete;
+  VulkanBindlessTable& operator=(VulkanBindlessTable&&)      = delete;
+
+  /**
+   * @brief first descriptor indexing feature the table needs that the device lacks
+   *
+   * @return VKMissingFeatureFlags::None when the table is supported
+   */
+  [[nodiscard]] static VKMissingFeatureFlags FindMissingFeature(const vk::PhysicalDeviceVulkan12Features& supported);
+
+  /**
+   * @brief turn on the descriptor indexing features the table needs, device must support them
+   */
+  static void EnableFeatures(vk::PhysicalDeviceVulkan12Features& features);
+
+  /**
+   * @brief create descriptor set layout, pool and the single bindless set
+   * capacities are clamped to the update-after-bind limits of the device
+   *
+   * @param device logical device, created with EnableFeatures
+   * @param physicalDevice physical device, used for limits
+   * @param maxTextures requested texture capacity
+   * @param maxBuffers requested storage buffer capacity
+   * @param frameCount number of frames in flight
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(vk::Device         device,
+                          vk::PhysicalDevice physicalDevice,
+                          u32                maxTextures,
+                          u32                maxBuffers,
+                          u32                frameCount);
+
+  /**
+   * @brief destroy set, pool and layout, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief frame fence was waited, slots released while this frame index was last recorded can be reused
+   */
+  void BeginFrame(u32 frameIndex);
+
+  /**
+   * @brief write texture into a free slot, thread safe
+   *
+   * @return index of the texture in textures[], InvalidIndex when the table is full
+   */
+  [[nodiscard]] u32 RegisterTexture(vk::ImageView   imageView,
+                                    vk::Sampler     sampler,
+                                    vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+  /**
+   * @brief write storage buffer range into a free slot, thread safe
+   *
+   * @return index of the buffer in buffers[], InvalidIndex when the table is full
+   */
+  [[nodiscard]] u32 RegisterBuffer(vk::Buffer buffer, vk::DeviceSize offset = 0, vk::DeviceSize range = VK_WHOLE_SIZE);
+
+  /**
+   * @brief release slot, reused once frames that may read it are done, thread safe
+   */
+  void ReleaseTexture(u32 index);
+  void ReleaseBuffer(u32 index);
+
+  [[nodiscard]] vk::DescriptorSetLayout GetSetLayout() const
+  {
+    return m_SetLayout;
+  }
+
+  [[nodiscard]] vk::DescriptorSet GetSet() const
+  {
+    return m_Set;
+  }
+
+private:
+  // slot allocator of one binding, never hands out a slot before its release is safe
+  struct Slots
+  {
+    u32                           capacity{0};
+    u32                           next{0};
+    std::vector<u32>              free;
+    std::vector<std::vector<u32>> released; // [frameIndex]
+
+    [[nodiscard]] u32 Acquire();
+  };
+
+private:
+  vk::Device              m_Device;
+  vk::DescriptorSetLayout m_SetLayout;
+  vk::DescriptorPool      m_Pool;
+  vk::DescriptorSet       m_Set;
+
+  std::mutex m_Mutex;
+  u32        m_FrameIndex{0};
+  Slots      m_Textures;
+  Slots      m_Buffers;
+};
+
+} // namespace four
@@ -0,0 +1,345 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanGpuCulling.hpp"
+
+#include "renderer/vulkan/VKHelpers.hpp"
+
+namespace four
+{
+
+namespace
+{
+constexpr u32 CullGroupSize    = 64;    // local_size_x of cull.comp and cullMeshlets.comp, meshlets per task
+constexpr u32 MaxMeshletTasks  = 65535; // smallest maxComputeWorkGroupCount[0] of any device
+constexpr u32 CullBindingCount = 5;     // objects, draws, counters, meshlets, tasks
+} // namespace
+
+//===============================================================================
+VulkanGpuCulling::~VulkanGpuCulling()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanGpuCulling::Init(vk::Device           device,
+                            VulkanAllocator&     allocator,
+                            u32                  frameCount,
+                            u32                  maxObjects,
+                            u32                  maxDraws,
+                            VulkanPipelineCache& pipelineCache)
+{
+  m_Device     = device;
+  m_Allocator  = &allocator;
+  m_MaxObjects = maxObjects;
+  m_MaxDraws   = maxDraws;
+
+  constexpr auto indirectUsage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer;
+  try
+  {
+    m_Frames.resize(frameCount);
+    for (auto& frame : m_Frames)
+    {
+      // objects are rewritten by cpu every frame, read by compute and vertex shader straight from mapped memory
+      frame.objectBuffer = m_Allocator->CreateBuffer(sizeof(GpuObjectData) * maxObjects,
+                                                     vk::BufferUsageFlagBits::eStorageBuffer,
+                                                     MemoryUsage::Upload);
+      frame.drawBuffer   = m_Allocator->CreateBuffer(sizeof(vk::DrawIndexedIndirectCommand) * maxDraws,
+                                                     indirectUsage,
+                                                     MemoryUsage::GpuOnly);
+      frame.countBuffer  = m_Allocator->CreateBuffer(sizeof(CullCounters),
+                                                     indirectUsage | vk::BufferUsageFlagBits::eTransferDst,
+                                                     MemoryUsage::GpuOnly);
+      frame.taskBuffer   = m_Allocator->CreateBuffer(sizeof(glm::uvec2) * MaxMeshletTasks,
+                                                     vk::BufferUsageFlagBits::eStorageBuffer,
+                                                     MemoryUsage::GpuOnly);
+    }
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create gpu culling buffers!, exception: {0}", e.what());
+    return false;
+  }
+
+  return CreateDescriptors() && CreatePipelines(pipelineCache);
+}
+
+//===============================================================================
+void VulkanGpuCulling::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  m_Device.destroyPipeline(m_Pipeline);
+  m_Device.destroyPipeline(m_MeshletPipeline);
+  m_Device.destroyPipelineLayout(m_PipelineLayout);
+  m_Device.destroyDescriptorPool(m_DescriptorPool);
+  m_Device.destroyDescriptorSetLayout(m_SetLayout);
+  for (auto& frame : m_Frames)
+  {
+    m_Allocator->DestroyBuffer(frame.objectBuffer);
+    m_Allocator->DestroyBuffer(frame.drawBuffer);
+    m_Allocator->DestroyBuffer(frame.countBuffer);
+    m_Allocator->DestroyBuffer(frame.taskBuffer);
+  }
+  m_Frames.clear();
+  m_Device = nullptr;
+}
+
+//===============================================================================
+bool VulkanGpuCulling::CreateDescriptors()
+{
+  // objects are also read by the indirect vertex shader, the rest only by the cull passes
+  using DSLB = vk::DescriptorSetLayoutBinding;
+  std::array<DSLB, CullBindingCount> bindings{};
+  for (u32 i = 0; i < CullBindingCount; ++i)
+  {
+    bindings[i] = DSLB{.binding         = i,
+                       .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                       .descriptorCount = 1,
+                       .stageFlags      = vk::ShaderStageFlagBits::eCompute};
+  }
+  bindings[0].stageFlags |= vk::ShaderStageFlagBits::eVertex;
+
+  const auto                   frameCount = static_cast<u32>(m_Frames.size());
+  const vk::DescriptorPoolSize poolSize{.type            = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = CullBindingCount * frameCount};
+  try
+  {
+    m_SetLayout      = m_Device.createDescriptorSetLayout({.bindingCount = static_cast<u32>(bindings.size()),
+                                                           .pBindings    = bindings.data()});
+    m_DescriptorPool = m_Device.createDescriptorPool({.maxSets = frameCount, .poolSizeCount = 1, .pPoolSizes = &poolSize});
+
+    const std::vector<vk::DescriptorSetLayout> layouts(frameCount, m_SetLayout);
+    const auto sets = m_Device.allocateDescriptorSets({.descriptorPool     = m_DescriptorPool,
+                                                       .descriptorSetCount = frameCount,
+                                                       .pSetLayouts        = layouts.data()});
+    for (u32 i = 0; i < frameCount; ++i)
+    {
+      auto& frame         = m_Frames[i];
+      frame.descriptorSet = sets[i];
+
+      // the meshlet buffer at binding 3 comes from SetMeshlets
+      const std::array bufferInfos{
+        vk::DescriptorBufferInfo{.buffer = frame.objectBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE},
+        vk::DescriptorBufferInfo{.buffer = frame.drawBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE},
+        vk::DescriptorBufferInfo{.buffer = frame.countBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE},
+      };
+      const vk::DescriptorBufferInfo taskInfo{.buffer = frame.taskBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE};
+      const std::array writes{
+        vk::WriteDescriptorSet{.dstSet          = frame.descriptorSet,
+                               .dstBinding      = 0,
+                               .dstArrayElement = 0,
+                               .descriptorCount = static_cast<u32>(bufferInfos.size()),
+                               .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                               .pBufferInfo     = bufferInfos.data()},
+        vk::WriteDescriptorSet{.dstSet          = frame.descriptorSet,
+                               .dstBinding      = 4,
+                               .dstArrayElement = 0,
+                               .descriptorCount = 1,
+                               .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                               .pBufferInfo     = &taskInfo},
+      };
+      m_Device.updateDescriptorSets(writes, {});
+    }
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create gpu culling descriptors!, exception: {0}", e.what());
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+bool VulkanGpuCulling::CreatePipelines(VulkanPipelineCache& pipelineCache)
+{
+  const vk::PushConstantRange pushConstant{.stageFlags = vk::ShaderStageFlagBits::eCompute,
+                                           .offset     = 0,
+                                           .size       = sizeof(CullConstants)};
+  try
+  {
+    m_PipelineLayout = m_Device.createPipelineLayout(
+      {.setLayoutCount = 1, .pSetLayouts = &m_SetLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstant});
+
+    m_Pipeline        = CreatePipeline(pipelineCache, "shaders/cull.comp.spv");
+    m_MeshletPipeline = CreatePipeline(pipelineCache, "shaders/cullMeshlets.comp.spv");
+    if (!m_Pipeline || !m_MeshletPipeline)
+    {
+      LOG_CORE_ERROR("failed to create cull pipeline!");
+      return false;
+    }
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create cull pipeline!, exception: {0}", e.what());
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+vk::Pipeline VulkanGpuCulling::CreatePipeline(VulkanPipelineCache& pipelineCache, const std::filesystem::path& path) const
+{
+  const auto                          shader = vkUtils::CreateShaderModule(path, m_Device);
+  const vk::ComputePipelineCreateInfo pipelineInfo{
+    .stage  = vkUtils::PipelineShaderStageCreateInfo(vk::ShaderStageFlagBits::eCompute, shader),
+    .layout = m_PipelineLayout,
+  };
+  const vk::Pipeline pipeline = pipelineCache.CreateComputePipeline(pipelineInfo);
+  m_Device.destroyShaderModule(shader);
+  return pipeline;
+}
+
+//===============================================================================
+void VulkanGpuCulling::SetMeshlets(vk::Buffer meshletBuffer)
+{
+  const vk::DescriptorBufferInfo info{.buffer = meshletBuffer, .offset = 0, .range = VK_WHOLE_SIZE};
+  for (const auto& frame : m_Frames)
+  {
+    const vk::WriteDescriptorSet write{.dstSet          = frame.descriptorSet,
+                                       .dstBinding      = 3,
+                                       .dstArrayElement = 0,
+                                       .descriptorCount = 1,
+                                       .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                                       .pBufferInfo     = &info};
+    m_Device.updateDescriptorSets(write, {});
+  }
+}
+
+//===============================================================================
+u32 VulkanGpuCulling::UpdateObjects(u32 frameIndex, std::span<const GpuObjectData> objects)
+{
+  auto&     frame = m_Frames[frameIndex];
+  const u32 count = std::min(static_cast<u32>(objects.size()), m_MaxObjects);
+  if (count < objects.size())
+  {
+    LOG_CORE_WARN("gpu culling supports {} objects, {} dropped", m_MaxObjects, objects.size() - count);
+  }
+
+  memcpy(frame.objectBuffer.mapped, objects.data(), sizeof(GpuObjectData) * count);
+  m_Allocator->Flush(frame.objectBuffer, 0, sizeof(GpuObjectData) * count);
+  frame.objectCount = count;
+  return count;
+}
+
+//===============================================================================
+void VulkanGpuCulling::RecordCull(vk::CommandBuffer cmd,
+                                  u32               frameIndex,
+                                  const glm::mat4&  viewProj,
+                                  const glm::vec3&  viewPosition) const
+{
+  const auto& frame = m_Frames[frameIndex];
+
+  // reset counters, previous frame draws from its own buffers so no hazard across frames
+  const CullCounters counters{};
+  cmd.updateBuffer(frame.countBuffer.buffer, 0, sizeof(CullCounters), &counters);
+  const vk::BufferMemoryBarrier2 resetBarrier{.srcStageMask  = vk::PipelineStageFlagBits2::eClear,
+                                              .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                              .dstStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                                              .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead |
+                                                               vk::AccessFlagBits2::eShaderStorageWrite,
+                                              .buffer        = frame.countBuffer.buffer,
+                                              .offset        = 0,
+                                              .size          = VK_WHOLE_SIZE};
+  cmd.pipelineBarrier2({.bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &resetBarrier});
+
+  if (frame.objectCount > 0)
+  {
+    const CullConstants constants{.frustumPlanes = ExtractFrustumPlanes(viewProj),
+                                  .viewPosition  = glm::vec4{viewPosition, 1.0F},
+                                  .objectCount   = frame.objectCount,
+                                  .maxDraws      = m_MaxDraws,
+                                  .maxTasks      = MaxMeshletTasks};
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_PipelineLayout, 0, frame.descriptorSet, {});
+    cmd.pushConstants(m_PipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants), &constants);
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_Pipeline);
+    cmd.dispatch((frame.objectCount + CullGroupSize - 1) / CullGroupSize, 1, 1);
+
+    // the meshlet pass appends to the same draws, reads the queued tasks and is sized by the object pass
+    const std::array taskBarriers{
+      vk::BufferMemoryBarrier2{.srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                               .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                               .dstStageMask  = vk::PipelineStageFlagBits2::eComputeShader |
+                                               vk::PipelineStageFlagBits2::eDrawIndirect,
+                               .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead |
+                                                vk::AccessFlagBits2::eShaderStorageWrite |
+                                                vk::AccessFlagBits2::eIndirectCommandRead,
+                               .buffer        = frame.countBuffer.buffer,
+                               .offset        = 0,
+                               .size          = VK_WHOLE_SIZE},
+      vk::BufferMemoryBarrier2{.srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                               .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                               .dstStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                               .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead,
+                               .buffer        = frame.taskBuffer.buffer,
+                               .offset        = 0,
+                               .size          = VK_WHOLE_SIZE},
+      vk::BufferMemoryBarrier2{.srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                               .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                               .dstStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                               .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                               .buffer        = frame.drawBuffer.buffer,
+                               .offset        = 0,
+                               .size          = VK_WHOLE_SIZE},
+    };
+    cmd.pipelineBarrier2({.bufferMemoryBarrierCount = static_cast<u32>(taskBarriers.size()),
+                          .pBufferMemoryBarriers    = taskBarriers.data()});
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_MeshletPipeline);
+    cmd.dispatchIndirect(frame.countBuffer.buffer, offsetof(CullCounters, dispatch));
+  }
+
+  // draw commands and count are consumed by the indirect draw
+  const std::array cullBarriers{
+    vk::BufferMemoryBarrier2{.srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                             .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                             .dstStageMask  = vk::PipelineStageFlagBits2::eDrawIndirect,
+                             .dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead,
+                             .buffer        = frame.drawBuffer.buffer,
+                             .offset        = 0,
+                             .size          = VK_WHOLE_SIZE},
+    vk::BufferMemoryBarrier2{.srcStageMask  = vk::PipelineStageFlagBits2::eComputeShader,
+                             .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                             .dstStageMask  = vk::PipelineStageFlagBits2::eDrawIndirect,
+                             .dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead,
+                             .buffer        = frame.countBuffer.buffer,
+                             .offset        = 0,
+                             .size          = VK_WHOLE_SIZE},
+  };
+  cmd.pipelineBarrier2({.bufferMemoryBarrierCount = static_cast<u32>(cullBarriers.size()),
+                        .pBufferMemoryBarriers    = cullBarriers.data()});
+}
+
+//===============================================================================
+void VulkanGpuCulling::RecordDraw(vk::CommandBuffer cmd, u32 frameIndex) const
+{
+  const auto& frame = m_Frames[frameIndex];
+  cmd.drawIndexedIndirectCount(frame.drawBuffer.buffer,
+                               0,
+                               frame.countBuffer.buffer,
+                               offsetof(CullCounters, drawCount),
+                               m_MaxDraws,
+                               sizeof(vk::DrawIndexedIndirectCommand));
+}
+
+//===============================================================================
+std::array<glm::vec4, 6> VulkanGpuCulling::ExtractFrustumPlanes(const glm::mat4& viewProj)
+{
+  // Gribb-Hartmann, rows of the matrix ( glm is column major )
+  const auto row = [&viewProj](int i) { return glm::vec4{viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]}; };
+
+  std::array<glm::vec4, 6> planes{
+    row(3) + row(0), // left
+    row(3) - row(0), // right
+    row(3) + row(1), // bottom
+    row(3) - row(1), // top
+    row(2),          // near, depth is zero to one
+    row(3) - row(2), // far
+  };
+  for (auto& plane : planes)
+  {
+    plane /= glm::length(glm::vec3{plane});
+  }
+  return planes;
+}
+
+} // namespace four
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/vulkanAllocator.hpp"
+#include "renderer/vulkan/vulkanPipelineCache.hpp"
+
+#include "glm/glm.hpp"
+
+#include <span>
+
+namespace four
+{
+
+/**
+ * @brief per object data read by cull.comp and the indirect vertex shader, std430 layout
+ * an object with meshlets is culled and drawn meshlet by meshlet, otherwise as a whole
+ */
+struct GpuObjectData
+{
+  glm::mat4 model;
+  glm::vec4 boundingSphere; // xyz center in object space, w radius
+  u32       indexCount{0};
+  u32       firstIndex{0};
+  i32       vertexOffset{0};
+  u32       textureIndex{0}; // bindless texture of the object
+  u32       firstMeshlet{0}; // into the meshlet buffer
+  u32       meshletCount{0};
+  u32       padding0{0};
+  u32       padding1{0};
+};
+static_assert(sizeof(GpuObjectData) == 112, "GpuObjectData must match std430 layout of ObjectData in shaders");
+
+/**
+ * @brief meshlet as culled by cullMeshlets.comp, std430 layout
+ * its triangles are a plain index range, so a surviving meshlet is one indexed indirect draw
+ */
+struct GpuMeshlet
+{
+  glm::vec4 boundingSphere; // xyz center in object space, w radius
+  glm::vec4 cone;           // xyz axis in object space, w cutoff, see Meshlet
+  u32       firstIndex{0};
+  u32       indexCount{0};
+  u32       padding0{0};
+  u32       padding1{0};
+};
+static_assert(sizeof(GpuMeshlet) == 48, "GpuMeshlet must match std430 layout of MeshletData in shaders");
+
+/**
+ * @brief GPU driven draw path
+ * object transforms and bounds live in a storage buffer, a compute pass culls them against the camera frustum
+ * and appends survivors to an indirect buffer that is drawn with a single drawIndexedIndirectCount.
+ * surviving objects with meshlets queue them in groups of 64 for a second pass, dispatched indirectly, that rejects
+ * meshlets outside the frustum or facing away from the camera and appends a draw for every other one
+ */
+class FOUR_ENGINE_API VulkanGpuCulling
+{
+public:
+  VulkanGpuCulling() = default;
+  ~VulkanGpuCulling();
+
+  VulkanGpuCulling(const VulkanGpuCulling&)            = delete;
+  VulkanGpuCulling(VulkanGpuCulling&&)                 = delete;
+  VulkanGpuCulling& operator=(const VulkanGpuCulling&) = delete;
+  VulkanGpuCulling& operator=(VulkanGpuCulling&&)      = delete;
+
+  /**
+   * @brief create per frame object, draw and count buffers, descriptor sets and cull pipeline
+   *
+   * @param device logical device
+   * @param allocator allocator to create buffers from
+   * @param frameCount number of frames in flight
+   * @param maxObjects maximum number of objects per frame
+   * @param maxDraws maximum number of draws per frame, objects and meshlets that pass culling
+   * @param pipelineCache cache the cull pipelines are created through
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(vk::Device           device,
+                          VulkanAllocator&     allocator,
+                          u32                  frameCount,
+                          u32                  maxObjects,
+                          u32                  maxDraws,
+                          VulkanPipelineCache& pipelineCache);
+
+  /**
+   * @brief destroy all resources, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief bind the GpuMeshlet buffer objects refer to with firstMeshlet, must be set before the first RecordCull
+   */
+  void SetMeshlets(vk::Buffer meshletBuffer);
+
+  /**
+   * @brief write objects of the frame into its persistently mapped object buffer
+   * objects past maxObjects are dropped
+   *
+   * @return number of objects written
+   */
+  u32 UpdateObjects(u32 frameIndex, std::span<const GpuObjectData> objects);
+
+  /**
+   * @brief record reset of the counters and both cull dispatches, must be outside of a render pass
+   *
+   * @param cmd command buffer in recording state
+   * @param frameIndex index of frame in flight
+   * @param viewProj projection * view matrix of the camera
+   * @param viewPosition world position of the camera, for the meshlet cone test
+   */
+  void RecordCull(vk::CommandBuffer cmd, u32 frameIndex, const glm::mat4& viewProj, const glm::vec3& viewPosition) const;
+
+  /**
+   * @brief record indirect draw of culled objects, pipeline and vertex/index buffers should be bound
+   */
+  void RecordDraw(vk::CommandBuffer cmd, u32 frameIndex) const;
+
+  /**
+   * @brief extract normalized frustum planes ( left, right, bottom, top, near, far ) for depth zero to one
+   * plane is xyz normal pointing inside and w distance
+   */
+  [[nodiscard]] static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProj);
+
+  [[nodiscard]] vk::DescriptorSetLayout GetObjectSetLayout() const
+  {
+    return m_SetLayout;
+  }
+
+  [[nodiscard]] vk::DescriptorSet GetObjectSet(u32 frameIndex) const
+  {
+    return m_Frames[frameIndex].descriptorSet;
+  }
+
+private:
+  // shared by both cull passes, 128 bytes is the push constant size every device supports
+  struct CullConstants
+  {
+    std::array<glm::vec4, 6> frustumPlanes;
+    glm::vec4                 viewPosition; // xyz, w unused
+    u32                       objectCount;
+    u32                       maxDraws;
+    u32                       maxTasks;
+    u32                       padding;
+  };
+  static_assert(sizeof(CullConstants) <= 128);
+
+  // reset every frame, written by both passes
+  struct CullCounters
+  {
+    u32                drawCount{0}; // read by drawIndexedIndirectCount
+    u32                taskCount{0}; // meshlet groups queued by the object pass, may exceed the task buffer
+    std::array<u32, 2> padding{};
+    std::array<u32, 4> dispatch{0, 1, 1, 0}; // vk::DispatchIndirectCommand of the meshlet pass and padding
+  };
+
+  struct FrameResources
+  {
+    AllocatedBuffer   objectBuffer;
+    AllocatedBuffer   drawBuffer;
+    AllocatedBuffer   countBuffer; // CullCounters
+    AllocatedBuffer   taskBuffer;  // object index and first meshlet of every group of the meshlet pass
+    vk::DescriptorSet descriptorSet;
+    u32               objectCount{0};
+  };
+
+  [[nodiscard]] bool         CreateDescriptors();
+  [[nodiscard]] bool         CreatePipelines(VulkanPipelineCache& pipelineCache);
+  [[nodiscard]] vk::Pipeline CreatePipeline(VulkanPipelineCache& pipelineCache, const std::filesystem::path& path) const;
+
+private:
+  vk::Device                  m_Device;
+  VulkanAllocator*            m_Allocator{nullptr};
+  u32                         m_MaxObjects{0};
+  u32                         m_MaxDraws{0};
+  std::vector<FrameResources> m_Frames;
+
+  vk::DescriptorSetLayout m_SetLayout;
+  vk::DescriptorPool      m_DescriptorPool;
+  vk::PipelineLayout      m_PipelineLayout;
+  vk::Pipeline            m_Pipeline;        // cull.comp, per object
+  vk::Pipeline            m_MeshletPipeline; // cullMeshlets.comp, per meshlet of surviving objects
+};
+
+} // namespace four
@@ -0,0 +1,150 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanGpuProfiler.hpp"
+
+namespace four
+{
+
+//===============================================================================
+VulkanGpuProfiler::~VulkanGpuProfiler()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanGpuProfiler::Init(vk::Device         device,
+                             vk::PhysicalDevice physicalDevice,
+                             u32                queueFamilyIndex,
+                             f32                timestampPeriod,
+                             u32                frameCount)
+{
+  m_Device = device;
+
+  const u32 validBits = physicalDevice.getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits;
+  if (validBits == 0 || timestampPeriod <= 0.0F)
+  {
+    LOG_CORE_WARN("queue family {} does not support timestamps, gpu pass timings are disabled", queueFamilyIndex);
+    return true;
+  }
+  m_TimestampPeriod = timestampPeriod;
+  m_TimestampMask   = validBits >= 64 ? std::numeric_limits<u64>::max() : (u64{1} << validBits) - 1;
+
+  try
+  {
+    m_Frames.resize(frameCount);
+    for (auto& frame : m_Frames)
+    {
+      frame.pool = m_Device.createQueryPool({.queryType = vk::QueryType::eTimestamp, .queryCount = 2 * PROFILER_MAX_GPU_PASSES});
+    }
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create timestamp query pool!, exception: {0}", e.what());
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+void VulkanGpuProfiler::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  for (const auto& frame : m_Frames)
+  {
+    m_Device.destroyQueryPool(frame.pool);
+  }
+  m_Frames.clear();
+  m_Device = nullptr;
+}
+
+//===============================================================================
+void VulkanGpuProfiler::BeginFrame(vk::CommandBuffer cmd, u32 frameIndex, u64 frameNumber)
+{
+  if (!IsEnabled())
+  {
+    return;
+  }
+
+  m_FrameIndex = frameIndex;
+  Frame& frame = m_Frames[frameIndex];
+  Collect(frame);
+
+  cmd.resetQueryPool(frame.pool, 0, 2 * PROFILER_MAX_GPU_PASSES);
+  frame.frameNumber = frameNumber;
+  frame.passCount   = 0;
+}
+
+//===============================================================================
+u32 VulkanGpuProfiler::BeginPass(vk::CommandBuffer cmd, std::string_view name)
+{
+  if (!IsEnabled() || m_Frames[m_FrameIndex].passCount == PROFILER_MAX_GPU_PASSES)
+  {
+    return InvalidPass;
+  }
+
+  Frame&    frame = m_Frames[m_FrameIndex];
+  const u32 pass  = frame.passCount++;
+  frame.names[pass] = name;
+  cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, frame.pool, 2 * pass);
+  return pass;
+}
+
+//===============================================================================
+void VulkanGpuProfiler::EndPass(vk::CommandBuffer cmd, u32 pass)
+{
+  if (pass == InvalidPass)
+  {
+    return;
+  }
+  cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, m_Frames[m_FrameIndex].pool, 2 * pass + 1);
+}
+
+//===============================================================================
+void VulkanGpuProfiler::Collect(Frame& frame) const
+{
+  if (frame.passCount == 0)
+  {
+    return;
+  }
+
+  // fence of the frame was waited, results are available and reading does not block
+  std::array<u64, 2 * PROFILER_MAX_GPU_PASSES> timestamps{};
+  const u32                                    queryCount = 2 * frame.passCount;
+  if (m_Device.getQueryPoolResults(frame.pool,
+                                   0,
+                                   queryCount,
+                                   queryCount * sizeof(u64),
+                                   timestamps.data(),
+                                   sizeof(u64),
+                                   vk::QueryResultFlagBits::e64) != vk::Result::eSuccess)
+  {
+    return;
+  }
+
+  u64 first = std::numeric_limits<u64>::max();
+  u64 last  = 0;
+  for (u32 i = 0; i < queryCount; ++i)
+  {
+    timestamps[i] &= m_TimestampMask;
+    first = std::min(first, timestamps[i]);
+    last  = std::max(last, timestamps[i]);
+  }
+
+  const auto toMs = [this](u64 ticks) { return static_cast<f32>(static_cast<f64>(ticks) * m_TimestampPeriod / 1e6); };
+
+  ProfileGpuFrame gpuFrame{.frameNumber = frame.frameNumber, .passCount = frame.passCount, .gpuMs = toMs(last - first)};
+  for (u32 pass = 0; pass < frame.passCount; ++pass)
+  {
+    const u64 begin           = timestamps[2 * pass];
+    const u64 end             = std::max(begin, timestamps[2 * pass + 1]);
+    gpuFrame.names[pass]      = frame.names[pass];
+    gpuFrame.startMs[pass]    = toMs(begin - first);
+    gpuFrame.durationMs[pass] = toMs(end - begin);
+  }
+  Profiler::Get().PushGpuFrame(gpuFrame);
+}
+
+} // namespace four
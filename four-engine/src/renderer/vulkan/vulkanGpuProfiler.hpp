@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/core.hpp"
+#include "core/profiler.hpp"
+
+#include "vulkan/vulkan.hpp"
+
+namespace four
+{
+
+/**
+ * @brief Per pass GPU timings from timestamp queries
+ * every frame in flight owns a query pool with a begin and end timestamp per pass. results are read once the fence
+ * of that frame signaled, so reading never waits on the gpu, and published to Profiler as a ProfileGpuFrame.
+ * when the queue has no valid timestamp bits every call is a no-op.
+ */
+class FOUR_ENGINE_API VulkanGpuProfiler
+{
+public:
+  static constexpr u32 InvalidPass = std::numeric_limits<u32>::max();
+
+  VulkanGpuProfiler() = default;
+  ~VulkanGpuProfiler();
+
+  VulkanGpuProfiler(const VulkanGpuProfiler&)            = delete;
+  VulkanGpuProfiler(VulkanGpuProfiler&&)                 = delete;
+  VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+  VulkanGpuProfiler& operator=(VulkanGpuProfiler&&)      = delete;
+
+  /**
+   * @brief create query pool per frame in flight
+   *
+   * @param device logical device
+   * @param physicalDevice physical device, used for timestamp valid bits of the queue family
+   * @param queueFamilyIndex family of the queue the timestamps are written on
+   * @param timestampPeriod nanoseconds per timestamp tick, VKDeviceLimits::timestamp_period
+   * @param frameCount number of frames in flight
+   * @return true if successfully initialized ( missing timestamp support is not an error )
+   */
+  [[nodiscard]] bool Init(vk::Device         device,
+                          vk::PhysicalDevice physicalDevice,
+                          u32                queueFamilyIndex,
+                          f32                timestampPeriod,
+                          u32                frameCount);
+
+  /**
+   * @brief destroy query pools, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief publish timings of the last frame recorded at frameIndex and record reset of its queries
+   * frame fence must be waited, must be outside of a render pass
+   *
+   * @param cmd command buffer in recording state
+   * @param frameIndex index of frame in flight
+   * @param frameNumber number of the frame being recorded, matches ProfileFrameRecord::frameNumber
+   */
+  void BeginFrame(vk::CommandBuffer cmd, u32 frameIndex, u64 frameNumber);
+
+  /**
+   * @brief write begin timestamp of a pass
+   *
+   * @param name pass name, string literal
+   * @return pass to end, InvalidPass when disabled or out of passes
+   */
+  u32 BeginPass(vk::CommandBuffer cmd, std::string_view name);
+
+  /**
+   * @brief write end timestamp of a pass started with BeginPass
+   */
+  void EndPass(vk::CommandBuffer cmd, u32 pass);
+
+  [[nodiscard]] bool IsEnabled() const
+  {
+    return !m_Frames.empty();
+  }
+
+private:
+  struct Frame
+  {
+    vk::QueryPool                                         pool;
+    u64                                                   frameNumber{0};
+    u32                                                   passCount{0};
+    std::array<std::string_view, PROFILER_MAX_GPU_PASSES> names{};
+  };
+
+  void Collect(Frame& frame) const;
+
+private:
+  vk::Device         m_Device;
+  f32                m_TimestampPeriod{1.0F};
+  u64                m_TimestampMask{0};
+  std::vector<Frame> m_Frames;
+  u32                m_FrameIndex{0};
+};
+
+} // namespace four
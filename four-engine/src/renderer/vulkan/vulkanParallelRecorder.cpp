@@ -0,0 +1,171 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanParallelRecorder.hpp"
+
+namespace four
+{
+
+//===============================================================================
+VulkanParallelRecorder::~VulkanParallelRecorder()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanParallelRecorder::Init(vk::Device device, u32 queueFamily, u32 threadCount, u32 frameCount)
+{
+  m_Device      = device;
+  m_ThreadCount = std::max(threadCount, 1U);
+  m_FrameCount  = frameCount;
+
+  try
+  {
+    m_CommandPools.reserve(static_cast<std::size_t>(m_ThreadCount) * m_FrameCount);
+    m_CommandBuffers.reserve(static_cast<std::size_t>(m_ThreadCount) * m_FrameCount);
+    for (u32 i = 0; i < m_ThreadCount * m_FrameCount; ++i)
+    {
+      // transient, pool is reset as a whole every time its frame is recorded
+      m_CommandPools.push_back(
+        m_Device.createCommandPool({.flags = vk::CommandPoolCreateFlagBits::eTransient, .queueFamilyIndex = queueFamily}));
+      m_CommandBuffers.push_back(m_Device.allocateCommandBuffers({.commandPool        = m_CommandPools.back(),
+                                                                  .level              = vk::CommandBufferLevel::eSecondary,
+                                                                  .commandBufferCount = 1})[0]);
+    }
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create parallel recorder command pools!, exception: {0}", e.what());
+    return false;
+  }
+
+  m_SliceFailed.assign(m_ThreadCount, 0);
+
+  // calling thread records slice 0, only the other slices need a worker
+  m_Workers.reserve(m_ThreadCount - 1);
+  for (u32 threadIndex = 1; threadIndex < m_ThreadCount; ++threadIndex)
+  {
+    m_Workers.emplace_back([this, threadIndex](const std::stop_token& stopToken) { WorkerLoop(stopToken, threadIndex); });
+  }
+
+  LOG_CORE_INFO("parallel command recording with {} threads", m_ThreadCount);
+  return true;
+}
+
+//===============================================================================
+void VulkanParallelRecorder::Shutdown()
+{
+  for (auto& worker : m_Workers)
+  {
+    worker.request_stop();
+  }
+  m_WorkCondition.notify_all();
+  m_Workers.clear();
+
+  for (auto pool : m_CommandPools)
+  {
+    m_Device.destroyCommandPool(pool);
+  }
+  m_CommandPools.clear();
+  m_CommandBuffers.clear();
+}
+
+//===============================================================================
+std::span<const vk::CommandBuffer> VulkanParallelRecorder::Record(u32                                     frameIndex,
+                                                                  const vk::CommandBufferInheritanceInfo& inheritance,
+                                                                  u32                                     itemCount,
+                                                                  const RecordFunction&                   record)
+{
+  m_Recorded.clear();
+  if (itemCount == 0)
+  {
+    return m_Recorded;
+  }
+
+  {
+    const std::scoped_lock lock(m_Mutex);
+    m_FrameIndex  = frameIndex;
+    m_ItemCount   = itemCount;
+    m_SliceCount  = std::min(m_ThreadCount, itemCount);
+    m_SliceSize   = (itemCount + m_SliceCount - 1) / m_SliceCount;
+    m_SliceCount  = (itemCount + m_SliceSize - 1) / m_SliceSize;
+    m_Inheritance = &inheritance;
+    m_Record      = &record;
+    m_Remaining   = m_ThreadCount - 1;
+    std::ranges::fill(m_SliceFailed, 0);
+    ++m_Generation;
+  }
+  m_WorkCondition.notify_all();
+
+  RecordSlice(0);
+
+  {
+    std::unique_lock lock(m_Mutex);
+    m_DoneCondition.wait(lock, [this] { return m_Remaining == 0; });
+    m_Inheritance = nullptr;
+    m_Record      = nullptr;
+  }
+
+  // execution order of the secondaries matches the draw list order, a failed slice may be left in the recording
+  // state and must not be executed
+  const std::size_t firstBuffer = static_cast<std::size_t>(frameIndex) * m_ThreadCount;
+  for (u32 slice = 0; slice < m_SliceCount; ++slice)
+  {
+    if (m_SliceFailed[slice] == 0)
+    {
+      m_Recorded.push_back(m_CommandBuffers[firstBuffer + slice]);
+    }
+  }
+  return m_Recorded;
+}
+
+//===============================================================================
+void VulkanParallelRecorder::WorkerLoop(const std::stop_token& stopToken, u32 threadIndex)
+{
+  u64 seenGeneration{0};
+  while (!stopToken.stop_requested())
+  {
+    {
+      std::unique_lock lock(m_Mutex);
+      if (!m_WorkCondition.wait(lock, stopToken, [&] { return m_Generation != seenGeneration; }))
+      {
+        return;
+      }
+      seenGeneration = m_Generation;
+    }
+
+    RecordSlice(threadIndex);
+
+    const std::scoped_lock lock(m_Mutex);
+    if (--m_Remaining == 0)
+    {
+      m_DoneCondition.notify_one();
+    }
+  }
+}
+
+//===============================================================================
+void VulkanParallelRecorder::RecordSlice(u32 threadIndex)
+{
+  if (threadIndex >= m_SliceCount)
+  {
+    return;
+  }
+
+  const std::size_t       slot  = (static_cast<std::size_t>(m_FrameIndex) * m_ThreadCount) + threadIndex;
+  const u32               begin = threadIndex * m_SliceSize;
+  const u32               end   = std::min(begin + m_SliceSize, m_ItemCount);
+  const vk::CommandBuffer cmd   = m_CommandBuffers[slot];
+  try
+  {
+    m_Device.resetCommandPool(m_CommandPools[slot]);
+    cmd.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+               .pInheritanceInfo = m_Inheritance});
+    (*m_Record)(cmd, begin, end);
+    cmd.end();
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to record draw slice [{}, {}), exception: {}", begin, end, e.what());
+    m_SliceFailed[threadIndex] = 1;
+  }
+}
+
+} // namespace four
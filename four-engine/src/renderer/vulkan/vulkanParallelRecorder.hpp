@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <thread>
+
+namespace four
+{
+
+/**
+ * @brief Records slices of a draw list into secondary command buffers on worker threads
+ * every thread owns one command pool per frame in flight, pool of a frame is reset when the frame is recorded again,
+ * so threads never share a pool and no lock is taken while recording.
+ * calling thread records the first slice itself.
+ */
+class FOUR_ENGINE_API VulkanParallelRecorder
+{
+public:
+  // records draws [begin, end) of the draw list into a secondary command buffer that is already begun
+  using RecordFunction = std::function<void(vk::CommandBuffer cmd, u32 begin, u32 end)>;
+
+  VulkanParallelRecorder() = default;
+  ~VulkanParallelRecorder();
+
+  VulkanParallelRecorder(const VulkanParallelRecorder&)            = delete;
+  VulkanParallelRecorder(VulkanParallelRecorder&&)                 = delete;
+  VulkanParallelRecorder& operator=(const VulkanParallelRecorder&) = delete;
+  VulkanParallelRecorder& operator=(VulkanParallelRecorder&&)      = delete;
+
+  /**
+   * @brief create per thread per frame command pools and start worker threads
+   *
+   * @param device logical device
+   * @param queueFamily family of the queue the primary command buffer is submitted to
+   * @param threadCount number of recording threads including calling thread
+   * @param frameCount number of frames in flight
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(vk::Device device, u32 queueFamily, u32 threadCount, u32 frameCount);
+
+  /**
+   * @brief stop worker threads and destroy command pools, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief record itemCount draws split in contiguous slices, blocks until every slice is recorded
+   * command buffers of the frame should not be in use by gpu
+   *
+   * @param frameIndex index of frame in flight
+   * @param inheritance render pass and framebuffer the secondaries are executed in
+   * @param itemCount number of items in the draw list
+   * @param record function recording a slice
+   * @return secondary command buffers in draw list order, to be executed by the primary command buffer. slices whose
+   * recording failed are left out, their draws are missing from the frame
+   */
+  [[nodiscard]] std::span<const vk::CommandBuffer> Record(u32                                     frameIndex,
+                                                          const vk::CommandBufferInheritanceInfo& inheritance,
+                                                          u32                                     itemCount,
+                                                          const RecordFunction&                   record);
+
+  [[nodiscard]] u32 GetThreadCount() const
+  {
+    return m_ThreadCount;
+  }
+
+private:
+  void WorkerLoop(const std::stop_token& stopToken, u32 threadIndex);
+  void RecordSlice(u32 threadIndex);
+
+private:
+  vk::Device                     m_Device;
+  u32                            m_ThreadCount{0};
+  u32                            m_FrameCount{0};
+  std::vector<vk::CommandPool>   m_CommandPools;   // [frame * threadCount + thread]
+  std::vector<vk::CommandBuffer> m_CommandBuffers; // [frame * threadCount + thread]
+  std::vector<vk::CommandBuffer> m_Recorded;
+  std::vector<u8>                m_SliceFailed; // [thread], set by the thread recording the slice, not a bit vector
+
+  // current job, written by calling thread before generation is bumped
+  u32                                     m_FrameIndex{0};
+  u32                                     m_SliceCount{0};
+  u32                                     m_SliceSize{0};
+  u32                                     m_ItemCount{0};
+  const vk::CommandBufferInheritanceInfo* m_Inheritance{nullptr};
+  const RecordFunction*                   m_Record{nullptr};
+
+  std::mutex                  m_Mutex;
+  std::condition_variable_any m_WorkCondition;
+  std::condition_variable     m_DoneCondition;
+  u64                         m_Generation{0};
+  u32                         m_Remaining{0};
+  std::vector<std::jthread>   m_Workers;
+};
+
+} // namespace four
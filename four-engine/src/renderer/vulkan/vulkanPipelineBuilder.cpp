@@ -1,9 +1,46 @@
 #include "vulkanPipelineBuilder.hpp"
 
+#include "renderer/vulkan/VKHelpers.hpp"
 
 namespace four
 {
 
+namespace
+{
+// serializes state field by field so padding and pointers never reach the description
+class StateWriter
+{
+public:
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  StateWriter& Add(const T& value)
+  {
+    return AddBytes(&value, sizeof(T));
+  }
+
+  StateWriter& Add(std::string_view value)
+  {
+    Add(value.size());
+    return AddBytes(value.data(), value.size());
+  }
+
+  [[nodiscard]] std::string Take()
+  {
+    return std::move(m_State);
+  }
+
+private:
+  StateWriter& AddBytes(const void* data, std::size_t size)
+  {
+    m_State.append(static_cast<const char*>(data), size);
+    return *this;
+  }
+
+private:
+  std::string m_State;
+};
+} // namespace
+
 //==============================================================================
 void VulkanPipelineBuilder::clear()
 {
@@ -17,11 +54,36 @@ void VulkanPipelineBuilder::clear()
   colorAttachmentformat = {};
 
   shaderStages.clear();
+  vertexShaderPath.clear();
+  fragmentShaderPath.clear();
 }
 
 //==============================================================================
-vk::Pipeline VulkanPipelineBuilder::BuildPipeline(vk::Device device)
+vk::Pipeline VulkanPipelineBuilder::BuildPipeline(vk::Device device, VulkanPipelineCache* cache, vk::PipelineCache targetCache)
 {
+  // builder may have been copied, point render info at our own format
+  if (renderInfo.colorAttachmentCount > 0)
+  {
+    renderInfo.pColorAttachmentFormats = &colorAttachmentformat;
+  }
+
+  std::array<vk::ShaderModule, 2> fileModules{};
+  if (shaderStages.empty() && !vertexShaderPath.empty())
+  {
+    fileModules[0] = vkUtils::CreateShaderModule(vertexShaderPath, device);
+    fileModules[1] = vkUtils::CreateShaderModule(fragmentShaderPath, device);
+    SetShaders(fileModules[0], fileModules[1]);
+  }
+  const auto destroyFileModules = [&]
+  {
+    if (fileModules[0])
+    {
+      shaderStages.clear();
+      device.destroyShaderModule(fileModules[0]);
+      device.destroyShaderModule(fileModules[1]);
+    }
+  };
+
   // make viewport state from our stored viewport and scissor.
   // at the moment we wont support multiple viewports or scissors
   vk::PipelineViewportStateCreateInfo viewportState{.viewportCount = 1, .scissorCount = 1};
@@ -65,10 +127,18 @@ vk::Pipeline VulkanPipelineBuilder::BuildPipeline(vk::Device device)
     .layout              = pipelineLayout,
   };
 
+  if (cache)
+  {
+    const vk::Pipeline pipeline = cache->CreateGraphicsPipeline(pipelineInfo, targetCache);
+    destroyFileModules();
+    return pipeline;
+  }
+
   // its easy to error out on create graphics pipeline, so we handle it a bit
   // better than the common VK_CHECK case
   vk::Pipeline newPipeline;
-  auto         result = device.createGraphicsPipelines(VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &newPipeline);
+  auto         result = device.createGraphicsPipelines(targetCache, 1, &pipelineInfo, nullptr, &newPipeline);
+  destroyFileModules();
   if (result != vk::Result::eSuccess)
   {
     LOG_CORE_ERROR("failed to create graphics pipeline");
@@ -88,6 +158,87 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::SetShaders(vk::ShaderModule vertex
   return *this;
 }
 
+//==============================================================================
+VulkanPipelineBuilder& VulkanPipelineBuilder::SetShaderFiles(std::filesystem::path vertexShader,
+                                                             std::filesystem::path fragmentShader)
+{
+  shaderStages.clear();
+  vertexShaderPath   = std::move(vertexShader);
+  fragmentShaderPath = std::move(fragmentShader);
+  return *this;
+}
+
+//==============================================================================
+std::string VulkanPipelineBuilder::Describe() const
+{
+  StateWriter writer;
+
+  writer.Add(shaderStages.size());
+  for (const auto& stage : shaderStages)
+  {
+    writer.Add(stage.stage).Add(static_cast<VkShaderModule>(stage.module)).Add(std::string_view{stage.pName});
+  }
+  writer.Add(vertexShaderPath.generic_string()).Add(fragmentShaderPath.generic_string());
+
+  writer.Add(inputAssembly.topology).Add(inputAssembly.primitiveRestartEnable);
+
+  writer.Add(rasterizer.depthClampEnable)
+    .Add(rasterizer.rasterizerDiscardEnable)
+    .Add(rasterizer.polygonMode)
+    .Add(rasterizer.cullMode)
+    .Add(rasterizer.frontFace)
+    .Add(rasterizer.depthBiasEnable)
+    .Add(rasterizer.depthBiasConstantFactor)
+    .Add(rasterizer.depthBiasClamp)
+    .Add(rasterizer.depthBiasSlopeFactor)
+    .Add(rasterizer.lineWidth);
+
+  writer.Add(colorBlendAttachment);
+
+  writer.Add(multisampling.rasterizationSamples)
+    .Add(multisampling.sampleShadingEnable)
+    .Add(multisampling.minSampleShading)
+    .Add(multisampling.alphaToCoverageEnable)
+    .Add(multisampling.alphaToOneEnable);
+
+  writer.Add(depthStencil.depthTestEnable)
+    .Add(depthStencil.depthWriteEnable)
+    .Add(depthStencil.depthCompareOp)
+    .Add(depthStencil.depthBoundsTestEnable)
+    .Add(depthStencil.stencilTestEnable)
+    .Add(depthStencil.front)
+    .Add(depthStencil.back)
+    .Add(depthStencil.minDepthBounds)
+    .Add(depthStencil.maxDepthBounds);
+
+  writer.Add(renderInfo.viewMask)
+    .Add(renderInfo.colorAttachmentCount)
+    .Add(colorAttachmentformat)
+    .Add(renderInfo.depthAttachmentFormat)
+    .Add(renderInfo.stencilAttachmentFormat);
+
+  writer.Add(static_cast<VkPipelineLayout>(pipelineLayout));
+  return writer.Take();
+}
+
+//==============================================================================
+u64 VulkanPipelineBuilder::Hash() const
+{
+  return HashDescription(Describe());
+}
+
+//==============================================================================
+u64 VulkanPipelineBuilder::HashDescription(std::string_view description)
+{
+  // FNV-1a
+  u64 hash = 0xCBF29CE484222325ULL;
+  for (const char byte : description)
+  {
+    hash = (hash ^ static_cast<u8>(byte)) * 0x100000001B3ULL;
+  }
+  return hash;
+}
+
 //==============================================================================
 VulkanPipelineBuilder& VulkanPipelineBuilder::SetInputTopology(vk::PrimitiveTopology topology)
 {
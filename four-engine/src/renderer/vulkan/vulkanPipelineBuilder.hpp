@@ -1,6 +1,7 @@
 #pragma once
 #include "core/core.hpp"
 #include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/vulkanPipelineCache.hpp"
 
 namespace four
 {
@@ -24,12 +25,28 @@ public:
   vk::PipelineRenderingCreateInfo          renderInfo{};
   vk::Format                               colorAttachmentformat{};
 
+  // alternative to shaderStages, modules are created and destroyed around BuildPipeline
+  // so a copy of the builder can be built later on another thread
+  std::filesystem::path vertexShaderPath;
+  std::filesystem::path fragmentShaderPath;
+
 
   void clear();
 
-  vk::Pipeline BuildPipeline(vk::Device device);
+  // pipeline goes through cache when given, so it is persisted and counted in cache telemetry
+  // targetCache replaces main cache of cache, used by worker threads
+  vk::Pipeline BuildPipeline(vk::Device device, VulkanPipelineCache* cache = nullptr, vk::PipelineCache targetCache = {});
+
+  // bytes of every state that ends up in the pipeline, equal state gives equal description within a session
+  [[nodiscard]] std::string Describe() const;
+
+  // hash of Describe, different state can collide, compare descriptions to be sure
+  [[nodiscard]] u64 Hash() const;
+
+  [[nodiscard]] static u64 HashDescription(std::string_view description);
 
   VulkanPipelineBuilder& SetShaders(vk::ShaderModule vertexShader, vk::ShaderModule fragmentShader);
+  VulkanPipelineBuilder& SetShaderFiles(std::filesystem::path vertexShader, std::filesystem::path fragmentShader);
   VulkanPipelineBuilder& SetInputTopology(vk::PrimitiveTopology topology);
   VulkanPipelineBuilder& SetPolygonMode(vk::PolygonMode mode);
   VulkanPipelineBuilder& SetCullMode(vk::CullModeFlagBits cullMode, vk::FrontFace frontFace);
@@ -0,0 +1,236 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanPipelineCache.hpp"
+
+#include <fstream>
+
+namespace four
+{
+
+namespace
+{
+constexpr u32 CacheFileMagic   = 0x34504346; // "FCP4"
+constexpr u32 CacheFileVersion = 2;          // 2: explicit reserved field in the header
+} // namespace
+
+//===============================================================================
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanPipelineCache::Init(vk::Device device, const VKDeviceProperties& properties, std::filesystem::path path)
+{
+  m_Device = device;
+  m_Path   = std::move(path);
+  m_Header = {.magic         = CacheFileMagic,
+              .version       = CacheFileVersion,
+              .vendorId      = properties.vendor_id,
+              .deviceId      = properties.device_id,
+              .driverVersion = properties.driver_version};
+  std::copy_n(properties.pipeline_cache_uuid.begin(),
+              std::min(properties.pipeline_cache_uuid.size(), m_Header.uuid.size()),
+              m_Header.uuid.begin());
+
+  const std::vector<u8> initialData = LoadFile();
+  m_LoadedFromDisk                  = !initialData.empty();
+  try
+  {
+    m_Cache = m_Device.createPipelineCache({.initialDataSize = initialData.size(), .pInitialData = initialData.data()});
+  } catch (const std::exception& e)
+  {
+    // driver rejected the data, start from an empty cache
+    LOG_CORE_WARN("pipeline cache data rejected, exception: {0}", e.what());
+    m_LoadedFromDisk = false;
+    try
+    {
+      m_Cache = m_Device.createPipelineCache({});
+    } catch (const std::exception& e2)
+    {
+      LOG_CORE_ERROR("failed to create pipeline cache!, exception: {0}", e2.what());
+      return false;
+    }
+  }
+
+  LOG_CORE_INFO("pipeline cache {} ( {} bytes from {} )",
+                m_LoadedFromDisk ? "warm" : "cold",
+                initialData.size(),
+                m_Path.string());
+  return true;
+}
+
+//===============================================================================
+void VulkanPipelineCache::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  Save();
+  LOG_CORE_INFO("pipeline cache: {} hits, {} misses, {:.2f} ms spent creating pipelines",
+                GetHitCount(),
+                GetMissCount(),
+                static_cast<f64>(m_CreationTimeNs.load()) / 1'000'000.0);
+
+  m_Device.destroyPipelineCache(m_Cache);
+  m_Cache  = nullptr;
+  m_Device = nullptr;
+}
+
+//===============================================================================
+std::vector<u8> VulkanPipelineCache::LoadFile() const
+{
+  std::ifstream file(m_Path, std::ios::binary);
+  if (!file.is_open())
+  {
+    return {};
+  }
+
+  FileHeader header{};
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+  {
+    LOG_CORE_WARN("pipeline cache file is truncated, ignored");
+    return {};
+  }
+
+  // a cache built by another device or driver is useless at best and crashes some drivers at worst
+  if (header.magic != m_Header.magic || header.version != m_Header.version || header.vendorId != m_Header.vendorId ||
+      header.deviceId != m_Header.deviceId || header.driverVersion != m_Header.driverVersion || header.uuid != m_Header.uuid)
+  {
+    LOG_CORE_INFO("pipeline cache file belongs to another device or driver, ignored");
+    return {};
+  }
+
+  std::vector<u8> data(header.dataSize);
+  if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+  {
+    LOG_CORE_WARN("pipeline cache file is truncated, ignored");
+    return {};
+  }
+  return data;
+}
+
+//===============================================================================
+bool VulkanPipelineCache::Save() const
+{
+  if (!m_Cache)
+  {
+    return false;
+  }
+
+  try
+  {
+    const std::vector<u8> data = m_Device.getPipelineCacheData(m_Cache);
+
+    FileHeader header = m_Header;
+    header.dataSize   = data.size();
+
+    if (m_Path.has_parent_path())
+    {
+      std::filesystem::create_directories(m_Path.parent_path());
+    }
+
+    std::filesystem::path tempPath = m_Path;
+    tempPath += ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+      if (!file.good())
+      {
+        LOG_CORE_ERROR("failed to write pipeline cache to {}", tempPath.string());
+        return false;
+      }
+    }
+    std::filesystem::rename(tempPath, m_Path);
+    LOG_CORE_INFO("pipeline cache saved, {} bytes", data.size());
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to save pipeline cache!, exception: {0}", e.what());
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+vk::PipelineCache VulkanPipelineCache::CreateWorkerCache() const
+{
+  return m_Device.createPipelineCache({});
+}
+
+//===============================================================================
+void VulkanPipelineCache::MergeWorkerCache(vk::PipelineCache workerCache)
+{
+  {
+    // main cache is externally synchronized when it is the destination of a merge
+    const std::scoped_lock lock(m_MergeMutex);
+    m_Device.mergePipelineCaches(m_Cache, workerCache);
+  }
+  m_Device.destroyPipelineCache(workerCache);
+}
+
+//===============================================================================
+vk::Pipeline VulkanPipelineCache::CreateGraphicsPipeline(vk::GraphicsPipelineCreateInfo createInfo, vk::PipelineCache cache)
+{
+  vk::PipelineCreationFeedback                 feedback{};
+  std::vector<vk::PipelineCreationFeedback>    stageFeedbacks(createInfo.stageCount);
+  const vk::PipelineCreationFeedbackCreateInfo feedbackInfo{.pNext                              = createInfo.pNext,
+                                                            .pPipelineCreationFeedback          = &feedback,
+                                                            .pipelineStageCreationFeedbackCount = createInfo.stageCount,
+                                                            .pPipelineStageCreationFeedbacks    = stageFeedbacks.data()};
+  createInfo.pNext = &feedbackInfo;
+
+  const auto start  = std::chrono::steady_clock::now();
+  const auto result = m_Device.createGraphicsPipeline(cache ? cache : m_Cache, createInfo);
+  if (result.result != vk::Result::eSuccess)
+  {
+    LOG_CORE_ERROR("failed to create graphics pipeline");
+    return nullptr;
+  }
+  RecordFeedback(feedback, std::chrono::steady_clock::now() - start);
+  return result.value;
+}
+
+//===============================================================================
+vk::Pipeline VulkanPipelineCache::CreateComputePipeline(vk::ComputePipelineCreateInfo createInfo, vk::PipelineCache cache)
+{
+  vk::PipelineCreationFeedback                 feedback{};
+  vk::PipelineCreationFeedback                 stageFeedback{};
+  const vk::PipelineCreationFeedbackCreateInfo feedbackInfo{.pNext                              = createInfo.pNext,
+                                                            .pPipelineCreationFeedback          = &feedback,
+                                                            .pipelineStageCreationFeedbackCount = 1,
+                                                            .pPipelineStageCreationFeedbacks    = &stageFeedback};
+  createInfo.pNext = &feedbackInfo;
+
+  const auto start  = std::chrono::steady_clock::now();
+  const auto result = m_Device.createComputePipeline(cache ? cache : m_Cache, createInfo);
+  if (result.result != vk::Result::eSuccess)
+  {
+    LOG_CORE_ERROR("failed to create compute pipeline");
+    return nullptr;
+  }
+  RecordFeedback(feedback, std::chrono::steady_clock::now() - start);
+  return result.value;
+}
+
+//===============================================================================
+void VulkanPipelineCache::RecordFeedback(const vk::PipelineCreationFeedback& feedback, std::chrono::nanoseconds elapsed)
+{
+  m_CreationTimeNs.fetch_add(static_cast<u64>(elapsed.count()), std::memory_order_relaxed);
+
+  // feedback is optional for the driver, without the valid bit we can not tell, count it as a miss
+  const bool valid = static_cast<bool>(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid);
+  const bool hit   = valid && static_cast<bool>(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit);
+  if (hit)
+  {
+    m_Hits.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
+  {
+    m_Misses.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace four
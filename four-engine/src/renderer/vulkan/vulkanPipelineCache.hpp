@@ -0,0 +1,130 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/VKTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+
+namespace four
+{
+
+/**
+ * @brief vk::PipelineCache persisted to disk
+ * file is keyed by pipelineCacheUUID, vendor, device and driver version of the device, a cache written by another
+ * device or driver is ignored instead of being handed to the driver.
+ * every pipeline created through this class reports creation feedback, used to count cache hits and misses
+ */
+class FOUR_ENGINE_API VulkanPipelineCache
+{
+public:
+  VulkanPipelineCache() = default;
+  ~VulkanPipelineCache();
+
+  VulkanPipelineCache(const VulkanPipelineCache&)            = delete;
+  VulkanPipelineCache(VulkanPipelineCache&&)                 = delete;
+  VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+  VulkanPipelineCache& operator=(VulkanPipelineCache&&)      = delete;
+
+  /**
+   * @brief create pipeline cache, seeded with file content when it matches the device
+   *
+   * @param device logical device
+   * @param properties properties of the physical device, pipeline_cache_uuid must be filled
+   * @param path path of the cache file
+   * @return true if successfully created ( missing or stale file is not an error )
+   */
+  [[nodiscard]] bool Init(vk::Device device, const VKDeviceProperties& properties, std::filesystem::path path);
+
+  /**
+   * @brief save cache to disk, log hit and miss counts and destroy cache
+   */
+  void Shutdown();
+
+  /**
+   * @brief write cache to a temporary file and rename it over the cache file, so a crash never leaves half a file
+   *
+   * @return true if saved
+   */
+  bool Save() const;
+
+  /**
+   * @brief create an empty cache for a worker thread, to be merged back with MergeWorkerCache
+   */
+  [[nodiscard]] vk::PipelineCache CreateWorkerCache() const;
+
+  /**
+   * @brief merge worker cache into main cache and destroy it, thread safe
+   */
+  void MergeWorkerCache(vk::PipelineCache workerCache);
+
+  /**
+   * @brief create graphics pipeline through the cache and record its creation feedback
+   *
+   * @param createInfo pipeline create info, feedback is chained in front of its pNext
+   * @param cache cache to use, main cache when null
+   * @return created pipeline, null handle on failure
+   */
+  [[nodiscard]] vk::Pipeline CreateGraphicsPipeline(vk::GraphicsPipelineCreateInfo createInfo, vk::PipelineCache cache = {});
+
+  /**
+   * @brief create compute pipeline through the cache and record its creation feedback
+   */
+  [[nodiscard]] vk::Pipeline CreateComputePipeline(vk::ComputePipelineCreateInfo createInfo, vk::PipelineCache cache = {});
+
+  [[nodiscard]] vk::PipelineCache GetHandle() const
+  {
+    return m_Cache;
+  }
+
+  [[nodiscard]] u32 GetHitCount() const
+  {
+    return m_Hits.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] u32 GetMissCount() const
+  {
+    return m_Misses.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] bool IsLoadedFromDisk() const
+  {
+    return m_LoadedFromDisk;
+  }
+
+private:
+  // written in front of the driver cache data
+  struct FileHeader
+  {
+    u32                                magic{0};
+    u32                                version{0};
+    u32                                vendorId{0};
+    u32                                deviceId{0};
+    u32                                driverVersion{0};
+    u32                                reserved{0}; // aligns dataSize, the header is written byte for byte
+    std::array<char, 2 * VK_UUID_SIZE> uuid{};      // pipeline_cache_uuid as hex
+    u64                                dataSize{0};
+  };
+  static_assert(std::has_unique_object_representations_v<FileHeader>, "cache file header must not have padding");
+
+  [[nodiscard]] std::vector<u8> LoadFile() const;
+  void                          RecordFeedback(const vk::PipelineCreationFeedback& feedback, std::chrono::nanoseconds elapsed);
+
+private:
+  vk::Device            m_Device;
+  vk::PipelineCache     m_Cache;
+  std::filesystem::path m_Path;
+  FileHeader            m_Header;
+  bool                  m_LoadedFromDisk{false};
+
+  std::mutex       m_MergeMutex;
+  std::atomic<u32> m_Hits{0};
+  std::atomic<u32> m_Misses{0};
+  std::atomic<u64> m_CreationTimeNs{0};
+};
+
+} // namespace four
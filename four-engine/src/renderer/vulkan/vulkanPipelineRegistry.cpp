@@ -0,0 +1,204 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanPipelineRegistry.hpp"
+
+namespace four
+{
+
+namespace
+{
+bool IsReady(const std::shared_future<vk::Pipeline>& future)
+{
+  return future.valid() && future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+}
+} // namespace
+
+//===============================================================================
+VulkanPipelineRegistry::~VulkanPipelineRegistry()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanPipelineRegistry::Init(vk::Device device, VulkanPipelineCache& pipelineCache, u32 threadCount)
+{
+  m_Device        = device;
+  m_PipelineCache = &pipelineCache;
+
+  const u32 workerCount = std::max(threadCount, 1U);
+  m_Workers.reserve(workerCount);
+  for (u32 i = 0; i < workerCount; ++i)
+  {
+    m_Workers.emplace_back([this](const std::stop_token& stopToken) { WorkerLoop(stopToken); });
+  }
+
+  LOG_CORE_INFO("pipeline registry with {} compile threads", workerCount);
+  return true;
+}
+
+//===============================================================================
+void VulkanPipelineRegistry::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  for (auto& worker : m_Workers)
+  {
+    worker.request_stop();
+  }
+  m_JobCondition.notify_all();
+  m_Workers.clear();
+
+  // nobody will compile what is left, wake up anyone waiting on it
+  for (auto& job : m_Jobs)
+  {
+    job.promise.set_value(nullptr);
+  }
+  m_Jobs.clear();
+
+  for (const auto& [hash, entry] : m_Pipelines)
+  {
+    if (IsReady(entry.pipeline) && entry.pipeline.get())
+    {
+      m_Device.destroyPipeline(entry.pipeline.get());
+    }
+  }
+  m_Pipelines.clear();
+  m_Device = nullptr;
+}
+
+//===============================================================================
+vk::Pipeline VulkanPipelineRegistry::GetOrCreate(const VulkanPipelineBuilder& builder)
+{
+  std::string                state = builder.Describe();
+  const u64                  hash  = VulkanPipelineBuilder::HashDescription(state);
+  std::promise<vk::Pipeline> promise;
+  {
+    std::unique_lock lock(m_Mutex);
+    if (const Entry* entry = Find(hash, state))
+    {
+      const auto future = entry->pipeline;
+      lock.unlock();
+      return future.get();
+    }
+    m_Pipelines.emplace(hash, Entry{.state = std::move(state), .pipeline = promise.get_future().share()});
+  }
+
+  VulkanPipelineBuilder pipelineBuilder = builder;
+  vk::Pipeline          pipeline;
+  try
+  {
+    pipeline = pipelineBuilder.BuildPipeline(m_Device, m_PipelineCache);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to build pipeline {:#x}, exception: {}", hash, e.what());
+  }
+  promise.set_value(pipeline);
+  return pipeline;
+}
+
+//===============================================================================
+std::shared_future<vk::Pipeline> VulkanPipelineRegistry::GetOrCreateAsync(const VulkanPipelineBuilder& builder)
+{
+  std::string state = builder.Describe();
+  const u64   hash  = VulkanPipelineBuilder::HashDescription(state);
+
+  const std::scoped_lock lock(m_Mutex);
+  if (const Entry* entry = Find(hash, state))
+  {
+    return entry->pipeline;
+  }
+
+  auto&      job    = m_Jobs.emplace_back(Job{.hash = hash, .builder = builder, .promise = {}});
+  const auto future = job.promise.get_future().share();
+  m_Pipelines.emplace(hash, Entry{.state = std::move(state), .pipeline = future});
+  m_JobCondition.notify_one();
+  return future;
+}
+
+//===============================================================================
+vk::Pipeline VulkanPipelineRegistry::GetOrPlaceholder(const VulkanPipelineBuilder& builder,
+                                                      vk::Pipeline                 placeholder) const
+{
+  const std::string state = builder.Describe();
+  const u64         hash  = VulkanPipelineBuilder::HashDescription(state);
+
+  const std::scoped_lock lock(m_Mutex);
+  const Entry*           entry = Find(hash, state);
+  if (entry == nullptr || !IsReady(entry->pipeline) || !entry->pipeline.get())
+  {
+    return placeholder;
+  }
+  return entry->pipeline.get();
+}
+
+//===============================================================================
+u32 VulkanPipelineRegistry::GetPipelineCount() const
+{
+  const std::scoped_lock lock(m_Mutex);
+  return static_cast<u32>(m_Pipelines.size());
+}
+
+//===============================================================================
+const VulkanPipelineRegistry::Entry* VulkanPipelineRegistry::Find(u64 hash, const std::string& state) const
+{
+  const auto [first, last] = m_Pipelines.equal_range(hash);
+  for (auto it = first; it != last; ++it)
+  {
+    if (it->second.state == state)
+    {
+      return &it->second;
+    }
+  }
+
+  if (first != last)
+  {
+    LOG_CORE_WARN("pipeline hash {:#x} collides with a different state, compiled as its own pipeline", hash);
+  }
+  return nullptr;
+}
+
+//===============================================================================
+void VulkanPipelineRegistry::WorkerLoop(const std::stop_token& stopToken)
+{
+  // own cache per worker, the main cache can not be written while it is merged into
+  vk::PipelineCache workerCache;
+  try
+  {
+    workerCache = m_PipelineCache->CreateWorkerCache();
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_WARN("failed to create worker pipeline cache, compiling into main cache, exception: {}", e.what());
+  }
+
+  while (true)
+  {
+    std::unique_lock lock(m_Mutex);
+    if (!m_JobCondition.wait(lock, stopToken, [this] { return !m_Jobs.empty(); }) || stopToken.stop_requested())
+    {
+      break;
+    }
+    Job job = std::move(m_Jobs.front());
+    m_Jobs.pop_front();
+    lock.unlock();
+
+    vk::Pipeline pipeline;
+    try
+    {
+      pipeline = job.builder.BuildPipeline(m_Device, m_PipelineCache, workerCache);
+    } catch (const std::exception& e)
+    {
+      LOG_CORE_ERROR("failed to build pipeline {:#x} on worker, exception: {}", job.hash, e.what());
+    }
+    job.promise.set_value(pipeline);
+  }
+
+  if (workerCache)
+  {
+    m_PipelineCache->MergeWorkerCache(workerCache);
+  }
+}
+
+} // namespace four
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/vulkanPipelineBuilder.hpp"
+#include "renderer/vulkan/vulkanPipelineCache.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace four
+{
+
+/**
+ * @brief Deduplicates pipelines by their builder state
+ * pipelines are looked up by the hash of the state and the full state description is compared on a hit, so two
+ * permutations whose hashes collide still get their own pipeline.
+ * a permutation seen for the first time can be compiled on a worker thread, caller keeps drawing with a placeholder
+ * until it is ready instead of stalling the frame on the driver compiler.
+ * every worker compiles into its own pipeline cache, merged into the main cache when the registry shuts down.
+ * registry owns every pipeline it returns.
+ */
+class FOUR_ENGINE_API VulkanPipelineRegistry
+{
+public:
+  VulkanPipelineRegistry() = default;
+  ~VulkanPipelineRegistry();
+
+  VulkanPipelineRegistry(const VulkanPipelineRegistry&)            = delete;
+  VulkanPipelineRegistry(VulkanPipelineRegistry&&)                 = delete;
+  VulkanPipelineRegistry& operator=(const VulkanPipelineRegistry&) = delete;
+  VulkanPipelineRegistry& operator=(VulkanPipelineRegistry&&)      = delete;
+
+  /**
+   * @brief start compile threads
+   *
+   * @param device logical device
+   * @param pipelineCache cache pipelines are created through, should outlive the registry
+   * @param threadCount number of compile threads
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(vk::Device device, VulkanPipelineCache& pipelineCache, u32 threadCount);
+
+  /**
+   * @brief stop compile threads, drop queued jobs and destroy every pipeline, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief return pipeline for the builder state, built on calling thread when missing
+   * waits when the same state is being compiled on a worker
+   *
+   * @return pipeline, null handle on failure
+   */
+  [[nodiscard]] vk::Pipeline GetOrCreate(const VulkanPipelineBuilder& builder);
+
+  /**
+   * @brief return pipeline for the builder state, queued for a worker thread when missing
+   * shader stages of the builder must outlive the compile, prefer SetShaderFiles
+   *
+   * @return future of the pipeline, null handle on failure
+   */
+  [[nodiscard]] std::shared_future<vk::Pipeline> GetOrCreateAsync(const VulkanPipelineBuilder& builder);
+
+  /**
+   * @brief pipeline for the builder state if it finished compiling, placeholder otherwise, never blocks
+   *
+   * @param builder state of the requested pipeline
+   * @param placeholder pipeline to use while requested one is not ready
+   */
+  [[nodiscard]] vk::Pipeline GetOrPlaceholder(const VulkanPipelineBuilder& builder, vk::Pipeline placeholder) const;
+
+  [[nodiscard]] u32 GetPipelineCount() const;
+
+private:
+  struct Entry
+  {
+    std::string                      state; // VulkanPipelineBuilder::Describe
+    std::shared_future<vk::Pipeline> pipeline;
+  };
+
+  struct Job
+  {
+    u64                        hash{0};
+    VulkanPipelineBuilder      builder;
+    std::promise<vk::Pipeline> promise;
+  };
+
+  // entry with the same state, null when missing, m_Mutex must be held
+  [[nodiscard]] const Entry* Find(u64 hash, const std::string& state) const;
+
+  void WorkerLoop(const std::stop_token& stopToken);
+
+private:
+  vk::Device           m_Device;
+  VulkanPipelineCache* m_PipelineCache{nullptr};
+
+  mutable std::mutex                   m_Mutex;
+  std::unordered_multimap<u64, Entry> m_Pipelines; // by hash of the state, more than one entry when hashes collide
+  std::deque<Job>                     m_Jobs;
+  std::condition_variable_any         m_JobCondition;
+  std::vector<std::jthread>           m_Workers;
+};
+
+} // namespace four
@@ -4,6 +4,7 @@
 #include "renderer/vulkan/vulkanRenderer.hpp"
 
 #include "renderer/vulkan/VKHelpers.hpp"
+#include "mesh/meshCooker.hpp"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -83,11 +84,10 @@ VKAPI_ATTR void VKAPI_CALL vkSubmitDebugUtilsMessageEXT(
 
 //===============================================================================
 VulkanRenderer::VulkanRenderer(WindowType& window) :
-m_Window{window},
-m_MainCamera{{1.0F, 2.0F, 3.5F}, -135.5F, -34.0F, {0.0F, 0.0F, 0.0F}}
+m_Window{&window}
 {
   LOG_CORE_INFO("Initializing Vulkan context.");
-  const bool result = InitVulkan();
+  m_Initialized = InitVulkan();
 
   KeyEvent key;
   key.SetupCallBack([&](KeyEventValue key, EventType type) { m_MainCamera.OnEvent(key, type); });
@@ -97,12 +97,25 @@ m_MainCamera{{1.0F, 2.0F, 3.5F}, -135.5F, -34.0F, {0.0F, 0.0F, 0.0F}}
   mouseMove.SetupCallBack([&](f32 x, f32 y) { m_MainCamera.OnMouseMove(x, y); });
   window.RegisterEvent(std::move(mouseMove));
 
-  if (!result)
+  if (!m_Initialized)
   {
     LOG_CORE_ERROR("Failed to initialize Vulkan context.");
   }
 }
 
+//===============================================================================
+VulkanRenderer::VulkanRenderer(vk::Extent2D headlessExtent) :
+m_DeviceExtensions{}, // nothing is presented, swapchain extension is not required
+m_SwapChainExtent{headlessExtent}
+{
+  LOG_CORE_INFO("Initializing headless Vulkan context ( {}x{} ).", headlessExtent.width, headlessExtent.height);
+  m_Initialized = InitVulkan();
+  if (!m_Initialized)
+  {
+    LOG_CORE_ERROR("Failed to initialize headless Vulkan context.");
+  }
+}
+
 //===============================================================================
 VulkanRenderer::~VulkanRenderer()
 {
@@ -119,12 +132,19 @@ bool VulkanRenderer::InitVulkan()
            CreateSurface() &&             //
            PickPhysicalDevice() &&        //
            CreateLogicalDevice() &&       //
+           CreateAllocator() &&           //
+           CreatePipelineCache() &&       //
+           CreatePipelineRegistry() &&    //
            CreateSwapChain() &&           //
            CreateImageViews() &&          //
            CreateRenderPass() &&          //
            CreateDescriptorSetLayout() && //
+           CreateBindlessTable() &&       //
+           OpenDemoMesh() &&              //
            CreateGraphicsPipeline() &&    //
            CreateCommandPool() &&         //
+           CreateUploader() &&            //
+           CreateStagingRing() &&         //
            CreateDepthResources() &&      //
            CreateFramebuffers() &&        //
            CreateTextureImage() &&        //
@@ -133,10 +153,14 @@ bool VulkanRenderer::InitVulkan()
            CreateVertexBuffers() &&       //
            CreateIndexBuffers() &&        //
            CreateUniformBuffers() &&      //
+           CreateObjectBuffers() &&       //
            CreateDescriptorPool() &&      //
            CreateDescriptorSets() &&      //
+           CreateGpuCulling() &&          //
            CreateCommandBuffers() &&      //
+           CreateRecorder() &&            //
            CreateSyncObjects() &&         //
+           CreateGpuProfiler() &&         //
            InitImGui() &&                 //
            InitTestTriangle();
 
@@ -152,33 +176,39 @@ void VulkanRenderer::ShutdownVulkan()
 {
   if (m_Device)
   {
+    // pending uploads still reference buffers and images destroyed below
+    m_Uploader.Shutdown();
+
     CleanupSwapChain();
 
     m_Device.destroySampler(m_TextureSampler);
     m_Device.destroyImageView(m_TextureImage.ImageView);
 
-    m_Device.destroyImage(m_TextureImage.image);
-    m_Device.freeMemory(m_TextureImage.imageMemory);
+    m_Allocator.DestroyImage(m_TextureImage);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    for (auto& uniformBuffer : m_UniformBuffers)
+    {
+      m_Allocator.DestroyBuffer(uniformBuffer);
+    }
+    for (auto& objectBuffer : m_ObjectBuffers)
     {
-      m_Device.destroyBuffer(m_UniformBuffers[i]);
-      m_Device.freeMemory(m_UniformBuffersMemory[i]);
+      m_Allocator.DestroyBuffer(objectBuffer);
     }
 
     m_Device.destroyDescriptorPool(m_DescriptorPool);
     m_Device.destroyDescriptorSetLayout(m_DescriptorSetLayout);
-    m_Device.destroyBuffer(m_VertexBuffer);
-    m_Device.freeMemory(m_VertexBufferMemory);
-
-    m_Device.destroyBuffer(m_IndexBuffer);
-    m_Device.freeMemory(m_IndexBufferMemory);
+    m_Device.destroyDescriptorSetLayout(m_ObjectSetLayout);
+    m_Allocator.DestroyBuffer(m_VertexBuffer);
+    m_Allocator.DestroyBuffer(m_IndexBuffer);
+    m_Allocator.DestroyBuffer(m_MeshletBuffer);
 
     m_Device.destroyPipelineLayout(m_PipelineLayout);
     m_Device.destroyPipeline(m_GraphicsPipeline);
 
     m_Device.destroyRenderPass(m_RenderPass);
 
+    m_Recorder.Shutdown();
+    m_GpuProfiler.Shutdown();
     m_Device.destroyCommandPool(m_CommandPool);
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
@@ -190,6 +220,16 @@ void VulkanRenderer::ShutdownVulkan()
       m_Frames[i].deletionQueue.flush();
     }
 
+    m_GpuCulling.Shutdown();
+    m_Device.destroyPipeline(m_IndirectPipeline);
+    m_Device.destroyPipelineLayout(m_IndirectPipelineLayout);
+    m_Device.destroyDescriptorSetLayout(m_EmptySetLayout);
+    m_Bindless.Shutdown();
+    m_StagingRing.Shutdown();
+    m_PipelineRegistry.Shutdown();
+    m_PipelineCache.Shutdown();
+    m_Allocator.LogStatistics();
+    m_Allocator.Shutdown();
     m_Device.destroy();
   }
   if (m_Instance)
@@ -268,7 +308,12 @@ bool VulkanRenderer::SetupDebugMessenger()
 //===============================================================================
 bool VulkanRenderer::CreateSurface()
 {
-  auto* window = m_Window.GetHandle();
+  if (IsHeadless())
+  {
+    return true;
+  }
+
+  auto* window = m_Window->GetHandle();
   assert(window != nullptr && "Window handle is null");
 
   VkSurfaceKHR surface = VK_NULL_HANDLE;
@@ -314,12 +359,26 @@ bool VulkanRenderer::PickPhysicalDevice()
     return false;
   }
 
-  const auto properties = m_PhysicalDevice.getProperties();
-  LOG_CORE_INFO("GPU: {}", properties.deviceName);
+  m_DeviceProperties = vkUtils::QueryDeviceProperties(m_PhysicalDevice);
+  LOG_CORE_INFO("GPU: {}", m_DeviceProperties.device_name);
+
+  // meshlets are culled by compute and drawn indirectly everywhere, a mesh shader path could take cooked meshlets as is
+  if (const auto& mesh = m_DeviceProperties.mesh_shader_properties;
+      mesh && mesh->max_mesh_output_vertices >= MESHLET_MAX_VERTICES &&
+      mesh->max_mesh_output_primitives >= MESHLET_MAX_TRIANGLES)
+  {
+    LOG_CORE_INFO("mesh shaders fit cooked meshlets, up to {} vertices and {} primitives per group",
+                  mesh->max_mesh_output_vertices,
+                  mesh->max_mesh_output_primitives);
+  }
 
   // TODO: move this part later // pick swapchain extent
-  const auto capabilities = m_PhysicalDevice.getSurfaceCapabilitiesKHR(m_Surface);
-  m_SwapChainExtent       = ChooseSwapExtent(capabilities);
+  // headless has no surface, it keeps the extent it was created with
+  if (!IsHeadless())
+  {
+    const auto capabilities = m_PhysicalDevice.getSurfaceCapabilitiesKHR(m_Surface);
+    m_SwapChainExtent       = ChooseSwapExtent(capabilities);
+  }
 
   return true;
 }
@@ -330,38 +389,111 @@ bool VulkanRenderer::CreateLogicalDevice()
   const auto indices = FindQueueFamilies(m_PhysicalDevice, m_Surface);
 
   std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-  const std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+  const std::set<uint32_t>               uniqueQueueFamilies = {indices.graphicsFamily.value(),
+                                                                indices.presentFamily.value(),
+                                                                indices.transferFamily.value()};
   queueCreateInfos.reserve(uniqueQueueFamilies.size());
-  for (float queuePriority = 1.F; const auto& queueFamily : uniqueQueueFamilies)
+  static constexpr float queuePriority = 1.F;
+  for (const auto& queueFamily : uniqueQueueFamilies)
   {
     queueCreateInfos.push_back(
       {.flags = {}, .queueFamilyIndex = queueFamily, .queueCount = 1, .pQueuePriorities = &queuePriority});
   }
-  auto features              = m_PhysicalDevice.getFeatures();
-  features.samplerAnisotropy = VK_TRUE;
+
+  // gpu driven path needs draw count from a buffer and multi draw indirect, falls back to cpu draw list without them
+  vk::PhysicalDeviceVulkan12Features supported12{};
+  vk::PhysicalDeviceFeatures2        supported{.pNext = &supported12};
+  m_PhysicalDevice.getFeatures2(&supported);
+  m_GpuDrivenSupported = supported12.drawIndirectCount == VK_TRUE && supported.features.multiDrawIndirect == VK_TRUE;
+
+  // bindless table needs descriptor indexing, falls back to the fixed per frame texture binding without it
+  m_DeviceProperties.missing_required_feature = VulkanBindlessTable::FindMissingFeature(supported12);
+  m_BindlessSupported                         = m_DeviceProperties.missing_required_feature == VKMissingFeatureFlags::None;
+  if (!m_BindlessSupported)
+  {
+    LOG_CORE_WARN("descriptor indexing feature {} is missing, bindless textures disabled",
+                  static_cast<u32>(m_DeviceProperties.missing_required_feature));
+  }
+
+  // timeline semaphore and synchronization2 are used by the uploader, dynamic rendering by the test triangle
+  vk::PhysicalDeviceVulkan13Features features13{.synchronization2 = VK_TRUE, .dynamicRendering = VK_TRUE};
+  vk::PhysicalDeviceVulkan12Features features12{.pNext = &features13};
+  features12.timelineSemaphore = VK_TRUE;
+  features12.drawIndirectCount = supported12.drawIndirectCount;
+  if (m_BindlessSupported)
+  {
+    VulkanBindlessTable::EnableFeatures(features12);
+  }
+  vk::PhysicalDeviceFeatures2 features{.pNext = &features12, .features = m_PhysicalDevice.getFeatures()};
+  features.features.samplerAnisotropy = VK_TRUE;
+
+  // present wait lets the frame pacer block on the display instead of a timer, optional
+  vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{.presentWait = VK_TRUE};
+  vk::PhysicalDevicePresentIdFeaturesKHR   presentIdFeatures{.pNext = &presentWaitFeatures, .presentId = VK_TRUE};
+  m_PresentWaitSupported = QueryPresentWaitSupport();
+  if (m_PresentWaitSupported)
+  {
+    m_DeviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    m_DeviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    features13.pNext = &presentIdFeatures;
+  }
 
   m_Device = m_PhysicalDevice.createDevice(
-    {.flags                   = {},
+    {.pNext                   = &features,
+     .flags                   = {},
      .queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size()),
      .pQueueCreateInfos       = queueCreateInfos.data(),
      .enabledExtensionCount   = static_cast<uint32_t>(m_DeviceExtensions.size()),
      .ppEnabledExtensionNames = m_DeviceExtensions.data(),
-     .pEnabledFeatures        = &features});
+     .pEnabledFeatures        = nullptr});
   if (!m_Device)
   {
     LOG_CORE_ERROR("failed to create logical device!");
     return false;
   }
 
+  // device extension entry point, the loader does not export it, so it is not reachable through static dispatch
+  if (m_PresentWaitSupported)
+  {
+    m_WaitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+      vkGetDeviceProcAddr(static_cast<VkDevice>(m_Device), "vkWaitForPresentKHR"));
+    m_PresentWaitSupported = m_WaitForPresent != nullptr;
+    if (!m_PresentWaitSupported)
+    {
+      LOG_CORE_WARN("failed to load vkWaitForPresentKHR, frames are paced by a timer");
+    }
+  }
+
   // get handle to graphics queue that created by the device
   m_GraphicsQueue = m_Device.getQueue(indices.graphicsFamily.value(), 0);
 
   // get handle to present queue that created by the device
   m_PresentQueue = m_Device.getQueue(indices.presentFamily.value(), 0);
 
+  // get handle to transfer queue, same as graphics queue when there is no separate transfer family
+  m_TransferQueue = m_Device.getQueue(indices.transferFamily.value(), 0);
+
   return true;
 }
 
+//===============================================================================
+bool VulkanRenderer::CreateAllocator()
+{
+  return m_Allocator.Init(m_Instance, m_PhysicalDevice, m_Device);
+}
+
+//===============================================================================
+bool VulkanRenderer::CreatePipelineCache()
+{
+  return m_PipelineCache.Init(m_Device, m_DeviceProperties, PIPELINE_CACHE_PATH);
+}
+
+//===============================================================================
+bool VulkanRenderer::CreatePipelineRegistry()
+{
+  return m_PipelineRegistry.Init(m_Device, m_PipelineCache, PIPELINE_COMPILE_THREADS);
+}
+
 //===============================================================================
 bool VulkanRenderer::CheckValidationLayerSupport()
 {
@@ -388,8 +520,8 @@ bool VulkanRenderer::CheckValidationLayerSupport()
 //===============================================================================
 std::vector<const char*> VulkanRenderer::GetRequiredExtensions()
 {
-  // add window extension enable
-  std::vector<const char*> extensions = m_Window.GetVulkanRequiredExtensions();
+  // add window extension enable, headless needs no surface extension
+  std::vector<const char*> extensions = IsHeadless() ? std::vector<const char*>{} : m_Window->GetVulkanRequiredExtensions();
 
   // check for vaidation layer
   if (EnableValidationLayers)
@@ -404,8 +536,8 @@ bool VulkanRenderer::IsDeviceSuitable(const vk::PhysicalDevice& device) const
 {
   const auto indices             = FindQueueFamilies(device, m_Surface);
   const bool extensionsSupported = CheckDeviceExtensionSupport(device);
-  bool       swapChainAquate     = false;
-  if (extensionsSupported)
+  bool       swapChainAquate     = IsHeadless();
+  if (extensionsSupported && !IsHeadless())
   {
     const auto swapChainSupport = QuerySwapChainSupport(device, m_Surface);
     swapChainAquate             = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -429,6 +561,33 @@ bool VulkanRenderer::CheckDeviceExtensionSupport(const vk::PhysicalDevice& devic
   return requiredExtensions.empty();
 }
 
+//===============================================================================
+bool VulkanRenderer::QueryPresentWaitSupport() const
+{
+  if (IsHeadless())
+  {
+    return false;
+  }
+
+  const std::vector<vk::ExtensionProperties> availableExtensions = m_PhysicalDevice.enumerateDeviceExtensionProperties();
+  const auto                                 hasExtension        = [&availableExtensions](std::string_view name)
+  {
+    return std::ranges::any_of(availableExtensions,
+                               [name](const vk::ExtensionProperties& extension)
+                               { return std::string_view{extension.extensionName} == name; });
+  };
+  if (!hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) || !hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+  {
+    return false;
+  }
+
+  vk::PhysicalDevicePresentWaitFeaturesKHR presentWait{};
+  vk::PhysicalDevicePresentIdFeaturesKHR   presentId{.pNext = &presentWait};
+  vk::PhysicalDeviceFeatures2              features{.pNext = &presentId};
+  m_PhysicalDevice.getFeatures2(&features);
+  return presentId.presentId == VK_TRUE && presentWait.presentWait == VK_TRUE;
+}
+
 //===============================================================================
 VulkanRenderer::SwapChainSupportDetails VulkanRenderer::QuerySwapChainSupport(const vk::PhysicalDevice& device,
                                                                               const vk::SurfaceKHR&     surface)
@@ -445,24 +604,51 @@ VulkanRenderer::QueueFamilyIndices VulkanRenderer::FindQueueFamilies(const vk::P
   // logic to find queue families
   const auto queueFamilies = device.getQueueFamilyProperties();
 
-  QueueFamilyIndices indices;
+  QueueFamilyIndices      indices;
+  std::optional<uint32_t> dedicatedTransferFamily;
+  std::optional<uint32_t> computeTransferFamily;
   for (uint32_t index = 0U; const auto& queueFamily : queueFamilies)
   {
-    if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
+    const bool graphics = static_cast<bool>(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics);
+    const bool compute  = static_cast<bool>(queueFamily.queueFlags & vk::QueueFlagBits::eCompute);
+    const bool transfer = static_cast<bool>(queueFamily.queueFlags & vk::QueueFlagBits::eTransfer);
+    if (graphics && !indices.IsComplete())
     {
       indices.graphicsFamily = index;
-      if (device.getSurfaceSupportKHR(index, surface) != 0U)
+      // without a surface nothing is presented, present family only aliases graphics
+      if (!surface || device.getSurfaceSupportKHR(index, surface) != 0U)
       {
         indices.presentFamily = index;
       }
+    }
 
-      if (indices.IsComplete())
+    // prefer a transfer only family ( DMA engine ) over an async compute family
+    if (transfer && !graphics)
+    {
+      if (compute)
       {
-        break;
+        computeTransferFamily = computeTransferFamily.value_or(index);
+      }
+      else
+      {
+        dedicatedTransferFamily = dedicatedTransferFamily.value_or(index);
       }
     }
     ++index;
   }
+
+  if (dedicatedTransferFamily.has_value())
+  {
+    indices.transferFamily = dedicatedTransferFamily;
+  }
+  else if (computeTransferFamily.has_value())
+  {
+    indices.transferFamily = computeTransferFamily;
+  }
+  else
+  {
+    indices.transferFamily = indices.graphicsFamily;
+  }
   return indices;
 }
 
@@ -530,8 +716,8 @@ vk::Extent2D VulkanRenderer::ChooseSwapExtent(const vk::SurfaceCapabilitiesKHR&
   {
     return capabilities.currentExtent;
   }
-  const uint32_t width  = m_Window.GetExtent().GetWidth();
-  const uint32_t height = m_Window.GetExtent().GetHeight();
+  const uint32_t width  = m_Window->GetExtent().GetWidth();
+  const uint32_t height = m_Window->GetExtent().GetHeight();
   vk::Extent2D   actualExtent{.width = width, .height = height};
 
   actualExtent.width  = std::clamp(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
@@ -562,6 +748,11 @@ bool VulkanRenderer::CreateImageViews()
 //===============================================================================
 bool VulkanRenderer::CreateSwapChain()
 {
+  if (IsHeadless())
+  {
+    return CreateOffscreenTarget();
+  }
+
   SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(m_PhysicalDevice, m_Surface);
 
   const auto surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
@@ -619,6 +810,29 @@ bool VulkanRenderer::CreateSwapChain()
   return true;
 }
 
+//===============================================================================
+bool VulkanRenderer::CreateOffscreenTarget()
+{
+  try
+  {
+    // stands in for the swapchain image, copied out by ReadbackFrame
+    m_OffscreenColor = CreateImage(m_SwapChainExtent.width,
+                                   m_SwapChainExtent.height,
+                                   HEADLESS_COLOR_FORMAT,
+                                   vk::ImageTiling::eOptimal,
+                                   vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                                   MemoryUsage::GpuOnly);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create offscreen color target!, exception: {0}", e.what());
+    return false;
+  }
+
+  m_SwapChainImages      = {m_OffscreenColor.image};
+  m_SwapChainImageFormat = HEADLESS_COLOR_FORMAT;
+  return true;
+}
+
 //===============================================================================
 vk::SurfaceFormatKHR VulkanRenderer::ChooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats)
 {
@@ -661,7 +875,7 @@ bool VulkanRenderer::CreateRenderPass()
     .stencilLoadOp  = vk::AttachmentLoadOp::eDontCare,
     .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
     .initialLayout  = vk::ImageLayout::eUndefined,
-    .finalLayout    = vk::ImageLayout::ePresentSrcKHR,
+    .finalLayout    = IsHeadless() ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR,
   };
   //depth
   const vk::AttachmentDescription depthAttachment{
@@ -738,13 +952,74 @@ bool VulkanRenderer::CreateDescriptorSetLayout()
     LOG_CORE_ERROR("failed to create descriptor set layout!");
     return false;
   }
+
+  // object data of the draws, indexed by gl_InstanceIndex
+  const vk::DescriptorSetLayoutBinding    objectLayoutBinding{.binding         = 0,
+                                                              .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                                                              .descriptorCount = 1,
+                                                              .stageFlags      = vk::ShaderStageFlagBits::eVertex};
+  const vk::DescriptorSetLayoutCreateInfo objectLayoutInfo{.bindingCount = 1, .pBindings = &objectLayoutBinding};
+  if (m_Device.createDescriptorSetLayout(&objectLayoutInfo, nullptr, &m_ObjectSetLayout) != vk::Result::eSuccess)
+  {
+    LOG_CORE_ERROR("failed to create object descriptor set layout!");
+    return false;
+  }
   return true;
 }
+//===============================================================================
+bool VulkanRenderer::CreateBindlessTable()
+{
+  if (!m_BindlessSupported)
+  {
+    return true;
+  }
+  return m_Bindless.Init(m_Device, m_PhysicalDevice, BINDLESS_MAX_TEXTURES, BINDLESS_MAX_BUFFERS, MAX_FRAMES_IN_FLIGHT);
+}
+
+//===============================================================================
+bool VulkanRenderer::OpenDemoMesh()
+{
+  // the vertex format of the cooked mesh decides the vertex input of the scene pipelines
+  if (std::filesystem::exists(DEMO_MESH_PATH) && m_DemoMesh.Open(DEMO_MESH_PATH))
+  {
+    m_VertexFormat = m_DemoMesh.GetVertexFormat();
+    LOG_CORE_INFO("mesh {} mapped, {} vertices, {} bytes each",
+                  DEMO_MESH_PATH,
+                  m_DemoMesh.GetHeader().vertexCount,
+                  m_DemoMesh.GetHeader().vertexStride);
+  }
+  return true;
+}
+
 //===============================================================================
 bool VulkanRenderer::CreateGraphicsPipeline()
 {
-  const auto vertShaderModule = vkUtils::CreateShaderModule("shaders/simpleShader.vert.spv", m_Device);
-  const auto fragShaderModule = vkUtils::CreateShaderModule("shaders/simpleShader.frag.spv", m_Device);
+  // set 0 camera uniforms, set 1 bindless table, set 2 object data
+  vk::DescriptorSetLayout bindlessLayout = m_Bindless.GetSetLayout();
+  if (!m_BindlessSupported)
+  {
+    m_EmptySetLayout = m_Device.createDescriptorSetLayout({});
+    bindlessLayout   = m_EmptySetLayout;
+  }
+  const std::array                   setLayouts = {m_DescriptorSetLayout, bindlessLayout, m_ObjectSetLayout};
+  const vk::PipelineLayoutCreateInfo pipelineLayoutInfo{.setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+                                                        .pSetLayouts    = setLayouts.data()};
+  if (m_Device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_PipelineLayout) != vk::Result::eSuccess)
+  {
+    LOG_CORE_ERROR("Failed to create pipeline layout");
+    return false;
+  }
+
+  m_GraphicsPipeline = CreateScenePipeline("shaders/simpleShader.vert.spv", m_PipelineLayout);
+  return static_cast<bool>(m_GraphicsPipeline);
+}
+
+//===============================================================================
+vk::Pipeline VulkanRenderer::CreateScenePipeline(const std::filesystem::path& vertShaderPath, vk::PipelineLayout layout)
+{
+  const auto vertShaderModule = vkUtils::CreateShaderModule(vertShaderPath, m_Device);
+  const auto fragShaderModule = vkUtils::CreateShaderModule(
+    m_BindlessSupported ? "shaders/simpleShaderBindless.frag.spv" : "shaders/simpleShader.frag.spv", m_Device);
 
   const vk::PipelineShaderStageCreateInfo      vertShaderStageInfo{.stage  = vk::ShaderStageFlagBits::eVertex,
                                                                    .module = vertShaderModule,
@@ -753,8 +1028,8 @@ bool VulkanRenderer::CreateGraphicsPipeline()
                                                                    .module = fragShaderModule,
                                                                    .pName  = "main"};
   const std::array                             shaderStages          = {vertShaderStageInfo, fragShaderStageInfo};
-  const auto                                   bindingDescription    = Vertex::GetBindingDescription();
-  const auto                                   attributeDescriptions = Vertex::GetAttributeDescriptions();
+  const auto                                   bindingDescription    = Vertex::GetBindingDescription(m_VertexFormat);
+  const auto                                   attributeDescriptions = Vertex::GetAttributeDescriptions(m_VertexFormat);
   const vk::PipelineVertexInputStateCreateInfo vertexInputInfo{
     .vertexBindingDescriptionCount   = 1,
     .pVertexBindingDescriptions      = &bindingDescription,
@@ -802,12 +1077,6 @@ bool VulkanRenderer::CreateGraphicsPipeline()
     .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
     .pDynamicStates    = dynamicStates.data(),
   };
-  const vk::PipelineLayoutCreateInfo pipelineLayoutInfo{.setLayoutCount = 1, .pSetLayouts = &m_DescriptorSetLayout};
-  if (m_Device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_PipelineLayout) != vk::Result::eSuccess)
-  {
-    LOG_CORE_ERROR("Failed to create pipeline layout");
-    return false;
-  }
 
   const vk::PipelineDepthStencilStateCreateInfo depthStencilInfo{
     .depthTestEnable       = VK_TRUE,
@@ -832,22 +1101,49 @@ bool VulkanRenderer::CreateGraphicsPipeline()
     .pDepthStencilState  = &depthStencilInfo,
     .pColorBlendState    = &colorBlendingInfo,
     .pDynamicState       = &dynamicStateInfo,
-    .layout              = m_PipelineLayout,
+    .layout              = layout,
     .renderPass          = m_RenderPass,
     .subpass             = 0,
     .basePipelineHandle  = VK_NULL_HANDLE,
   };
 
-  if (m_Device.createGraphicsPipelines(VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_GraphicsPipeline) != vk::Result::eSuccess)
+  const vk::Pipeline pipeline = m_PipelineCache.CreateGraphicsPipeline(pipelineInfo);
+
+  m_Device.destroyShaderModule(fragShaderModule);
+  m_Device.destroyShaderModule(vertShaderModule);
+
+  return pipeline;
+}
+
+//===============================================================================
+bool VulkanRenderer::CreateGpuCulling()
+{
+  if (!m_GpuDrivenSupported)
+  {
+    LOG_CORE_INFO("drawIndirectCount is not supported, using cpu draw list");
+    return true;
+  }
+
+  if (!m_GpuCulling.Init(
+        m_Device, m_Allocator, MAX_FRAMES_IN_FLIGHT, GPU_CULL_MAX_OBJECTS, GPU_CULL_MAX_DRAWS, m_PipelineCache))
   {
-    LOG_CORE_ERROR("Failed to create graphics pipeline");
     return false;
   }
+  m_GpuCulling.SetMeshlets(m_MeshletBuffer.buffer);
 
-  m_Device.destroyShaderModule(fragShaderModule);
-  m_Device.destroyShaderModule(vertShaderModule);
+  // set 0 and 1 are shared with the cpu path, set 2 is the culling object buffer instead of the frame one
+  const vk::DescriptorSetLayout      bindlessLayout = m_BindlessSupported ? m_Bindless.GetSetLayout() : m_EmptySetLayout;
+  const std::array                   setLayouts = {m_DescriptorSetLayout, bindlessLayout, m_GpuCulling.GetObjectSetLayout()};
+  const vk::PipelineLayoutCreateInfo pipelineLayoutInfo{.setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+                                                        .pSetLayouts    = setLayouts.data()};
+  if (m_Device.createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_IndirectPipelineLayout) != vk::Result::eSuccess)
+  {
+    LOG_CORE_ERROR("Failed to create indirect pipeline layout");
+    return false;
+  }
 
-  return true;
+  m_IndirectPipeline = CreateScenePipeline("shaders/simpleShader.vert.spv", m_IndirectPipelineLayout);
+  return static_cast<bool>(m_IndirectPipeline);
 }
 
 //===============================================================================
@@ -911,6 +1207,69 @@ bool VulkanRenderer::CreateCommandPool()
   return true;
 }
 
+//===============================================================================
+bool VulkanRenderer::CreateUploader()
+{
+  const QueueFamilyIndices queueFamilyIndices{FindQueueFamilies(m_PhysicalDevice, m_Surface)};
+
+  return m_Uploader.Init({.device         = m_Device,
+                          .allocator      = &m_Allocator,
+                          .transferQueue  = m_TransferQueue,
+                          .transferFamily = queueFamilyIndices.transferFamily.value(),
+                          .graphicsFamily = queueFamilyIndices.graphicsFamily.value()});
+}
+
+//===============================================================================
+bool VulkanRenderer::CreateStagingRing()
+{
+  return m_StagingRing.Init(m_Allocator, STAGING_RING_SIZE_PER_FRAME, MAX_FRAMES_IN_FLIGHT);
+}
+
+//===============================================================================
+bool VulkanRenderer::UploadDynamic(const void* data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset)
+{
+  const auto allocation = m_StagingRing.Allocate(size);
+  if (!allocation.has_value())
+  {
+    return false;
+  }
+
+  memcpy(allocation->mapped, data, static_cast<size_t>(size));
+  m_DynamicCopies.push_back(
+    {.srcBuffer = allocation->buffer,
+     .dstBuffer = dstBuffer,
+     .region    = vk::BufferCopy{.srcOffset = allocation->offset, .dstOffset = dstOffset, .size = size}});
+  return true;
+}
+
+//===============================================================================
+void VulkanRenderer::RecordDynamicCopies(vk::CommandBuffer cmd)
+{
+  if (m_DynamicCopies.empty())
+  {
+    return;
+  }
+
+  for (const auto& copy : m_DynamicCopies)
+  {
+    cmd.copyBuffer(copy.srcBuffer, copy.dstBuffer, copy.region);
+  }
+  m_DynamicCopies.clear();
+
+  // one barrier for all copies, destination can be used as any kind of geometry or shader input
+  const vk::MemoryBarrier2 barrier{
+    .srcStageMask  = vk::PipelineStageFlagBits2::eCopy,
+    .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+    .dstStageMask  = vk::PipelineStageFlagBits2::eVertexInput | vk::PipelineStageFlagBits2::eDrawIndirect |
+                     vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader |
+                     vk::PipelineStageFlagBits2::eComputeShader,
+    .dstAccessMask = vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead |
+                     vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eUniformRead |
+                     vk::AccessFlagBits2::eShaderStorageRead,
+  };
+  cmd.pipelineBarrier2({.memoryBarrierCount = 1, .pMemoryBarriers = &barrier});
+}
+
 //===============================================================================
 bool VulkanRenderer::CreateCommandBuffers()
 {
@@ -954,6 +1313,26 @@ bool VulkanRenderer::CreateCommandBuffers()
   return true;
 }
 
+//===============================================================================
+bool VulkanRenderer::CreateRecorder()
+{
+  const QueueFamilyIndices queueFamilyIndices{FindQueueFamilies(m_PhysicalDevice, m_Surface)};
+  const u32                threadCount = std::clamp(std::thread::hardware_concurrency(), 1U, PARALLEL_RECORD_MAX_THREADS);
+
+  return m_Recorder.Init(m_Device, queueFamilyIndices.graphicsFamily.value(), threadCount, MAX_FRAMES_IN_FLIGHT);
+}
+
+//===============================================================================
+bool VulkanRenderer::CreateGpuProfiler()
+{
+  const QueueFamilyIndices queueFamilyIndices{FindQueueFamilies(m_PhysicalDevice, m_Surface)};
+  return m_GpuProfiler.Init(m_Device,
+                            m_PhysicalDevice,
+                            queueFamilyIndices.graphicsFamily.value(),
+                            m_DeviceProperties.limits.timestamp_period,
+                            MAX_FRAMES_IN_FLIGHT);
+}
+
 //===============================================================================
 bool VulkanRenderer::CreateSyncObjects()
 {
@@ -986,33 +1365,22 @@ bool VulkanRenderer::CreateVertexBuffers()
 {
   try
   {
-    const vk::DeviceSize bufferSize{sizeof(vertices[0]) * vertices.size()};
-
-    vk::Buffer       stagingBuffer;
-    vk::DeviceMemory staggingBufferMemory;
-    CreateBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer,
-                 staggingBufferMemory);
-    void* data = nullptr;
-    if (m_Device.mapMemory(staggingBufferMemory, 0, bufferSize, {}, &data) != vk::Result::eSuccess)
-    {
-      LOG_CORE_ERROR("failed to map vertex buffer memory!");
-      return false;
-    }
-    memcpy(data, vertices.data(), static_cast<size_t>(bufferSize));
-    m_Device.unmapMemory(staggingBufferMemory);
+    // cooked streams are copied from the mapping straight into staging memory, nothing is parsed
+    const std::span<const std::byte> data = m_DemoMesh.IsOpen() ? m_DemoMesh.GetVertexData()
+                                                                : std::as_bytes(std::span{vertices});
+    const vk::DeviceSize             bufferSize{data.size()};
 
-    CreateBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                 vk::MemoryPropertyFlagBits::eDeviceLocal,
-                 m_VertexBuffer,
-                 m_VertexBufferMemory);
+    m_VertexBuffer = m_Allocator.CreateBuffer(bufferSize,
+                                              vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+                                              MemoryUsage::GpuOnly);
 
-    CopyBuffer(stagingBuffer, m_VertexBuffer, bufferSize);
-    m_Device.destroyBuffer(stagingBuffer);
-    m_Device.freeMemory(staggingBufferMemory);
+    // copied on the transfer queue, first frame waits for it instead of stalling here
+    m_Uploader.UploadBuffer(data.data(),
+                            bufferSize,
+                            m_VertexBuffer.buffer,
+                            0,
+                            vk::PipelineStageFlagBits2::eVertexInput,
+                            vk::AccessFlagBits2::eVertexAttributeRead);
 
     return true;
   } catch (const std::exception& e)
@@ -1027,32 +1395,131 @@ bool VulkanRenderer::CreateIndexBuffers()
 {
   try
   {
-    const vk::DeviceSize bufferSize{sizeof(indices[0]) * indices.size()};
-    vk::Buffer           stagingBuffer;
-    vk::DeviceMemory     staggingBufferMemory;
-    CreateBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer,
-                 staggingBufferMemory);
-    void* data = m_Device.mapMemory(staggingBufferMemory, 0, bufferSize);
-    if (data == nullptr)
+    // built-in quads get their meshlets here, cooked meshes bring them
+    MeshData    builtIn;
+    MeshletData builtInMeshlets;
+    if (!m_DemoMesh.IsOpen())
     {
-      LOG_CORE_ERROR("failed to map index buffer memory!");
-      return false;
+      for (const Vertex& vertex : vertices)
+      {
+        builtIn.vertices.push_back({.position = vertex.pos, .color = vertex.color, .texCoord = vertex.texCoord});
+      }
+      builtIn.indices = indices;
+      for (u32 firstIndex = 0; firstIndex < indices.size(); firstIndex += 6)
+      {
+        builtIn.submeshes.push_back({.firstIndex = firstIndex, .indexCount = 6});
+      }
+      builtInMeshlets = BuildMeshlets(builtIn);
+    }
+    const std::span<const Meshlet> meshlets = m_DemoMesh.IsOpen() ? m_DemoMesh.GetMeshlets()
+                                                                  : std::span<const Meshlet>{builtInMeshlets.meshlets};
+
+    // the gpu driven path draws meshlet by meshlet, their triangles follow the mesh indices as plain index ranges
+    const std::span<const std::byte> data = m_DemoMesh.IsOpen() ? m_DemoMesh.GetIndexData()
+                                                                : std::as_bytes(std::span{indices});
+    std::vector<u32>        meshletIndices;
+    std::vector<GpuMeshlet> gpuMeshlets;
+    if (m_GpuDrivenSupported)
+    {
+      meshletIndices = m_DemoMesh.IsOpen()
+                         ? ExpandMeshletIndices(meshlets, m_DemoMesh.GetMeshletVertices(), m_DemoMesh.GetMeshletTriangles())
+                         : ExpandMeshletIndices(meshlets, builtInMeshlets.vertices, builtInMeshlets.triangles);
+      auto firstIndex = static_cast<u32>(data.size() / sizeof(u32));
+      for (const Meshlet& meshlet : meshlets)
+      {
+        gpuMeshlets.push_back({.boundingSphere = meshlet.boundingSphere,
+                               .cone           = meshlet.cone,
+                               .firstIndex     = firstIndex,
+                               .indexCount     = meshlet.triangleCount * 3});
+        firstIndex += meshlet.triangleCount * 3;
+      }
+    }
+    const vk::DeviceSize bufferSize{data.size() + meshletIndices.size() * sizeof(u32)};
+
+    m_IndexBuffer = m_Allocator.CreateBuffer(bufferSize,
+                                             vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+                                             MemoryUsage::GpuOnly);
+
+    // copied on the transfer queue, first frame waits for it instead of stalling here
+    m_Uploader.UploadBuffer(data.data(),
+                            data.size(),
+                            m_IndexBuffer.buffer,
+                            0,
+                            vk::PipelineStageFlagBits2::eVertexInput,
+                            vk::AccessFlagBits2::eIndexRead);
+    if (!meshletIndices.empty())
+    {
+      m_Uploader.UploadBuffer(meshletIndices.data(),
+                              meshletIndices.size() * sizeof(u32),
+                              m_IndexBuffer.buffer,
+                              data.size(),
+                              vk::PipelineStageFlagBits2::eVertexInput,
+                              vk::AccessFlagBits2::eIndexRead);
+    }
+    if (!gpuMeshlets.empty())
+    {
+      m_MeshletBuffer = m_Allocator.CreateBuffer(gpuMeshlets.size() * sizeof(GpuMeshlet),
+                                                 vk::BufferUsageFlagBits::eTransferDst |
+                                                   vk::BufferUsageFlagBits::eStorageBuffer,
+                                                 MemoryUsage::GpuOnly);
+      m_Uploader.UploadBuffer(gpuMeshlets.data(),
+                              gpuMeshlets.size() * sizeof(GpuMeshlet),
+                              m_MeshletBuffer.buffer,
+                              0,
+                              vk::PipelineStageFlagBits2::eComputeShader,
+                              vk::AccessFlagBits2::eShaderStorageRead);
+      LOG_CORE_INFO("{} meshlets, {} expanded indices for meshlet culling", gpuMeshlets.size(), meshletIndices.size());
     }
-    memcpy(data, indices.data(), static_cast<size_t>(bufferSize));
-    m_Device.unmapMemory(staggingBufferMemory);
 
-    CreateBuffer(bufferSize,
-                 vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                 vk::MemoryPropertyFlagBits::eDeviceLocal,
-                 m_IndexBuffer,
-                 m_IndexBufferMemory);
+    m_DrawList.clear();
+    if (m_DemoMesh.IsOpen())
+    {
+      // one draw per submesh, bounds and lods come cooked
+      const auto submeshes = m_DemoMesh.GetSubmeshes();
+      const auto lods      = m_DemoMesh.GetLods();
+      m_MeshLods.assign(lods.begin(), lods.end());
+      for (u32 i = 0; i < submeshes.size(); ++i)
+      {
+        m_DrawList.push_back({.indexCount     = submeshes[i].indexCount,
+                              .firstIndex     = submeshes[i].firstIndex,
+                              .vertexOffset   = submeshes[i].vertexOffset,
+                              .boundingSphere = submeshes[i].boundingSphere,
+                              .textureIndex   = m_TextureIndex,
+                              .mesh           = i,
+                              .material       = m_TextureIndex,
+                              .firstMeshlet   = submeshes[i].firstMeshlet,
+                              .meshletCount   = submeshes[i].meshletCount,
+                              .firstLod       = submeshes[i].firstLod,
+                              .lodCount       = submeshes[i].lodCount});
+      }
 
-    CopyBuffer(stagingBuffer, m_IndexBuffer, bufferSize);
-    m_Device.destroyBuffer(stagingBuffer);
-    m_Device.freeMemory(staggingBufferMemory);
+      // both streams are in staging memory, the mapping is not needed anymore
+      m_DemoMesh.Close();
+      return true;
+    }
+
+    // one draw per quad of the mesh, bounded by the sphere around its vertices
+    for (const MeshSubmesh& quad : builtIn.submeshes)
+    {
+      glm::vec3 center{0.0F};
+      for (u32 i = quad.firstIndex; i < quad.firstIndex + 6; ++i)
+      {
+        center += vertices[indices[i]].pos / 6.0F;
+      }
+      f32 radius{0.0F};
+      for (u32 i = quad.firstIndex; i < quad.firstIndex + 6; ++i)
+      {
+        radius = std::max(radius, glm::length(vertices[indices[i]].pos - center));
+      }
+      m_DrawList.push_back({.indexCount     = 6,
+                            .firstIndex     = quad.firstIndex,
+                            .boundingSphere = glm::vec4{center, radius},
+                            .textureIndex   = m_TextureIndex,
+                            .mesh           = quad.firstIndex / 6,
+                            .material       = m_TextureIndex,
+                            .firstMeshlet   = quad.firstMeshlet,
+                            .meshletCount   = quad.meshletCount});
+    }
 
     return true;
   } catch (const std::exception& e)
@@ -1067,45 +1534,61 @@ bool VulkanRenderer::CreateUniformBuffers()
 {
   try
   {
-    vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
+    vk::DeviceSize bufferSize = sizeof(CameraUniforms);
 
     m_UniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    m_UniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-    m_UniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    for (auto& uniformBuffer : m_UniformBuffers)
+    {
+      // device local, written every frame by a copy from the staging ring
+      uniformBuffer = m_Allocator.CreateBuffer(bufferSize,
+                                               vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformBuffer,
+                                               MemoryUsage::GpuOnly);
+    }
+    return true;
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create uniform buffer!, exception: {0}", e.what());
+  }
+  return false;
+}
+//===============================================================================
+bool VulkanRenderer::CreateObjectBuffers()
+{
+  try
+  {
+    m_GpuObjects.reserve(MAX_DRAW_OBJECTS);
+    m_ObjectBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    for (auto& objectBuffer : m_ObjectBuffers)
     {
-      CreateBuffer(bufferSize,
-                   vk::BufferUsageFlagBits::eUniformBuffer,
-                   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                   m_UniformBuffers[i],
-                   m_UniformBuffersMemory[i]);
-      if (m_Device.mapMemory(m_UniformBuffersMemory[i], 0, bufferSize, {}, &m_UniformBuffersMapped[i]) != vk::Result::eSuccess)
+      // written by the cpu every frame, read in place by the vertex shader
+      objectBuffer = m_Allocator.CreateBuffer(sizeof(GpuObjectData) * MAX_DRAW_OBJECTS,
+                                              vk::BufferUsageFlagBits::eStorageBuffer,
+                                              MemoryUsage::Upload);
+      if (objectBuffer.mapped == nullptr)
       {
-        LOG_CORE_ERROR("failed to map uniform buffer memory!");
+        LOG_CORE_ERROR("failed to map object buffer memory!");
         return false;
       }
     }
     return true;
   } catch (const std::exception& e)
   {
-    LOG_CORE_ERROR("failed to create uniform buffer!, exception: {0}", e.what());
+    LOG_CORE_ERROR("failed to create object buffer!, exception: {0}", e.what());
   }
   return false;
 }
+
 //===============================================================================
 void VulkanRenderer::ReCreateSwapChain()
 {
-  const auto renderTime = std::chrono::high_resolution_clock::now();
-  while (m_Window.GetWidth() == 0 || m_Window.GetHeight() == 0)
+  // minimized, retried with the next frame. window events belong to the main thread, render thread can not wait on them
+  if (m_Window->GetWidth() == 0 || m_Window->GetHeight() == 0)
   {
-    m_Window.WaitEvents();
+    return;
   }
-  const auto renderTimeDuration = std::chrono::duration_cast<std::chrono::microseconds>(
-    std::chrono::high_resolution_clock::now() - renderTime);
-  LOG_CORE_INFO("rocord Render time: {0} us", renderTimeDuration.count());
   m_Device.waitIdle();
   CleanupSwapChain();
+  m_PresentId = 0;
   if (CreateSwapChain() && CreateImageViews() && CreateDepthResources() && CreateFramebuffers())
   {
     // success
@@ -1119,8 +1602,7 @@ void VulkanRenderer::ReCreateSwapChain()
 void VulkanRenderer::CleanupSwapChain()
 {
   m_Device.destroyImageView(m_DepthImage.ImageView);
-  m_Device.destroyImage(m_DepthImage.image);
-  m_Device.freeMemory(m_DepthImage.imageMemory);
+  m_Allocator.DestroyImage(m_DepthImage);
 
   for (auto& framebuffer : m_SwapChainFramebuffers)
   {
@@ -1132,20 +1614,26 @@ void VulkanRenderer::CleanupSwapChain()
     m_Device.destroyImageView(imageView);
   }
   m_Device.destroySwapchainKHR(m_SwapChain);
+  m_Allocator.DestroyImage(m_OffscreenColor);
 }
 
 //===============================================================================
-void VulkanRenderer::RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t imageIndex) const
+void VulkanRenderer::RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t imageIndex)
 {
-  const auto&                      extent = GetExtent();
-  const vk::CommandBufferBeginInfo beginInfo{};
-  cmd.begin(beginInfo);
+  FOUR_PROFILE_FUNCTION();
+  const auto& extent = GetExtent();
 
   const std::array clearValues{
     vk::ClearValue{.color = vk::ClearColorValue{.float32 = {{0.0F, 0.0F, 0.0F, 1.0F}}}},
     vk::ClearValue{.depthStencil = {.depth = 1.0F, .stencil = 0}},
   };
 
+  // gpu driven path draws everything with one indirect call, otherwise big batch lists are split over the
+  // recorder threads, small ones are not worth the hand off
+  const auto batchCount = static_cast<u32>(m_FramePacket->batches.size());
+  const bool parallel =
+    !m_GpuDrivenSupported && batchCount >= PARALLEL_RECORD_MIN_DRAWS && m_Recorder.GetThreadCount() > 1;
+
   //begin render pass
   const vk::RenderPassBeginInfo renderPassInfo{
     .renderPass      = m_RenderPass,
@@ -1154,11 +1642,81 @@ void VulkanRenderer::RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t
     .clearValueCount = static_cast<uint32_t>(clearValues.size()),
     .pClearValues    = clearValues.data(),
   };
-  cmd.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+  cmd.beginRenderPass(renderPassInfo,
+                      parallel ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline);
+
+  if (m_GpuDrivenSupported)
+  {
+    RecordIndirectDraws(cmd);
+  }
+  else if (parallel)
+  {
+    const vk::CommandBufferInheritanceInfo inheritance{.renderPass  = m_RenderPass,
+                                                       .subpass     = 0,
+                                                       .framebuffer = m_SwapChainFramebuffers[imageIndex]};
+    const auto secondaries = m_Recorder.Record(m_CurrentFrame,
+                                               inheritance,
+                                               batchCount,
+                                               [this](vk::CommandBuffer secondary, u32 begin, u32 end)
+                                               { RecordDraws(secondary, begin, end); });
+    // every slice failed to record, nothing to execute
+    if (!secondaries.empty())
+    {
+      cmd.executeCommands(static_cast<uint32_t>(secondaries.size()), secondaries.data());
+    }
+  }
+  else
+  {
+    RecordDraws(cmd, 0, batchCount);
+  }
 
-  // basic draw
-  cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_GraphicsPipeline);
-  std::array vertexBuffers = {m_VertexBuffer};
+  // draw ImGui
+  // DrawImGui(commandBuffer, m_SwapChainImageViews[imageIndex]);
+
+  //end render pass
+  cmd.endRenderPass();
+}
+
+//===============================================================================
+void VulkanRenderer::RecordDraws(vk::CommandBuffer cmd, u32 begin, u32 end) const
+{
+  // state is not inherited by secondary command buffers, every slice binds it again
+  BindGeometryState(cmd, m_GraphicsPipeline, m_PipelineLayout);
+
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_PipelineLayout, 2, m_ObjectSets[m_CurrentFrame], {});
+
+  // object i of the buffer belongs to draw i, the instances of a batch are consecutive draws of the same mesh,
+  // firstInstance hands the index of the first one to gl_InstanceIndex
+  for (u32 i = begin; i < end; ++i)
+  {
+    const RenderBatch& batch = m_FramePacket->batches[i];
+    if (batch.first >= MAX_DRAW_OBJECTS)
+    {
+      break;
+    }
+    const DrawItem& item  = m_FramePacket->draws[batch.first];
+    const u32       count = std::min(batch.count, MAX_DRAW_OBJECTS - batch.first);
+    cmd.drawIndexed(item.indexCount, count, item.firstIndex, item.vertexOffset, batch.first);
+  }
+}
+
+//===============================================================================
+void VulkanRenderer::RecordIndirectDraws(vk::CommandBuffer cmd) const
+{
+  BindGeometryState(cmd, m_IndirectPipeline, m_IndirectPipelineLayout);
+  const vk::DescriptorSet objectSet = m_GpuCulling.GetObjectSet(m_CurrentFrame);
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_IndirectPipelineLayout, 2, objectSet, {});
+
+  m_GpuCulling.RecordDraw(cmd, m_CurrentFrame);
+}
+
+//===============================================================================
+void VulkanRenderer::BindGeometryState(vk::CommandBuffer cmd, vk::Pipeline pipeline, vk::PipelineLayout layout) const
+{
+  const auto& extent = GetExtent();
+
+  cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+  std::array vertexBuffers = {m_VertexBuffer.buffer};
   std::array offsets       = {vk::DeviceSize{0}};
 
   vk::Viewport viewport{
@@ -1175,78 +1733,93 @@ void VulkanRenderer::RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t
   cmd.setScissor(0, 1, &scissor);
 
   cmd.bindVertexBuffers(0, 1, vertexBuffers.data(), offsets.data());
-  cmd.bindIndexBuffer(m_IndexBuffer, 0, vk::IndexType::eUint16);
-  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_PipelineLayout, 0, 1, &m_DescriptorSets[m_CurrentFrame], 0, nullptr);
-
-  cmd.drawIndexed(indices.size(), 1, 0, 0, 0);
-
-  // draw ImGui
-  // DrawImGui(commandBuffer, m_SwapChainImageViews[imageIndex]);
-
-  //end render pass
-  cmd.endRenderPass();
-
-
-  cmd.end();
+  cmd.bindIndexBuffer(m_IndexBuffer.buffer, 0, vk::IndexType::eUint32);
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0, 1, &m_DescriptorSets[m_CurrentFrame], 0, nullptr);
+  if (m_BindlessSupported)
+  {
+    // one bind per command buffer, draws pick their resources by index
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 1, m_Bindless.GetSet(), {});
+  }
 }
 
 //===============================================================================
-vk::CommandBuffer VulkanRenderer::BeginSingleTimeCommands() const
+void VulkanRenderer::DrawFrame()
 {
-  vk::CommandBufferAllocateInfo allocInfo{.commandPool        = m_CommandPool,
-                                          .level              = vk::CommandBufferLevel::ePrimary,
-                                          .commandBufferCount = 1};
-  vk::CommandBuffer             commandBuffer{};
-  if (m_Device.allocateCommandBuffers(&allocInfo, &commandBuffer) != vk::Result::eSuccess)
+  FOUR_PROFILE_FUNCTION();
+
+  // headless has no simulation thread, it produces its own packets
+  if (IsHeadless())
   {
-    LOG_CORE_ERROR("failed to allocate command buffer!");
-    assert(false && "failed to allocate command buffer!");
+    PublishFramePacket(m_FrameNumber);
   }
-  commandBuffer.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-  return commandBuffer;
-}
+  m_FramePackets.Consume();
+  m_FramePacket = &m_FramePackets.GetReadBuffer();
 
-//===============================================================================
-void VulkanRenderer::EndSingleTimeCommands(vk::CommandBuffer commandBuffer) const
-{
-  commandBuffer.end();
-  m_GraphicsQueue.submit(vk::SubmitInfo{.commandBufferCount = 1, .pCommandBuffers = &commandBuffer});
-  m_GraphicsQueue.waitIdle();
-  m_Device.freeCommandBuffers(m_CommandPool, commandBuffer);
+  RenderFrame();
+
+  if (m_PresentPacing.load(std::memory_order_relaxed))
+  {
+    FOUR_PROFILE_SCOPE("WaitForPresent");
+    WaitForPresent();
+  }
+
+  {
+    const std::scoped_lock lock(m_RenderedMutex);
+    m_RenderedFrame = m_FramePacket->frameNumber;
+  }
+  m_RenderedCondition.notify_all();
 }
 
 //===============================================================================
-void VulkanRenderer::DrawFrame()
+void VulkanRenderer::RenderFrame()
 {
-  [[maybe_unused]] const auto result = m_Device.waitForFences(1,
-                                                              &m_Frames[m_CurrentFrame].inFlightFence,
-                                                              VK_TRUE,
-                                                              std::numeric_limits<uint64_t>::max());
+  {
+    FOUR_PROFILE_SCOPE("WaitFrameFence");
+    [[maybe_unused]] const auto result = m_Device.waitForFences(1,
+                                                                &m_Frames[m_CurrentFrame].inFlightFence,
+                                                                VK_TRUE,
+                                                                std::numeric_limits<uint64_t>::max());
+  }
 
   m_Frames[m_CurrentFrame].deletionQueue.flush();
 
+  // gpu is done with this frame, its staging region can be reused
+  m_StagingRing.BeginFrame(m_CurrentFrame);
+  if (m_BindlessSupported)
+  {
+    m_Bindless.BeginFrame(m_CurrentFrame);
+  }
+
+  // headless renders into its single offscreen target
   uint32_t imageIndex{};
-  switch (const vk::Result result = m_Device.acquireNextImageKHR(m_SwapChain,
-                                                                 std::numeric_limits<uint64_t>::max(),
-                                                                 m_Frames[m_CurrentFrame].imageAvailableSemaphore,
-                                                                 nullptr,
-                                                                 &imageIndex);
-          result)
-  {
-    case vk::Result::eErrorOutOfDateKHR:
+  if (!IsHeadless())
+  {
+    switch (const vk::Result result = m_Device.acquireNextImageKHR(m_SwapChain,
+                                                                   std::numeric_limits<uint64_t>::max(),
+                                                                   m_Frames[m_CurrentFrame].imageAvailableSemaphore,
+                                                                   nullptr,
+                                                                   &imageIndex);
+            result)
     {
-      ReCreateSwapChain();
-      return;
+      case vk::Result::eErrorOutOfDateKHR:
+      {
+        ReCreateSwapChain();
+        return;
+      }
+      case vk::Result::eSuccess:
+      case vk::Result::eSuboptimalKHR:
+        break;
+      default:
+        LOG_CORE_ERROR("failed to acquire swap chain image!");
+        return;
     }
-    case vk::Result::eSuccess:
-    case vk::Result::eSuboptimalKHR:
-      break;
-    default:
-      LOG_CORE_ERROR("failed to acquire swap chain image!");
-      return;
   }
 
+  // kick uploads recorded since last frame, they run on the transfer queue while this frame is recorded
+  m_Uploader.Submit();
+
   UpdateUniformBuffer(m_CurrentFrame);
+  UpdateObjects();
 
   if (m_Device.resetFences(1, &m_Frames[m_CurrentFrame].inFlightFence) != vk::Result::eSuccess)
   {
@@ -1256,33 +1829,78 @@ void VulkanRenderer::DrawFrame()
 
   auto cmd = m_Frames[m_CurrentFrame].commandBuffer;
   cmd.reset();
+  cmd.begin(vk::CommandBufferBeginInfo{});
+  m_GpuProfiler.BeginFrame(cmd, m_CurrentFrame, m_FramePacket->frameNumber);
+
+  u32       pass            = m_GpuProfiler.BeginPass(cmd, "Upload");
+  const u64 uploadWaitValue = m_Uploader.RecordAcquireBarriers(cmd);
+  RecordDynamicCopies(cmd);
+  m_GpuProfiler.EndPass(cmd, pass);
+  if (m_GpuDrivenSupported)
+  {
+    pass = m_GpuProfiler.BeginPass(cmd, "Cull");
+    const glm::vec3 viewPosition{glm::inverse(m_CameraUniforms.view)[3]};
+    m_GpuCulling.RecordCull(cmd, m_CurrentFrame, m_CameraUniforms.viewProj, viewPosition);
+    m_GpuProfiler.EndPass(cmd, pass);
+  }
+  pass = m_GpuProfiler.BeginPass(cmd, "Scene");
   RecordCommandBuffer(cmd, imageIndex);
+  m_GpuProfiler.EndPass(cmd, pass);
+  cmd.end();
 
+  std::array signalSemaphores = {GetCurrentFrameData().renderFinishedSemaphore};
 
-  std::array                            waitSemaphores   = {GetCurrentFrameData().imageAvailableSemaphore};
-  std::array<vk::PipelineStageFlags, 1> waitStages       = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-  std::array                            signalSemaphores = {GetCurrentFrameData().renderFinishedSemaphore};
+  // binary swapchain semaphore, plus the uploader timeline when this frame consumes freshly uploaded data
+  std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+  if (!IsHeadless())
+  {
+    waitInfos.push_back({.semaphore = GetCurrentFrameData().imageAvailableSemaphore,
+                         .value     = 0,
+                         .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput});
+  }
+  if (uploadWaitValue != 0)
+  {
+    waitInfos.push_back({.semaphore = m_Uploader.GetTimelineSemaphore(),
+                         .value     = uploadWaitValue,
+                         .stageMask = vk::PipelineStageFlagBits2::eAllCommands});
+  }
+  const vk::SemaphoreSubmitInfo     signalInfo{.semaphore = signalSemaphores[0],
+                                               .value     = 0,
+                                               .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+  const vk::CommandBufferSubmitInfo cmdInfo{.commandBuffer = cmd};
 
   assert(cmd && "Command buffer is null!");
-  m_GraphicsQueue.submit(vk::SubmitInfo{.waitSemaphoreCount   = 1,
-                                        .pWaitSemaphores      = waitSemaphores.data(),
-                                        .pWaitDstStageMask    = waitStages.data(),
-                                        .commandBufferCount   = 1,
-                                        .pCommandBuffers      = &cmd,
-                                        .signalSemaphoreCount = 1,
-                                        .pSignalSemaphores    = signalSemaphores.data()},
-                         GetCurrentFrameData().inFlightFence);
+  m_GraphicsQueue.submit2(vk::SubmitInfo2{.waitSemaphoreInfoCount   = static_cast<uint32_t>(waitInfos.size()),
+                                          .pWaitSemaphoreInfos      = waitInfos.data(),
+                                          .commandBufferInfoCount   = 1,
+                                          .pCommandBufferInfos      = &cmdInfo,
+                                          .signalSemaphoreInfoCount = IsHeadless() ? 0U : 1U,
+                                          .pSignalSemaphoreInfos    = &signalInfo},
+                          GetCurrentFrameData().inFlightFence);
+
+  ++m_FrameNumber;
+  if (IsHeadless())
+  {
+    // nothing to present, the frame stays in the offscreen target until the next one
+    m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    return;
+  }
+
+  // ids let the frame pacer wait for this image to reach the display
+  const u64              presentId = ++m_PresentId;
+  const vk::PresentIdKHR presentIdInfo{.swapchainCount = 1, .pPresentIds = &presentId};
 
   std::array swapChains = {m_SwapChain};
   if (const vk::Result result = m_PresentQueue.presentKHR(
-        {.waitSemaphoreCount = 1,
+        {.pNext              = m_PresentWaitSupported ? &presentIdInfo : nullptr,
+         .waitSemaphoreCount = 1,
          .pWaitSemaphores    = signalSemaphores.data(),
          .swapchainCount     = 1,
          .pSwapchains        = swapChains.data(),
          .pImageIndices      = &imageIndex});
-      result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || m_Window.WasWindowResized())
+      result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || m_Window->WasWindowResized())
   {
-    m_Window.ResetWindowResized();
+    m_Window->ResetWindowResized();
     ReCreateSwapChain();
   }
   else if (result != vk::Result::eSuccess)
@@ -1307,35 +1925,16 @@ void VulkanRenderer::DrawImGui(vk::CommandBuffer cmd, vk::ImageView targetImageV
   cmd.endRendering();
 }
 
-//===============================================================================
-void VulkanRenderer::CreateBuffer(vk::DeviceSize          size,
-                                  vk::BufferUsageFlags    usage,
-                                  vk::MemoryPropertyFlags properties,
-                                  vk::Buffer&             buffer,
-                                  vk::DeviceMemory&       bufferMemory)
-{
-  buffer = m_Device.createBuffer(
-    vk::BufferCreateInfo{.size = size, .usage = usage, .sharingMode = vk::SharingMode::eExclusive});
-
-  const vk::MemoryRequirements memRequirment = m_Device.getBufferMemoryRequirements(buffer);
-  const vk::MemoryAllocateInfo allocInfo{.allocationSize  = memRequirment.size,
-                                         .memoryTypeIndex = FindMemoryType(memRequirment.memoryTypeBits, properties)};
-  if (m_Device.allocateMemory(&allocInfo, nullptr, &bufferMemory) != vk::Result::eSuccess)
-  {
-    LOG_CORE_ERROR("failed to allocate buffer memory!");
-    throw std::runtime_error("failed to allocate buffer memory!");
-  }
-  m_Device.bindBufferMemory(buffer, bufferMemory, 0);
-}
-
 //===============================================================================
 bool VulkanRenderer::CreateDescriptorPool()
 {
-  const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+  const std::array<vk::DescriptorPoolSize, 3> poolSizes{
     {{.type = vk::DescriptorType::eUniformBuffer, .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)},
-     {.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)}},
+     {.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)},
+     {.type = vk::DescriptorType::eStorageBuffer, .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)}},
   };
-  const vk::DescriptorPoolCreateInfo poolInfo{.maxSets       = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
+  // camera set and object set per frame
+  const vk::DescriptorPoolCreateInfo poolInfo{.maxSets       = static_cast<uint32_t>(2 * MAX_FRAMES_IN_FLIGHT),
                                               .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
                                               .pPoolSizes    = poolSizes.data()};
   if (m_Device.createDescriptorPool(&poolInfo, nullptr, &m_DescriptorPool) != vk::Result::eSuccess)
@@ -1362,12 +1961,28 @@ bool VulkanRenderer::CreateDescriptorSets()
     return false;
   }
 
+  // object sets point at whole buffers and are never written again, draws only pick their index
+  const std::vector<vk::DescriptorSetLayout> objectLayouts(MAX_FRAMES_IN_FLIGHT, m_ObjectSetLayout);
+  m_ObjectSets = m_Device.allocateDescriptorSets({.descriptorPool     = m_DescriptorPool,
+                                                  .descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
+                                                  .pSetLayouts        = objectLayouts.data()});
+  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+  {
+    const vk::DescriptorBufferInfo objectInfo{.buffer = m_ObjectBuffers[i].buffer, .offset = 0, .range = VK_WHOLE_SIZE};
+    const vk::WriteDescriptorSet   objectWrite{.dstSet          = m_ObjectSets[i],
+                                               .dstBinding      = 0,
+                                               .descriptorCount = 1,
+                                               .descriptorType  = vk::DescriptorType::eStorageBuffer,
+                                               .pBufferInfo     = &objectInfo};
+    m_Device.updateDescriptorSets(objectWrite, {});
+  }
+
   for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
   {
     const vk::DescriptorBufferInfo bufferInfo{
-      .buffer = m_UniformBuffers[i],
+      .buffer = m_UniformBuffers[i].buffer,
       .offset = 0,
-      .range  = sizeof(UniformBufferObject),
+      .range  = sizeof(CameraUniforms),
     };
     const vk::DescriptorImageInfo imageInfo{
       .sampler     = m_TextureSampler,
@@ -1403,14 +2018,11 @@ bool VulkanRenderer::CreateDepthResources()
   try
   {
     const vk::Format depthFormat = FindDepthFormat();
-    CreateImage(m_SwapChainExtent.width,
-                m_SwapChainExtent.height,
-                depthFormat,
-                vk::ImageTiling::eOptimal,
-                vk::ImageUsageFlagBits::eDepthStencilAttachment,
-                vk::MemoryPropertyFlagBits::eDeviceLocal,
-                m_DepthImage.image,
-                m_DepthImage.imageMemory);
+    m_DepthImage                 = CreateImage(m_SwapChainExtent.width,
+                                               m_SwapChainExtent.height,
+                                               depthFormat,
+                                               vk::ImageTiling::eOptimal,
+                                               vk::ImageUsageFlagBits::eDepthStencilAttachment);
     m_DepthImage.ImageView = CreateImageView(m_DepthImage.image, depthFormat, vk::ImageAspectFlagBits::eDepth);
     return true;
   } catch (const std::exception& e)
@@ -1436,41 +2048,22 @@ bool VulkanRenderer::CreateTextureImage()
       LOG_CORE_ERROR("failed to load texture image!");
       return false;
     }
-    vk::Buffer       stagingBuffer;
-    vk::DeviceMemory stagingBufferMemory;
-    CreateBuffer(imageSize,
-                 vk::BufferUsageFlagBits::eTransferSrc,
-                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                 stagingBuffer,
-                 stagingBufferMemory);
-    auto* data = m_Device.mapMemory(stagingBufferMemory, 0, imageSize);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    m_Device.unmapMemory(stagingBufferMemory);
-
+    m_TextureImage = CreateImage(static_cast<uint32_t>(texWidth),
+                                 static_cast<uint32_t>(texHeight),
+                                 vk::Format::eR8G8B8A8Srgb,
+                                 vk::ImageTiling::eOptimal,
+                                 vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled);
+
+    // pixels are copied into staging memory by the uploader, safe to free right after
+    m_Uploader.UploadImage(pixels,
+                           imageSize,
+                           m_TextureImage.image,
+                           {.width = static_cast<uint32_t>(texWidth), .height = static_cast<uint32_t>(texHeight), .depth = 1},
+                           vk::ImageLayout::eShaderReadOnlyOptimal,
+                           vk::PipelineStageFlagBits2::eFragmentShader,
+                           vk::AccessFlagBits2::eShaderSampledRead);
     stbi_image_free(pixels);
 
-    CreateImage(static_cast<uint32_t>(texWidth),
-                static_cast<uint32_t>(texHeight),
-                vk::Format::eR8G8B8A8Srgb,
-                vk::ImageTiling::eOptimal,
-                vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-                vk::MemoryPropertyFlagBits::eDeviceLocal,
-                m_TextureImage.image,
-                m_TextureImage.imageMemory);
-    TransitionImageLayout(m_TextureImage.image,
-                          vk::Format::eR8G8B8A8Srgb,
-                          vk::ImageLayout::eUndefined,
-                          vk::ImageLayout::eTransferDstOptimal);
-    CopyBufferToImage(stagingBuffer, m_TextureImage.image, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-    TransitionImageLayout(m_TextureImage.image,
-                          vk::Format::eR8G8B8A8Srgb,
-                          vk::ImageLayout::eTransferDstOptimal,
-                          vk::ImageLayout::eShaderReadOnlyOptimal);
-
-    // clean up
-    m_Device.destroyBuffer(stagingBuffer);
-    m_Device.freeMemory(stagingBufferMemory);
-
     return true;
   } catch (const std::exception& e)
   {
@@ -1515,6 +2108,12 @@ bool VulkanRenderer::CreateTextureSampler()
       .minLod                  = 0.0F,
       .maxLod                  = 0.0F,
     });
+
+    // registered once, draws reference it by index
+    if (m_BindlessSupported)
+    {
+      m_TextureIndex = m_Bindless.RegisterTexture(m_TextureImage.ImageView, m_TextureSampler);
+    }
     return true;
   } catch (const std::exception& e)
   {
@@ -1523,43 +2122,27 @@ bool VulkanRenderer::CreateTextureSampler()
   return false;
 }
 //===============================================================================
-void VulkanRenderer::CreateImage(
-  uint32_t                width,
-  uint32_t                height,
-  vk::Format              format,
-  vk::ImageTiling         tiling,
-  vk::ImageUsageFlags     usage,
-  vk::MemoryPropertyFlags properties,
-  vk::Image&              textureImage,
-  vk::DeviceMemory&       textureImageMemory) const
-{
-  textureImage              = m_Device.createImage({
-                 .imageType     = vk::ImageType::e2D,
-                 .format        = format,
-                 .extent        = {.width = width, .height = height, .depth = 1},
-                 .mipLevels     = 1,
-                 .arrayLayers   = 1,
-                 .samples       = vk::SampleCountFlagBits::e1,
-                 .tiling        = tiling,
-                 .usage         = usage,
-                 .sharingMode   = vk::SharingMode::eExclusive,
-                 .initialLayout = vk::ImageLayout::eUndefined,
-  });
-  const auto memRequirments = m_Device.getImageMemoryRequirements(textureImage);
-  textureImageMemory        = m_Device.allocateMemory({
-           .allocationSize  = memRequirments.size,
-           .memoryTypeIndex = FindMemoryType(memRequirments.memoryTypeBits, properties),
-  });
-  m_Device.bindImageMemory(textureImage, textureImageMemory, 0);
-}
-
-//===============================================================================
-void VulkanRenderer::CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size) const
-{
-  vk::CommandBuffer commandBuffer{BeginSingleTimeCommands()};
-  vk::BufferCopy    copyRegion{.size = size};
-  commandBuffer.copyBuffer(srcBuffer, dstBuffer, copyRegion);
-  EndSingleTimeCommands(commandBuffer);
+AllocatedImage VulkanRenderer::CreateImage(uint32_t            width,
+                                           uint32_t            height,
+                                           vk::Format          format,
+                                           vk::ImageTiling     tiling,
+                                           vk::ImageUsageFlags usage,
+                                           MemoryUsage         memoryUsage)
+{
+  return m_Allocator.CreateImage(
+    {
+      .imageType     = vk::ImageType::e2D,
+      .format        = format,
+      .extent        = {.width = width, .height = height, .depth = 1},
+      .mipLevels     = 1,
+      .arrayLayers   = 1,
+      .samples       = vk::SampleCountFlagBits::e1,
+      .tiling        = tiling,
+      .usage         = usage,
+      .sharingMode   = vk::SharingMode::eExclusive,
+      .initialLayout = vk::ImageLayout::eUndefined,
+    },
+    memoryUsage);
 }
 
 //===============================================================================
@@ -1569,114 +2152,266 @@ void VulkanRenderer::StopRenderImpl()
 }
 
 //===============================================================================
-uint32_t VulkanRenderer::FindMemoryType(uint32_t typeFilter, const vk::MemoryPropertyFlags& properties) const
+void VulkanRenderer::PublishFramePacket(u64 frameNumber)
 {
-  vk::PhysicalDeviceMemoryProperties memProperties{m_PhysicalDevice.getMemoryProperties()};
-  for (size_t i = 0; i < memProperties.memoryTypeCount; ++i)
+  FOUR_PROFILE_FUNCTION();
+
+  // frames between two fixed updates blend them
+  // headless animates by frame number, so the same frame always renders the same image
+  const Camera camera = Camera::Interpolate(m_PreviousCamera, m_MainCamera, m_InterpolationAlpha);
+  FramePacket& packet = m_FramePackets.GetWriteBuffer();
+  packet.frameNumber  = frameNumber;
+  packet.view         = camera.GetViewMatrix();
+  packet.time         = IsHeadless() ? static_cast<f32>(frameNumber) * HEADLESS_FRAME_TIME
+                                     : glm::mix(m_PreviousSimulationTime, m_SimulationTime, m_InterpolationAlpha);
+
+  // demo scene spins around z, every object keeps its own model matrix on top
+  const glm::mat4 spin = glm::rotate(glm::mat4(1.0F), packet.time * glm::radians(90.0F), glm::vec3(0.0F, 0.0F, 1.0F));
+  SelectLods(spin, glm::vec3{glm::inverse(packet.view)[3]});
+
+  // sorted by pipeline, material and mesh, runs of the same mesh become one instanced draw
+  // every lod is a mesh of its own, objects of one mesh at different lods are not merged
+  m_RenderQueue.Clear();
+  for (u32 i = 0; i < m_DrawList.size(); ++i)
   {
-    if (((typeFilter & (1 << i)) != 0U) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+    m_RenderQueue.Push(RenderKey::Make(0, m_DrawList[i].material, m_DrawList[i].mesh * MESH_MAX_LODS + m_LodLevels[i]),
+                       i);
+  }
+  m_RenderQueue.Build();
+
+  const auto entries = m_RenderQueue.GetEntries();
+  const auto batches = m_RenderQueue.GetBatches();
+  packet.draws.resize(entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    DrawItem& draw = packet.draws[i];
+    draw           = m_DrawList[entries[i].item];
+    draw.model     = spin * draw.model;
+
+    // meshlets only cover the full detail range, coarser lods are drawn as a whole
+    if (const u32 lod = m_LodLevels[entries[i].item]; lod > 0)
     {
-      return i;
+      draw.firstIndex   = m_MeshLods[draw.firstLod + lod].firstIndex;
+      draw.indexCount   = m_MeshLods[draw.firstLod + lod].indexCount;
+      draw.meshletCount = 0;
     }
   }
+  packet.batches.assign(batches.begin(), batches.end());
 
-  LOG_CORE_ERROR("failed to find suitable memory type!");
-  // TODO: not sure if it is recoverable
-  assert(false && "failed to find suitable memory type!");
-  return {};
+  m_FramePackets.Publish();
+  m_PublishedFrame = frameNumber;
+  m_PacketSignal.fetch_add(1, std::memory_order_release);
+  m_PacketSignal.notify_one();
 }
 
 //===============================================================================
-void VulkanRenderer::UpdateUniformBuffer(uint32_t currentImage)
+void VulkanRenderer::SelectLods(const glm::mat4& transform, const glm::vec3& viewPosition)
 {
-  static auto startTime = std::chrono::high_resolution_clock::now();
+  FOUR_PROFILE_FUNCTION();
 
-  const auto  currentTime = std::chrono::high_resolution_clock::now();
-  const float time        = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-  m_MainCamera.Update(0.2F);
-  glm::mat4 view = m_MainCamera.GetViewMatrix();
+  // error projected from the nearest point of the bounds, the render thread publishes the scale of its projection
+  const f32 errorScale = m_LodErrorScale.load(std::memory_order_relaxed);
+  m_LodLevels.resize(m_DrawList.size(), 0);
+  for (std::size_t i = 0; i < m_DrawList.size(); ++i)
+  {
+    const DrawItem& item = m_DrawList[i];
+    if (item.lodCount < 2 || errorScale <= 0.0F)
+    {
+      continue;
+    }
+    const glm::mat4 model = transform * item.model;
+    const f32       scale = std::max({glm::length(glm::vec3{model[0]}),
+                                      glm::length(glm::vec3{model[1]}),
+                                      glm::length(glm::vec3{model[2]})});
+    const glm::vec3 center{model * glm::vec4{glm::vec3{item.boundingSphere}, 1.0F}};
+    const f32       distance = std::max(glm::length(center - viewPosition) - item.boundingSphere.w * scale, CAMERA_NEAR);
+    m_LodLevels[i]           = SelectLod(std::span{m_MeshLods}.subspan(item.firstLod, item.lodCount),
+                                         errorScale * scale / distance,
+                                         m_LodLevels[i],
+                                         LOD_ERROR_PIXELS,
+                                         LOD_HYSTERESIS);
+  }
+}
 
-  UniformBufferObject
-    ubo{.model = glm::rotate(glm::mat4(1.0F), time * glm::radians(90.0F), glm::vec3(0.0F, 0.0F, 1.0F)),
-        .view = m_MainCamera.GetViewMatrix(), //glm::lookAt(glm::vec3(2.0F, 2.0F, 2.0F), glm::vec3(0.0F, 0.0F, 0.0F), glm::vec3(0.0F, 0.0F, 1.0F)),
-        .proj = glm::perspective(glm::radians(45.0F),
-                                 static_cast<float>(m_SwapChainExtent.width) / static_cast<float>(m_SwapChainExtent.height),
-                                 0.1F,
-                                 10.F)};
-  ubo.proj[1][1] *= -1;
-  memcpy(m_UniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+//===============================================================================
+bool VulkanRenderer::WaitForFramePacket(const std::stop_token& stopToken)
+{
+  // stop request wakes the wait the same way a publish does
+  const std::stop_callback wake(stopToken,
+                                [this]
+                                {
+                                  m_PacketSignal.fetch_add(1, std::memory_order_release);
+                                  m_PacketSignal.notify_all();
+                                });
+  while (!stopToken.stop_requested())
+  {
+    // signal is read before checking, a publish in between changes it and the wait returns at once
+    const u64 signal = m_PacketSignal.load(std::memory_order_acquire);
+    if (m_FramePackets.HasFresh())
+    {
+      return true;
+    }
+    m_PacketSignal.wait(signal, std::memory_order_acquire);
+  }
+  return false;
 }
 
 //===============================================================================
-void VulkanRenderer::TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const
+bool VulkanRenderer::WaitForRenderedFrame()
 {
-  const vk::CommandBuffer commandBuffer{BeginSingleTimeCommands()};
-
-  vk::PipelineStageFlags sourceStage{};
-  vk::PipelineStageFlags destinationStage{};
-  vk::ImageMemoryBarrier barrier{
-    .oldLayout        = oldLayout,
-    .newLayout        = newLayout,
-    .image            = image,
-    .subresourceRange = {.aspectMask     = vk::ImageAspectFlagBits::eColor,
-                         .baseMipLevel   = 0,
-                         .levelCount     = 1,
-                         .baseArrayLayer = 0,
-                         .layerCount     = 1},
-  };
+  std::unique_lock lock(m_RenderedMutex);
+  return m_RenderedCondition.wait_for(lock,
+                                      std::chrono::nanoseconds(PRESENT_WAIT_TIMEOUT_NS),
+                                      [this] { return m_RenderedFrame >= m_PublishedFrame; });
+}
 
-  if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal)
+//===============================================================================
+bool VulkanRenderer::WaitForPresent()
+{
+  if (!m_PresentWaitSupported)
   {
-    barrier.srcAccessMask = {};
-    barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-
-    sourceStage      = vk::PipelineStageFlagBits::eTopOfPipe;
-    destinationStage = vk::PipelineStageFlagBits::eTransfer;
+    return false;
   }
-  else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
+  if (m_PresentId <= PRESENT_WAIT_FRAME_LAG)
   {
-    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-    sourceStage      = vk::PipelineStageFlagBits::eTransfer;
-    destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
+    // nothing old enough is queued yet
+    return true;
   }
-  else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eStencilAttachmentOptimal)
+
+  // waiting on the newest present would leave the gpu idle while the next frame is recorded
+  const VkResult result = m_WaitForPresent(static_cast<VkDevice>(m_Device),
+                                           static_cast<VkSwapchainKHR>(m_SwapChain),
+                                           m_PresentId - PRESENT_WAIT_FRAME_LAG,
+                                           PRESENT_WAIT_TIMEOUT_NS);
+  if (result != VK_SUCCESS && result != VK_TIMEOUT)
   {
-    barrier.srcAccessMask = {};
-    barrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+    LOG_CORE_WARN("failed to wait for present, result: {}", static_cast<i32>(result));
+  }
+  return result == VK_SUCCESS;
+}
 
-    sourceStage      = vk::PipelineStageFlagBits::eTopOfPipe;
-    destinationStage = vk::PipelineStageFlagBits::eEarlyFragmentTests;
+//===============================================================================
+std::vector<u8> VulkanRenderer::ReadbackFrame()
+{
+  if (!IsHeadless() || m_FrameNumber == 0)
+  {
+    LOG_CORE_ERROR("frame readback needs a headless renderer that rendered at least one frame");
+    return {};
   }
-  else
+
+  const vk::DeviceSize size = static_cast<vk::DeviceSize>(m_SwapChainExtent.width) * m_SwapChainExtent.height * 4;
+  std::vector<u8>      pixels;
+  try
   {
-    LOG_CORE_ERROR("unsupported layout transition!");
-    return;
+    m_Device.waitIdle();
+    AllocatedBuffer readback = m_Allocator.CreateBuffer(size, vk::BufferUsageFlagBits::eTransferDst, MemoryUsage::Readback);
+
+    ImmediateSubmit(
+      [&](vk::CommandBuffer cmd)
+      {
+        // render pass left the image in transfer src layout, only its writes need to be made visible
+        const vk::ImageMemoryBarrier2 barrier{.srcStageMask     = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                              .srcAccessMask    = vk::AccessFlagBits2::eColorAttachmentWrite,
+                                              .dstStageMask     = vk::PipelineStageFlagBits2::eCopy,
+                                              .dstAccessMask    = vk::AccessFlagBits2::eTransferRead,
+                                              .oldLayout        = vk::ImageLayout::eTransferSrcOptimal,
+                                              .newLayout        = vk::ImageLayout::eTransferSrcOptimal,
+                                              .image            = m_OffscreenColor.image,
+                                              .subresourceRange = {.aspectMask     = vk::ImageAspectFlagBits::eColor,
+                                                                   .baseMipLevel   = 0,
+                                                                   .levelCount     = 1,
+                                                                   .baseArrayLayer = 0,
+                                                                   .layerCount     = 1}};
+        cmd.pipelineBarrier2({.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier});
+
+        const vk::BufferImageCopy region{
+          .bufferOffset      = 0,
+          .bufferRowLength   = 0,
+          .bufferImageHeight = 0,
+          .imageSubresource  = {.aspectMask = vk::ImageAspectFlagBits::eColor, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1},
+          .imageOffset       = {.x = 0, .y = 0, .z = 0},
+          .imageExtent       = {.width = m_SwapChainExtent.width, .height = m_SwapChainExtent.height, .depth = 1}};
+        cmd.copyImageToBuffer(m_OffscreenColor.image, vk::ImageLayout::eTransferSrcOptimal, readback.buffer, region);
+
+        const vk::MemoryBarrier2 hostBarrier{.srcStageMask  = vk::PipelineStageFlagBits2::eCopy,
+                                             .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                             .dstStageMask  = vk::PipelineStageFlagBits2::eHost,
+                                             .dstAccessMask = vk::AccessFlagBits2::eHostRead};
+        cmd.pipelineBarrier2({.memoryBarrierCount = 1, .pMemoryBarriers = &hostBarrier});
+      });
+
+    m_Allocator.Invalidate(readback, 0, size);
+    const auto* mapped = static_cast<const u8*>(readback.mapped);
+    pixels.assign(mapped, mapped + size);
+    m_Allocator.DestroyBuffer(readback);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to read back frame!, exception: {0}", e.what());
   }
+  return pixels;
+}
 
-  commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+//===============================================================================
+void VulkanRenderer::UpdateUniformBuffer(uint32_t currentImage)
+{
+  // projection follows the swapchain, owned by the render thread, the view comes from the frame packet
+  CameraUniforms camera{
+    .view = m_FramePacket->view,
+    .proj = glm::perspective(glm::radians(CAMERA_FIELD_OF_VIEW),
+                             static_cast<float>(m_SwapChainExtent.width) / static_cast<float>(m_SwapChainExtent.height),
+                             CAMERA_NEAR,
+                             CAMERA_FAR)};
+  camera.proj[1][1] *= -1;
+  m_LodErrorScale.store(GetLodErrorScale(camera.proj[1][1], static_cast<f32>(m_SwapChainExtent.height)),
+                        std::memory_order_relaxed);
+  camera.viewProj = camera.proj * camera.view;
+  // copied into the uniform buffer of the frame at the start of its command buffer
+  if (!UploadDynamic(&camera, sizeof(camera), m_UniformBuffers[currentImage].buffer, 0))
+  {
+    LOG_CORE_ERROR("failed to stage camera uniforms, staging ring of the frame is full!");
+  }
+  m_CameraUniforms = camera;
+}
 
-  EndSingleTimeCommands(commandBuffer);
+//===============================================================================
+void VulkanRenderer::FixedUpdate(f32 step)
+{
+  m_PreviousCamera         = m_MainCamera;
+  m_PreviousSimulationTime = m_SimulationTime;
+  m_MainCamera.Update(step);
+  m_SimulationTime += step;
 }
 
 //===============================================================================
-void VulkanRenderer::CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) const
+void VulkanRenderer::UpdateObjects()
 {
-  const vk::CommandBuffer commandBuffer{BeginSingleTimeCommands()};
+  FOUR_PROFILE_FUNCTION();
 
-  vk::BufferImageCopy region{
-    .bufferOffset      = 0,
-    .bufferRowLength   = 0,
-    .bufferImageHeight = 0,
-    .imageSubresource = {.aspectMask = vk::ImageAspectFlagBits::eColor, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1},
-    .imageOffset = {.x = 0, .y = 0, .z = 0},
-    .imageExtent = {.width = width, .height = height, .depth = 1},
-  };
+  const auto& draws = m_FramePacket->draws;
+  m_GpuObjects.resize(draws.size());
+  for (std::size_t i = 0; i < draws.size(); ++i)
+  {
+    const DrawItem& item = draws[i];
+    m_GpuObjects[i]      = {.model          = item.model,
+                            .boundingSphere = item.boundingSphere,
+                            .indexCount     = item.indexCount,
+                            .firstIndex     = item.firstIndex,
+                            .vertexOffset   = item.vertexOffset,
+                            .textureIndex   = item.textureIndex,
+                            .firstMeshlet   = item.firstMeshlet,
+                            .meshletCount   = item.meshletCount};
+  }
 
-  commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+  if (m_GpuDrivenSupported)
+  {
+    m_GpuCulling.UpdateObjects(m_CurrentFrame, m_GpuObjects);
+    return;
+  }
 
-  EndSingleTimeCommands(commandBuffer);
+  // the gpu finished the previous use of this buffer, the frame fence was waited on; draws past the end are dropped
+  const std::size_t count = std::min<std::size_t>(m_GpuObjects.size(), MAX_DRAW_OBJECTS);
+  memcpy(m_ObjectBuffers[m_CurrentFrame].mapped, m_GpuObjects.data(), sizeof(GpuObjectData) * count);
+  m_Allocator.Flush(m_ObjectBuffers[m_CurrentFrame], 0, sizeof(GpuObjectData) * count);
 }
 
 //========================================================================
@@ -1737,6 +2472,12 @@ vk::ImageView VulkanRenderer::CreateImageView(vk::Image image, vk::Format format
 }
 bool VulkanRenderer::InitImGui()
 {
+  // imgui draws into a window, there is none without a surface
+  if (IsHeadless())
+  {
+    return true;
+  }
+
   try
   {
     // 1: create descriptor pool for IMGUI
@@ -1768,7 +2509,7 @@ bool VulkanRenderer::InitImGui()
     ImGui::CreateContext();
 
     // this initializes imgui for SDL
-    if (!ImGui_ImplGlfw_InitForVulkan(m_Window.GetHandle(), false))
+    if (!ImGui_ImplGlfw_InitForVulkan(m_Window->GetHandle(), false))
     {
       LOG_CORE_ERROR("ImGui_ImplGlfw_InitForVulkan failed.");
       return false;
@@ -1818,8 +2559,6 @@ bool VulkanRenderer::InitTestTriangle()
 {
   try
   {
-    const auto vertShader = vkUtils::CreateShaderModule("shaders/coloredTriangle.vert.spv", m_Device);
-    const auto fragShader = vkUtils::CreateShaderModule("shaders/coloredTriangle.frag.spv", m_Device);
 
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo{
       .setLayoutCount         = 0,
@@ -1830,26 +2569,20 @@ bool VulkanRenderer::InitTestTriangle()
 
     VulkanPipelineBuilder pipelineBuilder;
     pipelineBuilder.pipelineLayout = m_TestTrianglePipelineLayout;
-    m_TestTrianglePipeline         = pipelineBuilder.SetShaders(vertShader, fragShader)
-                               .SetInputTopology(vk::PrimitiveTopology::eTriangleList)
-                               .SetPolygonMode(vk::PolygonMode::eFill)
-                               .SetCullMode(vk::CullModeFlagBits::eBack, vk::FrontFace::eClockwise)
-                               .SetMultiSamplingNone()
-                               .DisableBlending()
-                               .DisableDepthTest()
-                               .SetColorAttachmentFormat(m_SwapChainImageFormat)
-                               .SetDepthFormat(vk::Format::eUndefined)
-                               .BuildPipeline(m_Device);
-
-    m_Device.destroyShaderModule(vertShader);
-    m_Device.destroyShaderModule(fragShader);
-
-    m_MainDeletionQueue.push_function(
-      [this]()
-      {
-        m_Device.destroyPipelineLayout(m_TestTrianglePipelineLayout);
-        m_Device.destroyPipeline(m_TestTrianglePipeline);
-      });
+    pipelineBuilder.SetShaderFiles("shaders/coloredTriangle.vert.spv", "shaders/coloredTriangle.frag.spv")
+      .SetInputTopology(vk::PrimitiveTopology::eTriangleList)
+      .SetPolygonMode(vk::PolygonMode::eFill)
+      .SetCullMode(vk::CullModeFlagBits::eBack, vk::FrontFace::eClockwise)
+      .SetMultiSamplingNone()
+      .DisableBlending()
+      .DisableDepthTest()
+      .SetColorAttachmentFormat(m_SwapChainImageFormat)
+      .SetDepthFormat(vk::Format::eUndefined);
+
+    // pipeline is owned by the registry
+    m_TestTrianglePipeline = m_PipelineRegistry.GetOrCreate(pipelineBuilder);
+
+    m_MainDeletionQueue.push_function([this]() { m_Device.destroyPipelineLayout(m_TestTrianglePipelineLayout); });
 
     return true;
   } catch (const std::exception& e)
@@ -4,12 +4,24 @@
 #include "core/core.hpp"
 
 #include "renderer/renderer.hpp"
+#include "renderer/renderQueue.hpp"
 #include "vulkan/vulkan.hpp"
 
 #include "window/glfw/glfwWindow.hpp"
 #include "camera/camera.hpp"
+#include "core/tripleBuffer.hpp"
 #include "renderer/vulkan/vulkanPipelineBuilder.hpp"
-#include <vk_mem_alloc.h>
+#include "renderer/vulkan/vulkanAllocator.hpp"
+#include "renderer/vulkan/vulkanUploader.hpp"
+#include "renderer/vulkan/vulkanStagingRing.hpp"
+#include "renderer/vulkan/vulkanParallelRecorder.hpp"
+#include "renderer/vulkan/vulkanGpuCulling.hpp"
+#include "renderer/vulkan/vulkanPipelineCache.hpp"
+#include "renderer/vulkan/vulkanPipelineRegistry.hpp"
+#include "renderer/vulkan/vulkanBindlessTable.hpp"
+#include "renderer/vulkan/vulkanGpuProfiler.hpp"
+#include "renderer/vulkan/VKTypes.hpp"
+#include "mesh/meshFile.hpp"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -17,6 +29,10 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+
 // export module vkContext;
 // export
 namespace four
@@ -36,29 +52,102 @@ struct Vertex
   glm::vec3 color;
   glm::vec2 texCoord;
 
-  static vk::VertexInputBindingDescription GetBindingDescription()
+  static vk::VertexInputBindingDescription GetBindingDescription(MeshVertexFormat format = MeshVertexFormat::Full)
   {
-    return {.binding = 0, .stride = sizeof(Vertex), .inputRate = vk::VertexInputRate::eVertex};
+    return {.binding = 0, .stride = GetVertexStride(format), .inputRate = vk::VertexInputRate::eVertex};
   }
 
-  static std::array<vk::VertexInputAttributeDescription, 3> GetAttributeDescriptions()
+  /**
+   * @brief layout of a vertex stream, the quantized one is expanded to float by the vertex input
+   * and adds the octahedral normal at location 3
+   */
+  static std::vector<vk::VertexInputAttributeDescription> GetAttributeDescriptions(
+    MeshVertexFormat format = MeshVertexFormat::Full)
   {
     using VIAD = vk::VertexInputAttributeDescription;
+    using QMV  = QuantizedMeshVertex;
+    if (format == MeshVertexFormat::Quantized)
+    {
+      return {VIAD{.location = 0, .binding = 0, .format = vk::Format::eR16G16B16A16Sfloat, .offset = offsetof(QMV, position)},
+              VIAD{.location = 1, .binding = 0, .format = vk::Format::eR8G8B8A8Unorm, .offset = offsetof(QMV, color)},
+              VIAD{.location = 2, .binding = 0, .format = vk::Format::eR16G16Unorm, .offset = offsetof(QMV, texCoord)},
+              VIAD{.location = 3, .binding = 0, .format = vk::Format::eR16G16Snorm, .offset = offsetof(QMV, normal)}};
+    }
     return {VIAD{.location = 0, .binding = 0, .format = vk::Format::eR32G32B32Sfloat, .offset = offsetof(Vertex, pos)},
             VIAD{.location = 1, .binding = 0, .format = vk::Format::eR32G32B32Sfloat, .offset = offsetof(Vertex, color)},
             VIAD{.location = 2, .binding = 0, .format = vk::Format::eR32G32Sfloat, .offset = offsetof(Vertex, texCoord)}};
   }
 };
 
-struct UniformBufferObject
+// cooked vertex streams are uploaded as they are
+static_assert(sizeof(Vertex) == sizeof(MeshVertex) && offsetof(Vertex, pos) == offsetof(MeshVertex, position) &&
+              offsetof(Vertex, color) == offsetof(MeshVertex, color) &&
+              offsetof(Vertex, texCoord) == offsetof(MeshVertex, texCoord));
+
+// camera uniforms of a frame, set 0 binding 0, written once per frame
+struct CameraUniforms
 {
-  alignas(16) glm::mat4 model;
   alignas(16) glm::mat4 view;
   alignas(16) glm::mat4 proj;
+  alignas(16) glm::mat4 viewProj;
 };
 
+/**
+ * @brief one object of a frame, drawn with its own model matrix
+ * the renderer writes the object data of every draw into a storage buffer in draw order, the vertex shader finds
+ * it through gl_InstanceIndex, so draws need no descriptor update or push constant of their own.
+ * draws with the same mesh and material are merged into one instanced draw, mesh must identify the geometry range
+ */
+struct DrawItem
+{
+  glm::mat4 model{1.0F};
+  u32       indexCount{0};
+  u32       firstIndex{0};
+  i32       vertexOffset{0};
+  glm::vec4 boundingSphere{0.0F}; // xyz center in object space, w radius
+  u32       textureIndex{0};        // bindless texture, unused without descriptor indexing
+  u32       mesh{0};                // sort key fields, see RenderKey
+  u32       material{0};
+  u32       firstMeshlet{0};        // meshlets of the geometry range, culled one by one on the gpu driven path
+  u32       meshletCount{0};        // 0 draws the range as a whole
+  u32       firstLod{0};            // lods of the geometry range in the lods of the renderer, the first is the range
+  u32       lodCount{0};            // below 2 the range is always drawn at full detail
+};
+
+/**
+ * @brief everything the render thread needs to draw one frame, written by the simulation thread
+ * immutable once published, the simulation thread already fills the next one while this is recorded
+ */
+struct FramePacket
+{
+  u64                      frameNumber{0};
+  glm::mat4                view{1.0F};
+  f32                      time{0.0F}; // simulation time the frame shows, seconds
+  std::vector<DrawItem>    draws;      // sorted by RenderKey
+  std::vector<RenderBatch> batches;    // instanced draws over draws, first is the index of the first instance
+};
 
-constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+constexpr int            MAX_FRAMES_IN_FLIGHT        = 2;
+constexpr vk::DeviceSize STAGING_RING_SIZE_PER_FRAME = 8ULL * 1024 * 1024;
+constexpr u32            PARALLEL_RECORD_MIN_DRAWS   = 64; // below this draws are recorded inline on main thread
+constexpr u32            PARALLEL_RECORD_MAX_THREADS = 8;
+constexpr u32            GPU_CULL_MAX_OBJECTS        = 128 * 1024;
+constexpr u32            GPU_CULL_MAX_DRAWS          = 256 * 1024; // surviving objects and meshlets per frame
+constexpr u32            MAX_DRAW_OBJECTS            = 64 * 1024; // objects per frame of the cpu draw list path
+constexpr const char*    PIPELINE_CACHE_PATH         = "cache/pipeline.cache"; // relative to working directory
+constexpr const char*    DEMO_MESH_PATH              = "assets/meshes/demo.fmesh"; // cooked, built-in quads when missing
+constexpr u32            PIPELINE_COMPILE_THREADS    = 2; // background compilation of new pipeline permutations
+constexpr u32            BINDLESS_MAX_TEXTURES       = 16 * 1024;
+constexpr u32            BINDLESS_MAX_BUFFERS        = 16 * 1024;
+constexpr vk::Format     HEADLESS_COLOR_FORMAT       = vk::Format::eR8G8B8A8Unorm;
+constexpr f32            HEADLESS_FRAME_TIME         = 1.0F / 60.0F; // animation step of a headless frame, seconds
+constexpr u64            PRESENT_WAIT_FRAME_LAG      = 1;            // presents left queued by WaitForPresent
+constexpr u64            PRESENT_WAIT_TIMEOUT_NS     = 100'000'000;
+constexpr f32            CAMERA_FIELD_OF_VIEW        = 45.0F; // vertical, degrees
+constexpr f32            CAMERA_NEAR                 = 0.1F;
+constexpr f32            CAMERA_FAR                  = 10.0F;
+constexpr f32            LOD_ERROR_PIXELS            = 1.0F;  // simplification error a lod may show on screen
+constexpr f32            LOD_HYSTERESIS              = 0.25F; // a coarser lod must be this much below the error first
 
 class FOUR_ENGINE_API VulkanRenderer final : public Renderer<VulkanRenderer>
 {
@@ -69,6 +158,7 @@ public:
   {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily; // falls back to graphics family when there is no async transfer queue
 
     [[nodiscard]] bool IsComplete() const
     {
@@ -113,14 +203,15 @@ public:
     DeletionQueue deletionQueue;
   };
 
-  struct AllocatedImage
-  {
-    vk::Image        image;
-    vk::DeviceMemory imageMemory;
-    vk::ImageView    ImageView;
-  };
-
   explicit VulkanRenderer(WindowType& window);
+
+  /**
+   * @brief headless renderer, no window, surface or swapchain
+   * frames are rendered into an offscreen color target and never presented, runs on software ICDs like lavapipe
+   *
+   * @param headlessExtent size of the offscreen target
+   */
+  explicit VulkanRenderer(vk::Extent2D headlessExtent);
   ~VulkanRenderer() final;
 
   VulkanRenderer(const VulkanRenderer&)            = delete;
@@ -128,8 +219,84 @@ public:
   VulkanRenderer& operator=(const VulkanRenderer&) = delete;
   VulkanRenderer& operator=(VulkanRenderer&&)      = delete;
 
+  [[nodiscard]] bool IsInitialized() const
+  {
+    return m_Initialized;
+  }
+
+  [[nodiscard]] bool IsHeadless() const
+  {
+    return m_Window == nullptr;
+  }
+
+  [[nodiscard]] u64 GetFrameNumber() const
+  {
+    return m_FrameNumber;
+  }
+
+  /**
+   * @brief advance simulated scene state by one fixed step
+   *
+   * @param step tick duration, seconds
+   */
+  void FixedUpdate(f32 step);
+
+  /**
+   * @brief where the next frame is rendered between the previous and the current fixed update, [0, 1]
+   */
+  void SetInterpolationAlpha(f32 alpha)
+  {
+    m_InterpolationAlpha = alpha;
+  }
+
+  /**
+   * @brief snapshot interpolated simulation state into a frame packet and hand it to the render thread
+   * simulation thread only, never blocks
+   *
+   * @param frameNumber number of the simulated frame, reported by profiler records of both threads
+   */
+  void PublishFramePacket(u64 frameNumber);
+
+  /**
+   * @brief block until a packet newer than the one last rendered is published, render thread only
+   *
+   * @return false when stop was requested
+   */
+  [[nodiscard]] bool WaitForFramePacket(const std::stop_token& stopToken);
+
+  /**
+   * @brief block until the render thread finished the last published packet, simulation thread only
+   * with present pacing that includes waiting for the display, used by the frame pacer
+   *
+   * @return false on timeout
+   */
+  [[nodiscard]] bool WaitForRenderedFrame();
+
+  /**
+   * @brief make the render thread wait for all but PRESENT_WAIT_FRAME_LAG presents to reach the display
+   * after each present, only has effect when present wait is supported
+   */
+  void SetPresentPacing(bool enabled)
+  {
+    m_PresentPacing.store(enabled, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] bool IsPresentWaitSupported() const
+  {
+    return m_PresentWaitSupported;
+  }
+
+  /**
+   * @brief wait for gpu and copy the last rendered frame into host memory, headless only
+   *
+   * @return HEADLESS_COLOR_FORMAT pixels, rows tightly packed, empty on failure
+   */
+  [[nodiscard]] std::vector<u8> ReadbackFrame();
+
 protected:
   void DrawFrame();
+  void RenderFrame();
+  bool WaitForPresent();
   void DrawBackground(vk::CommandBuffer cmd) const;
   void DrawImGui(vk::CommandBuffer cmd, vk::ImageView targetImageView) const;
   void DrawGeometry(vk::CommandBuffer cmd) const;
@@ -160,6 +327,12 @@ protected:
     return m_Device;
   }
 
+  // new material permutations go through GetOrCreateAsync so they compile off the render thread
+  [[nodiscard]] VulkanPipelineRegistry& GetPipelineRegistry()
+  {
+    return m_PipelineRegistry;
+  }
+
   [[nodiscard]] vk::Extent2D GetExtent() const
   {
     return m_SwapChainExtent;
@@ -171,6 +344,19 @@ protected:
 
   void ImmediateSubmit(std::function<void(vk::CommandBuffer commandBuffer)>&& function);
 
+  /**
+   * @brief copy dynamic data into a device buffer as part of current frame
+   * data goes through the per frame staging ring and the copy is recorded before the render pass,
+   * only valid while a frame is built in DrawFrame
+   *
+   * @param data pointer to data to copy
+   * @param size size of data in bytes
+   * @param dstBuffer destination buffer, needs transfer dst usage
+   * @param dstOffset offset in destination buffer
+   * @return false if staging ring of the frame is full
+   */
+  [[nodiscard]] bool UploadDynamic(const void* data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset);
+
 private:
   [[nodiscard]] bool InitVulkan();
   void               ShutdownVulkan();
@@ -180,22 +366,34 @@ private:
   [[nodiscard]] bool CreateSurface();
   [[nodiscard]] bool PickPhysicalDevice();
   [[nodiscard]] bool CreateLogicalDevice();
+  [[nodiscard]] bool CreateAllocator();
+  [[nodiscard]] bool CreatePipelineCache();
+  [[nodiscard]] bool CreatePipelineRegistry();
 
   [[nodiscard]] bool CreateSwapChain();
+  [[nodiscard]] bool CreateOffscreenTarget();
   [[nodiscard]] bool CreateImageViews();
 
   // graphic pipeline
-  [[nodiscard]] bool       CreateRenderPass();
-  [[nodiscard]] bool       CreateDescriptorSetLayout();
-  [[nodiscard]] bool       CreateGraphicsPipeline();
-  [[nodiscard]] vk::Format FindDepthFormat() const;
-  [[nodiscard]] bool       HasStencilComponent(vk::Format format) const;
+  [[nodiscard]] bool         CreateRenderPass();
+  [[nodiscard]] bool         CreateDescriptorSetLayout();
+  [[nodiscard]] bool         CreateBindlessTable();
+  [[nodiscard]] bool         OpenDemoMesh();
+  [[nodiscard]] bool         CreateGraphicsPipeline();
+  [[nodiscard]] bool         CreateGpuCulling();
+  [[nodiscard]] vk::Pipeline CreateScenePipeline(const std::filesystem::path& vertShaderPath, vk::PipelineLayout layout);
+  [[nodiscard]] vk::Format   FindDepthFormat() const;
+  [[nodiscard]] bool         HasStencilComponent(vk::Format format) const;
 
 
   [[nodiscard]] bool CreateFramebuffers();
   [[nodiscard]] bool CreateCommandPool();
+  [[nodiscard]] bool CreateUploader();
+  [[nodiscard]] bool CreateStagingRing();
   [[nodiscard]] bool CreateCommandBuffers();
+  [[nodiscard]] bool CreateRecorder();
   [[nodiscard]] bool CreateSyncObjects();
+  [[nodiscard]] bool CreateGpuProfiler();
 
   void ReCreateSwapChain();
   void CleanupSwapChain();
@@ -203,21 +401,7 @@ private:
   [[nodiscard]] bool CreateVertexBuffers();
   [[nodiscard]] bool CreateIndexBuffers();
   [[nodiscard]] bool CreateUniformBuffers();
-
-  /**
-   * Creates a buffer and allocates memory for it.
-   * exeption on failure
-   * @param size
-   * @param usage
-   * @param properties
-   * @param buffer ref to buffer that will be created
-   * @param bufferMemory ref to memory that will be allocated
-   */
-  void CreateBuffer(vk::DeviceSize          size,
-                    vk::BufferUsageFlags    usage,
-                    vk::MemoryPropertyFlags properties,
-                    vk::Buffer&             buffer,
-                    vk::DeviceMemory&       bufferMemory);
+  [[nodiscard]] bool CreateObjectBuffers();
 
   [[nodiscard]] bool CreateDescriptorPool();
   [[nodiscard]] bool CreateDescriptorSets();
@@ -228,38 +412,53 @@ private:
 
 
   /**
-   * Creates an image and allocates memory for it.
+   * Creates an image and sub-allocates memory for it through the allocator.
    * exeption on failure
    * @param width
    * @param height
    * @param format
    * @param tiling
    * @param usage
-   * @param properties
-   * @param textureImage ref to image that will be created
-   * @param textureImageMemory ref to memory that will be allocated
+   * @param memoryUsage memory usage class of the image
+   * @return created image ( image view is not created )
    */
-  void CreateImage(uint32_t                width,
-                   uint32_t                height,
-                   vk::Format              format,
-                   vk::ImageTiling         tiling,
-                   vk::ImageUsageFlags     usage,
-                   vk::MemoryPropertyFlags properties,
-                   vk::Image&              textureImage,
-                   vk::DeviceMemory&       textureImageMemory) const;
+  [[nodiscard]] AllocatedImage CreateImage(uint32_t            width,
+                                           uint32_t            height,
+                                           vk::Format          format,
+                                           vk::ImageTiling     tiling,
+                                           vk::ImageUsageFlags usage,
+                                           MemoryUsage         memoryUsage = MemoryUsage::GpuOnly);
 
-  void CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size) const;
+  /**
+   * @brief record draw commands of a frame, command buffer should be in recording state
+   */
+  void RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t imageIndex);
 
-  void RecordCommandBuffer(const vk::CommandBuffer& cmd, uint32_t imageIndex) const;
+  /**
+   * @brief bind geometry state and record batches [begin, end) of the frame packet, one instanced draw each
+   * called concurrently from recorder threads, must not modify the renderer
+   */
+  void RecordDraws(vk::CommandBuffer cmd, u32 begin, u32 end) const;
+  void RecordIndirectDraws(vk::CommandBuffer cmd) const;
+  void BindGeometryState(vk::CommandBuffer cmd, vk::Pipeline pipeline, vk::PipelineLayout layout) const;
+  void RecordDynamicCopies(vk::CommandBuffer cmd);
 
-  [[nodiscard]] vk::CommandBuffer BeginSingleTimeCommands() const;
+  void UpdateUniformBuffer(uint32_t currentImage);
 
-  void EndSingleTimeCommands(vk::CommandBuffer cmd) const;
+  /**
+   * @brief write the object data of every draw of the packet, in draw order
+   * into the frame object buffer, or into the culling object buffer on the gpu driven path
+   */
+  void UpdateObjects();
 
-  void UpdateUniformBuffer(uint32_t currentImage);
+  /**
+   * @brief pick the lod of every draw list item from its projected error, simulation thread only
+   *
+   * @param transform applied on top of the model matrices of the items
+   * @param viewPosition camera position in world space
+   */
+  void SelectLods(const glm::mat4& transform, const glm::vec3& viewPosition);
 
-  void TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
-  void CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) const;
   void CopyImageToImage(vk::CommandBuffer cmd,
                         vk::Image         srcImage,
                         vk::Image         dstImage,
@@ -274,6 +473,7 @@ private:
   [[nodiscard]] std::vector<const char*> GetRequiredExtensions();
   [[nodiscard]] bool                     IsDeviceSuitable(const vk::PhysicalDevice& device) const;
   [[nodiscard]] bool                     CheckDeviceExtensionSupport(const vk::PhysicalDevice& device) const;
+  [[nodiscard]] bool                     QueryPresentWaitSupport() const;
   [[nodiscard]] vk::Extent2D             ChooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities) const;
 
 
@@ -285,7 +485,6 @@ private:
     void* /*pUserData*/);
 
   [[nodiscard]] uint32_t RateDeviceSuitability(const vk::PhysicalDevice& device) const;
-  [[nodiscard]] uint32_t FindMemoryType(uint32_t typeFilter, const vk::MemoryPropertyFlags& properties) const;
 
   [[nodiscard]] vk::ImageView CreateImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspect) const;
 
@@ -302,21 +501,33 @@ private:
 
 
 private:
-  WindowType&                m_Window;
+  WindowType*                m_Window{nullptr}; // null when headless
+  bool                       m_Initialized{false};
   vk::Instance               m_Instance;
   vk::DebugUtilsMessengerEXT m_DebugMessenger;
   vk::SurfaceKHR             m_Surface;
   vk::PhysicalDevice         m_PhysicalDevice;
+  VKDeviceProperties         m_DeviceProperties;
   vk::Device                 m_Device;
   vk::Queue                  m_GraphicsQueue;
   vk::Queue                  m_PresentQueue;
+  vk::Queue                  m_TransferQueue;
   std::vector<const char*>   m_DeviceExtensions{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+  VulkanAllocator            m_Allocator;
+  VulkanUploader             m_Uploader;
+  VulkanStagingRing          m_StagingRing;
+  VulkanPipelineCache        m_PipelineCache;
+  VulkanPipelineRegistry     m_PipelineRegistry;
 
   vk::Extent2D               m_SwapChainExtent;
   vk::SwapchainKHR           m_SwapChain;
+  bool                       m_PresentWaitSupported{false}; // presentId and presentWait enabled, entry point loaded
+  PFN_vkWaitForPresentKHR    m_WaitForPresent{nullptr};
+  u64                        m_PresentId{0}; // id of the last present, restarts with every swapchain
   std::vector<vk::Image>     m_SwapChainImages;
   vk::Format                 m_SwapChainImageFormat{};
   std::vector<vk::ImageView> m_SwapChainImageViews;
+  AllocatedImage             m_OffscreenColor; // headless replacement of the swapchain images
 
   vk::RenderPass               m_RenderPass;
   vk::Pipeline                 m_GraphicsPipeline;
@@ -324,18 +535,43 @@ private:
   std::vector<vk::Framebuffer> m_SwapChainFramebuffers;
   std::vector<FrameData>       m_Frames;
   vk::CommandPool              m_CommandPool;
+  VulkanParallelRecorder       m_Recorder;
+  VulkanGpuProfiler            m_GpuProfiler;
+  std::vector<DrawItem>        m_DrawList;
+  std::vector<MeshLod>         m_MeshLods; // lods of the draw list items, copied from the cooked mesh
+
+  // gpu driven path, used when device supports drawIndirectCount
+  bool                       m_GpuDrivenSupported{false};
+  VulkanGpuCulling           m_GpuCulling;
+  vk::PipelineLayout         m_IndirectPipelineLayout;
+  vk::Pipeline               m_IndirectPipeline;
+  vk::DescriptorSetLayout    m_EmptySetLayout; // stands in for the bindless set when it is not supported
+
+  // bindless textures and buffers, used when device supports descriptor indexing
+  bool                m_BindlessSupported{false};
+  VulkanBindlessTable m_Bindless;
+  u32                 m_TextureIndex{0};
   DeletionQueue                m_MainDeletionQueue;
 
+  // copies from staging ring recorded for current frame
+  struct DynamicCopy
+  {
+    vk::Buffer     srcBuffer;
+    vk::Buffer     dstBuffer;
+    vk::BufferCopy region;
+  };
+  std::vector<DynamicCopy> m_DynamicCopies;
+
   // Immediate commands
   vk::Fence         m_ImmediateFence;
   vk::CommandPool   m_ImmediateCommandPool;
   vk::CommandBuffer m_ImmediateCommandBuffer;
 
   u32                       m_CurrentFrame{0};
-  vk::Buffer                m_VertexBuffer;
-  vk::DeviceMemory          m_VertexBufferMemory;
-  vk::Buffer                m_IndexBuffer;
-  vk::DeviceMemory          m_IndexBufferMemory;
+  u64                       m_FrameNumber{0};
+  AllocatedBuffer           m_VertexBuffer;
+  AllocatedBuffer           m_IndexBuffer;   // mesh indices, then the expanded meshlet indices on the gpu driven path
+  AllocatedBuffer           m_MeshletBuffer; // GpuMeshlet of every meshlet, gpu driven path only
   const std::vector<Vertex> vertices{
     {.pos = {-0.5F, -0.5F, 0.0F}, .color = {1.0F, 0.0F, 0.0F}, .texCoord = {1.0F, 0.0F}},
     {.pos = {0.5F, -0.5F, 0.0F}, .color = {0.0F, 1.0F, 0.0F}, .texCoord = {0.0F, 0.0F}},
@@ -347,20 +583,46 @@ private:
     {.pos = {0.5F, 0.5F, -0.5F}, .color = {0.0F, 0.0F, 1.0F}, .texCoord = {0.0F, 1.0F}},
     {.pos = {-0.5F, 0.5F, -0.5F}, .color = {1.0F, 1.0F, 1.0F}, .texCoord = {1.0F, 1.0F}},
   };
-  const std::vector<uint16_t>   indices{0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4};
+  const std::vector<uint32_t>   indices{0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4};
+  MeshFile                      m_DemoMesh; // mapped from OpenDemoMesh until the upload is recorded
+  MeshVertexFormat              m_VertexFormat{MeshVertexFormat::Full};
   vk::DescriptorSetLayout       m_DescriptorSetLayout;
-  std::vector<vk::Buffer>       m_UniformBuffers;
-  std::vector<vk::DeviceMemory> m_UniformBuffersMemory;
-  std::vector<void*>            m_UniformBuffersMapped;
+  std::vector<AllocatedBuffer>  m_UniformBuffers; // camera, device local, filled through UploadDynamic each frame
 
   vk::DescriptorPool             m_DescriptorPool;
   std::vector<vk::DescriptorSet> m_DescriptorSets;
 
+  // per object data of the cpu draw list path, set 2, persistently mapped, one buffer per frame in flight
+  std::vector<GpuObjectData>     m_GpuObjects;
+  vk::DescriptorSetLayout        m_ObjectSetLayout;
+  std::vector<AllocatedBuffer>   m_ObjectBuffers;
+  std::vector<vk::DescriptorSet> m_ObjectSets;
+
   AllocatedImage m_TextureImage;
   vk::Sampler    m_TextureSampler;
   AllocatedImage m_DepthImage;
 
-  Camera m_MainCamera;
+  Camera         m_MainCamera{{1.0F, 2.0F, 3.5F}, -135.5F, -34.0F, {0.0F, 0.0F, 0.0F}};
+  CameraUniforms m_CameraUniforms{};
+
+  // simulation state of the previous fixed update, frames are rendered between it and the current one
+  Camera m_PreviousCamera{m_MainCamera};
+  f32    m_SimulationTime{0.0F};
+  f32    m_PreviousSimulationTime{0.0F};
+  f32    m_InterpolationAlpha{1.0F};
+
+  // lock-free hand-off of frame packets from simulation to render thread
+  TripleBuffer<FramePacket> m_FramePackets;
+  const FramePacket*        m_FramePacket{nullptr}; // packet of the frame being rendered, render thread
+  u64                       m_PublishedFrame{0};    // simulation thread
+  RenderQueue               m_RenderQueue;          // simulation thread, sorts the draws of the packet
+  std::vector<u32>          m_LodLevels;            // simulation thread, lod of every draw list item last frame
+  std::atomic<f32>          m_LodErrorScale{0.0F};  // pixels per unit at distance 1, from the render thread projection
+  std::atomic<u64>          m_PacketSignal{0};      // bumped on publish and on stop, render thread waits on it
+  std::atomic<bool>         m_PresentPacing{false};
+  std::mutex                m_RenderedMutex;
+  std::condition_variable   m_RenderedCondition;
+  u64                       m_RenderedFrame{0}; // guarded by m_RenderedMutex
 
   vk::PipelineLayout m_TestTrianglePipelineLayout;
   vk::Pipeline       m_TestTrianglePipeline;
@@ -0,0 +1,72 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanStagingRing.hpp"
+
+namespace four
+{
+
+//===============================================================================
+VulkanStagingRing::~VulkanStagingRing()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanStagingRing::Init(VulkanAllocator& allocator, vk::DeviceSize sizePerFrame, u32 frameCount)
+{
+  m_Allocator    = &allocator;
+  m_SizePerFrame = sizePerFrame;
+  try
+  {
+    m_Buffer = m_Allocator->CreateBuffer(sizePerFrame * frameCount, vk::BufferUsageFlagBits::eTransferSrc, MemoryUsage::Upload);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to create staging ring!, exception: {0}", e.what());
+    return false;
+  }
+
+  if (m_Buffer.mapped == nullptr)
+  {
+    LOG_CORE_ERROR("failed to map staging ring memory!");
+    return false;
+  }
+  return true;
+}
+
+//===============================================================================
+void VulkanStagingRing::Shutdown()
+{
+  if (m_Allocator == nullptr)
+  {
+    return;
+  }
+  m_Allocator->DestroyBuffer(m_Buffer);
+  m_Allocator = nullptr;
+}
+
+//===============================================================================
+void VulkanStagingRing::BeginFrame(u32 frameIndex)
+{
+  m_FrameBegin = m_SizePerFrame * frameIndex;
+  m_Head       = m_FrameBegin;
+}
+
+//===============================================================================
+std::optional<VulkanStagingRing::Allocation> VulkanStagingRing::Allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+  assert((alignment & (alignment - 1)) == 0 && "alignment must be power of two");
+
+  const vk::DeviceSize offset = (m_Head + alignment - 1) & ~(alignment - 1);
+  if (offset + size > m_FrameBegin + m_SizePerFrame)
+  {
+    LOG_CORE_WARN("staging ring is full, {} bytes requested, {} bytes used of {}", size, GetUsed(), m_SizePerFrame);
+    return std::nullopt;
+  }
+
+  m_Head = offset + size;
+  return Allocation{.buffer = m_Buffer.buffer,
+                    .offset = offset,
+                    .mapped = static_cast<std::byte*>(m_Buffer.mapped) + offset};
+}
+
+} // namespace four
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/vulkanAllocator.hpp"
+
+namespace four
+{
+
+/**
+ * @brief Persistently mapped staging ring partitioned per frame in flight
+ * each frame owns one region of a single upload buffer and bump allocates from it,
+ * region is recycled in BeginFrame() once the frame fence is signaled, so no allocation happens per frame
+ */
+class FOUR_ENGINE_API VulkanStagingRing
+{
+public:
+  struct Allocation
+  {
+    vk::Buffer     buffer;
+    vk::DeviceSize offset{0};
+    void*          mapped{nullptr};
+  };
+
+  VulkanStagingRing() = default;
+  ~VulkanStagingRing();
+
+  VulkanStagingRing(const VulkanStagingRing&)            = delete;
+  VulkanStagingRing(VulkanStagingRing&&)                 = delete;
+  VulkanStagingRing& operator=(const VulkanStagingRing&) = delete;
+  VulkanStagingRing& operator=(VulkanStagingRing&&)      = delete;
+
+  /**
+   * @brief create the staging buffer
+   *
+   * @param allocator allocator to create the buffer from
+   * @param sizePerFrame size of region of each frame in bytes
+   * @param frameCount number of frames in flight
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(VulkanAllocator& allocator, vk::DeviceSize sizePerFrame, u32 frameCount);
+
+  /**
+   * @brief destroy the staging buffer, gpu should not use it anymore
+   */
+  void Shutdown();
+
+  /**
+   * @brief recycle region of the frame, call after fence of the frame is signaled
+   */
+  void BeginFrame(u32 frameIndex);
+
+  /**
+   * @brief bump allocate from region of current frame
+   * memory is valid until the next BeginFrame() of the same frame index
+   *
+   * @param size size in bytes
+   * @param alignment alignment of offset in the buffer, must be power of two
+   * @return allocation, or nullopt if region of the frame is full
+   */
+  [[nodiscard]] std::optional<Allocation> Allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+
+  [[nodiscard]] vk::DeviceSize GetUsed() const
+  {
+    return m_Head - m_FrameBegin;
+  }
+
+  [[nodiscard]] vk::DeviceSize GetSizePerFrame() const
+  {
+    return m_SizePerFrame;
+  }
+
+private:
+  VulkanAllocator* m_Allocator{nullptr};
+  AllocatedBuffer  m_Buffer;
+  vk::DeviceSize   m_SizePerFrame{0};
+  vk::DeviceSize   m_FrameBegin{0};
+  vk::DeviceSize   m_Head{0};
+};
+
+} // namespace four
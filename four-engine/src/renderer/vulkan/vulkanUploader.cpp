@@ -0,0 +1,381 @@
+#include "four-pch.hpp"
+
+#include "renderer/vulkan/vulkanUploader.hpp"
+
+namespace four
+{
+
+namespace
+{
+// alignment of staging sub-allocations, covers texel size of every format we upload and the copy offset rules
+constexpr vk::DeviceSize StagingAlignment = 16;
+
+constexpr vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+//===============================================================================
+VulkanUploader::~VulkanUploader()
+{
+  Shutdown();
+}
+
+//===============================================================================
+bool VulkanUploader::Init(const InitInfo& info)
+{
+  m_Device         = info.device;
+  m_Allocator      = info.allocator;
+  m_TransferQueue  = info.transferQueue;
+  m_TransferFamily = info.transferFamily;
+  m_GraphicsFamily = info.graphicsFamily;
+  m_Queue          = NeedsOwnershipTransfer() ? VKTransfer_0 : VKMain;
+
+  try
+  {
+    m_CommandPool = m_Device.createCommandPool(
+      {.flags            = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+       .queueFamilyIndex = m_TransferFamily});
+
+    vk::SemaphoreTypeCreateInfo timelineInfo{.semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0};
+    m_TimelineSemaphore = m_Device.createSemaphore({.pNext = &timelineInfo});
+
+    m_StagingRing = m_Allocator->CreateBuffer(AlignUp(info.stagingSize, StagingAlignment),
+                                              vk::BufferUsageFlagBits::eTransferSrc,
+                                              MemoryUsage::Upload);
+  } catch (const std::exception& e)
+  {
+    LOG_CORE_ERROR("failed to initialize uploader: {}", e.what());
+    return false;
+  }
+
+  LOG_CORE_INFO("uploader using queue family {} ( graphics family {} ), staging ring {} bytes",
+                m_TransferFamily,
+                m_GraphicsFamily,
+                m_StagingRing.size);
+  return true;
+}
+
+//===============================================================================
+void VulkanUploader::Shutdown()
+{
+  if (!m_Device)
+  {
+    return;
+  }
+
+  // nothing recorded is allowed to be lost, flush and drain the queue
+  Wait(Submit());
+  Collect();
+
+  m_Allocator->DestroyBuffer(m_StagingRing);
+  m_Device.destroySemaphore(m_TimelineSemaphore);
+  m_Device.destroyCommandPool(m_CommandPool);
+  m_FreeCommandBuffers.clear();
+  m_BufferAcquires.clear();
+  m_ImageAcquires.clear();
+  m_Device = nullptr;
+}
+
+//===============================================================================
+bool VulkanUploader::NeedsOwnershipTransfer() const
+{
+  return m_TransferFamily != m_GraphicsFamily;
+}
+
+//===============================================================================
+vk::CommandBuffer VulkanUploader::GetRecordingCommandBuffer()
+{
+  if (m_Recording)
+  {
+    return m_CurrentBatch.cmd;
+  }
+
+  vk::CommandBuffer cmd;
+  if (m_FreeCommandBuffers.empty())
+  {
+    cmd = m_Device.allocateCommandBuffers(
+      {.commandPool = m_CommandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1})[0];
+  }
+  else
+  {
+    cmd = m_FreeCommandBuffers.back();
+    m_FreeCommandBuffers.pop_back();
+  }
+
+  cmd.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+  m_CurrentBatch.cmd = cmd;
+  m_Recording        = true;
+  return cmd;
+}
+
+//===============================================================================
+VulkanUploader::StagingAllocation VulkanUploader::AllocateStaging(vk::DeviceSize size)
+{
+  const vk::DeviceSize ringSize    = m_StagingRing.size;
+  const vk::DeviceSize alignedSize = AlignUp(size, StagingAlignment);
+
+  // big uploads would starve the ring, give them their own buffer that dies with the batch
+  if (alignedSize > ringSize / 2)
+  {
+    AllocatedBuffer dedicated = m_Allocator->CreateBuffer(size, vk::BufferUsageFlagBits::eTransferSrc, MemoryUsage::Upload);
+    const StagingAllocation allocation{.buffer = dedicated.buffer, .offset = 0, .mapped = dedicated.mapped};
+    m_CurrentBatch.dedicatedStaging.push_back(dedicated);
+    return allocation;
+  }
+
+  // an allocation never wraps around the end of the ring, skip the remaining bytes instead
+  vk::DeviceSize offset = m_RingHead % ringSize;
+  if (offset + alignedSize > ringSize)
+  {
+    m_RingHead += ringSize - offset;
+    offset = 0;
+  }
+
+  while (m_RingHead + alignedSize - m_RingTail > ringSize)
+  {
+    Collect();
+    if (m_RingHead + alignedSize - m_RingTail <= ringSize)
+    {
+      break;
+    }
+    if (m_InFlightBatches.empty())
+    {
+      // nothing owns the ring, only the skipped bytes are left between tail and head
+      if (!m_Recording)
+      {
+        m_RingTail = m_RingHead;
+        break;
+      }
+      // ring is full of work that is not submitted yet, kick it so it can be reclaimed
+      Submit();
+    }
+    Wait({.value = m_InFlightBatches.front().timelineValue});
+  }
+
+  m_RingHead += alignedSize;
+  return {.buffer = m_StagingRing.buffer,
+          .offset = offset,
+          .mapped = static_cast<std::byte*>(m_StagingRing.mapped) + offset};
+}
+
+//===============================================================================
+void VulkanUploader::UploadBuffer(const void*             data,
+                                  vk::DeviceSize          size,
+                                  vk::Buffer              dstBuffer,
+                                  vk::DeviceSize          dstOffset,
+                                  vk::PipelineStageFlags2 dstStage,
+                                  vk::AccessFlags2        dstAccess)
+{
+  const StagingAllocation staging = AllocateStaging(size);
+  std::memcpy(staging.mapped, data, size);
+
+  const vk::CommandBuffer cmd = GetRecordingCommandBuffer();
+  cmd.copyBuffer(staging.buffer, dstBuffer, vk::BufferCopy{.srcOffset = staging.offset, .dstOffset = dstOffset, .size = size});
+
+  // on same family the timeline wait of graphics submit is enough to make the copy visible
+  if (!NeedsOwnershipTransfer())
+  {
+    return;
+  }
+
+  const vk::BufferMemoryBarrier2 release{.srcStageMask        = vk::PipelineStageFlagBits2::eCopy,
+                                         .srcAccessMask       = vk::AccessFlagBits2::eTransferWrite,
+                                         .dstStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                         .dstAccessMask       = vk::AccessFlagBits2::eNone,
+                                         .srcQueueFamilyIndex = m_TransferFamily,
+                                         .dstQueueFamilyIndex = m_GraphicsFamily,
+                                         .buffer              = dstBuffer,
+                                         .offset              = dstOffset,
+                                         .size                = size};
+  cmd.pipelineBarrier2({.bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &release});
+
+  m_PendingBufferAcquires.push_back({.srcStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                     .srcAccessMask       = vk::AccessFlagBits2::eNone,
+                                     .dstStageMask        = dstStage,
+                                     .dstAccessMask       = dstAccess,
+                                     .srcQueueFamilyIndex = m_TransferFamily,
+                                     .dstQueueFamilyIndex = m_GraphicsFamily,
+                                     .buffer              = dstBuffer,
+                                     .offset              = dstOffset,
+                                     .size                = size});
+}
+
+//===============================================================================
+void VulkanUploader::UploadImage(const void*             data,
+                                 vk::DeviceSize          size,
+                                 vk::Image               dstImage,
+                                 vk::Extent3D            extent,
+                                 vk::ImageLayout         finalLayout,
+                                 vk::PipelineStageFlags2 dstStage,
+                                 vk::AccessFlags2        dstAccess)
+{
+  const StagingAllocation staging = AllocateStaging(size);
+  std::memcpy(staging.mapped, data, size);
+
+  const vk::ImageSubresourceRange range{.aspectMask     = vk::ImageAspectFlagBits::eColor,
+                                        .baseMipLevel   = 0,
+                                        .levelCount     = 1,
+                                        .baseArrayLayer = 0,
+                                        .layerCount     = 1};
+
+  const vk::CommandBuffer       cmd = GetRecordingCommandBuffer();
+  const vk::ImageMemoryBarrier2 toTransfer{.srcStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                           .srcAccessMask       = vk::AccessFlagBits2::eNone,
+                                           .dstStageMask        = vk::PipelineStageFlagBits2::eCopy,
+                                           .dstAccessMask       = vk::AccessFlagBits2::eTransferWrite,
+                                           .oldLayout           = vk::ImageLayout::eUndefined,
+                                           .newLayout           = vk::ImageLayout::eTransferDstOptimal,
+                                           .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                           .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                           .image               = dstImage,
+                                           .subresourceRange    = range};
+  cmd.pipelineBarrier2({.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toTransfer});
+
+  const vk::BufferImageCopy region{.bufferOffset      = staging.offset,
+                                   .bufferRowLength   = 0,
+                                   .bufferImageHeight = 0,
+                                   .imageSubresource  = {.aspectMask     = vk::ImageAspectFlagBits::eColor,
+                                                         .mipLevel       = 0,
+                                                         .baseArrayLayer = 0,
+                                                         .layerCount     = 1},
+                                   .imageOffset       = {0, 0, 0},
+                                   .imageExtent       = extent};
+  cmd.copyBufferToImage(staging.buffer, dstImage, vk::ImageLayout::eTransferDstOptimal, region);
+
+  // the layout transition is done once, by the release barrier, and repeated identically by the acquire barrier
+  const bool                    transfer = NeedsOwnershipTransfer();
+  const vk::ImageMemoryBarrier2 release{.srcStageMask        = vk::PipelineStageFlagBits2::eCopy,
+                                        .srcAccessMask       = vk::AccessFlagBits2::eTransferWrite,
+                                        .dstStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                        .dstAccessMask       = vk::AccessFlagBits2::eNone,
+                                        .oldLayout           = vk::ImageLayout::eTransferDstOptimal,
+                                        .newLayout           = finalLayout,
+                                        .srcQueueFamilyIndex = transfer ? m_TransferFamily : vk::QueueFamilyIgnored,
+                                        .dstQueueFamilyIndex = transfer ? m_GraphicsFamily : vk::QueueFamilyIgnored,
+                                        .image               = dstImage,
+                                        .subresourceRange    = range};
+  cmd.pipelineBarrier2({.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &release});
+
+  if (!transfer)
+  {
+    return;
+  }
+
+  m_PendingImageAcquires.push_back({.srcStageMask        = vk::PipelineStageFlagBits2::eNone,
+                                    .srcAccessMask       = vk::AccessFlagBits2::eNone,
+                                    .dstStageMask        = dstStage,
+                                    .dstAccessMask       = dstAccess,
+                                    .oldLayout           = vk::ImageLayout::eTransferDstOptimal,
+                                    .newLayout           = finalLayout,
+                                    .srcQueueFamilyIndex = m_TransferFamily,
+                                    .dstQueueFamilyIndex = m_GraphicsFamily,
+                                    .image               = dstImage,
+                                    .subresourceRange    = range});
+}
+
+//===============================================================================
+UploadTicket VulkanUploader::Submit()
+{
+  if (!m_Recording)
+  {
+    return {.value = m_NextTimelineValue - 1};
+  }
+
+  m_CurrentBatch.cmd.end();
+  m_CurrentBatch.timelineValue = m_NextTimelineValue++;
+  m_CurrentBatch.ringEnd       = m_RingHead;
+
+  const vk::CommandBufferSubmitInfo cmdInfo{.commandBuffer = m_CurrentBatch.cmd};
+  const vk::SemaphoreSubmitInfo     signalInfo{.semaphore = m_TimelineSemaphore,
+                                               .value     = m_CurrentBatch.timelineValue,
+                                               .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+  const vk::SubmitInfo2 submitInfo{.commandBufferInfoCount   = 1,
+                                   .pCommandBufferInfos      = &cmdInfo,
+                                   .signalSemaphoreInfoCount = 1,
+                                   .pSignalSemaphoreInfos    = &signalInfo};
+  m_TransferQueue.submit2(submitInfo);
+
+  // acquire barriers are only valid to record once the matching release is submitted
+  m_BufferAcquires.insert(m_BufferAcquires.end(), m_PendingBufferAcquires.begin(), m_PendingBufferAcquires.end());
+  m_ImageAcquires.insert(m_ImageAcquires.end(), m_PendingImageAcquires.begin(), m_PendingImageAcquires.end());
+  m_PendingBufferAcquires.clear();
+  m_PendingImageAcquires.clear();
+  m_AcquireWaitValue = m_CurrentBatch.timelineValue;
+
+  const UploadTicket ticket{.value = m_CurrentBatch.timelineValue};
+  m_InFlightBatches.push_back(std::move(m_CurrentBatch));
+  m_CurrentBatch = {};
+  m_Recording    = false;
+  return ticket;
+}
+
+//===============================================================================
+u64 VulkanUploader::RecordAcquireBarriers(vk::CommandBuffer cmd)
+{
+  Collect();
+
+  if (!m_BufferAcquires.empty() || !m_ImageAcquires.empty())
+  {
+    cmd.pipelineBarrier2({.bufferMemoryBarrierCount = static_cast<u32>(m_BufferAcquires.size()),
+                          .pBufferMemoryBarriers    = m_BufferAcquires.data(),
+                          .imageMemoryBarrierCount  = static_cast<u32>(m_ImageAcquires.size()),
+                          .pImageMemoryBarriers     = m_ImageAcquires.data()});
+    m_BufferAcquires.clear();
+    m_ImageAcquires.clear();
+  }
+
+  const u64 waitValue = m_AcquireWaitValue;
+  m_AcquireWaitValue  = 0;
+  return waitValue;
+}
+
+//===============================================================================
+u64 VulkanUploader::GetCompletedValue() const
+{
+  return m_Device.getSemaphoreCounterValue(m_TimelineSemaphore);
+}
+
+//===============================================================================
+bool VulkanUploader::IsComplete(UploadTicket ticket) const
+{
+  return ticket.value <= GetCompletedValue();
+}
+
+//===============================================================================
+void VulkanUploader::Wait(UploadTicket ticket) const
+{
+  if (ticket.value == 0)
+  {
+    return;
+  }
+
+  const vk::SemaphoreWaitInfo waitInfo{.semaphoreCount = 1, .pSemaphores = &m_TimelineSemaphore, .pValues = &ticket.value};
+  [[maybe_unused]] const auto result = m_Device.waitSemaphores(waitInfo, std::numeric_limits<uint64_t>::max());
+}
+
+//===============================================================================
+void VulkanUploader::Collect()
+{
+  if (m_InFlightBatches.empty())
+  {
+    return;
+  }
+
+  const u64 completed = GetCompletedValue();
+  while (!m_InFlightBatches.empty() && m_InFlightBatches.front().timelineValue <= completed)
+  {
+    Batch& batch = m_InFlightBatches.front();
+    m_RingTail   = batch.ringEnd;
+    for (auto& staging : batch.dedicatedStaging)
+    {
+      m_Allocator->DestroyBuffer(staging);
+    }
+    batch.cmd.reset();
+    m_FreeCommandBuffers.push_back(batch.cmd);
+    m_InFlightBatches.pop_front();
+  }
+}
+
+} // namespace four
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "vulkan/vulkan.hpp"
+#include "renderer/vulkan/VKTypes.hpp"
+#include "renderer/vulkan/vulkanAllocator.hpp"
+
+namespace four
+{
+
+/**
+ * @brief handle to a submitted upload batch
+ * value is the timeline semaphore value signaled when the batch is finished on gpu
+ */
+struct UploadTicket
+{
+  u64 value{0};
+};
+
+/**
+ * @brief Upload service using the dedicated transfer queue
+ * copies are recorded into a batch and submitted together, staging memory comes from a ring arena
+ * that get recycled when timeline semaphore reports the batch as completed.
+ * when transfer queue family is different than graphics, ownership is released on transfer queue
+ * and acquired on graphics queue with RecordAcquireBarriers()
+ */
+class FOUR_ENGINE_API VulkanUploader
+{
+public:
+  struct InitInfo
+  {
+    vk::Device       device;
+    VulkanAllocator* allocator{nullptr};
+    vk::Queue        transferQueue;
+    u32              transferFamily{0};
+    u32              graphicsFamily{0};
+    vk::DeviceSize   stagingSize{64ULL * 1024 * 1024};
+  };
+
+  VulkanUploader() = default;
+  ~VulkanUploader();
+
+  VulkanUploader(const VulkanUploader&)            = delete;
+  VulkanUploader(VulkanUploader&&)                 = delete;
+  VulkanUploader& operator=(const VulkanUploader&) = delete;
+  VulkanUploader& operator=(VulkanUploader&&)      = delete;
+
+  /**
+   * @brief create command pool, timeline semaphore and staging ring
+   *
+   * @param info device, queues and staging size to use
+   * @return true if successfully initialized
+   */
+  [[nodiscard]] bool Init(const InitInfo& info);
+
+  /**
+   * @brief destroy all resources, device should be idle
+   */
+  void Shutdown();
+
+  /**
+   * @brief record copy of data into buffer in current batch
+   *
+   * @param data pointer to data to copy, copied into staging memory before return
+   * @param size size of data in bytes
+   * @param dstBuffer destination buffer
+   * @param dstOffset offset in destination buffer
+   * @param dstStage graphics stage that is going to consume the buffer
+   * @param dstAccess access of the graphics stage
+   */
+  void UploadBuffer(const void*             data,
+                    vk::DeviceSize          size,
+                    vk::Buffer              dstBuffer,
+                    vk::DeviceSize          dstOffset,
+                    vk::PipelineStageFlags2 dstStage,
+                    vk::AccessFlags2        dstAccess);
+
+  /**
+   * @brief record copy of tightly packed pixels into first mip of the image in current batch
+   * image is transitioned from undefined layout to final layout
+   *
+   * @param data pointer to pixels, copied into staging memory before return
+   * @param size size of data in bytes
+   * @param dstImage destination image
+   * @param extent extent of the image
+   * @param finalLayout layout of the image after upload
+   * @param dstStage graphics stage that is going to consume the image
+   * @param dstAccess access of the graphics stage
+   */
+  void UploadImage(const void*             data,
+                   vk::DeviceSize          size,
+                   vk::Image               dstImage,
+                   vk::Extent3D            extent,
+                   vk::ImageLayout         finalLayout,
+                   vk::PipelineStageFlags2 dstStage,
+                   vk::AccessFlags2        dstAccess);
+
+  /**
+   * @brief submit current batch to the transfer queue without waiting
+   *
+   * @return ticket of submitted batch, or ticket of last batch if nothing was recorded
+   */
+  UploadTicket Submit();
+
+  /**
+   * @brief record queue family acquire barriers of submitted batches into graphics command buffer
+   *
+   * @param cmd graphics command buffer in recording state
+   * @return timeline value that graphics submit must wait on, 0 if no wait needed
+   */
+  [[nodiscard]] u64 RecordAcquireBarriers(vk::CommandBuffer cmd);
+
+  /**
+   * @brief check if batch is finished on gpu
+   */
+  [[nodiscard]] bool IsComplete(UploadTicket ticket) const;
+
+  /**
+   * @brief block until batch is finished on gpu
+   */
+  void Wait(UploadTicket ticket) const;
+
+  /**
+   * @brief true if current batch has recorded copies that are not submitted
+   */
+  [[nodiscard]] bool HasPendingCopies() const
+  {
+    return m_Recording;
+  }
+
+  [[nodiscard]] vk::Semaphore GetTimelineSemaphore() const
+  {
+    return m_TimelineSemaphore;
+  }
+
+  [[nodiscard]] VKQueue GetQueue() const
+  {
+    return m_Queue;
+  }
+
+private:
+  struct StagingAllocation
+  {
+    vk::Buffer     buffer;
+    vk::DeviceSize offset{0};
+    void*          mapped{nullptr};
+  };
+
+  struct Batch
+  {
+    vk::CommandBuffer            cmd;
+    u64                          timelineValue{0};
+    u64                          ringEnd{0};
+    std::vector<AllocatedBuffer> dedicatedStaging;
+  };
+
+  [[nodiscard]] bool              NeedsOwnershipTransfer() const;
+  [[nodiscard]] StagingAllocation AllocateStaging(vk::DeviceSize size);
+  [[nodiscard]] vk::CommandBuffer GetRecordingCommandBuffer();
+  [[nodiscard]] u64               GetCompletedValue() const;
+  void                            Collect();
+
+private:
+  vk::Device       m_Device;
+  VulkanAllocator* m_Allocator{nullptr};
+  vk::Queue        m_TransferQueue;
+  VKQueue          m_Queue{VKMain};
+  u32              m_TransferFamily{0};
+  u32              m_GraphicsFamily{0};
+
+  vk::CommandPool                m_CommandPool;
+  std::vector<vk::CommandBuffer> m_FreeCommandBuffers;
+  vk::Semaphore                  m_TimelineSemaphore;
+  u64                            m_NextTimelineValue{1};
+
+  // staging ring, head and tail are monotonic byte counters, offset in buffer is counter % size
+  AllocatedBuffer m_StagingRing;
+  u64             m_RingHead{0};
+  u64             m_RingTail{0};
+
+  Batch             m_CurrentBatch;
+  bool              m_Recording{false};
+  std::deque<Batch> m_InFlightBatches;
+
+  // acquire barriers waiting to be recorded on graphics queue
+  std::vector<vk::BufferMemoryBarrier2> m_BufferAcquires;
+  std::vector<vk::ImageMemoryBarrier2>  m_ImageAcquires;
+  std::vector<vk::BufferMemoryBarrier2> m_PendingBufferAcquires;
+  std::vector<vk::ImageMemoryBarrier2>  m_PendingImageAcquires;
+  u64                                   m_AcquireWaitValue{0};
+};
+
+} // namespace four
@@ -0,0 +1,121 @@
+#include "four-pch.hpp"
+
+#include "scene/archetype.hpp"
+
+namespace four
+{
+
+namespace
+{
+constexpr u32 AlignUp(u32 value, u32 alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+//===============================================================================
+Archetype::Archetype(ComponentMask mask) : m_Mask{mask}
+{
+  m_ColumnOffsets.fill(NoColumn);
+
+  u32 rowSize = sizeof(Entity);
+  for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; ++id)
+  {
+    if (Has(id))
+    {
+      m_Components.push_back(id);
+      m_ComponentSizes[id] = GetComponentInfo(id).size;
+      rowSize += m_ComponentSizes[id];
+    }
+  }
+
+  // start from the capacity ignoring padding, shrink until the aligned columns fit
+  m_ChunkCapacity = std::max(ECS_CHUNK_SIZE / rowSize, 1U);
+  while (true)
+  {
+    u32 offset = sizeof(Entity) * m_ChunkCapacity;
+    for (const ComponentId id : m_Components)
+    {
+      offset              = AlignUp(offset, GetComponentInfo(id).alignment);
+      m_ColumnOffsets[id] = offset;
+      offset += m_ComponentSizes[id] * m_ChunkCapacity;
+    }
+    if (offset <= ECS_CHUNK_SIZE || m_ChunkCapacity == 1)
+    {
+      break;
+    }
+    --m_ChunkCapacity;
+  }
+}
+
+//===============================================================================
+Archetype::~Archetype()
+{
+  for (u32 chunk = 0; chunk < m_Chunks.size(); ++chunk)
+  {
+    const u32 rows = GetRowCount(chunk);
+    for (const ComponentId id : m_Components)
+    {
+      const ComponentInfo& info   = GetComponentInfo(id);
+      auto*                column = static_cast<std::byte*>(GetColumn(chunk, id));
+      for (u32 row = 0; row < rows; ++row)
+      {
+        info.destroy(column + (row * info.size));
+      }
+    }
+  }
+}
+
+//===============================================================================
+ArchetypeLocation Archetype::Allocate(Entity entity)
+{
+  if (m_EntityCount == m_Chunks.size() * m_ChunkCapacity)
+  {
+    // a single component bigger than a chunk gets a chunk of its own size
+    const u32 lastColumn = m_Components.empty() ? 0 : m_ColumnOffsets[m_Components.back()];
+    const u32 lastSize   = m_Components.empty() ? 0 : m_ComponentSizes[m_Components.back()] * m_ChunkCapacity;
+    m_Chunks.push_back(AllocateAlignedBlock(std::max(ECS_CHUNK_SIZE, lastColumn + lastSize)));
+  }
+
+  const ArchetypeLocation location{.chunk = m_EntityCount / m_ChunkCapacity, .row = m_EntityCount % m_ChunkCapacity};
+  new (GetEntities(location.chunk) + location.row) Entity{entity};
+  ++m_EntityCount;
+  return location;
+}
+
+//===============================================================================
+Entity Archetype::Remove(ArchetypeLocation location)
+{
+  const ArchetypeLocation last{.chunk = (m_EntityCount - 1) / m_ChunkCapacity,
+                               .row   = (m_EntityCount - 1) % m_ChunkCapacity};
+  const bool              isLast = location.chunk == last.chunk && location.row == last.row;
+
+  for (const ComponentId id : m_Components)
+  {
+    const ComponentInfo& info      = GetComponentInfo(id);
+    void*                component = GetComponent(location, id);
+    info.destroy(component);
+    if (!isLast)
+    {
+      void* lastComponent = GetComponent(last, id);
+      info.moveConstruct(component, lastComponent);
+      info.destroy(lastComponent);
+    }
+  }
+
+  Entity moved = NullEntity;
+  if (!isLast)
+  {
+    moved                                     = GetEntities(last.chunk)[last.row];
+    GetEntities(location.chunk)[location.row] = moved;
+  }
+
+  --m_EntityCount;
+  if (m_EntityCount == (m_Chunks.size() - 1) * m_ChunkCapacity)
+  {
+    m_Chunks.pop_back();
+  }
+  return moved;
+}
+
+} // namespace four
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "component/component.hpp"
+#include "entity/entity.hpp"
+
+namespace four
+{
+
+constexpr u32 ECS_CHUNK_SIZE = 16 * 1024; // bytes of one archetype chunk, fits comfortably in L1 and L2
+
+struct AlignedDeleter
+{
+  void operator()(std::byte* block) const
+  {
+    ::operator delete(block, std::align_val_t{ECS_MAX_ALIGNMENT});
+  }
+};
+
+/** memory block aligned to ECS_MAX_ALIGNMENT */
+using AlignedBlock = std::unique_ptr<std::byte[], AlignedDeleter>;
+
+[[nodiscard]] inline AlignedBlock AllocateAlignedBlock(size_t size)
+{
+  return AlignedBlock{static_cast<std::byte*>(::operator new(size, std::align_val_t{ECS_MAX_ALIGNMENT}))};
+}
+
+/**
+ * @brief where the components of an entity live inside its archetype
+ */
+struct ArchetypeLocation
+{
+  u32 chunk{0};
+  u32 row{0};
+};
+
+/**
+ * @brief Storage of every entity with one exact set of components
+ * entities are packed in fixed size chunks, each chunk holds the entity handles followed by one contiguous column
+ * per component ( SoA ), so iterating a component touches only the memory of that component.
+ * rows are kept dense, removing a row moves the last row of the archetype into the hole.
+ */
+class FOUR_ENGINE_API Archetype
+{
+public:
+  static constexpr u32 NoColumn = std::numeric_limits<u32>::max();
+
+  explicit Archetype(ComponentMask mask);
+  ~Archetype();
+
+  Archetype(const Archetype&)            = delete;
+  Archetype(Archetype&&)                 = delete;
+  Archetype& operator=(const Archetype&) = delete;
+  Archetype& operator=(Archetype&&)      = delete;
+
+  [[nodiscard]] ComponentMask GetMask() const
+  {
+    return m_Mask;
+  }
+
+  [[nodiscard]] bool Has(ComponentId id) const
+  {
+    return (m_Mask & (ComponentMask{1} << id)) != 0;
+  }
+
+  /**
+   * @brief component ids in ascending order
+   */
+  [[nodiscard]] const std::vector<ComponentId>& GetComponents() const
+  {
+    return m_Components;
+  }
+
+  [[nodiscard]] u32 GetEntityCount() const
+  {
+    return m_EntityCount;
+  }
+
+  [[nodiscard]] u32 GetChunkCount() const
+  {
+    return static_cast<u32>(m_Chunks.size());
+  }
+
+  [[nodiscard]] u32 GetChunkCapacity() const
+  {
+    return m_ChunkCapacity;
+  }
+
+  /**
+   * @brief rows used in chunk, every chunk but the last one is full
+   */
+  [[nodiscard]] u32 GetRowCount(u32 chunk) const
+  {
+    return chunk + 1 < m_Chunks.size() ? m_ChunkCapacity : m_EntityCount - (chunk * m_ChunkCapacity);
+  }
+
+  [[nodiscard]] Entity* GetEntities(u32 chunk) const
+  {
+    return reinterpret_cast<Entity*>(m_Chunks[chunk].get());
+  }
+
+  /**
+   * @brief first element of the component column of chunk, null when the archetype does not have the component
+   */
+  [[nodiscard]] void* GetColumn(u32 chunk, ComponentId id) const
+  {
+    const u32 offset = m_ColumnOffsets[id];
+    return offset != NoColumn ? m_Chunks[chunk].get() + offset : nullptr;
+  }
+
+  template <typename T>
+  [[nodiscard]] T* GetColumn(u32 chunk) const
+  {
+    return static_cast<T*>(GetColumn(chunk, GetComponentId<std::remove_const_t<T>>()));
+  }
+
+  [[nodiscard]] void* GetComponent(ArchetypeLocation location, ComponentId id) const
+  {
+    return static_cast<std::byte*>(GetColumn(location.chunk, id)) + (location.row * m_ComponentSizes[id]);
+  }
+
+  /**
+   * @brief append a row for entity, its components are left uninitialized for the caller to construct
+   */
+  [[nodiscard]] ArchetypeLocation Allocate(Entity entity);
+
+  /**
+   * @brief destroy components of row and fill it with the last row
+   *
+   * @return entity moved into the row, NullEntity when the removed row was the last one
+   */
+  [[nodiscard]] Entity Remove(ArchetypeLocation location);
+
+  /**
+   * @brief cached archetype reached by adding or removing one component, null until first looked up
+   */
+  [[nodiscard]] Archetype* GetAddEdge(ComponentId id) const
+  {
+    return m_AddEdges[id];
+  }
+  [[nodiscard]] Archetype* GetRemoveEdge(ComponentId id) const
+  {
+    return m_RemoveEdges[id];
+  }
+  void SetAddEdge(ComponentId id, Archetype* archetype)
+  {
+    m_AddEdges[id] = archetype;
+  }
+  void SetRemoveEdge(ComponentId id, Archetype* archetype)
+  {
+    m_RemoveEdges[id] = archetype;
+  }
+
+private:
+  ComponentMask            m_Mask;
+  std::vector<ComponentId> m_Components;
+  u32                      m_ChunkCapacity{0};
+  u32                      m_EntityCount{0};
+
+  // indexed by component id, NoColumn and 0 for components the archetype does not have
+  std::array<u32, ECS_MAX_COMPONENTS> m_ColumnOffsets{};
+  std::array<u32, ECS_MAX_COMPONENTS> m_ComponentSizes{};
+
+  std::array<Archetype*, ECS_MAX_COMPONENTS> m_AddEdges{};
+  std::array<Archetype*, ECS_MAX_COMPONENTS> m_RemoveEdges{};
+
+  std::vector<AlignedBlock> m_Chunks;
+};
+
+} // namespace four
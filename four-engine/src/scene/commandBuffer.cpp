@@ -0,0 +1,117 @@
+#include "four-pch.hpp"
+
+#include "scene/commandBuffer.hpp"
+
+namespace four
+{
+
+//===============================================================================
+CommandBuffer::~CommandBuffer()
+{
+  Clear();
+}
+
+//===============================================================================
+Entity CommandBuffer::CreateEntity()
+{
+  const Entity placeholder{.index = PlaceholderBit | m_CreatedCount++, .generation = 0};
+  m_Commands.push_back({.type = CommandType::Create, .entity = placeholder});
+  return placeholder;
+}
+
+//===============================================================================
+void CommandBuffer::DestroyEntity(Entity entity)
+{
+  m_Commands.push_back({.type = CommandType::Destroy, .entity = entity});
+}
+
+//===============================================================================
+void CommandBuffer::Playback(Scene& scene)
+{
+  std::vector<Entity> created;
+  created.reserve(m_CreatedCount);
+  // null, placeholders of other buffers or of creates not played back yet resolve to null and are dropped
+  const auto resolve = [&created](Entity entity)
+  {
+    if (entity.IsNull() || (entity.index & PlaceholderBit) == 0)
+    {
+      return entity;
+    }
+    const u32 slot = entity.index & ~PlaceholderBit;
+    return slot < created.size() ? created[slot] : NullEntity;
+  };
+
+  for (const Command& command : m_Commands)
+  {
+    // placeholder of a create command is only resolved once the entity exists
+    const Entity entity = command.type != CommandType::Create ? resolve(command.entity) : command.entity;
+    switch (command.type)
+    {
+      case CommandType::Create:
+        created.push_back(scene.CreateEntity());
+        break;
+      case CommandType::Destroy:
+        if (scene.IsAlive(entity))
+        {
+          scene.DestroyEntity(entity);
+        }
+        break;
+      case CommandType::Add:
+        if (scene.IsAlive(entity))
+        {
+          GetComponentInfo(command.component).moveConstruct(scene.EmplaceComponent(entity, command.component),
+                                                            command.payload);
+        }
+        break;
+      case CommandType::Remove:
+        if (scene.IsAlive(entity))
+        {
+          scene.RemoveComponent(entity, command.component);
+        }
+        break;
+    }
+  }
+
+  Clear();
+}
+
+//===============================================================================
+void* CommandBuffer::AllocatePayload(u32 size, u32 alignment)
+{
+  if (size > BlockSize - alignment)
+  {
+    // oversized component gets its own block, placed before the block still being filled
+    const auto position = m_Blocks.empty() ? m_Blocks.end() : m_Blocks.end() - 1;
+    return m_Blocks.insert(position, AllocateAlignedBlock(size))->get();
+  }
+
+  m_BlockOffset = (m_BlockOffset + alignment - 1) & ~(alignment - 1);
+  if (m_BlockOffset + size > BlockSize)
+  {
+    m_Blocks.push_back(AllocateAlignedBlock(BlockSize));
+    m_BlockOffset = 0;
+  }
+
+  void* payload = m_Blocks.back().get() + m_BlockOffset;
+  m_BlockOffset += size;
+  return payload;
+}
+
+//===============================================================================
+void CommandBuffer::Clear()
+{
+  for (const Command& command : m_Commands)
+  {
+    if (command.type == CommandType::Add)
+    {
+      GetComponentInfo(command.component).destroy(command.payload);
+    }
+  }
+
+  m_Commands.clear();
+  m_Blocks.clear();
+  m_BlockOffset  = BlockSize;
+  m_CreatedCount = 0;
+}
+
+} // namespace four
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "scene/scene.hpp"
+
+namespace four
+{
+
+/**
+ * @brief Deferred structural changes of a Scene
+ * commands are recorded while the scene is iterated, possibly on several threads with one buffer each, and applied
+ * in record order by Playback. component values are moved into stable blocks owned by the buffer until played back.
+ * entities created through the buffer get a placeholder handle that is only valid for later commands of the same
+ * buffer, Playback maps it to the real entity.
+ */
+class FOUR_ENGINE_API CommandBuffer
+{
+public:
+  CommandBuffer() = default;
+  ~CommandBuffer();
+
+  CommandBuffer(const CommandBuffer&)            = delete;
+  CommandBuffer(CommandBuffer&&)                 = default;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(CommandBuffer&&)      = delete;
+
+  /**
+   * @brief create entity at playback
+   *
+   * @return placeholder, usable with the commands of this buffer only
+   */
+  Entity CreateEntity();
+
+  void DestroyEntity(Entity entity);
+
+  template <ComponentType T, typename... Args>
+  void AddComponent(Entity entity, Args&&... args)
+  {
+    void* payload = AllocatePayload(sizeof(T), alignof(T));
+    new (payload) T(std::forward<Args>(args)...);
+    m_Commands.push_back(
+      {.type = CommandType::Add, .component = GetComponentId<T>(), .entity = entity, .payload = payload});
+  }
+
+  template <ComponentType T>
+  void RemoveComponent(Entity entity)
+  {
+    m_Commands.push_back({.type = CommandType::Remove, .component = GetComponentId<T>(), .entity = entity});
+  }
+
+  /**
+   * @brief apply and clear recorded commands, commands on entities that are no longer alive are dropped
+   */
+  void Playback(Scene& scene);
+
+  [[nodiscard]] bool IsEmpty() const
+  {
+    return m_Commands.empty();
+  }
+
+private:
+  static constexpr u32 PlaceholderBit = 1U << 31U; // scenes never reach this many entities
+  static constexpr u32 BlockSize      = 4096;
+
+  enum class CommandType : u8
+  {
+    Create,
+    Destroy,
+    Add,
+    Remove,
+  };
+
+  struct Command
+  {
+    CommandType type{CommandType::Create};
+    ComponentId component{0};
+    Entity      entity;
+    void*       payload{nullptr}; // constructed component of Add
+  };
+
+  [[nodiscard]] void* AllocatePayload(u32 size, u32 alignment);
+
+  /**
+   * @brief destroy payloads, played back or not, and release their blocks
+   */
+  void Clear();
+
+private:
+  std::vector<Command>      m_Commands;
+  std::vector<AlignedBlock> m_Blocks;
+  u32                       m_BlockOffset{BlockSize}; // used bytes of the last block
+  u32                       m_CreatedCount{0};
+};
+
+} // namespace four
@@ -0,0 +1,160 @@
+#include "four-pch.hpp"
+
+#include "scene/scene.hpp"
+
+namespace four
+{
+
+//===============================================================================
+Scene::Scene()
+{
+  m_EmptyArchetype = GetOrCreateArchetype(0);
+}
+
+//===============================================================================
+Scene::~Scene() = default;
+
+//===============================================================================
+Entity Scene::CreateEntity()
+{
+  const Entity  entity = AllocateEntity();
+  EntityRecord& record = m_Records[entity.index];
+  record.archetype     = m_EmptyArchetype;
+  record.location      = m_EmptyArchetype->Allocate(entity);
+  return entity;
+}
+
+//===============================================================================
+void Scene::DestroyEntity(Entity entity)
+{
+  if (!IsAlive(entity))
+  {
+    return;
+  }
+
+  EntityRecord& record = m_Records[entity.index];
+  const Entity  moved  = record.archetype->Remove(record.location);
+  if (!moved.IsNull())
+  {
+    m_Records[moved.index].location = record.location;
+  }
+
+  record.archetype = nullptr;
+  ++record.generation;
+  m_FreeIndices.push_back(entity.index);
+}
+
+//===============================================================================
+Entity Scene::AllocateEntity()
+{
+  if (!m_FreeIndices.empty())
+  {
+    const u32 index = m_FreeIndices.back();
+    m_FreeIndices.pop_back();
+    return {.index = index, .generation = m_Records[index].generation};
+  }
+
+  m_Records.emplace_back();
+  return {.index = static_cast<u32>(m_Records.size() - 1), .generation = 0};
+}
+
+//===============================================================================
+Archetype* Scene::GetOrCreateArchetype(ComponentMask mask)
+{
+  auto [it, inserted] = m_Archetypes.try_emplace(mask);
+  if (inserted)
+  {
+    it->second = std::make_unique<Archetype>(mask);
+    m_ArchetypeList.push_back(it->second.get());
+  }
+  return it->second.get();
+}
+
+//===============================================================================
+void Scene::MoveEntity(Entity entity, Archetype* target)
+{
+  EntityRecord&           record   = m_Records[entity.index];
+  Archetype*              source   = record.archetype;
+  const ArchetypeLocation location = target->Allocate(entity);
+
+  for (const ComponentId id : source->GetComponents())
+  {
+    if (target->Has(id))
+    {
+      GetComponentInfo(id).moveConstruct(target->GetComponent(location, id), source->GetComponent(record.location, id));
+    }
+  }
+
+  // destroys the moved-from components and the ones target does not have
+  const Entity moved = source->Remove(record.location);
+  if (!moved.IsNull())
+  {
+    m_Records[moved.index].location = record.location;
+  }
+
+  record.archetype = target;
+  record.location  = location;
+}
+
+//===============================================================================
+void* Scene::EmplaceComponent(Entity entity, ComponentId id)
+{
+  if (!IsAlive(entity))
+  {
+    LOG_CORE_ERROR("component added to entity {} that is not alive", entity.GetId());
+    throw std::invalid_argument("entity is not alive");
+  }
+
+  EntityRecord& record = m_Records[entity.index];
+  if (record.archetype->Has(id))
+  {
+    void* component = record.archetype->GetComponent(record.location, id);
+    GetComponentInfo(id).destroy(component);
+    return component;
+  }
+
+  Archetype* target = record.archetype->GetAddEdge(id);
+  if (target == nullptr)
+  {
+    target = GetOrCreateArchetype(record.archetype->GetMask() | (ComponentMask{1} << id));
+    record.archetype->SetAddEdge(id, target);
+    target->SetRemoveEdge(id, record.archetype);
+  }
+
+  MoveEntity(entity, target);
+  return target->GetComponent(record.location, id);
+}
+
+//===============================================================================
+void Scene::RemoveComponent(Entity entity, ComponentId id)
+{
+  if (!IsAlive(entity) || !m_Records[entity.index].archetype->Has(id))
+  {
+    return;
+  }
+
+  EntityRecord& record = m_Records[entity.index];
+  Archetype*    target = record.archetype->GetRemoveEdge(id);
+  if (target == nullptr)
+  {
+    target = GetOrCreateArchetype(record.archetype->GetMask() & ~(ComponentMask{1} << id));
+    record.archetype->SetRemoveEdge(id, target);
+    target->SetAddEdge(id, record.archetype);
+  }
+
+  MoveEntity(entity, target);
+}
+
+//===============================================================================
+void* Scene::FindComponent(Entity entity, ComponentId id) const
+{
+  if (!IsAlive(entity))
+  {
+    return nullptr;
+  }
+
+  const EntityRecord& record = m_Records[entity.index];
+  return record.archetype->Has(id) ? record.archetype->GetComponent(record.location, id) : nullptr;
+}
+
+} // namespace four
@@ -1,14 +1,212 @@
 #pragma once
 
+#include "core/core.hpp"
+
+#include "component/component.hpp"
+#include "entity/entity.hpp"
+#include "scene/archetype.hpp"
+#include "scene/sceneView.hpp"
+#include "scene/transformGraph.hpp"
+
+#include <unordered_map>
+
 namespace four
 {
-class Scene
+
+class CommandBuffer;
+
+/**
+ * @brief Archetype based entity component store
+ * every entity lives in the archetype of its exact component set, adding or removing a component moves its row to
+ * the neighbour archetype, found through cached edges. entities are generational handles into a slot table, so
+ * stale handles are detected instead of aliasing a reused slot.
+ * not thread safe, structural changes from systems running in parallel go through CommandBuffer.
+ */
+class FOUR_ENGINE_API Scene
 {
 public:
   Scene();
   ~Scene();
 
+  Scene(const Scene&)            = delete;
+  Scene(Scene&&)                 = delete;
+  Scene& operator=(const Scene&) = delete;
+  Scene& operator=(Scene&&)      = delete;
+
+  /**
+   * @brief create entity without components
+   */
+  Entity CreateEntity();
+
+  /**
+   * @brief create entity directly in the archetype of its components, no intermediate moves
+   */
+  template <typename... Ts>
+    requires(sizeof...(Ts) > 0 && (ComponentType<std::remove_cvref_t<Ts>> && ...))
+  Entity CreateEntity(Ts&&... components)
+  {
+    const Entity            entity   = AllocateEntity();
+    EntityRecord&           record   = m_Records[entity.index];
+    Archetype*              target   = GetOrCreateArchetype(GetComponentMask<std::remove_cvref_t<Ts>...>());
+    const ArchetypeLocation location = target->Allocate(entity);
+    record.archetype                 = target;
+    record.location                  = location;
+    (new (target->GetComponent(location, GetComponentId<std::remove_cvref_t<Ts>>()))
+       std::remove_cvref_t<Ts>(std::forward<Ts>(components)),
+     ...);
+    return entity;
+  }
+
+  /**
+   * @brief destroy entity and its components, stale handles are ignored
+   */
+  void DestroyEntity(Entity entity);
+
+  [[nodiscard]] bool IsAlive(Entity entity) const
+  {
+    return entity.index < m_Records.size() && m_Records[entity.index].generation == entity.generation &&
+           m_Records[entity.index].archetype != nullptr;
+  }
+
+  /**
+   * @brief add component to a live entity, replaces the value when the entity already has it
+   */
+  template <ComponentType T, typename... Args>
+  T& AddComponent(Entity entity, Args&&... args)
+  {
+    return *new (EmplaceComponent(entity, GetComponentId<T>())) T(std::forward<Args>(args)...);
+  }
+
+  template <ComponentType T>
+  void RemoveComponent(Entity entity)
+  {
+    RemoveComponent(entity, GetComponentId<T>());
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] bool HasComponent(Entity entity) const
+  {
+    return IsAlive(entity) && m_Records[entity.index].archetype->Has(GetComponentId<T>());
+  }
+
+  /**
+   * @brief component of entity, null when the entity is not alive or does not have it
+   */
+  template <ComponentType T>
+  [[nodiscard]] T* TryGetComponent(Entity entity)
+  {
+    return static_cast<T*>(FindComponent(entity, GetComponentId<T>()));
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] const T* TryGetComponent(Entity entity) const
+  {
+    return static_cast<const T*>(FindComponent(entity, GetComponentId<T>()));
+  }
+
+  /**
+   * @brief component of entity, entity must be alive and have it
+   */
+  template <ComponentType T>
+  [[nodiscard]] T& GetComponent(Entity entity)
+  {
+    return *TryGetComponent<T>(entity);
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] const T& GetComponent(Entity entity) const
+  {
+    return *TryGetComponent<T>(entity);
+  }
+
+  /**
+   * @brief query every entity that has all of Ts, see SceneView
+   */
+  template <typename... Ts>
+    requires(sizeof...(Ts) > 0)
+  [[nodiscard]] SceneView<Ts...> View()
+  {
+    return SceneView<Ts...>{FindArchetypes(GetComponentMask<std::remove_const_t<Ts>...>())};
+  }
+
+  /**
+   * @brief read only query of a const scene, every component is handed out as const
+   */
+  template <typename... Ts>
+    requires(sizeof...(Ts) > 0)
+  [[nodiscard]] SceneView<const Ts...> View() const
+  {
+    return SceneView<const Ts...>{FindArchetypes(GetComponentMask<std::remove_const_t<Ts>...>())};
+  }
+
+  [[nodiscard]] u32 GetEntityCount() const
+  {
+    return static_cast<u32>(m_Records.size() - m_FreeIndices.size());
+  }
+
+  [[nodiscard]] u32 GetArchetypeCount() const
+  {
+    return static_cast<u32>(m_ArchetypeList.size());
+  }
+
+  /**
+   * @brief parent/child transforms of the scene, updated by the engine once per frame after the fixed ticks
+   */
+  [[nodiscard]] TransformGraph& GetTransformGraph()
+  {
+    return m_Transforms;
+  }
+
+private:
+  friend class CommandBuffer;
+
+  struct EntityRecord
+  {
+    u32               generation{0};
+    Archetype*        archetype{nullptr}; // null while the slot is free
+    ArchetypeLocation location;
+  };
+
+  Entity     AllocateEntity();
+  Archetype* GetOrCreateArchetype(ComponentMask mask);
+
+  // non empty archetypes that have every component of mask
+  [[nodiscard]] std::vector<Archetype*> FindArchetypes(ComponentMask mask) const
+  {
+    std::vector<Archetype*> matches;
+    for (Archetype* archetype : m_ArchetypeList)
+    {
+      if ((archetype->GetMask() & mask) == mask && archetype->GetEntityCount() != 0)
+      {
+        matches.push_back(archetype);
+      }
+    }
+    return matches;
+  }
+
+  /**
+   * @brief move entity with its shared components to target, components target lacks are destroyed
+   */
+  void MoveEntity(Entity entity, Archetype* target);
+
+  /**
+   * @brief storage for component id of entity, uninitialized, an existing value is destroyed first
+   * throws std::invalid_argument when the entity is not alive
+   */
+  [[nodiscard]] void* EmplaceComponent(Entity entity, ComponentId id);
+  void                RemoveComponent(Entity entity, ComponentId id);
+  [[nodiscard]] void* FindComponent(Entity entity, ComponentId id) const;
+
 private:
-  std::vector<Entity*> m_Entities;
-  std::vector<System*> m_Systems;
+  std::vector<EntityRecord> m_Records;
+  std::vector<u32>          m_FreeIndices;
+
+  // list keeps creation order, views visit archetypes in the same order every run
+  std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_Archetypes;
+  std::vector<Archetype*>                                       m_ArchetypeList;
+  Archetype*                                                    m_EmptyArchetype{nullptr};
+
+  TransformGraph m_Transforms;
 };
+
+} // namespace four
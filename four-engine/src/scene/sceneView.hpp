@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "scene/archetype.hpp"
+
+#include <span>
+
+namespace four
+{
+
+/**
+ * @brief Typed query over every archetype that has all of Ts
+ * iteration walks archetype chunks and hands out component columns as contiguous arrays, no lookup per entity.
+ * const components are read only. the scene must not change structurally while iterating, record changes in a
+ * CommandBuffer and play it back afterwards.
+ */
+template <typename... Ts>
+class SceneView
+{
+public:
+  explicit SceneView(std::vector<Archetype*> archetypes) : m_Archetypes{std::move(archetypes)}
+  {
+  }
+
+  /**
+   * @brief call function for every entity, as function(Ts&...) or function(Entity, Ts&...)
+   */
+  template <typename Function>
+  void Each(Function&& function) const
+  {
+    EachChunk(
+      [&function](std::span<const Entity> entities, std::span<Ts>... columns)
+      {
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+          if constexpr (std::is_invocable_v<Function&, Entity, Ts&...>)
+          {
+            function(entities[i], columns[i]...);
+          }
+          else
+          {
+            function(columns[i]...);
+          }
+        }
+      });
+  }
+
+  /**
+   * @brief call function once per chunk with its entities and component columns, for batch and SIMD kernels
+   */
+  template <typename Function>
+  void EachChunk(Function&& function) const
+  {
+    for (Archetype* archetype : m_Archetypes)
+    {
+      for (u32 chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+      {
+        const u32 rows = archetype->GetRowCount(chunk);
+        function(std::span<const Entity>(archetype->GetEntities(chunk), rows),
+                 std::span<Ts>(archetype->template GetColumn<Ts>(chunk), rows)...);
+      }
+    }
+  }
+
+  [[nodiscard]] u32 Count() const
+  {
+    u32 count = 0;
+    for (const Archetype* archetype : m_Archetypes)
+    {
+      count += archetype->GetEntityCount();
+    }
+    return count;
+  }
+
+  [[nodiscard]] const std::vector<Archetype*>& GetArchetypes() const
+  {
+    return m_Archetypes;
+  }
+
+private:
+  std::vector<Archetype*> m_Archetypes;
+};
+
+} // namespace four
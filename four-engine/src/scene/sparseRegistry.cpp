@@ -0,0 +1,125 @@
+#include "four-pch.hpp"
+
+#include "scene/sparseRegistry.hpp"
+
+namespace four
+{
+
+//===============================================================================
+SparseRegistry::SparseRegistry() = default;
+
+//===============================================================================
+SparseRegistry::~SparseRegistry() = default;
+
+//===============================================================================
+Entity SparseRegistry::CreateEntity()
+{
+  if (!m_FreeIndices.empty())
+  {
+    const u32 index = m_FreeIndices.back();
+    m_FreeIndices.pop_back();
+    return {.index = index, .generation = m_Generations[index]};
+  }
+
+  m_Generations.push_back(0);
+  return {.index = static_cast<u32>(m_Generations.size() - 1), .generation = 0};
+}
+
+//===============================================================================
+void SparseRegistry::DestroyEntity(Entity entity)
+{
+  if (!IsAlive(entity))
+  {
+    return;
+  }
+
+  for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; ++id)
+  {
+    if (m_Pools[id] && m_Pools[id]->Contains(entity))
+    {
+      OnComponentRemoving(entity, id);
+      m_Pools[id]->Erase(entity);
+    }
+  }
+
+  ++m_Generations[entity.index];
+  m_FreeIndices.push_back(entity.index);
+}
+
+//===============================================================================
+const SparseGroupData& SparseRegistry::GetOrCreateGroup(ComponentMask owned, std::vector<SparseSet*> pools)
+{
+  for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; ++id)
+  {
+    if ((owned & (ComponentMask{1} << id)) == 0 || m_GroupOfComponent[id] == nullptr)
+    {
+      continue;
+    }
+    if (m_GroupOfComponent[id]->owned == owned)
+    {
+      return *m_GroupOfComponent[id];
+    }
+    LOG_CORE_ERROR("component {} is already owned by another group", id);
+    throw std::logic_error("component pool owned by two groups");
+  }
+
+  auto& group = *m_Groups.emplace_back(std::make_unique<SparseGroupData>(owned, std::move(pools)));
+  for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; ++id)
+  {
+    if ((owned & (ComponentMask{1} << id)) != 0)
+    {
+      m_GroupOfComponent[id] = &group;
+    }
+  }
+
+  // gather entities that already have every owned component at the front of each pool
+  const auto smallest = std::ranges::min_element(group.pools, {}, &SparseSet::Size);
+  for (const Entity entity : std::vector<Entity>((*smallest)->GetEntities().begin(), (*smallest)->GetEntities().end()))
+  {
+    if (std::ranges::all_of(group.pools, [entity](const SparseSet* pool) { return pool->Contains(entity); }))
+    {
+      for (SparseSet* pool : group.pools)
+      {
+        pool->Swap(pool->GetPosition(entity), group.size);
+      }
+      ++group.size;
+    }
+  }
+  return group;
+}
+
+//===============================================================================
+void SparseRegistry::OnComponentAdded(Entity entity, ComponentId id)
+{
+  SparseGroupData* group = m_GroupOfComponent[id];
+  if (group == nullptr ||
+      !std::ranges::all_of(group->pools, [entity](const SparseSet* pool) { return pool->Contains(entity); }))
+  {
+    return;
+  }
+
+  for (SparseSet* pool : group->pools)
+  {
+    pool->Swap(pool->GetPosition(entity), group->size);
+  }
+  ++group->size;
+}
+
+//===============================================================================
+void SparseRegistry::OnComponentRemoving(Entity entity, ComponentId id)
+{
+  SparseGroupData* group = m_GroupOfComponent[id];
+  if (group == nullptr || m_Pools[id]->GetPosition(entity) >= group->size)
+  {
+    return;
+  }
+
+  // last member takes the place of the leaving entity, the group stays packed
+  --group->size;
+  for (SparseSet* pool : group->pools)
+  {
+    pool->Swap(pool->GetPosition(entity), group->size);
+  }
+}
+
+} // namespace four
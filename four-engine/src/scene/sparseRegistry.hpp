@@ -0,0 +1,246 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "component/component.hpp"
+#include "scene/sparseSet.hpp"
+
+namespace four
+{
+
+/**
+ * @brief entities of the pools of an owning group, every owned pool holds them first and in the same order
+ */
+struct SparseGroupData
+{
+  ComponentMask           owned{0};
+  std::vector<SparseSet*> pools;
+  u32                     size{0}; // leading dense positions that belong to the group
+};
+
+/**
+ * @brief Entities that have every owned component, iterated in lockstep over the packed pools
+ * handle into the registry, stays valid as long as the registry
+ */
+template <typename... Ts>
+class SparseGroup
+{
+public:
+  SparseGroup(const SparseGroupData& data, SparsePool<Ts>&... pools) : m_Data{&data}, m_Pools{&pools...}
+  {
+  }
+
+  [[nodiscard]] u32 Size() const
+  {
+    return m_Data->size;
+  }
+
+  /**
+   * @brief call function for every entity of the group, as function(Ts&...) or function(Entity, Ts&...)
+   * position i of every owned pool is the same entity, the loop has no lookup and no branch
+   */
+  template <typename Function>
+  void Each(Function&& function) const
+  {
+    const u32     size     = m_Data->size;
+    const Entity* entities = std::get<0>(m_Pools)->GetEntities().data();
+    std::apply(
+      [&](auto*... pools)
+      {
+        const auto columns = std::make_tuple(pools->GetComponents().data()...);
+        for (u32 i = 0; i < size; ++i)
+        {
+          std::apply(
+            [&](auto*... components)
+            {
+              if constexpr (std::is_invocable_v<Function&, Entity, Ts&...>)
+              {
+                function(entities[i], components[i]...);
+              }
+              else
+              {
+                function(components[i]...);
+              }
+            },
+            columns);
+        }
+      },
+      m_Pools);
+  }
+
+  /**
+   * @brief packed components of the group, one span per owned type, all of Size() elements
+   */
+  template <typename T>
+  [[nodiscard]] std::span<T> GetComponents() const
+  {
+    return std::get<SparsePool<T>*>(m_Pools)->GetComponents().first(m_Data->size);
+  }
+
+private:
+  const SparseGroupData*         m_Data;
+  std::tuple<SparsePool<Ts>*...> m_Pools;
+};
+
+/**
+ * @brief Sparse set based entity component store
+ * alternative to Scene for components that are added and removed all the time: each component type has its own
+ * SparsePool, so adding or removing a component touches only that pool and never moves the other components of the
+ * entity. joint iteration of hot component sets goes through owning groups, which keep the owned pools sorted so
+ * the group members come first and line up.
+ * a pool can be owned by one group at most. not thread safe.
+ */
+class FOUR_ENGINE_API SparseRegistry
+{
+public:
+  SparseRegistry();
+  ~SparseRegistry();
+
+  SparseRegistry(const SparseRegistry&)            = delete;
+  SparseRegistry(SparseRegistry&&)                 = delete;
+  SparseRegistry& operator=(const SparseRegistry&) = delete;
+  SparseRegistry& operator=(SparseRegistry&&)      = delete;
+
+  Entity CreateEntity();
+
+  /**
+   * @brief remove every component of entity and free its slot, stale handles are ignored
+   */
+  void DestroyEntity(Entity entity);
+
+  [[nodiscard]] bool IsAlive(Entity entity) const
+  {
+    return entity.index < m_Generations.size() && m_Generations[entity.index] == entity.generation;
+  }
+
+  /**
+   * @brief add component to a live entity, replaces the value when the entity already has it
+   */
+  template <ComponentType T, typename... Args>
+  T& AddComponent(Entity entity, Args&&... args)
+  {
+    SparsePool<T>& pool = GetPool<T>();
+    if (T* component = pool.TryGet(entity))
+    {
+      *component = T(std::forward<Args>(args)...);
+      return *component;
+    }
+
+    pool.Emplace(entity, std::forward<Args>(args)...);
+    OnComponentAdded(entity, GetComponentId<T>());
+    return pool.Get(entity);
+  }
+
+  template <ComponentType T>
+  void RemoveComponent(Entity entity)
+  {
+    SparsePool<T>& pool = GetPool<T>();
+    if (pool.Contains(entity))
+    {
+      OnComponentRemoving(entity, GetComponentId<T>());
+      pool.Erase(entity);
+    }
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] bool HasComponent(Entity entity) const
+  {
+    const SparseSet* pool = FindPool(GetComponentId<T>());
+    return pool != nullptr && pool->Contains(entity);
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] T* TryGetComponent(Entity entity)
+  {
+    return GetPool<T>().TryGet(entity);
+  }
+
+  template <ComponentType T>
+  [[nodiscard]] T& GetComponent(Entity entity)
+  {
+    return GetPool<T>().Get(entity);
+  }
+
+  /**
+   * @brief call function for every entity that has all of Ts, as function(Entity, Ts&...)
+   * walks the smallest pool and looks the others up, use a group for sets iterated every frame
+   */
+  template <ComponentType... Ts, typename Function>
+  void Each(Function&& function)
+  {
+    std::tuple<SparsePool<Ts>&...> pools{GetPool<Ts>()...};
+    const SparseSet*               smallest = nullptr;
+    std::apply(
+      [&smallest](auto&... pool)
+      { ((smallest = smallest == nullptr || pool.Size() < smallest->Size() ? &pool : smallest), ...); },
+      pools);
+
+    // walk backwards, function may remove the component of the current entity from the pool being walked
+    const std::span<const Entity> entities = smallest->GetEntities();
+    for (u32 i = static_cast<u32>(entities.size()); i-- > 0;)
+    {
+      const Entity entity = entities[i];
+      if ((std::get<SparsePool<Ts>&>(pools).Contains(entity) && ...))
+      {
+        function(entity, std::get<SparsePool<Ts>&>(pools).Get(entity)...);
+      }
+    }
+  }
+
+  /**
+   * @brief owning group of Ts, created and sorted on first use and kept up to date by every add and remove
+   * throws std::logic_error when one of the pools is already owned by another group
+   */
+  template <ComponentType... Ts>
+    requires(sizeof...(Ts) > 1)
+  [[nodiscard]] SparseGroup<Ts...> Group()
+  {
+    const SparseGroupData& data = GetOrCreateGroup(GetComponentMask<Ts...>(), {&GetPool<Ts>()...});
+    return SparseGroup<Ts...>{data, GetPool<Ts>()...};
+  }
+
+  [[nodiscard]] u32 GetEntityCount() const
+  {
+    return static_cast<u32>(m_Generations.size() - m_FreeIndices.size());
+  }
+
+private:
+  template <ComponentType T>
+  [[nodiscard]] SparsePool<T>& GetPool()
+  {
+    const ComponentId id = GetComponentId<T>();
+    if (!m_Pools[id])
+    {
+      m_Pools[id] = std::make_unique<SparsePool<T>>();
+    }
+    return static_cast<SparsePool<T>&>(*m_Pools[id]);
+  }
+
+  [[nodiscard]] const SparseSet* FindPool(ComponentId id) const
+  {
+    return m_Pools[id].get();
+  }
+
+  const SparseGroupData& GetOrCreateGroup(ComponentMask owned, std::vector<SparseSet*> pools);
+
+  /**
+   * @brief entity just got component id, joins the owning group when it now has every owned component
+   */
+  void OnComponentAdded(Entity entity, ComponentId id);
+
+  /**
+   * @brief entity is about to lose component id, leaves the owning group first
+   */
+  void OnComponentRemoving(Entity entity, ComponentId id);
+
+private:
+  std::array<std::unique_ptr<SparseSet>, ECS_MAX_COMPONENTS> m_Pools;
+
+  std::vector<std::unique_ptr<SparseGroupData>>    m_Groups;
+  std::array<SparseGroupData*, ECS_MAX_COMPONENTS> m_GroupOfComponent{}; // owning group of each pool, may be null
+
+  std::vector<u32> m_Generations; // [entity index], bumped when the entity is destroyed
+  std::vector<u32> m_FreeIndices;
+};
+
+} // namespace four
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "entity/entity.hpp"
+
+#include <span>
+
+namespace four
+{
+
+constexpr u32 SPARSE_PAGE_SIZE = 4096; // sparse entries per page, pages are only allocated for used index ranges
+
+/**
+ * @brief Set of entities with O(1) insert, erase and lookup
+ * the sparse array maps entity index to a position in the packed dense array, the dense array holds the entities
+ * without holes. erasing moves the last entity into the hole, so iteration order is not stable.
+ * dense positions can be swapped, owning groups use it to keep the entities of several sets in the same order.
+ */
+class FOUR_ENGINE_API SparseSet
+{
+public:
+  static constexpr u32 NoPosition = std::numeric_limits<u32>::max();
+
+  SparseSet()          = default;
+  virtual ~SparseSet() = default;
+
+  SparseSet(const SparseSet&)            = delete;
+  SparseSet(SparseSet&&)                 = delete;
+  SparseSet& operator=(const SparseSet&) = delete;
+  SparseSet& operator=(SparseSet&&)      = delete;
+
+  [[nodiscard]] bool Contains(Entity entity) const
+  {
+    const u32 position = Find(entity.index);
+    return position != NoPosition && m_Dense[position] == entity;
+  }
+
+  /**
+   * @brief dense position of entity, NoPosition when not in the set
+   */
+  [[nodiscard]] u32 GetPosition(Entity entity) const
+  {
+    const u32 position = Find(entity.index);
+    return position != NoPosition && m_Dense[position] == entity ? position : NoPosition;
+  }
+
+  [[nodiscard]] std::span<const Entity> GetEntities() const
+  {
+    return m_Dense;
+  }
+
+  [[nodiscard]] u32 Size() const
+  {
+    return static_cast<u32>(m_Dense.size());
+  }
+
+  /**
+   * @brief swap two dense positions, with their components
+   */
+  virtual void Swap(u32 first, u32 second)
+  {
+    std::swap(m_Dense[first], m_Dense[second]);
+    SetPosition(m_Dense[first].index, first);
+    SetPosition(m_Dense[second].index, second);
+  }
+
+  /**
+   * @brief remove entity with its component, entity must be in the set
+   */
+  virtual void Erase(Entity entity)
+  {
+    const u32 position = GetPosition(entity);
+    const u32 last     = Size() - 1;
+    if (position != last)
+    {
+      Swap(position, last);
+    }
+    SetPosition(entity.index, NoPosition);
+    m_Dense.pop_back();
+  }
+
+protected:
+  /**
+   * @brief append entity, must not be in the set
+   *
+   * @return dense position of entity
+   */
+  u32 Insert(Entity entity)
+  {
+    const u32 position = Size();
+    m_Dense.push_back(entity);
+    SetPosition(entity.index, position);
+    return position;
+  }
+
+private:
+  using Page = std::array<u32, SPARSE_PAGE_SIZE>;
+
+  [[nodiscard]] u32 Find(u32 index) const
+  {
+    const u32 page = index / SPARSE_PAGE_SIZE;
+    return page < m_Sparse.size() && m_Sparse[page] ? (*m_Sparse[page])[index % SPARSE_PAGE_SIZE] : NoPosition;
+  }
+
+  void SetPosition(u32 index, u32 position)
+  {
+    const u32 page = index / SPARSE_PAGE_SIZE;
+    if (page >= m_Sparse.size())
+    {
+      m_Sparse.resize(page + 1);
+    }
+    if (!m_Sparse[page])
+    {
+      m_Sparse[page] = std::make_unique<Page>();
+      m_Sparse[page]->fill(NoPosition);
+    }
+    (*m_Sparse[page])[index % SPARSE_PAGE_SIZE] = position;
+  }
+
+private:
+  std::vector<std::unique_ptr<Page>> m_Sparse; // [entity index / page size][entity index % page size]
+  std::vector<Entity>                m_Dense;
+};
+
+/**
+ * @brief Sparse set with one component per entity, components packed in the same order as the entities
+ */
+template <typename T>
+class SparsePool final : public SparseSet
+{
+public:
+  template <typename... Args>
+  T& Emplace(Entity entity, Args&&... args)
+  {
+    Insert(entity);
+    return m_Components.emplace_back(std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]] T& Get(Entity entity)
+  {
+    return m_Components[GetPosition(entity)];
+  }
+
+  [[nodiscard]] const T& Get(Entity entity) const
+  {
+    return m_Components[GetPosition(entity)];
+  }
+
+  [[nodiscard]] T* TryGet(Entity entity)
+  {
+    const u32 position = GetPosition(entity);
+    return position != NoPosition ? &m_Components[position] : nullptr;
+  }
+
+  [[nodiscard]] std::span<T> GetComponents()
+  {
+    return m_Components;
+  }
+
+  void Swap(u32 first, u32 second) final
+  {
+    SparseSet::Swap(first, second);
+    std::swap(m_Components[first], m_Components[second]);
+  }
+
+  void Erase(Entity entity) final
+  {
+    SparseSet::Erase(entity);
+    m_Components.pop_back();
+  }
+
+private:
+  std::vector<T> m_Components;
+};
+
+} // namespace four
@@ -0,0 +1,323 @@
+#include "four-pch.hpp"
+
+#include "scene/transformGraph.hpp"
+
+#include "core/jobSystem.hpp"
+#include "core/profiler.hpp"
+
+#include <atomic>
+#include <cmath>
+
+namespace four
+{
+
+//===============================================================================
+u32 TransformGraph::GetSlot(TransformNode node) const
+{
+  if (!IsAlive(node))
+  {
+    throw std::invalid_argument("transform node is not alive");
+  }
+  return node.index;
+}
+
+//===============================================================================
+TransformNode TransformGraph::CreateNode(TransformNode parent, const LocalTransform& local)
+{
+  const u32 parentSlot = parent.IsNull() ? NoParent : GetSlot(parent);
+
+  u32 slot = 0;
+  if (m_FreeSlots.empty())
+  {
+    slot = static_cast<u32>(m_Slots.size());
+    m_Slots.emplace_back();
+  }
+  else
+  {
+    slot = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+  }
+
+  // appended out of order, the next Update moves it into its level
+  Slot& record = m_Slots[slot];
+  record.dense = static_cast<u32>(m_Local.size());
+  record.alive = true;
+  m_Parent.push_back(parentSlot == NoParent ? NoParent : m_Slots[parentSlot].dense);
+  m_Level.push_back(0);
+  m_Local.push_back(local);
+  m_World.emplace_back();
+  m_Dirty.push_back(1);
+  m_Changed.push_back(0);
+  Link(slot, parentSlot);
+
+  m_AnyDirty    = true;
+  m_LayoutDirty = true;
+  return {.index = slot, .generation = record.generation};
+}
+
+//===============================================================================
+void TransformGraph::DestroyNode(TransformNode node)
+{
+  if (!IsAlive(node))
+  {
+    return;
+  }
+
+  // the dense entries stay behind until Relayout drops everything that is no longer linked
+  Unlink(node.index);
+  std::vector<u32> stack{node.index};
+  while (!stack.empty())
+  {
+    const u32 slot = stack.back();
+    stack.pop_back();
+    for (u32 child = m_Slots[slot].firstChild; child != NoParent; child = m_Slots[child].nextSibling)
+    {
+      stack.push_back(child);
+    }
+    m_Slots[slot] = {.generation = m_Slots[slot].generation + 1};
+    m_FreeSlots.push_back(slot);
+  }
+  m_LayoutDirty = true;
+}
+
+//===============================================================================
+void TransformGraph::SetParent(TransformNode node, TransformNode parent)
+{
+  const u32 slot       = GetSlot(node);
+  const u32 parentSlot = parent.IsNull() ? NoParent : GetSlot(parent);
+  for (u32 ancestor = parentSlot; ancestor != NoParent; ancestor = m_Slots[ancestor].parent)
+  {
+    if (ancestor == slot)
+    {
+      throw std::invalid_argument("transform node can not be moved into its own subtree");
+    }
+  }
+
+  Unlink(slot);
+  Link(slot, parentSlot);
+  m_Parent[m_Slots[slot].dense] = parentSlot == NoParent ? NoParent : m_Slots[parentSlot].dense;
+  MarkDirty(m_Slots[slot].dense);
+  m_LayoutDirty = true;
+}
+
+//===============================================================================
+TransformNode TransformGraph::GetParent(TransformNode node) const
+{
+  const u32 parent = m_Slots[GetSlot(node)].parent;
+  return parent == NoParent ? NullTransformNode : TransformNode{.index = parent, .generation = m_Slots[parent].generation};
+}
+
+//===============================================================================
+void TransformGraph::SetLocal(TransformNode node, const LocalTransform& local)
+{
+  const u32 dense = m_Slots[GetSlot(node)].dense;
+  m_Local[dense]  = local;
+  MarkDirty(dense);
+}
+
+//===============================================================================
+void TransformGraph::Link(u32 slot, u32 parent)
+{
+  u32& head                 = parent == NoParent ? m_FirstRoot : m_Slots[parent].firstChild;
+  m_Slots[slot].parent      = parent;
+  m_Slots[slot].nextSibling = head;
+  head                      = slot;
+}
+
+//===============================================================================
+void TransformGraph::Unlink(u32 slot)
+{
+  const u32 parent = m_Slots[slot].parent;
+  u32*      link   = parent == NoParent ? &m_FirstRoot : &m_Slots[parent].firstChild;
+  while (*link != slot)
+  {
+    link = &m_Slots[*link].nextSibling;
+  }
+  *link                     = m_Slots[slot].nextSibling;
+  m_Slots[slot].parent      = NoParent;
+  m_Slots[slot].nextSibling = NoParent;
+}
+
+//===============================================================================
+void TransformGraph::MarkDirty(u32 dense)
+{
+  m_Dirty[dense] = 1;
+  if (m_LayoutDirty)
+  {
+    // levels are unknown until Relayout, which finds the dirty range itself
+    m_AnyDirty = true;
+    return;
+  }
+
+  const u32 level   = m_Level[dense];
+  m_FirstDirtyLevel = m_AnyDirty ? std::min(m_FirstDirtyLevel, level) : level;
+  m_LastDirtyLevel  = m_AnyDirty ? std::max(m_LastDirtyLevel, level) : level;
+  m_AnyDirty        = true;
+}
+
+//===============================================================================
+void TransformGraph::Relayout()
+{
+  FOUR_PROFILE_FUNCTION();
+
+  // breadth first over the links, slots that were destroyed are not reachable any more
+  std::vector<u32> order;
+  order.reserve(GetNodeCount());
+  for (u32 root = m_FirstRoot; root != NoParent; root = m_Slots[root].nextSibling)
+  {
+    order.push_back(root);
+  }
+
+  m_LevelBegin.assign(1, 0);
+  for (u32 levelStart = 0; levelStart < order.size();)
+  {
+    const auto levelEnd = static_cast<u32>(order.size());
+    m_LevelBegin.push_back(levelEnd);
+    for (u32 i = levelStart; i < levelEnd; ++i)
+    {
+      for (u32 child = m_Slots[order[i]].firstChild; child != NoParent; child = m_Slots[child].nextSibling)
+      {
+        order.push_back(child);
+      }
+    }
+    levelStart = levelEnd;
+  }
+
+  const auto                  count = static_cast<u32>(order.size());
+  std::vector<u32>            parents(count);
+  std::vector<u32>            levels(count);
+  std::vector<LocalTransform> locals(count);
+  std::vector<WorldTransform> worlds(count);
+  std::vector<u8>             dirty(count);
+  m_AnyDirty = false;
+  for (u32 level = 0; level + 1 < m_LevelBegin.size(); ++level)
+  {
+    for (u32 i = m_LevelBegin[level]; i < m_LevelBegin[level + 1]; ++i)
+    {
+      Slot&     slot = m_Slots[order[i]];
+      const u32 old  = slot.dense;
+      slot.dense     = i;
+      parents[i]     = slot.parent == NoParent ? NoParent : m_Slots[slot.parent].dense; // parents moved first
+      levels[i]      = level;
+      locals[i]      = m_Local[old];
+      worlds[i]      = m_World[old];
+      dirty[i]       = m_Dirty[old];
+      if (dirty[i] != 0)
+      {
+        m_FirstDirtyLevel = m_AnyDirty ? m_FirstDirtyLevel : level;
+        m_LastDirtyLevel  = level;
+        m_AnyDirty        = true;
+      }
+    }
+  }
+
+  m_Parent = std::move(parents);
+  m_Level  = std::move(levels);
+  m_Local  = std::move(locals);
+  m_World  = std::move(worlds);
+  m_Dirty  = std::move(dirty);
+  m_Changed.assign(count, 0);
+  m_ChangedBegin = count;
+  m_LayoutDirty  = false;
+}
+
+//===============================================================================
+u32 TransformGraph::UpdateRange(u32 begin, u32 end)
+{
+  u32 updated = 0;
+  for (u32 i = begin; i < end; ++i)
+  {
+    const u32 parent  = m_Parent[i];
+    const u8  changed = static_cast<u8>(m_Dirty[i] | (parent == NoParent ? u8{0} : m_Changed[parent]));
+    m_Changed[i]      = changed;
+    if (changed == 0)
+    {
+      continue;
+    }
+    m_Dirty[i] = 0;
+    ++updated;
+
+    // local matrix is rotation * scale, then the parent applies on top
+    const LocalTransform& local = m_Local[i];
+    const f32             sin   = std::sin(local.rotation);
+    const f32             cos   = std::cos(local.rotation);
+    const glm::vec2       c0{cos * local.scale.x, sin * local.scale.x};
+    const glm::vec2       c1{-sin * local.scale.y, cos * local.scale.y};
+    if (parent == NoParent)
+    {
+      m_World[i] = {.c0 = c0, .c1 = c1, .translation = local.position};
+      continue;
+    }
+
+    const WorldTransform& world = m_World[parent];
+    m_World[i].c0               = {world.c0.x * c0.x + world.c1.x * c0.y, world.c0.y * c0.x + world.c1.y * c0.y};
+    m_World[i].c1               = {world.c0.x * c1.x + world.c1.x * c1.y, world.c0.y * c1.x + world.c1.y * c1.y};
+    m_World[i].translation      = world.Apply(local.position);
+  }
+  return updated;
+}
+
+//===============================================================================
+template <typename UpdateLevel>
+void TransformGraph::UpdateLevels(UpdateLevel&& updateLevel)
+{
+  if (m_LayoutDirty)
+  {
+    Relayout();
+  }
+
+  // flags of the last Update, everything before m_ChangedBegin is already zero
+  std::fill(m_Changed.begin() + m_ChangedBegin, m_Changed.end(), u8{0});
+  m_ChangedBegin = static_cast<u32>(m_Changed.size());
+  m_UpdatedCount = 0;
+  if (!m_AnyDirty)
+  {
+    return;
+  }
+
+  m_ChangedBegin = m_LevelBegin[m_FirstDirtyLevel];
+  for (u32 level = m_FirstDirtyLevel; level < GetLevelCount(); ++level)
+  {
+    const u32 updated = updateLevel(m_LevelBegin[level], m_LevelBegin[level + 1]);
+    m_UpdatedCount += updated;
+
+    // nothing below changes once a level past the last dirty one is unchanged
+    if (updated == 0 && level >= m_LastDirtyLevel)
+    {
+      break;
+    }
+  }
+  m_AnyDirty = false;
+}
+
+//===============================================================================
+void TransformGraph::Update()
+{
+  FOUR_PROFILE_FUNCTION();
+  UpdateLevels([this](u32 begin, u32 end) { return UpdateRange(begin, end); });
+}
+
+//===============================================================================
+void TransformGraph::Update(JobSystem& jobs)
+{
+  FOUR_PROFILE_FUNCTION();
+  UpdateLevels(
+    [this, &jobs](u32 begin, u32 end)
+    {
+      if (end - begin <= TRANSFORM_GRAPH_GRAIN)
+      {
+        return UpdateRange(begin, end);
+      }
+
+      // a level only reads the level before it, its chunks are independent
+      std::atomic<u32> updated{0};
+      jobs.ParallelFor(begin,
+                       end,
+                       TRANSFORM_GRAPH_GRAIN,
+                       [this, &updated](u32 chunkBegin, u32 chunkEnd)
+                       { updated.fetch_add(UpdateRange(chunkBegin, chunkEnd), std::memory_order_relaxed); });
+      return updated.load(std::memory_order_relaxed);
+    });
+}
+
+} // namespace four
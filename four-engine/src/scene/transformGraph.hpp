@@ -0,0 +1,209 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "glm/glm.hpp"
+
+namespace four
+{
+
+class JobSystem;
+
+constexpr u32 TRANSFORM_GRAPH_GRAIN = 1024; // nodes per job when a level is updated in parallel
+
+/**
+ * @brief Generational handle of a node of a TransformGraph, stays valid while the graph reorders its nodes
+ */
+struct TransformNode
+{
+  static constexpr u32 InvalidIndex = std::numeric_limits<u32>::max();
+
+  u32 index{InvalidIndex};
+  u32 generation{0};
+
+  [[nodiscard]] bool IsNull() const
+  {
+    return index == InvalidIndex;
+  }
+
+  bool operator==(const TransformNode&) const = default;
+};
+
+constexpr TransformNode NullTransformNode{};
+
+/**
+ * @brief transform of a node relative to its parent, applied as scale, then rotation, then translation
+ */
+struct LocalTransform
+{
+  glm::vec2 position{0.0F, 0.0F};
+  f32       rotation{0.0F}; // radians
+  glm::vec2 scale{1.0F, 1.0F};
+};
+
+/**
+ * @brief 2D affine world matrix, column major, x' = c0 * x + c1 * y + translation
+ */
+struct WorldTransform
+{
+  glm::vec2 c0{1.0F, 0.0F};
+  glm::vec2 c1{0.0F, 1.0F};
+  glm::vec2 translation{0.0F, 0.0F};
+
+  [[nodiscard]] glm::vec2 Apply(glm::vec2 point) const
+  {
+    return {c0.x * point.x + c1.x * point.y + translation.x, c0.y * point.x + c1.y * point.y + translation.y};
+  }
+};
+
+/**
+ * @brief Parent/child transform hierarchy stored breadth first
+ * nodes live in contiguous arrays ordered by depth, every level is one range and the children of a node are
+ * adjacent, so a level only reads world matrices of the level before it. changing the local transform of a node
+ * marks it dirty, Update recomputes the world matrices of dirty nodes and their descendants only and skips the
+ * levels above the first dirty one, a static scene costs nothing. levels are independent ranges and run in
+ * parallel on the job system when they are large enough.
+ * creating, destroying or reparenting nodes reorders the arrays on the next Update. not thread safe.
+ */
+class FOUR_ENGINE_API TransformGraph
+{
+public:
+  TransformGraph()  = default;
+  ~TransformGraph() = default;
+
+  TransformGraph(const TransformGraph&)            = delete;
+  TransformGraph(TransformGraph&&)                 = delete;
+  TransformGraph& operator=(const TransformGraph&) = delete;
+  TransformGraph& operator=(TransformGraph&&)      = delete;
+
+  /**
+   * @brief new node under parent, a root when parent is null
+   * throws std::invalid_argument when parent is not alive
+   */
+  TransformNode CreateNode(TransformNode parent = NullTransformNode, const LocalTransform& local = {});
+
+  /**
+   * @brief destroy node and its whole subtree, stale handles are ignored
+   */
+  void DestroyNode(TransformNode node);
+
+  /**
+   * @brief move node with its subtree under parent, a root when parent is null, keeps the local transform
+   * throws std::invalid_argument when a node is not alive or parent is inside the subtree of node
+   */
+  void SetParent(TransformNode node, TransformNode parent);
+
+  [[nodiscard]] TransformNode GetParent(TransformNode node) const;
+
+  [[nodiscard]] bool IsAlive(TransformNode node) const
+  {
+    return node.index < m_Slots.size() && m_Slots[node.index].generation == node.generation &&
+           m_Slots[node.index].alive;
+  }
+
+  void SetLocal(TransformNode node, const LocalTransform& local);
+
+  [[nodiscard]] const LocalTransform& GetLocal(TransformNode node) const
+  {
+    return m_Local[m_Slots[node.index].dense];
+  }
+
+  /**
+   * @brief world matrix as of the last Update
+   */
+  [[nodiscard]] const WorldTransform& GetWorld(TransformNode node) const
+  {
+    return m_World[m_Slots[node.index].dense];
+  }
+
+  /**
+   * @brief whether the last Update recomputed the world matrix of node, for uploading only what moved
+   */
+  [[nodiscard]] bool IsWorldChanged(TransformNode node) const
+  {
+    return m_Changed[m_Slots[node.index].dense] != 0;
+  }
+
+  /**
+   * @brief recompute world matrices of dirty nodes and their subtrees, level by level on the calling thread
+   */
+  void Update();
+
+  /**
+   * @brief same as Update, levels with more than TRANSFORM_GRAPH_GRAIN nodes are split over jobs
+   */
+  void Update(JobSystem& jobs);
+
+  [[nodiscard]] u32 GetNodeCount() const
+  {
+    return static_cast<u32>(m_Slots.size() - m_FreeSlots.size());
+  }
+
+  [[nodiscard]] u32 GetLevelCount() const
+  {
+    return m_LevelBegin.empty() ? 0 : static_cast<u32>(m_LevelBegin.size() - 1);
+  }
+
+  /**
+   * @brief world matrices recomputed by the last Update
+   */
+  [[nodiscard]] u32 GetUpdatedCount() const
+  {
+    return m_UpdatedCount;
+  }
+
+private:
+  static constexpr u32 NoParent = std::numeric_limits<u32>::max();
+
+  // tree links by slot, stable while the dense arrays are reordered
+  struct Slot
+  {
+    u32  generation{0};
+    u32  dense{0};
+    u32  parent{NoParent};
+    u32  firstChild{NoParent};
+    u32  nextSibling{NoParent};
+    bool alive{false};
+  };
+
+  [[nodiscard]] u32 GetSlot(TransformNode node) const; // throws std::invalid_argument when not alive
+  void              Link(u32 slot, u32 parent);
+  void              Unlink(u32 slot);
+  void              MarkDirty(u32 dense);
+
+  /**
+   * @brief sort the dense arrays breadth first, children after their parent in sibling order
+   */
+  void Relayout();
+
+  /**
+   * @brief walk the levels that may change, updateLevel(begin, end) returns the matrices it recomputed
+   */
+  template <typename UpdateLevel>
+  void UpdateLevels(UpdateLevel&& updateLevel);
+
+  u32 UpdateRange(u32 begin, u32 end);
+
+private:
+  std::vector<Slot> m_Slots;
+  std::vector<u32>  m_FreeSlots;
+  u32               m_FirstRoot{NoParent}; // roots are siblings of each other
+
+  // dense arrays, breadth first after Relayout, new nodes are appended until then
+  std::vector<u32>            m_Parent; // dense index of the parent, NoParent for roots
+  std::vector<u32>            m_Level;
+  std::vector<LocalTransform> m_Local;
+  std::vector<WorldTransform> m_World;
+  std::vector<u8>             m_Dirty;   // local transform changed since the last Update
+  std::vector<u8>             m_Changed; // world matrix recomputed by the last Update
+
+  std::vector<u32> m_LevelBegin;         // dense range of level l is [m_LevelBegin[l], m_LevelBegin[l + 1])
+  u32              m_FirstDirtyLevel{0}; // levels before it are clean
+  u32              m_LastDirtyLevel{0};  // levels after it only change below a changed parent
+  bool             m_AnyDirty{false};
+  bool             m_LayoutDirty{false}; // nodes were created, destroyed or reparented
+  u32              m_ChangedBegin{0};    // m_Changed is zero before this dense index
+  u32              m_UpdatedCount{0};
+};
+
+} // namespace four
@@ -1,8 +1,76 @@
 #pragma once
 
+#include "core/core.hpp"
+
+#include "component/component.hpp"
+
 namespace four
 {
-class System
+
+class Scene;
+class CommandBuffer;
+class JobSystem;
+
+/**
+ * @brief component types a system accesses, see System
+ */
+template <ComponentType... Ts>
+struct ComponentList
+{
+  [[nodiscard]] static ComponentMask GetMask()
+  {
+    return GetComponentMask<Ts...>();
+  }
+};
+
+/**
+ * @brief what a system gets to work with during one update
+ */
+struct SystemContext
+{
+  Scene&         scene;
+  CommandBuffer& commands; // structural changes, played back after every system of the update ran
+  JobSystem&     jobs;     // for ParallelFor inside the system
+  f32            deltaTime{0.0F};
+};
+
+/**
+ * @brief Base of scene systems
+ * a system declares at compile time which components it reads and writes, the scheduler runs systems whose
+ * accesses do not conflict at the same time:
+ *
+ *   class MovementSystem final : public System
+ *   {
+ *   public:
+ *     static constexpr std::string_view Name = "Movement";
+ *     using Reads                             = ComponentList<CLifeSpan>;
+ *     using Writes                            = ComponentList<CTransform>;
+ *     void Update(SystemContext& context) final;
+ *   };
+ *
+ * Update may only touch the declared components of the scene, everything else goes through the command buffer.
+ */
+class FOUR_ENGINE_API System
 {
 public:
+  System()          = default;
+  virtual ~System() = default;
+
+  System(const System&)            = delete;
+  System(System&&)                 = delete;
+  System& operator=(const System&) = delete;
+  System& operator=(System&&)      = delete;
+
+  virtual void Update(SystemContext& context) = 0;
 };
+
+template <typename T>
+concept SystemType = std::derived_from<T, System> && requires {
+  typename T::Reads;
+  typename T::Writes;
+  { T::Name } -> std::convertible_to<std::string_view>;
+  { T::Reads::GetMask() } -> std::same_as<ComponentMask>;
+  { T::Writes::GetMask() } -> std::same_as<ComponentMask>;
+};
+
+} // namespace four
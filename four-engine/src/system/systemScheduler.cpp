@@ -0,0 +1,206 @@
+#include "four-pch.hpp"
+
+#include "system/systemScheduler.hpp"
+
+#include <sstream>
+
+namespace four
+{
+
+namespace
+{
+constexpr f32 nsToMs = 1e-6F;
+
+// component ids of mask, "-" when empty
+std::string FormatMask(ComponentMask mask)
+{
+  std::string text;
+  for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; ++id)
+  {
+    if ((mask & (ComponentMask{1} << id)) != 0)
+    {
+      text += text.empty() ? std::format("{}", id) : std::format(",{}", id);
+    }
+  }
+  return text.empty() ? "-" : text;
+}
+} // namespace
+
+//===============================================================================
+bool SystemScheduler::SetEnabled(std::string_view name, bool enabled)
+{
+  for (auto& entry : m_Entries)
+  {
+    if (entry->name == name)
+    {
+      entry->enabled = enabled;
+      return true;
+    }
+  }
+  return false;
+}
+
+//===============================================================================
+bool SystemScheduler::Conflicts(const Entry& first, const Entry& second)
+{
+  return (first.writes & (second.reads | second.writes)) != 0 || (second.writes & first.reads) != 0;
+}
+
+//===============================================================================
+void SystemScheduler::BuildGraph()
+{
+  for (u32 i = 0; i < m_Entries.size(); ++i)
+  {
+    Entry& entry = *m_Entries[i];
+    entry.dependencies.clear();
+    entry.dependents.clear();
+    entry.level = 0;
+    if (!entry.enabled)
+    {
+      continue;
+    }
+
+    // depending on every earlier conflicting system keeps conflicting ones in registration order
+    for (u32 j = 0; j < i; ++j)
+    {
+      Entry& earlier = *m_Entries[j];
+      if (earlier.enabled && Conflicts(entry, earlier))
+      {
+        entry.dependencies.push_back(j);
+        earlier.dependents.push_back(i);
+        entry.level = std::max(entry.level, earlier.level + 1);
+      }
+    }
+    entry.pending.store(static_cast<u32>(entry.dependencies.size()), std::memory_order_relaxed);
+  }
+}
+
+//===============================================================================
+void SystemScheduler::Run(Scene& scene, JobSystem& jobs, f32 deltaTime)
+{
+  FOUR_PROFILE_SCOPE("Systems");
+
+  BuildGraph();
+  m_RunStart = Profiler::Now();
+
+  JobCounter counter;
+  for (u32 i = 0; i < m_Entries.size(); ++i)
+  {
+    if (m_Entries[i]->enabled && m_Entries[i]->dependencies.empty())
+    {
+      Submit(i, scene, jobs, deltaTime, counter);
+    }
+  }
+  jobs.Wait(counter);
+
+  for (auto& entry : m_Entries)
+  {
+    entry->commands.Playback(scene);
+  }
+}
+
+//===============================================================================
+void SystemScheduler::Submit(u32 index, Scene& scene, JobSystem& jobs, f32 deltaTime, JobCounter& counter)
+{
+  jobs.Submit(
+    [this, index, &scene, &jobs, deltaTime, &counter]
+    {
+      Entry& entry = *m_Entries[index];
+      entry.thread = jobs.GetWorkerIndex();
+      entry.start  = Profiler::Now();
+      {
+        const ProfileScope scope(entry.name);
+        SystemContext      context{.scene = scene, .commands = entry.commands, .jobs = jobs, .deltaTime = deltaTime};
+        entry.system->Update(context);
+      }
+      entry.end = Profiler::Now();
+      entry.totalMs += static_cast<f64>(entry.end - entry.start) * 1e-6;
+      ++entry.runCount;
+
+      // the last dependency to finish starts the dependent, still under counter so Run keeps waiting
+      for (const u32 dependent : entry.dependents)
+      {
+        if (m_Entries[dependent]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          Submit(dependent, scene, jobs, deltaTime, counter);
+        }
+      }
+    },
+    &counter);
+}
+
+//===============================================================================
+std::vector<SystemTiming> SystemScheduler::GetTimings() const
+{
+  std::vector<SystemTiming> timings;
+  for (const auto& entry : m_Entries)
+  {
+    if (!entry->enabled || entry->runCount == 0)
+    {
+      continue;
+    }
+    timings.push_back({.name       = entry->name,
+                       .level      = entry->level,
+                       .thread     = entry->thread,
+                       .startMs    = static_cast<f32>(entry->start - m_RunStart) * nsToMs,
+                       .durationMs = static_cast<f32>(entry->end - entry->start) * nsToMs,
+                       .averageMs  = static_cast<f32>(entry->totalMs / static_cast<f64>(entry->runCount))});
+  }
+  return timings;
+}
+
+//===============================================================================
+std::string SystemScheduler::DumpSchedule() const
+{
+  u32 levelCount = 0;
+  for (const auto& entry : m_Entries)
+  {
+    levelCount = entry->enabled ? std::max(levelCount, entry->level + 1) : levelCount;
+  }
+
+  std::ostringstream out;
+  out << std::format("system schedule, {} systems in {} levels\n", m_Entries.size(), levelCount);
+  for (u32 level = 0; level < levelCount; ++level)
+  {
+    out << std::format("level {}\n", level);
+    for (u32 i = 0; i < m_Entries.size(); ++i)
+    {
+      const Entry& entry = *m_Entries[i];
+      if (!entry.enabled || entry.level != level)
+      {
+        continue;
+      }
+
+      std::string after;
+      for (const u32 dependency : entry.dependencies)
+      {
+        after += std::format("{}{}", after.empty() ? "" : ",", m_Entries[dependency]->name);
+      }
+      out << std::format("  {:<24} reads {:<12} writes {:<12} after {:<24}",
+                         entry.name,
+                         FormatMask(entry.reads),
+                         FormatMask(entry.writes),
+                         after.empty() ? "-" : after);
+      if (entry.runCount != 0)
+      {
+        out << std::format(" thread {:>2} start {:7.3f} ms took {:7.3f} ms avg {:7.3f} ms",
+                           entry.thread,
+                           static_cast<f32>(entry.start - m_RunStart) * nsToMs,
+                           static_cast<f32>(entry.end - entry.start) * nsToMs,
+                           entry.totalMs / static_cast<f64>(entry.runCount));
+      }
+      out << '\n';
+    }
+  }
+
+  for (const auto& entry : m_Entries)
+  {
+    if (!entry->enabled)
+    {
+      out << std::format("disabled {}\n", entry->name);
+    }
+  }
+  return out.str();
+}
+
+} // namespace four
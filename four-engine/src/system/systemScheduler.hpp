@@ -0,0 +1,123 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "core/jobSystem.hpp"
+#include "core/profiler.hpp"
+#include "scene/commandBuffer.hpp"
+#include "system/system.hpp"
+
+#include <atomic>
+
+namespace four
+{
+
+/**
+ * @brief timings of one system in the last schedule that ran
+ */
+struct SystemTiming
+{
+  std::string_view name;
+  u32              level{0};        // longest chain of conflicting systems before this one
+  u32              thread{0};       // worker index that ran the system, 0 is the main thread
+  f32              startMs{0.0F};   // relative to the start of the run
+  f32              durationMs{0.0F};
+  f32              averageMs{0.0F}; // over every run since the system was added
+};
+
+/**
+ * @brief Runs scene systems in parallel along their component dependencies
+ * every run builds a DAG over the enabled systems: a system depends on each earlier registered system it conflicts
+ * with, two systems conflict when one writes a component the other reads or writes. systems without a path between
+ * them run at the same time on the job system, conflicting ones always run in registration order, so results do
+ * not depend on thread timing. each system records structural changes in its own command buffer, they are played
+ * back in registration order once every system finished.
+ */
+class FOUR_ENGINE_API SystemScheduler
+{
+public:
+  SystemScheduler()  = default;
+  ~SystemScheduler() = default;
+
+  SystemScheduler(const SystemScheduler&)            = delete;
+  SystemScheduler(SystemScheduler&&)                 = delete;
+  SystemScheduler& operator=(const SystemScheduler&) = delete;
+  SystemScheduler& operator=(SystemScheduler&&)      = delete;
+
+  /**
+   * @brief add system at the end of the registration order
+   */
+  template <SystemType T, typename... Args>
+  T& AddSystem(Args&&... args)
+  {
+    auto   system    = std::make_unique<T>(std::forward<Args>(args)...);
+    T&     reference = *system;
+    Entry& entry     = *m_Entries.emplace_back(std::make_unique<Entry>());
+    entry.system     = std::move(system);
+    entry.name       = T::Name;
+    entry.reads      = T::Reads::GetMask();
+    entry.writes     = T::Writes::GetMask();
+    return reference;
+  }
+
+  /**
+   * @brief disabled systems are left out of the graph from the next run
+   *
+   * @return false when no system has this name
+   */
+  bool SetEnabled(std::string_view name, bool enabled);
+
+  /**
+   * @brief run every enabled system once and play back their command buffers, returns when all finished
+   * call from a thread of jobs, usually the main thread
+   */
+  void Run(Scene& scene, JobSystem& jobs, f32 deltaTime);
+
+  [[nodiscard]] u32 GetSystemCount() const
+  {
+    return static_cast<u32>(m_Entries.size());
+  }
+
+  /**
+   * @brief timings of the enabled systems of the last run, in registration order
+   */
+  [[nodiscard]] std::vector<SystemTiming> GetTimings() const;
+
+  /**
+   * @brief readable schedule of the last run: levels, dependencies, accesses and timings
+   */
+  [[nodiscard]] std::string DumpSchedule() const;
+
+private:
+  struct Entry
+  {
+    std::unique_ptr<System> system;
+    std::string_view        name;
+    ComponentMask           reads{0};
+    ComponentMask           writes{0};
+    bool                    enabled{true};
+    CommandBuffer           commands;
+
+    // graph of the last run, over enabled entries
+    std::vector<u32> dependencies; // entry indices
+    std::vector<u32> dependents;
+    std::atomic<u32> pending{0};   // dependencies still running
+    u32              level{0};
+    u32              thread{0};
+    ProfileTime      start{0};
+    ProfileTime      end{0};
+    f64              totalMs{0.0};
+    u64              runCount{0};
+  };
+
+  [[nodiscard]] static bool Conflicts(const Entry& first, const Entry& second);
+
+  void BuildGraph();
+  void Submit(u32 index, Scene& scene, JobSystem& jobs, f32 deltaTime, JobCounter& counter);
+
+private:
+  std::vector<std::unique_ptr<Entry>> m_Entries;
+  ProfileTime                         m_RunStart{0};
+};
+
+} // namespace four
@@ -0,0 +1,20 @@
+#include "four-pch.hpp"
+
+#include "system/transformSystem.hpp"
+
+#include "core/transformKernels.hpp"
+#include "scene/scene.hpp"
+
+namespace four
+{
+
+//===============================================================================
+void TransformSystem::Update(SystemContext& context)
+{
+  const f32 deltaTime = context.deltaTime;
+  context.scene.View<CTransform>().EachChunk(
+    [deltaTime](std::span<const Entity> /*entities*/, std::span<CTransform> transforms)
+    { IntegrateTransforms(transforms, deltaTime); });
+}
+
+} // namespace four
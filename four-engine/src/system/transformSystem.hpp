@@ -0,0 +1,24 @@
+#pragma once
+
+#include "core/core.hpp"
+
+#include "component/transform.hpp"
+#include "system/system.hpp"
+
+namespace four
+{
+
+/**
+ * @brief Moves every CTransform by its velocity, one batch kernel call per archetype chunk
+ */
+class FOUR_ENGINE_API TransformSystem final : public System
+{
+public:
+  static constexpr std::string_view Name = "Transform";
+  using Reads                             = ComponentList<>;
+  using Writes                            = ComponentList<CTransform>;
+
+  void Update(SystemContext& context) final;
+};
+
+} // namespace four
@@ -3,6 +3,7 @@
 #include "four-pch.hpp"
 
 #include "window/glfw/glfwWindow.hpp"
+#include "core/profiler.hpp"
 
 #include "GLFW/glfw3.h"
 
@@ -54,9 +55,9 @@ void GlfwWindow::GlfwErrorsCallback(int32_t /*error*/, const char* descripton)
 void GlfwWindow::FrameBufferResizedCallback(GLFWwindow* window, int32_t width, int32_t height)
 {
   auto self                  = reinterpret_cast<GlfwWindow*>(glfwGetWindowUserPointer(window));
-  self->m_FrameBufferResized = true;
   self->m_Width              = static_cast<uint32_t>(width);
   self->m_Height             = static_cast<uint32_t>(height);
+  self->m_FrameBufferResized = true;
 }
 
 //----------------------------------------------------------------------------------------
@@ -114,13 +115,11 @@ void GlfwWindow::OnUpdateImpl()
   double deltaTime = m_CurrentTime - m_LastTime;
   if (deltaTime >= 1.0)
   {
-    int framerate{std::max(1, static_cast<int>(m_Frames / deltaTime))};
-    m_Title = std::to_string(framerate) + " FPS";
+    const ProfileStats stats = Profiler::Get().GetStats();
+    m_Title = std::format("{:.0f} FPS | frame p95 {:.2f} ms | gpu p95 {:.2f} ms", stats.fps, stats.frame.p95, stats.gpu.p95);
     glfwSetWindowTitle(m_Window, m_Title.data());
-    m_Frames   = -1;
     m_LastTime = m_CurrentTime;
   }
-  ++m_Frames;
   glfwPollEvents();
   static float mouseLastX{0.0F};
   static float mouseLastY{0.0F};
@@ -5,6 +5,8 @@
 #include "event/WindowEvent.hpp"
 #include "window/window.hpp"
 
+#include <atomic>
+
 struct GLFWwindow;
 
 
@@ -43,9 +45,9 @@ public:
   GlfwWindow(const GlfwWindow&) = delete;
 
   /**
-   * @brief Default Move Constructor
+   * @brief Deleted move Constructor, glfw user pointer refers to this object
    */
-  GlfwWindow(GlfwWindow&&) = default;
+  GlfwWindow(GlfwWindow&&) = delete;
 
   /**
    * @brief Deleted copy assignment operator
@@ -53,9 +55,9 @@ public:
   GlfwWindow& operator=(const GlfwWindow&) = delete;
 
   /**
-   * @brief Default move assignment operator
+   * @brief Deleted move assignment operator
    */
-  GlfwWindow& operator=(GlfwWindow&&) = default;
+  GlfwWindow& operator=(GlfwWindow&&) = delete;
 
 
 private:
@@ -166,12 +168,13 @@ private:
 private:
   GLFWwindow* m_Window;
   std::string m_Title;
-  uint32_t    m_Width;
-  uint32_t    m_Height;
-  bool        m_FrameBufferResized = false;
-  double      m_CurrentTime        = 0.0;
-  double      m_LastTime           = 0.0;
-  int         m_Frames             = 0;
+  double      m_CurrentTime = 0.0;
+  double      m_LastTime    = 0.0;
+
+  // written by glfw callbacks on main thread, read by the render thread
+  std::atomic<uint32_t> m_Width;
+  std::atomic<uint32_t> m_Height;
+  std::atomic<bool>     m_FrameBufferResized = false;
 
   std::vector<KeyEvent>      m_KeyEvents;
   std::vector<MouseMovement> m_MouseEvents;
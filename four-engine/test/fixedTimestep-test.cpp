@@ -0,0 +1,47 @@
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_approx.hpp"
+
+#include "core/fixedTimestep.hpp"
+
+TEST_CASE("Fixed timestep splits frame time into equal ticks")
+{
+  four::FixedTimestep timestep{100.0F, 5};
+  REQUIRE(timestep.GetStep() == Catch::Approx(0.01F));
+
+  SECTION("ticks do not depend on frame rate")
+  {
+    // one second at 30 fps and at 144 fps simulates the same ticks
+    four::FixedTimestep slow{100.0F, 5};
+    four::FixedTimestep fast{100.0F, 5};
+    four::u64           slowTicks = 0;
+    four::u64           fastTicks = 0;
+    for (int i = 0; i < 30; ++i)
+    {
+      slowTicks += slow.Advance(1.0 / 30.0);
+    }
+    for (int i = 0; i < 144; ++i)
+    {
+      fastTicks += fast.Advance(1.0 / 144.0);
+    }
+    REQUIRE(slowTicks >= 99);
+    REQUIRE(slowTicks <= 100);
+    REQUIRE(fastTicks >= 99);
+    REQUIRE(fastTicks <= 100);
+  }
+
+  SECTION("alpha is the fraction of the next tick")
+  {
+    REQUIRE(timestep.Advance(0.025) == 2);
+    REQUIRE(timestep.GetAlpha() == Catch::Approx(0.5F).margin(1e-4));
+    REQUIRE(timestep.Advance(0.0075) == 1);
+    REQUIRE(timestep.GetAlpha() == Catch::Approx(0.25F).margin(1e-4));
+  }
+
+  SECTION("catch-up cap drops time instead of simulating it")
+  {
+    REQUIRE(timestep.Advance(1.005) == 5);
+    REQUIRE(timestep.GetDroppedTime() == Catch::Approx(0.95).margin(1e-6));
+    REQUIRE(timestep.GetAlpha() < 1.0F);
+    REQUIRE(timestep.Advance(0.0) == 0);
+  }
+}
@@ -0,0 +1,65 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "renderer/vulkan/vulkanRenderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+constexpr four::u32 WIDTH       = 256;
+constexpr four::u32 HEIGHT      = 256;
+constexpr four::u32 FRAME_COUNT = 64;
+} // namespace
+
+TEST_CASE("Headless renderer renders fixed frame count and reads back last frame")
+{
+  four::Log::Init();
+
+  four::VulkanRenderer renderer{vk::Extent2D{.width = WIDTH, .height = HEIGHT}};
+  REQUIRE(renderer.IsInitialized());
+  REQUIRE(renderer.IsHeadless());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (four::u32 i = 0; i < FRAME_COUNT; ++i)
+  {
+    renderer.Render();
+  }
+  renderer.StopRender();
+  const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  REQUIRE(renderer.GetFrameNumber() == FRAME_COUNT);
+
+  const std::vector<four::u8> pixels = renderer.ReadbackFrame();
+  REQUIRE(pixels.size() == static_cast<size_t>(WIDTH) * HEIGHT * 4);
+
+  // something other than a black clear was drawn
+  bool anyColor = false;
+  for (size_t i = 0; i < pixels.size() && !anyColor; i += 4)
+  {
+    anyColor = pixels[i] != 0 || pixels[i + 1] != 0 || pixels[i + 2] != 0;
+  }
+  REQUIRE(anyColor);
+
+  LOG_WARN("headless {} frames {}x{}: {:.2f} ms total, {:.3f} ms per frame",
+           FRAME_COUNT,
+           WIDTH,
+           HEIGHT,
+           totalMs,
+           totalMs / FRAME_COUNT);
+}
+
+TEST_CASE("Headless renderer keeps the requested extent")
+{
+  four::Log::Init();
+
+  // not square and not a common window size, so a surface or window extent cannot match it by chance
+  constexpr four::u32  width  = 320;
+  constexpr four::u32  height = 96;
+  four::VulkanRenderer renderer{vk::Extent2D{.width = width, .height = height}};
+  REQUIRE(renderer.IsInitialized());
+
+  renderer.Render();
+  renderer.StopRender();
+  REQUIRE(renderer.ReadbackFrame().size() == static_cast<size_t>(width) * height * 4);
+}
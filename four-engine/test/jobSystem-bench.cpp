@@ -0,0 +1,115 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/jobSystem.hpp"
+#include "core/log.hpp"
+
+#include <chrono>
+
+namespace
+{
+constexpr four::u32 JobCount = 200'000;
+constexpr int       Runs     = 5;
+
+// best of several runs, in jobs per second
+template <typename Function>
+double MeasureJobsPerSecond(four::u32 jobCount, Function&& function)
+{
+  double best = 0.0;
+  for (int run = 0; run < Runs; ++run)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    best                 = std::max(best, jobCount / seconds);
+  }
+  return best;
+}
+
+// a few hundred nanoseconds of work, enough that the job is not only scheduling cost
+void Work(std::atomic<four::u64>& sink)
+{
+  four::u64 value = 0;
+  for (four::u64 i = 0; i < 256; ++i)
+  {
+    value = value * 31 + i;
+  }
+  sink.fetch_add(value, std::memory_order_relaxed);
+}
+} // namespace
+
+TEST_CASE("Job system spawn and steal throughput")
+{
+  four::Log::Init();
+  four::JobSystem        jobs;
+  std::atomic<four::u64> sink{0};
+
+  // main thread spawns every job, workers only get work by stealing from it
+  const double spawn = MeasureJobsPerSecond(JobCount,
+                                            [&]
+                                            {
+                                              four::JobCounter counter;
+                                              for (four::u32 i = 0; i < JobCount; ++i)
+                                              {
+                                                jobs.Submit([&sink] { Work(sink); }, &counter);
+                                              }
+                                              jobs.Wait(counter);
+                                            });
+
+  // jobs spawn their children, work spreads as a tree and every thread spawns and steals
+  const double tree = MeasureJobsPerSecond(JobCount,
+                                           [&]
+                                           {
+                                             constexpr four::u32 fanOut = 64;
+                                             four::JobCounter    counter;
+                                             for (four::u32 i = 0; i < JobCount / fanOut; ++i)
+                                             {
+                                               jobs.Submit(
+                                                 [&]
+                                                 {
+                                                   for (four::u32 j = 1; j < fanOut; ++j)
+                                                   {
+                                                     jobs.Submit([&sink] { Work(sink); }, &counter);
+                                                   }
+                                                   Work(sink);
+                                                 },
+                                                 &counter);
+                                             }
+                                             jobs.Wait(counter);
+                                           });
+
+  // chunks of one range, the common case for systems iterating components
+  const double parallelFor = MeasureJobsPerSecond(JobCount,
+                                                  [&]
+                                                  {
+                                                    jobs.ParallelFor(0,
+                                                                     JobCount,
+                                                                     64,
+                                                                     [&sink](four::u32 begin, four::u32 end)
+                                                                     {
+                                                                       for (four::u32 i = begin; i < end; ++i)
+                                                                       {
+                                                                         Work(sink);
+                                                                       }
+                                                                     });
+                                                  });
+
+  // same work without the job system
+  const double serial = MeasureJobsPerSecond(JobCount,
+                                             [&]
+                                             {
+                                               for (four::u32 i = 0; i < JobCount; ++i)
+                                               {
+                                                 Work(sink);
+                                               }
+                                             });
+
+  const four::JobSystemStats stats = jobs.GetStats();
+  REQUIRE(stats.executed >= static_cast<four::u64>(JobCount) * Runs * 2);
+
+  LOG_WARN("job system with {} threads, jobs per second", jobs.GetThreadCount());
+  LOG_WARN("  serial:       {:.0f}", serial);
+  LOG_WARN("  spawn:        {:.0f}", spawn);
+  LOG_WARN("  spawn tree:   {:.0f}", tree);
+  LOG_WARN("  parallel for: {:.0f}", parallelFor);
+  LOG_WARN("  executed {}, stolen {}", stats.executed, stats.stolen);
+}
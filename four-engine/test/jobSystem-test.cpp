@@ -0,0 +1,178 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/jobSystem.hpp"
+#include "core/log.hpp"
+
+#include <numeric>
+#include <thread>
+
+TEST_CASE("Work-stealing queue")
+{
+  four::WorkStealingQueue<four::u32> queue{4};
+  four::u32                          value = 0;
+
+  SECTION("owner pops newest, thief steals oldest")
+  {
+    for (four::u32 i = 1; i <= 4; ++i)
+    {
+      REQUIRE(queue.Push(i));
+    }
+    REQUIRE_FALSE(queue.Push(5));
+
+    REQUIRE(queue.Pop(value));
+    REQUIRE(value == 4);
+    REQUIRE(queue.Steal(value));
+    REQUIRE(value == 1);
+    REQUIRE(queue.Size() == 2);
+  }
+
+  SECTION("every element is taken exactly once")
+  {
+    constexpr four::u32                itemCount = 100'000;
+    four::WorkStealingQueue<four::u32> shared{1024};
+    std::vector<std::atomic<four::u32>> taken(itemCount);
+    std::atomic<bool>                  done{false};
+
+    std::vector<std::jthread> thieves;
+    for (int t = 0; t < 3; ++t)
+    {
+      thieves.emplace_back(
+        [&]
+        {
+          four::u32 item = 0;
+          while (!done.load() || shared.Size() != 0)
+          {
+            if (shared.Steal(item))
+            {
+              taken[item].fetch_add(1);
+            }
+          }
+        });
+    }
+
+    four::u32 item = 0;
+    for (four::u32 i = 0; i < itemCount; ++i)
+    {
+      while (!shared.Push(i))
+      {
+        if (shared.Pop(item))
+        {
+          taken[item].fetch_add(1);
+        }
+      }
+    }
+    while (shared.Pop(item))
+    {
+      taken[item].fetch_add(1);
+    }
+    done = true;
+    thieves.clear();
+
+    REQUIRE(std::ranges::all_of(taken, [](const auto& count) { return count.load() == 1; }));
+  }
+}
+
+TEST_CASE("Job system runs jobs, dependencies and parallel for")
+{
+  four::Log::Init();
+  four::JobSystem jobs{4};
+
+  SECTION("counter waits for every job")
+  {
+    std::atomic<four::u32> ran{0};
+    four::JobCounter       counter;
+    for (int i = 0; i < 10'000; ++i)
+    {
+      jobs.Submit([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+    }
+    jobs.Wait(counter);
+    REQUIRE(counter.IsDone());
+    REQUIRE(ran == 10'000);
+  }
+
+  SECTION("nested jobs and jobs from other threads")
+  {
+    std::atomic<four::u32> ran{0};
+    four::JobCounter       counter;
+    std::jthread           external(
+      [&]
+      {
+        for (int i = 0; i < 100; ++i)
+        {
+          jobs.Submit(
+            [&]
+            {
+              four::JobCounter inner;
+              for (int j = 0; j < 10; ++j)
+              {
+                jobs.Submit([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &inner);
+              }
+              jobs.Wait(inner);
+            },
+            &counter);
+        }
+      });
+    external.join();
+    jobs.Wait(counter);
+    REQUIRE(ran == 1000);
+  }
+
+  SECTION("dependent job starts after its group")
+  {
+    std::atomic<four::u32> ran{0};
+    four::u32              seen = 0;
+    four::JobCounter       first;
+    four::JobCounter       second;
+    for (int i = 0; i < 64; ++i)
+    {
+      jobs.Submit(
+        [&ran]
+        {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          ran.fetch_add(1);
+        },
+        &first);
+    }
+    jobs.SubmitAfter(first, [&] { seen = ran.load(); }, &second);
+    jobs.Wait(second);
+    REQUIRE(seen == 64);
+
+    // dependency already finished, job is queued right away
+    jobs.SubmitAfter(first, [&] { seen = 0; }, &second);
+    jobs.Wait(second);
+    REQUIRE(seen == 0);
+  }
+
+  SECTION("main thread jobs run on the main thread only")
+  {
+    const auto       mainId = std::this_thread::get_id();
+    bool             onMain = false;
+    four::JobCounter counter;
+    jobs.Submit([&] { jobs.SubmitMainThread([&] { onMain = std::this_thread::get_id() == mainId; }, &counter); },
+                &counter);
+
+    // main thread runs the job while it waits for the group
+    jobs.Wait(counter);
+    REQUIRE(onMain);
+    REQUIRE(jobs.RunMainThreadJobs() == 0);
+  }
+
+  SECTION("parallel for covers the range once")
+  {
+    std::vector<four::u32> values(100'003, 0);
+    jobs.ParallelFor(0,
+                     static_cast<four::u32>(values.size()),
+                     256,
+                     [&values](four::u32 begin, four::u32 end)
+                     {
+                       for (four::u32 i = begin; i < end; ++i)
+                       {
+                         values[i] += i;
+                       }
+                     });
+
+    std::vector<four::u32> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0U);
+    REQUIRE(values == expected);
+  }
+}
@@ -0,0 +1,158 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "mesh/meshCooker.hpp"
+#include "mesh/meshFile.hpp"
+#include "mesh/meshOptimizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace
+{
+const std::filesystem::path MeshDir = "mesh-bench-data"; // mesh-bench is taken by the executable
+
+void WriteText(const std::filesystem::path& path, std::string_view text)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+// flat grid of size x size quads in the xy plane facing +z
+std::string GridObj(four::u32 size)
+{
+  std::string text;
+  for (four::u32 y = 0; y <= size; ++y)
+  {
+    for (four::u32 x = 0; x <= size; ++x)
+    {
+      text += std::format("v {} {} 0\nvt {} {}\n", x, y, static_cast<float>(x) / size, static_cast<float>(y) / size);
+    }
+  }
+  for (four::u32 y = 0; y < size; ++y)
+  {
+    for (four::u32 x = 0; x < size; ++x)
+    {
+      const four::u32 a = y * (size + 1) + x + 1;
+      const four::u32 b = a + size + 1;
+      text += std::format("f {}/{} {}/{} {}/{} {}/{}\n", a, a, a + 1, a + 1, b + 1, b + 1, b, b);
+    }
+  }
+  return text;
+}
+
+// size x size quads in the xy plane facing +z, triangles shuffled so no cache friendly order is left
+four::MeshData ShuffledGrid(four::u32 size, four::u32 seed)
+{
+  four::MeshData mesh;
+  for (four::u32 y = 0; y <= size; ++y)
+  {
+    for (four::u32 x = 0; x <= size; ++x)
+    {
+      const glm::vec2 texCoord{static_cast<float>(x) / size, static_cast<float>(y) / size};
+      mesh.vertices.push_back({.position = {static_cast<float>(x), static_cast<float>(y), 0.0F}, .texCoord = texCoord});
+    }
+  }
+  std::vector<std::array<four::u32, 3>> triangles;
+  for (four::u32 y = 0; y < size; ++y)
+  {
+    for (four::u32 x = 0; x < size; ++x)
+    {
+      const four::u32 a = y * (size + 1) + x;
+      const four::u32 b = a + size + 1;
+      triangles.push_back({a, a + 1, b + 1});
+      triangles.push_back({a, b + 1, b});
+    }
+  }
+  std::mt19937 random{seed};
+  std::ranges::shuffle(triangles, random);
+  for (const auto& triangle : triangles)
+  {
+    mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+  }
+  mesh.submeshes.push_back({.firstIndex = 0, .indexCount = static_cast<four::u32>(mesh.indices.size())});
+  return mesh;
+}
+} // namespace
+
+TEST_CASE("Cooked mesh load bench")
+{
+  four::Log::Init();
+
+  // half a million vertices, about a million triangles
+  WriteText(MeshDir / "bench.obj", GridObj(724));
+  const auto time = [](auto&& function)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  four::MeshData mesh;
+  const double   import = time([&] { REQUIRE(four::ImportObj(MeshDir / "bench.obj", mesh)); });
+  const double   cook   = time([&] { REQUIRE(four::CookMesh(mesh, MeshDir / "bench.fmesh")); });
+
+  // what an upload does with the mapping: read every vertex and index byte once
+  std::vector<std::byte> staging;
+  four::MeshFile         file;
+  const double           load = time(
+    [&]
+    {
+      REQUIRE(file.Open(MeshDir / "bench.fmesh"));
+      staging.resize(file.GetVertexData().size() + file.GetIndexData().size());
+      std::memcpy(staging.data(), file.GetVertexData().data(), file.GetVertexData().size());
+      std::memcpy(staging.data() + file.GetVertexData().size(), file.GetIndexData().data(), file.GetIndexData().size());
+      file.Close();
+    });
+
+  LOG_WARN("mesh of {} vertices, {} triangles", mesh.vertices.size(), mesh.indices.size() / 3);
+  LOG_WARN("  obj import:          {:.1f} ms", import);
+  LOG_WARN("  cook:                {:.1f} ms", cook);
+  LOG_WARN("  map and copy cooked: {:.1f} ms, {} MB", load, staging.size() / (1024 * 1024));
+}
+
+TEST_CASE("Mesh optimize bench")
+{
+  four::Log::Init();
+
+  // about a million triangles in random order
+  four::MeshData mesh  = ShuffledGrid(724, 3);
+  const auto     start = std::chrono::steady_clock::now();
+  const auto     stats = four::OptimizeMesh(mesh);
+  const double   time  = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  REQUIRE(stats.after.acmr < stats.before.acmr);
+
+  LOG_WARN("optimize {} triangles: {:.1f} ms", stats.before.triangles, time);
+  LOG_WARN("  acmr {:.3f} -> {:.3f}", stats.before.acmr, stats.after.acmr);
+  LOG_WARN("  atvr {:.3f} -> {:.3f}", stats.before.atvr, stats.after.atvr);
+}
+
+TEST_CASE("Mesh simplify bench")
+{
+  four::Log::Init();
+
+  // about a million triangles of a rolling height field, nothing is flat so every collapse has a cost
+  // optimized first, the cooker simplifies meshes in cache order
+  four::MeshData mesh = ShuffledGrid(724, 5);
+  for (four::MeshVertex& vertex : mesh.vertices)
+  {
+    vertex.position.z = std::sin(vertex.position.x * 0.05F) * std::cos(vertex.position.y * 0.07F) * 8.0F;
+  }
+  (void)four::OptimizeMesh(mesh);
+  const auto start  = std::chrono::steady_clock::now();
+  const auto levels = four::SimplifyMesh(mesh.indices, mesh.vertices, 4);
+  const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  REQUIRE(levels.size() == 4);
+
+  LOG_WARN("simplify {} triangles into {} lods: {:.1f} ms", mesh.indices.size() / 3, levels.size(), time);
+  for (const four::MeshLodLevel& level : levels)
+  {
+    LOG_WARN("  {} triangles, error {:.4f}", level.indices.size() / 3, level.error);
+  }
+}
@@ -0,0 +1,191 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "mesh/meshCooker.hpp"
+#include "mesh/meshFile.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+const std::filesystem::path MeshDir = "mesh-test";
+
+void WriteText(const std::filesystem::path& path, std::string_view text)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+// flat grid of size x size quads in the xy plane facing +z
+std::string GridObj(four::u32 size)
+{
+  std::string text;
+  for (four::u32 y = 0; y <= size; ++y)
+  {
+    for (four::u32 x = 0; x <= size; ++x)
+    {
+      text += std::format("v {} {} 0\nvt {} {}\n", x, y, static_cast<float>(x) / size, static_cast<float>(y) / size);
+    }
+  }
+  for (four::u32 y = 0; y < size; ++y)
+  {
+    for (four::u32 x = 0; x < size; ++x)
+    {
+      const four::u32 a = y * (size + 1) + x + 1;
+      const four::u32 b = a + size + 1;
+      text += std::format("f {}/{} {}/{} {}/{} {}/{}\n", a, a, a + 1, a + 1, b + 1, b + 1, b, b);
+    }
+  }
+  return text;
+}
+} // namespace
+
+TEST_CASE("OBJ import")
+{
+  four::Log::Init();
+  WriteText(MeshDir / "import.obj",
+            "# two quads sharing an edge, then a colored triangle with relative indices\n"
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 2 0 0\nv 2 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+            "o quads\nusemtl stone\n"
+            "f 1/1 2/2 3/3 4/4\n"
+            "f 2/1 5/2 6/3 3/4\n"
+            "o triangle\nusemtl wood\n"
+            "v 0 0 1 1 0 0\nv 1 0 1 0 1 0\nv 0 1 1 0 0 1\n"
+            "f -3 -2 -1\n");
+
+  four::MeshData mesh;
+  REQUIRE(four::ImportObj(MeshDir / "import.obj", mesh));
+  REQUIRE(mesh.indices.size() == 15);
+  REQUIRE(mesh.vertices.size() == 11); // shared corners differ in texture coordinates, the triangle has none
+  REQUIRE(mesh.submeshes.size() == 2);
+  REQUIRE((mesh.submeshes[0].firstIndex == 0 && mesh.submeshes[0].indexCount == 12));
+  REQUIRE((mesh.submeshes[1].firstIndex == 12 && mesh.submeshes[1].indexCount == 3));
+  REQUIRE((mesh.submeshes[0].material == 0 && mesh.submeshes[1].material == 1));
+
+  // texture rows flip, the vertex color extension is read
+  REQUIRE(mesh.vertices[mesh.indices[2]].texCoord == glm::vec2{1.0F, 0.0F});
+  REQUIRE(mesh.vertices[mesh.indices[12]].color == glm::vec3{1.0F, 0.0F, 0.0F});
+  REQUIRE(mesh.vertices[mesh.indices[0]].color == glm::vec3{1.0F});
+
+  WriteText(MeshDir / "broken.obj", "v 0 0 0\nf 1 2 3\n");
+  REQUIRE_FALSE(four::ImportObj(MeshDir / "broken.obj", mesh));
+  REQUIRE_FALSE(four::ImportObj(MeshDir / "missing.obj", mesh));
+}
+
+TEST_CASE("Cooked mesh round trip")
+{
+  four::Log::Init();
+  WriteText(MeshDir / "grid.obj", GridObj(32));
+  four::MeshData mesh;
+  REQUIRE(four::ImportObj(MeshDir / "grid.obj", mesh));
+  REQUIRE(four::CookMesh(mesh, MeshDir / "grid.fmesh"));
+
+  four::MeshFile file;
+  REQUIRE(file.Open(MeshDir / "grid.fmesh"));
+  const auto& header = file.GetHeader();
+  REQUIRE(header.vertexCount == 33 * 33);
+  REQUIRE(header.indexCount == 32 * 32 * 6);
+  REQUIRE(file.GetVertexData().size() == mesh.vertices.size() * sizeof(four::MeshVertex));
+  REQUIRE(std::equal(file.GetIndices().begin(), file.GetIndices().end(), mesh.indices.begin(), mesh.indices.end()));
+  REQUIRE(reinterpret_cast<std::uintptr_t>(file.GetVertexData().data()) % four::MESH_STREAM_ALIGNMENT == 0);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(file.GetIndexData().data()) % four::MESH_STREAM_ALIGNMENT == 0);
+  REQUIRE(std::abs(header.boundingSphere.w - std::sqrt(2.0F) * 16.0F) < 1e-3F);
+
+  // every triangle lands in exactly one meshlet within the limits, every meshlet faces +z with a tight cone
+  const auto submesh  = file.GetSubmeshes()[0];
+  const auto meshlets = file.GetMeshlets();
+  REQUIRE(submesh.meshletCount == meshlets.size());
+  four::u32 triangles   = 0;
+  bool      withinLimit = true;
+  bool      inSphere    = true;
+  bool      facesUp     = true;
+  for (const four::Meshlet& meshlet : meshlets)
+  {
+    triangles += meshlet.triangleCount;
+    withinLimit = withinLimit && meshlet.vertexCount <= four::MESHLET_MAX_VERTICES &&
+                  meshlet.triangleCount <= four::MESHLET_MAX_TRIANGLES && meshlet.triangleOffset % 4 == 0;
+    for (four::u32 i = 0; i < meshlet.triangleCount * 3; ++i)
+    {
+      const four::u8  local    = file.GetMeshletTriangles()[meshlet.triangleOffset + i];
+      const glm::vec3 position = file.GetVertices()[file.GetMeshletVertices()[meshlet.vertexOffset + local]].position;
+      withinLimit              = withinLimit && local < meshlet.vertexCount;
+      inSphere = inSphere && glm::length(position - glm::vec3{meshlet.boundingSphere}) <= meshlet.boundingSphere.w + 1e-4F;
+    }
+    facesUp = facesUp && meshlet.cone.z > 0.999F && meshlet.cone.w < 0.01F;
+  }
+  REQUIRE(triangles == header.indexCount / 3);
+  REQUIRE(withinLimit);
+  REQUIRE(inSphere);
+  REQUIRE(facesUp);
+}
+
+TEST_CASE("Meshlet expansion and cone culling")
+{
+  four::Log::Init();
+  WriteText(MeshDir / "meshlets.obj", GridObj(16));
+  four::MeshData mesh;
+  REQUIRE(four::ImportObj(MeshDir / "meshlets.obj", mesh));
+  const four::MeshletData meshlets = four::BuildMeshlets(mesh);
+  REQUIRE(meshlets.meshlets.size() > 1);
+
+  // expanded meshlets draw every triangle of the mesh, meshlet after meshlet
+  const std::vector<four::u32> expanded =
+    four::ExpandMeshletIndices(meshlets.meshlets, meshlets.vertices, meshlets.triangles);
+  REQUIRE(expanded.size() == mesh.indices.size());
+  std::vector<std::array<four::u32, 3>> original;
+  std::vector<std::array<four::u32, 3>> clustered;
+  for (std::size_t i = 0; i < expanded.size(); i += 3)
+  {
+    std::array<four::u32, 3> a{mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+    std::array<four::u32, 3> b{expanded[i], expanded[i + 1], expanded[i + 2]};
+    std::ranges::rotate(a, std::ranges::min_element(a));
+    std::ranges::rotate(b, std::ranges::min_element(b));
+    original.push_back(a);
+    clustered.push_back(b);
+  }
+  std::ranges::sort(original);
+  std::ranges::sort(clustered);
+  REQUIRE(original == clustered);
+
+  // the grid faces +z, every meshlet is culled from below and none from above, not even at a grazing angle
+  bool culledBelow = true;
+  bool keptAbove   = true;
+  for (const four::Meshlet& meshlet : meshlets.meshlets)
+  {
+    culledBelow = culledBelow && four::IsMeshletBackfacing(meshlet, glm::vec3{8.0F, 8.0F, -20.0F});
+    keptAbove   = keptAbove && !four::IsMeshletBackfacing(meshlet, glm::vec3{8.0F, 8.0F, 20.0F}) &&
+                !four::IsMeshletBackfacing(meshlet, glm::vec3{-100.0F, 8.0F, 0.5F});
+  }
+  REQUIRE(culledBelow);
+  REQUIRE(keptAbove);
+}
+
+TEST_CASE("Cooked mesh rejects stale and truncated files")
+{
+  four::Log::Init();
+  WriteText(MeshDir / "small.obj", GridObj(4));
+  four::MeshData mesh;
+  REQUIRE(four::ImportObj(MeshDir / "small.obj", mesh));
+  REQUIRE(four::CookMesh(mesh, MeshDir / "small.fmesh"));
+
+  std::ifstream     in(MeshDir / "small.fmesh", std::ios::binary);
+  const std::string bytes{std::istreambuf_iterator<char>(in), {}};
+
+  four::MeshFile file;
+  WriteText(MeshDir / "truncated.fmesh", std::string_view{bytes}.substr(0, bytes.size() - 1));
+  REQUIRE_FALSE(file.Open(MeshDir / "truncated.fmesh"));
+
+  std::string stale = bytes;
+  stale[4]          = 0x7F; // version
+  WriteText(MeshDir / "stale.fmesh", stale);
+  REQUIRE_FALSE(file.Open(MeshDir / "stale.fmesh"));
+
+  WriteText(MeshDir / "text.fmesh", "not a mesh");
+  REQUIRE_FALSE(file.Open(MeshDir / "text.fmesh"));
+  REQUIRE_FALSE(file.Open(MeshDir / "missing.fmesh"));
+  REQUIRE(file.Open(MeshDir / "small.fmesh"));
+}
@@ -0,0 +1,314 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "mesh/meshCooker.hpp"
+#include "mesh/meshFile.hpp"
+#include "mesh/meshOptimizer.hpp"
+
+#include "glm/gtc/packing.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <random>
+
+namespace
+{
+const std::filesystem::path MeshDir = "mesh-test";
+
+// size x size quads in the xy plane facing +z, triangles shuffled so no cache friendly order is left
+four::MeshData ShuffledGrid(four::u32 size, four::u32 seed)
+{
+  four::MeshData mesh;
+  for (four::u32 y = 0; y <= size; ++y)
+  {
+    for (four::u32 x = 0; x <= size; ++x)
+    {
+      const glm::vec2 texCoord{static_cast<float>(x) / size, static_cast<float>(y) / size};
+      mesh.vertices.push_back({.position = {static_cast<float>(x), static_cast<float>(y), 0.0F}, .texCoord = texCoord});
+    }
+  }
+  std::vector<std::array<four::u32, 3>> triangles;
+  for (four::u32 y = 0; y < size; ++y)
+  {
+    for (four::u32 x = 0; x < size; ++x)
+    {
+      const four::u32 a = y * (size + 1) + x;
+      const four::u32 b = a + size + 1;
+      triangles.push_back({a, a + 1, b + 1});
+      triangles.push_back({a, b + 1, b});
+    }
+  }
+  std::mt19937 random{seed};
+  std::ranges::shuffle(triangles, random);
+  for (const auto& triangle : triangles)
+  {
+    mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+  }
+  mesh.submeshes.push_back({.firstIndex = 0, .indexCount = static_cast<four::u32>(mesh.indices.size())});
+  return mesh;
+}
+
+// unit uv sphere, the seam column is duplicated for its texture coordinates
+four::MeshData UvSphere(four::u32 rings, four::u32 segments)
+{
+  four::MeshData mesh;
+  for (four::u32 ring = 0; ring <= rings; ++ring)
+  {
+    const float theta  = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+    const float radius = ring == 0 || ring == rings ? 0.0F : std::sin(theta); // poles collapse to one point
+    for (four::u32 segment = 0; segment <= segments; ++segment)
+    {
+      const float phi = 2.0F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+      const glm::vec3 position{radius * std::cos(phi), radius * std::sin(phi), std::cos(theta)};
+      const glm::vec2 texCoord{static_cast<float>(segment) / segments, static_cast<float>(ring) / rings};
+      mesh.vertices.push_back({.position = position, .texCoord = texCoord});
+    }
+  }
+  for (four::u32 ring = 0; ring < rings; ++ring)
+  {
+    for (four::u32 segment = 0; segment < segments; ++segment)
+    {
+      const four::u32 a = ring * (segments + 1) + segment;
+      const four::u32 b = a + segments + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, b, b + 1, a, b + 1, a + 1});
+    }
+  }
+  mesh.submeshes.push_back({.firstIndex = 0, .indexCount = static_cast<four::u32>(mesh.indices.size())});
+  return mesh;
+}
+
+// triangles of indices rotated to start at their smallest index and sorted, equal when only the order changed
+std::vector<std::array<four::u32, 3>> SortedTriangles(std::span<const four::u32> indices)
+{
+  std::vector<std::array<four::u32, 3>> triangles;
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+  {
+    std::array<four::u32, 3> triangle{indices[i], indices[i + 1], indices[i + 2]};
+    std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+    triangles.push_back(triangle);
+  }
+  std::ranges::sort(triangles);
+  return triangles;
+}
+} // namespace
+
+TEST_CASE("Vertex cache and overdraw ordering")
+{
+  four::Log::Init();
+  four::MeshData mesh        = ShuffledGrid(64, 1);
+  const auto     vertexCount = static_cast<four::u32>(mesh.vertices.size());
+  const auto     triangles   = SortedTriangles(mesh.indices);
+
+  const four::VertexCacheStats shuffled = four::AnalyzeVertexCache(mesh.indices, vertexCount);
+  REQUIRE(shuffled.vertices == vertexCount);
+  REQUIRE(shuffled.acmr > 2.0F);
+
+  // a regular grid reaches about 0.5 with an ideal order, Tipsify gets well below 1
+  four::OptimizeVertexCache(mesh.indices, vertexCount);
+  const four::VertexCacheStats optimized = four::AnalyzeVertexCache(mesh.indices, vertexCount);
+  REQUIRE(optimized.acmr < 0.9F);
+  REQUIRE(optimized.atvr < 1.7F);
+  REQUIRE(SortedTriangles(mesh.indices) == triangles);
+
+  // clusters only move as a whole, the cache efficiency stays about within the threshold
+  four::OptimizeOverdraw(mesh.indices, mesh.vertices);
+  const four::VertexCacheStats reordered = four::AnalyzeVertexCache(mesh.indices, vertexCount);
+  REQUIRE(reordered.acmr <= optimized.acmr * four::OVERDRAW_THRESHOLD + 0.05F);
+  REQUIRE(SortedTriangles(mesh.indices) == triangles);
+
+  LOG_WARN("grid of {} triangles, acmr / atvr", triangles.size());
+  LOG_WARN("  shuffled:        {:.3f} / {:.3f}", shuffled.acmr, shuffled.atvr);
+  LOG_WARN("  vertex cache:    {:.3f} / {:.3f}", optimized.acmr, optimized.atvr);
+  LOG_WARN("  overdraw order:  {:.3f} / {:.3f}", reordered.acmr, reordered.atvr);
+}
+
+TEST_CASE("Overdraw ordering draws outward facing clusters first")
+{
+  four::Log::Init();
+
+  // two parallel quads facing -z, the one at -z faces away from the center and may occlude the other
+  four::MeshData mesh;
+  mesh.vertices = {{.position = {0.0F, 0.0F, -1.0F}},
+                   {.position = {1.0F, 0.0F, -1.0F}},
+                   {.position = {1.0F, 1.0F, -1.0F}},
+                   {.position = {0.0F, 1.0F, -1.0F}},
+                   {.position = {0.0F, 0.0F, 1.0F}},
+                   {.position = {1.0F, 0.0F, 1.0F}},
+                   {.position = {1.0F, 1.0F, 1.0F}},
+                   {.position = {0.0F, 1.0F, 1.0F}}};
+  mesh.indices  = {4, 6, 5, 4, 7, 6, 0, 2, 1, 0, 3, 2};
+  four::OptimizeOverdraw(mesh.indices, mesh.vertices);
+  REQUIRE(mesh.indices == std::vector<four::u32>{0, 2, 1, 0, 3, 2, 4, 6, 5, 4, 7, 6});
+}
+
+TEST_CASE("Vertex deduplication and fetch order")
+{
+  four::Log::Init();
+  four::MeshData mesh;
+  mesh.vertices = {{.position = {0.0F, 0.0F, 0.0F}},
+                   {.position = {1.0F, 0.0F, 0.0F}},
+                   {.position = {9.0F, 9.0F, 9.0F}}, // unused
+                   {.position = {1.0F, 1.0F, 0.0F}},
+                   {.position = {1.0F, 0.0F, 0.0F}}, // same as 1
+                   {.position = {1.0F, 1.0F, 0.0F}, .texCoord = {1.0F, 0.0F}}};
+  mesh.indices   = {3, 0, 1, 4, 5, 3};
+  mesh.submeshes = {{.firstIndex = 0, .indexCount = 3}, {.firstIndex = 3, .indexCount = 3, .vertexOffset = 0}};
+
+  REQUIRE(four::DeduplicateVertices(mesh) == 1);
+  REQUIRE(mesh.vertices.size() == 5);
+  REQUIRE(mesh.indices == std::vector<four::u32>{3, 0, 1, 1, 4, 3});
+
+  // vertices end up in the order of their first use, the unused one is gone
+  four::OptimizeVertexFetch(mesh);
+  REQUIRE(mesh.vertices.size() == 4);
+  REQUIRE(mesh.indices == std::vector<four::u32>{0, 1, 2, 2, 3, 0});
+  REQUIRE(mesh.vertices[0].position == glm::vec3{1.0F, 1.0F, 0.0F});
+  REQUIRE(mesh.vertices[3].texCoord == glm::vec2{1.0F, 0.0F});
+
+  // offsets are folded, a submesh drawn at vertex offset 2 keeps referencing the same vertices
+  four::MeshData offsetMesh = mesh;
+  offsetMesh.indices        = {0, 1, 2, 0, 1, 0};
+  offsetMesh.submeshes      = {{.firstIndex = 0, .indexCount = 3},
+                               {.firstIndex = 3, .indexCount = 3, .vertexOffset = 2}};
+  four::OptimizeVertexFetch(offsetMesh);
+  REQUIRE(offsetMesh.submeshes[1].vertexOffset == 0);
+  REQUIRE(offsetMesh.indices == std::vector<four::u32>{0, 1, 2, 2, 3, 2});
+}
+
+TEST_CASE("Quantized vertex stream")
+{
+  four::Log::Init();
+  four::MeshData mesh = ShuffledGrid(16, 2);
+  for (four::MeshVertex& vertex : mesh.vertices)
+  {
+    vertex.position = vertex.position * 0.37F + glm::vec3{-3.0F, 2.0F, 0.5F};
+  }
+  const std::vector<four::MeshVertex> source = mesh.vertices;
+  REQUIRE(four::CookMesh(mesh, MeshDir / "quantized.fmesh", {.vertexFormat = four::MeshVertexFormat::Quantized}));
+
+  four::MeshFile file;
+  REQUIRE(file.Open(MeshDir / "quantized.fmesh"));
+  REQUIRE(file.GetVertexFormat() == four::MeshVertexFormat::Quantized);
+  REQUIRE(file.GetHeader().vertexStride == sizeof(four::QuantizedMeshVertex));
+  REQUIRE(file.GetVertices().empty());
+  const auto vertices = file.GetQuantizedVertices();
+  REQUIRE(vertices.size() == mesh.vertices.size());
+
+  // the cooker reorders vertices, the cooked ones are compared to the optimized mesh it returns
+  float positionError = 0.0F;
+  float texCoordError = 0.0F;
+  float normalError   = 0.0F;
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    const glm::vec3 position{glm::unpackHalf1x16(vertices[i].position[0]),
+                             glm::unpackHalf1x16(vertices[i].position[1]),
+                             glm::unpackHalf1x16(vertices[i].position[2])};
+    const glm::vec2 texCoord{vertices[i].texCoord[0] / 65535.0F, vertices[i].texCoord[1] / 65535.0F};
+    const glm::vec2 encoded{vertices[i].normal[0] / 32767.0F, vertices[i].normal[1] / 32767.0F};
+    positionError = std::max(positionError, glm::length(position - mesh.vertices[i].position));
+    texCoordError = std::max(texCoordError, glm::length(texCoord - mesh.vertices[i].texCoord));
+    normalError   = std::max(normalError, glm::length(four::DecodeOctahedral(encoded) - glm::vec3{0.0F, 0.0F, 1.0F}));
+  }
+  REQUIRE(positionError < 4e-3F); // half has 11 significant bits, positions are below 8
+  REQUIRE(texCoordError < 2e-5F);
+  REQUIRE(normalError < 1e-4F);
+  REQUIRE(vertices[0].color == std::array<four::u8, 4>{255, 255, 255, 255});
+  REQUIRE(vertices[0].position[3] == glm::packHalf1x16(1.0F));
+
+  // octahedral normals round trip in every octant
+  float octahedralError = 0.0F;
+  for (const glm::vec3 direction : {glm::vec3{1.0F, 2.0F, 3.0F},
+                                    glm::vec3{-1.0F, 0.5F, -3.0F},
+                                    glm::vec3{0.2F, -1.0F, -0.1F},
+                                    glm::vec3{0.0F, 0.0F, -1.0F}})
+  {
+    const glm::vec3 normal  = glm::normalize(direction);
+    const glm::vec3 decoded = four::DecodeOctahedral(four::EncodeOctahedral(normal));
+    octahedralError         = std::max(octahedralError, glm::length(decoded - normal));
+  }
+  REQUIRE(octahedralError < 1e-5F);
+
+  // texture coordinates outside of [0, 1] do not fit unorm16, the cooker keeps the full format
+  mesh = {.vertices = source, .indices = {0, 1, 2}, .submeshes = {{.firstIndex = 0, .indexCount = 3}}};
+  mesh.vertices[1].texCoord = {2.0F, 0.0F};
+  REQUIRE(four::CookMesh(mesh, MeshDir / "wrapped.fmesh", {.vertexFormat = four::MeshVertexFormat::Quantized}));
+  REQUIRE(file.Open(MeshDir / "wrapped.fmesh"));
+  REQUIRE(file.GetVertexFormat() == four::MeshVertexFormat::Full);
+  REQUIRE(file.GetVertices().size() == 3);
+}
+
+TEST_CASE("Lod chain simplification")
+{
+  four::Log::Init();
+  const four::MeshData sphere = UvSphere(32, 64);
+  const auto           levels = four::SimplifyMesh(sphere.indices, sphere.vertices, 4);
+  REQUIRE(levels.size() == 4);
+
+  // every level about halves the triangles, errors only grow and no triangle turns inward, edge on ones may remain
+  std::size_t previousTriangles = sphere.indices.size() / 3;
+  float       previousError     = 0.0F;
+  for (const four::MeshLodLevel& level : levels)
+  {
+    const std::size_t triangles = level.indices.size() / 3;
+    REQUIRE(triangles <= previousTriangles * 6 / 10);
+    REQUIRE(level.error >= previousError);
+    bool outward = true;
+    for (std::size_t i = 0; i < level.indices.size(); i += 3)
+    {
+      const glm::vec3 a = sphere.vertices[level.indices[i]].position;
+      const glm::vec3 b = sphere.vertices[level.indices[i + 1]].position;
+      const glm::vec3 c = sphere.vertices[level.indices[i + 2]].position;
+      const glm::vec3 n = glm::cross(b - a, c - a);
+      outward           = outward && glm::dot(n, a + b + c) > -0.01F * glm::length(n) * glm::length(a + b + c);
+    }
+    REQUIRE(outward);
+    LOG_WARN("lod of {} triangles, error {:.4f}", triangles, level.error);
+    previousTriangles = triangles;
+    previousError     = level.error;
+  }
+  REQUIRE(previousError > 0.0F);
+  REQUIRE(previousError < 0.5F);
+
+  // a flat grid simplifies without error and keeps its border, its four corners always stay
+  const four::MeshData grid      = ShuffledGrid(16, 4);
+  const auto           flat      = four::SimplifyMesh(grid.indices, grid.vertices, 8);
+  const auto           corners   = {0U, 16U, 17U * 16U, 17U * 17U - 1U};
+  const auto&          coarsest  = flat.back().indices;
+  REQUIRE(flat.back().error < 1e-4F);
+  REQUIRE(coarsest.size() / 3 < 16 * 4 * 2);
+  for (const four::u32 corner : corners)
+  {
+    REQUIRE(std::ranges::find(coarsest, corner) != coarsest.end());
+  }
+}
+
+TEST_CASE("Cooked lods and lod selection")
+{
+  four::Log::Init();
+  four::MeshData mesh = UvSphere(16, 32);
+  REQUIRE(four::CookMesh(mesh, MeshDir / "lods.fmesh", {.lodCount = 3}));
+
+  four::MeshFile file;
+  REQUIRE(file.Open(MeshDir / "lods.fmesh"));
+  const four::MeshSubmesh submesh = file.GetSubmeshes()[0];
+  const auto              lods    = file.GetLods().subspan(submesh.firstLod, submesh.lodCount);
+  REQUIRE(lods.size() == 3);
+  REQUIRE((lods[0].firstIndex == submesh.firstIndex && lods[0].indexCount == submesh.indexCount));
+  REQUIRE(lods[0].error == 0.0F);
+  REQUIRE(lods[1].firstIndex == submesh.firstIndex + submesh.indexCount);
+  REQUIRE(lods[2].indexCount < lods[1].indexCount);
+  REQUIRE(lods[2].firstIndex + lods[2].indexCount == file.GetHeader().indexCount);
+
+  // the coarser lod is taken only well inside its range, the finer one as soon as it is needed
+  const std::array<four::MeshLod, 4> chain{{{.error = 0.0F}, {.error = 0.01F}, {.error = 0.04F}, {.error = 0.16F}}};
+  const auto select = [&](float pixelsPerUnit, four::u32 current)
+  { return four::SelectLod(chain, pixelsPerUnit, current, 1.0F, 0.25F); };
+  REQUIRE(select(1000.0F, 3) == 0);
+  REQUIRE(select(50.0F, 0) == 1);
+  REQUIRE(select(24.0F, 1) == 1); // lod 2 is at 0.96 pixels, not below 0.75 yet
+  REQUIRE(select(18.0F, 1) == 2);
+  REQUIRE(select(24.0F, 2) == 2); // back up to 0.96 pixels, still within 1
+  REQUIRE(select(26.0F, 2) == 1);
+  REQUIRE(select(1.0F, 0) == 3);
+  REQUIRE(four::GetLodErrorScale(-2.0F, 720.0F) == 720.0F);
+}
@@ -0,0 +1,49 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/application.hpp"
+#include "core/log.hpp"
+#include "renderer/vulkan/vulkanRenderer.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+class MyApp final : public four::Application
+{
+public:
+  MyApp(const std::string& title, uint32_t width, uint32_t height) : four::Application(title, width, height)
+  {
+  }
+  void Init() final
+  {
+  }
+  void OnUpdate(float deltaTime) final
+  {
+  }
+};
+
+namespace
+{
+// construct and destroy an application, pipeline cache is loaded at init and saved at shutdown
+double MeasureStartupMs()
+{
+  const auto start = std::chrono::steady_clock::now();
+  {
+    MyApp app("pipeline cache bench", 400, 600);
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+TEST_CASE("Pipeline cache cold vs warm startup")
+{
+  four::Log::Init();
+
+  std::filesystem::remove(four::PIPELINE_CACHE_PATH);
+  const double coldMs = MeasureStartupMs();
+  REQUIRE(std::filesystem::exists(four::PIPELINE_CACHE_PATH));
+
+  const double warmMs = MeasureStartupMs();
+  REQUIRE(std::filesystem::exists(four::PIPELINE_CACHE_PATH));
+
+  LOG_WARN("startup cold: {:.2f} ms, warm: {:.2f} ms, saved {:.2f} ms", coldMs, warmMs, coldMs - warmMs);
+}
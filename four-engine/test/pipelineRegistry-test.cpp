@@ -0,0 +1,93 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "renderer/vulkan/vulkanPipelineBuilder.hpp"
+#include "renderer/vulkan/vulkanRenderer.hpp"
+
+namespace
+{
+four::VulkanPipelineBuilder MakeTriangleBuilder(vk::PipelineLayout layout)
+{
+  four::VulkanPipelineBuilder builder;
+  builder.pipelineLayout = layout;
+  builder.SetShaderFiles("shaders/coloredTriangle.vert.spv", "shaders/coloredTriangle.frag.spv")
+    .SetInputTopology(vk::PrimitiveTopology::eTriangleList)
+    .SetPolygonMode(vk::PolygonMode::eFill)
+    .SetCullMode(vk::CullModeFlagBits::eBack, vk::FrontFace::eClockwise)
+    .SetMultiSamplingNone()
+    .DisableBlending()
+    .DisableDepthTest()
+    .SetColorAttachmentFormat(vk::Format::eR8G8B8A8Unorm)
+    .SetDepthFormat(vk::Format::eUndefined);
+  return builder;
+}
+} // namespace
+
+TEST_CASE("Pipeline builder hash only depends on pipeline state")
+{
+  const four::VulkanPipelineBuilder builder = MakeTriangleBuilder(nullptr);
+
+  // a copy points its render info at its own format, pointers must not change the hash
+  const four::VulkanPipelineBuilder copy = builder;
+  REQUIRE(copy.Describe() == builder.Describe());
+  REQUIRE(copy.Hash() == builder.Hash());
+  REQUIRE(builder.Hash() == four::VulkanPipelineBuilder::HashDescription(builder.Describe()));
+
+  // building the same state again, after a clear, gives the same hash
+  four::VulkanPipelineBuilder rebuilt = MakeTriangleBuilder(nullptr);
+  rebuilt.clear();
+  rebuilt = MakeTriangleBuilder(nullptr);
+  REQUIRE(rebuilt.Hash() == builder.Hash());
+
+  SECTION("every state change shows in description and hash")
+  {
+    four::VulkanPipelineBuilder culled = builder;
+    culled.SetCullMode(vk::CullModeFlagBits::eFront, vk::FrontFace::eClockwise);
+    REQUIRE(culled.Describe() != builder.Describe());
+    REQUIRE(culled.Hash() != builder.Hash());
+
+    four::VulkanPipelineBuilder formatted = builder;
+    formatted.SetColorAttachmentFormat(vk::Format::eB8G8R8A8Unorm);
+    REQUIRE(formatted.Describe() != builder.Describe());
+    REQUIRE(formatted.Hash() != builder.Hash());
+
+    four::VulkanPipelineBuilder shaded = builder;
+    shaded.SetShaderFiles("shaders/coloredTriangle.vert.spv", "shaders/other.frag.spv");
+    REQUIRE(shaded.Describe() != builder.Describe());
+    REQUIRE(shaded.Hash() != builder.Hash());
+  }
+}
+
+TEST_CASE("Pipeline registry deduplicates equal state and separates different state")
+{
+  four::Log::Init();
+
+  four::VulkanRenderer renderer{vk::Extent2D{.width = 64, .height = 64}};
+  REQUIRE(renderer.IsInitialized());
+
+  const vk::Device              device   = renderer.GetDevice();
+  const vk::PipelineLayout      layout   = device.createPipelineLayout(vk::PipelineLayoutCreateInfo{});
+  four::VulkanPipelineRegistry& registry = renderer.GetPipelineRegistry();
+  const four::u32               count    = registry.GetPipelineCount();
+
+  const four::VulkanPipelineBuilder builder  = MakeTriangleBuilder(layout);
+  const vk::Pipeline                pipeline = registry.GetOrCreate(builder);
+  REQUIRE(pipeline);
+  REQUIRE(registry.GetOrCreate(MakeTriangleBuilder(layout)) == pipeline);
+  REQUIRE(registry.GetOrCreateAsync(builder).get() == pipeline);
+  REQUIRE(registry.GetOrPlaceholder(builder, nullptr) == pipeline);
+  REQUIRE(registry.GetPipelineCount() == count + 1);
+
+  four::VulkanPipelineBuilder culled = builder;
+  culled.SetCullMode(vk::CullModeFlagBits::eNone, vk::FrontFace::eClockwise);
+  REQUIRE(registry.GetOrPlaceholder(culled, pipeline) == pipeline);
+  const vk::Pipeline culledPipeline = registry.GetOrCreateAsync(culled).get();
+  REQUIRE(culledPipeline);
+  REQUIRE(culledPipeline != pipeline);
+  REQUIRE(registry.GetOrPlaceholder(culled, nullptr) == culledPipeline);
+  REQUIRE(registry.GetPipelineCount() == count + 2);
+
+  // pipelines keep working without their layout, registry destroys them with the renderer
+  renderer.StopRender();
+  device.destroyPipelineLayout(layout);
+}
@@ -0,0 +1,69 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "core/profiler.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+TEST_CASE("Profiler frame stats and chrome trace export")
+{
+  four::Log::Init();
+  auto& profiler = four::Profiler::Get();
+
+  // frame n takes n ms, history keeps the latest PROFILER_FRAME_HISTORY frames
+  const four::u32 frameCount = four::PROFILER_FRAME_HISTORY + 100;
+  for (four::u32 i = 1; i <= frameCount; ++i)
+  {
+    profiler.PushFrame({.frameNumber = i, .start = four::Profiler::Now(), .frameMs = static_cast<four::f32>(i)});
+  }
+
+  const auto frames = profiler.GetFrames();
+  REQUIRE(frames.size() == four::PROFILER_FRAME_HISTORY);
+  REQUIRE(frames.front().frameNumber == 101);
+  REQUIRE(frames.back().frameNumber == frameCount);
+
+  const auto stats = profiler.GetStats();
+  REQUIRE(stats.frameCount == four::PROFILER_FRAME_HISTORY);
+  REQUIRE(stats.frame.max == static_cast<four::f32>(frameCount));
+  REQUIRE(stats.frame.p50 <= stats.frame.p95);
+  REQUIRE(stats.frame.p95 <= stats.frame.p99);
+  REQUIRE(stats.frame.p99 <= stats.frame.max);
+
+  // zones from several threads
+  std::vector<std::jthread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back(
+      []
+      {
+        for (int i = 0; i < 100; ++i)
+        {
+          FOUR_PROFILE_SCOPE("worker zone");
+        }
+      });
+  }
+  threads.clear();
+
+  // zone names end up in json strings
+  {
+    FOUR_PROFILE_SCOPE("say \"hi\" from C:\\path\n");
+  }
+
+  four::ProfileGpuFrame gpuFrame{.frameNumber = frameCount, .passCount = 1, .gpuMs = 0.5F};
+  gpuFrame.names[0]      = "Scene";
+  gpuFrame.durationMs[0] = 0.5F;
+  profiler.PushGpuFrame(gpuFrame);
+  REQUIRE(profiler.GetStats().gpuFrameCount == 1);
+
+  const std::filesystem::path tracePath = "profile/profiler-test.json";
+  REQUIRE(profiler.ExportChromeTrace(tracePath));
+
+  std::ifstream     file(tracePath);
+  const std::string trace{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+  REQUIRE(trace.find("worker zone") != std::string::npos);
+  REQUIRE(trace.find("Scene") != std::string::npos);
+  REQUIRE(trace.find(R"(say \"hi\" from C:\\path\n)") != std::string::npos);
+}
@@ -0,0 +1,66 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "renderer/renderQueue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+TEST_CASE("Render queue bench")
+{
+  four::Log::Init();
+
+  // a scene of many objects sharing few meshes and materials, pushed in scene order
+  constexpr four::u32                 count = 100000;
+  std::mt19937_64                     random(42);
+  std::vector<four::RenderQueueEntry> requests;
+  for (four::u32 i = 0; i < count; ++i)
+  {
+    requests.push_back({.key  = four::RenderKey::Make(random() % 4, random() % 64, random() % 256, random() % 4096),
+                        .item = i});
+  }
+
+  const auto time = [](auto&& function)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < 20; ++run)
+    {
+      function();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 20;
+  };
+
+  four::RenderQueue queue;
+  const double      radix = time(
+    [&]
+    {
+      queue.Clear();
+      for (const auto& request : requests)
+      {
+        queue.Push(request.key, request.item);
+      }
+      queue.Build();
+    });
+
+  std::vector<four::RenderQueueEntry> sorted;
+  const double                        comparison = time(
+    [&]
+    {
+      sorted = requests;
+      std::ranges::stable_sort(sorted, {}, &four::RenderQueueEntry::key);
+    });
+
+  const auto& stats = queue.GetStats();
+  REQUIRE(stats.batches <= 4 * 64 * 256);
+  REQUIRE(stats.batches < stats.requests);
+
+  LOG_WARN("render queue of {} draws", count);
+  LOG_WARN("  push, radix sort and batch: {:.3f} ms", radix);
+  LOG_WARN("  std::stable_sort:           {:.3f} ms", comparison);
+  LOG_WARN("  draw calls {} -> {}, pipeline changes {}, material changes {}",
+           stats.requests,
+           stats.batches,
+           stats.pipelineChanges,
+           stats.materialChanges);
+}
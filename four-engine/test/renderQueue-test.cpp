@@ -0,0 +1,85 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "renderer/renderQueue.hpp"
+
+#include <algorithm>
+#include <random>
+
+TEST_CASE("Render keys order pipeline before material before mesh")
+{
+  using four::RenderKey;
+  const auto key = RenderKey::Make(3, 70000, 5, 9);
+  REQUIRE(RenderKey::GetPipeline(key) == 3);
+  REQUIRE(RenderKey::GetMaterial(key) == 70000);
+  REQUIRE(RenderKey::GetMesh(key) == 5);
+  REQUIRE((key & ~RenderKey::BatchMask) == 9);
+
+  REQUIRE(RenderKey::Make(0, 0xFFFFF, 0xFFFFF, 0xFFF) < RenderKey::Make(1, 0, 0, 0));
+  REQUIRE(RenderKey::Make(0, 1, 0, 0) > RenderKey::Make(0, 0, 0xFFFFF, 0xFFF));
+  REQUIRE(RenderKey::Make(0, 0, 1, 0) > RenderKey::Make(0, 0, 0, 0xFFF));
+}
+
+TEST_CASE("Render queue sorts like a stable sort")
+{
+  // small queues take the comparison sort, big ones the radix sort, both must agree
+  for (const four::u32 count : {10U, 5000U})
+  {
+    std::mt19937_64                     random(count);
+    four::RenderQueue                   queue;
+    std::vector<four::RenderQueueEntry> expected;
+    for (four::u32 i = 0; i < count; ++i)
+    {
+      // few distinct keys so equal keys are common, fields spread over all bytes
+      const auto key = four::RenderKey::Make(random() % 3, random() % 40 * 3001, random() % 7, random() % 2);
+      queue.Push(key, i);
+      expected.push_back({.key = key, .item = i});
+    }
+    std::ranges::stable_sort(expected, {}, &four::RenderQueueEntry::key);
+    queue.Sort();
+
+    const auto entries = queue.GetEntries();
+    REQUIRE(entries.size() == expected.size());
+    bool same = true;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      same = same && entries[i].key == expected[i].key && entries[i].item == expected[i].item;
+    }
+    REQUIRE(same);
+  }
+}
+
+TEST_CASE("Render queue merges draws of the same mesh into batches")
+{
+  using four::RenderKey;
+  four::RenderQueue queue;
+  queue.Push(RenderKey::Make(1, 2, 7, 3), 0);
+  queue.Push(RenderKey::Make(0, 2, 7), 1);
+  queue.Push(RenderKey::Make(1, 2, 7, 1), 2);
+  queue.Push(RenderKey::Make(0, 1, 7), 3);
+  queue.Push(RenderKey::Make(0, 2, 7), 4);
+  queue.Push(RenderKey::Make(0, 2, 8), 5);
+  queue.Build();
+
+  const auto batches = queue.GetBatches();
+  REQUIRE(batches.size() == 4);
+  REQUIRE((batches[0].first == 0 && batches[0].count == 1)); // material 1
+  REQUIRE((batches[1].first == 1 && batches[1].count == 2)); // material 2 mesh 7
+  REQUIRE((batches[2].first == 3 && batches[2].count == 1)); // material 2 mesh 8
+  REQUIRE((batches[3].first == 4 && batches[3].count == 2)); // pipeline 1, order bits ignored
+  REQUIRE(RenderKey::GetMesh(batches[2].key) == 8);
+
+  // instances of a batch are in key order, push order between equal keys
+  const auto entries = queue.GetEntries();
+  REQUIRE((entries[1].item == 1 && entries[2].item == 4));
+  REQUIRE((entries[4].item == 2 && entries[5].item == 0));
+
+  const auto& stats = queue.GetStats();
+  REQUIRE(stats.requests == 6);
+  REQUIRE(stats.batches == 4);
+  REQUIRE(stats.pipelineChanges == 1);
+  REQUIRE(stats.materialChanges == 1); // the next pipeline keeps material 2
+  queue.Clear();
+  queue.Build();
+  REQUIRE(queue.GetBatches().empty());
+}
@@ -0,0 +1,239 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "component/lifespan.hpp"
+#include "component/shape.hpp"
+#include "component/transform.hpp"
+#include "core/log.hpp"
+#include "scene/commandBuffer.hpp"
+#include "scene/scene.hpp"
+
+#include <chrono>
+
+namespace
+{
+// counts live instances, catches components that are leaked or destroyed twice by archetype moves
+struct CTracked
+{
+  static inline int liveCount = 0;
+
+  int value{0};
+
+  explicit CTracked(int v) : value{v}
+  {
+    ++liveCount;
+  }
+  CTracked(CTracked&& other) noexcept : value{other.value}
+  {
+    ++liveCount;
+  }
+  CTracked& operator=(CTracked&&) noexcept = default;
+  CTracked(const CTracked&)                = delete;
+  CTracked& operator=(const CTracked&)     = delete;
+  ~CTracked()
+  {
+    --liveCount;
+  }
+};
+} // namespace
+
+TEST_CASE("Scene entities and components")
+{
+  four::Log::Init();
+
+  SECTION("generational handles")
+  {
+    four::Scene        scene;
+    const four::Entity first = scene.CreateEntity();
+    scene.DestroyEntity(first);
+    const four::Entity second = scene.CreateEntity();
+
+    REQUIRE(second.index == first.index);
+    REQUIRE(second.generation != first.generation);
+    REQUIRE_FALSE(scene.IsAlive(first));
+    REQUIRE(scene.IsAlive(second));
+    REQUIRE(scene.GetEntityCount() == 1);
+  }
+
+  SECTION("add, get, remove move entities between archetypes")
+  {
+    four::Scene        scene;
+    const four::Entity entity = scene.CreateEntity();
+    scene.AddComponent<four::CTransform>(entity, glm::vec2{1.0F, 2.0F}, glm::vec2{3.0F, 4.0F});
+    scene.AddComponent<four::CLifeSpan>(entity, 10);
+
+    REQUIRE(scene.HasComponent<four::CTransform>(entity));
+    REQUIRE(scene.GetComponent<four::CTransform>(entity).position.y == 2.0F);
+    REQUIRE(scene.GetComponent<four::CLifeSpan>(entity).remaining == 10);
+
+    scene.RemoveComponent<four::CTransform>(entity);
+    REQUIRE_FALSE(scene.HasComponent<four::CTransform>(entity));
+    REQUIRE(scene.TryGetComponent<four::CTransform>(entity) == nullptr);
+    REQUIRE(scene.GetComponent<four::CLifeSpan>(entity).total == 10);
+  }
+
+  SECTION("removing rows keeps the other entities intact")
+  {
+    {
+      four::Scene               scene;
+      std::vector<four::Entity> entities;
+      for (int i = 0; i < 5000; ++i)
+      {
+        entities.push_back(scene.CreateEntity(CTracked{i}, four::CLifeSpan{i}));
+      }
+      REQUIRE(CTracked::liveCount == 5000);
+
+      // every other entity loses its life span or dies, rows are swapped back across chunks
+      for (int i = 0; i < 5000; i += 2)
+      {
+        if (i % 4 == 0)
+        {
+          scene.DestroyEntity(entities[i]);
+        }
+        else
+        {
+          scene.RemoveComponent<four::CLifeSpan>(entities[i]);
+        }
+      }
+      REQUIRE(CTracked::liveCount == 3750);
+
+      for (int i = 0; i < 5000; ++i)
+      {
+        if (i % 4 == 0)
+        {
+          REQUIRE_FALSE(scene.IsAlive(entities[i]));
+          continue;
+        }
+        REQUIRE(scene.GetComponent<CTracked>(entities[i]).value == i);
+        REQUIRE(scene.HasComponent<four::CLifeSpan>(entities[i]) == (i % 2 == 1));
+      }
+    }
+    REQUIRE(CTracked::liveCount == 0);
+  }
+
+  SECTION("views visit matching entities")
+  {
+    four::Scene scene;
+    for (int i = 0; i < 100; ++i)
+    {
+      const four::Entity entity = scene.CreateEntity(four::CTransform{.position = {static_cast<float>(i), 0.0F}});
+      if (i % 2 == 0)
+      {
+        scene.AddComponent<four::CLifeSpan>(entity, i);
+      }
+      if (i % 3 == 0)
+      {
+        scene.AddComponent<four::CShape>(entity);
+      }
+    }
+
+    REQUIRE(scene.View<four::CTransform>().Count() == 100);
+    REQUIRE(scene.View<const four::CTransform, four::CLifeSpan>().Count() == 50);
+
+    int visited = 0;
+    scene.View<const four::CTransform, four::CLifeSpan>().Each(
+      [&](four::Entity entity, const four::CTransform& transform, four::CLifeSpan& lifeSpan)
+      {
+        REQUIRE(static_cast<int>(transform.position.x) == lifeSpan.total);
+        REQUIRE(scene.HasComponent<four::CLifeSpan>(entity));
+        ++visited;
+      });
+    REQUIRE(visited == 50);
+
+    // a const scene only hands out const components
+    const four::Scene& constScene = scene;
+    static_assert(std::is_same_v<decltype(constScene.View<four::CTransform, const four::CLifeSpan>()),
+                                 four::SceneView<const four::CTransform, const four::CLifeSpan>>);
+    REQUIRE(constScene.View<four::CTransform, four::CLifeSpan>().Count() == 50);
+  }
+
+  SECTION("command buffer defers structural changes")
+  {
+    four::Scene scene;
+    for (int i = 0; i < 10; ++i)
+    {
+      scene.CreateEntity(four::CLifeSpan{i});
+    }
+
+    four::CommandBuffer commands;
+    scene.View<four::CLifeSpan>().Each(
+      [&commands](four::Entity entity, four::CLifeSpan& lifeSpan)
+      {
+        if (lifeSpan.total < 5)
+        {
+          commands.DestroyEntity(entity);
+        }
+        else
+        {
+          commands.AddComponent<CTracked>(entity, lifeSpan.total);
+        }
+      });
+    const four::Entity spawned = commands.CreateEntity();
+    commands.AddComponent<CTracked>(spawned, 100);
+    commands.AddComponent<four::CTransform>(spawned);
+    REQUIRE(scene.GetEntityCount() == 10);
+
+    commands.Playback(scene);
+    REQUIRE(commands.IsEmpty());
+    REQUIRE(scene.GetEntityCount() == 6);
+    REQUIRE(scene.View<CTracked>().Count() == 6);
+    REQUIRE(scene.View<CTracked, four::CTransform>().Count() == 1);
+    REQUIRE(CTracked::liveCount == 6);
+  }
+
+  SECTION("command buffer drops null and stale placeholder handles")
+  {
+    four::Scene        scene;
+    const four::Entity entity = scene.CreateEntity(four::CLifeSpan{1});
+
+    // placeholder of a buffer that was already played back, its index is past anything the next playback creates
+    four::CommandBuffer previous;
+    (void)previous.CreateEntity();
+    const four::Entity stale = previous.CreateEntity();
+    previous.Playback(scene);
+    REQUIRE(scene.GetEntityCount() == 3);
+
+    four::CommandBuffer commands;
+    commands.DestroyEntity(four::NullEntity);
+    commands.AddComponent<CTracked>(four::NullEntity, 1);
+    commands.RemoveComponent<four::CLifeSpan>(four::NullEntity);
+    commands.DestroyEntity(stale);
+    commands.AddComponent<CTracked>(stale, 2);
+    commands.RemoveComponent<four::CLifeSpan>(stale);
+    commands.Playback(scene);
+
+    REQUIRE(commands.IsEmpty());
+    REQUIRE(scene.GetEntityCount() == 3);
+    REQUIRE(scene.IsAlive(entity));
+    REQUIRE(scene.View<CTracked>().Count() == 0);
+    REQUIRE(CTracked::liveCount == 0);
+  }
+}
+
+TEST_CASE("Scene iteration over one million entities")
+{
+  four::Log::Init();
+
+  constexpr int count = 1'000'000;
+  four::Scene   scene;
+  for (int i = 0; i < count; ++i)
+  {
+    scene.CreateEntity(four::CTransform{.velocity = {1.0F, 2.0F}}, four::CLifeSpan{i});
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  scene.View<four::CTransform>().EachChunk(
+    [](std::span<const four::Entity>, std::span<four::CTransform> transforms)
+    {
+      for (four::CTransform& transform : transforms)
+      {
+        transform.position += transform.velocity * 0.5F;
+      }
+    });
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  float sum = 0.0F;
+  scene.View<const four::CTransform>().Each([&sum](const four::CTransform& transform) { sum += transform.position.y; });
+  REQUIRE(sum == static_cast<float>(count));
+
+  LOG_WARN("integrated {} transforms in {:.3f} ms", count, ms);
+}
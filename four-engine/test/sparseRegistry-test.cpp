@@ -0,0 +1,168 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "component/lifespan.hpp"
+#include "component/shape.hpp"
+#include "component/transform.hpp"
+#include "core/log.hpp"
+#include "scene/scene.hpp"
+#include "scene/sparseRegistry.hpp"
+
+#include <chrono>
+
+namespace
+{
+// every owned pool lists the group members first and in the same order
+template <typename... Ts>
+bool GroupIsConsistent(four::SparseRegistry& registry, const four::SparseGroup<Ts...>& group)
+{
+  bool consistent = true;
+  group.Each(
+    [&](four::Entity entity, Ts&... components)
+    {
+      consistent = consistent && ((&registry.GetComponent<Ts>(entity) == &components) && ...);
+    });
+  return consistent;
+}
+} // namespace
+
+TEST_CASE("Sparse registry pools and owning groups")
+{
+  four::Log::Init();
+
+  SECTION("add, remove and generations")
+  {
+    four::SparseRegistry registry;
+    const four::Entity   entity = registry.CreateEntity();
+    registry.AddComponent<four::CLifeSpan>(entity, 3);
+    REQUIRE(registry.HasComponent<four::CLifeSpan>(entity));
+    REQUIRE(registry.GetComponent<four::CLifeSpan>(entity).remaining == 3);
+
+    registry.RemoveComponent<four::CLifeSpan>(entity);
+    REQUIRE_FALSE(registry.HasComponent<four::CLifeSpan>(entity));
+
+    registry.DestroyEntity(entity);
+    const four::Entity reused = registry.CreateEntity();
+    REQUIRE(reused.index == entity.index);
+    REQUIRE_FALSE(registry.IsAlive(entity));
+    REQUIRE(registry.IsAlive(reused));
+  }
+
+  SECTION("group follows component churn")
+  {
+    four::SparseRegistry      registry;
+    std::vector<four::Entity> entities;
+    for (int i = 0; i < 1000; ++i)
+    {
+      const four::Entity entity = registry.CreateEntity();
+      registry.AddComponent<four::CTransform>(entity, glm::vec2{static_cast<float>(i), 0.0F}, glm::vec2{});
+      if (i % 2 == 0)
+      {
+        registry.AddComponent<four::CShape>(entity);
+      }
+      entities.push_back(entity);
+    }
+
+    // group created after the fact sorts the existing pools
+    auto group = registry.Group<four::CTransform, four::CShape>();
+    REQUIRE(group.Size() == 500);
+    REQUIRE(GroupIsConsistent(registry, group));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      if (i % 3 == 0)
+      {
+        registry.RemoveComponent<four::CShape>(entities[i]);
+      }
+      else if (i % 3 == 1)
+      {
+        registry.AddComponent<four::CShape>(entities[i]);
+      }
+      else if (i % 5 == 0)
+      {
+        registry.DestroyEntity(entities[i]);
+      }
+    }
+
+    int expected = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+      const bool alive    = registry.IsAlive(entities[i]);
+      const bool hasShape = alive && registry.HasComponent<four::CShape>(entities[i]);
+      expected += hasShape ? 1 : 0;
+    }
+    REQUIRE(group.Size() == static_cast<four::u32>(expected));
+    REQUIRE(GroupIsConsistent(registry, group));
+
+    int visited = 0;
+    registry.Each<four::CTransform, four::CShape>([&visited](four::Entity, four::CTransform&, four::CShape&)
+                                                  { ++visited; });
+    REQUIRE(visited == expected);
+  }
+
+  SECTION("a pool is owned by one group")
+  {
+    four::SparseRegistry registry;
+    auto                 group = registry.Group<four::CTransform, four::CShape>();
+    REQUIRE(registry.Group<four::CTransform, four::CShape>().Size() == group.Size());
+    REQUIRE_THROWS(registry.Group<four::CTransform, four::CLifeSpan>());
+  }
+}
+
+TEST_CASE("Life span churn, sparse pools vs archetypes")
+{
+  four::Log::Init();
+
+  constexpr int entityCount = 100'000;
+  constexpr int rounds      = 10;
+
+  // every round half of the entities lose their life span and get a new one, like expiring and respawning
+  four::SparseRegistry      registry;
+  std::vector<four::Entity> sparseEntities;
+  for (int i = 0; i < entityCount; ++i)
+  {
+    const four::Entity entity = registry.CreateEntity();
+    registry.AddComponent<four::CTransform>(entity);
+    registry.AddComponent<four::CShape>(entity);
+    registry.AddComponent<four::CLifeSpan>(entity, i);
+    sparseEntities.push_back(entity);
+  }
+  auto sparseStart = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; ++round)
+  {
+    for (int i = round % 2; i < entityCount; i += 2)
+    {
+      registry.RemoveComponent<four::CLifeSpan>(sparseEntities[i]);
+      registry.AddComponent<four::CLifeSpan>(sparseEntities[i], round);
+    }
+  }
+  const double sparseMs =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sparseStart).count();
+
+  four::Scene               scene;
+  std::vector<four::Entity> sceneEntities;
+  for (int i = 0; i < entityCount; ++i)
+  {
+    sceneEntities.push_back(scene.CreateEntity(four::CTransform{}, four::CShape{}, four::CLifeSpan{i}));
+  }
+  auto sceneStart = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; ++round)
+  {
+    for (int i = round % 2; i < entityCount; i += 2)
+    {
+      scene.RemoveComponent<four::CLifeSpan>(sceneEntities[i]);
+      scene.AddComponent<four::CLifeSpan>(sceneEntities[i], round);
+    }
+  }
+  const double sceneMs =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sceneStart).count();
+
+  REQUIRE(scene.View<four::CLifeSpan>().Count() == entityCount);
+  int lifeSpans = 0;
+  registry.Each<four::CLifeSpan>([&lifeSpans](four::Entity, four::CLifeSpan&) { ++lifeSpans; });
+  REQUIRE(lifeSpans == entityCount);
+
+  LOG_WARN("{} life span remove/add pairs: sparse pools {:.2f} ms, archetypes {:.2f} ms",
+           entityCount / 2 * rounds,
+           sparseMs,
+           sceneMs);
+}
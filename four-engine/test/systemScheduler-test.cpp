@@ -0,0 +1,170 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "component/lifespan.hpp"
+#include "component/shape.hpp"
+#include "component/transform.hpp"
+#include "core/log.hpp"
+#include "scene/scene.hpp"
+#include "system/systemScheduler.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+// order in which systems started, shared by every test system
+struct RunLog
+{
+  std::mutex                    mutex;
+  std::vector<std::string_view> order;
+  std::atomic<int>              waiting{0};
+  std::atomic<bool>             overlapped{false};
+
+  void Add(std::string_view name)
+  {
+    const std::scoped_lock lock(mutex);
+    order.push_back(name);
+  }
+
+  // true when another system arrives within the timeout, only possible if both run at the same time
+  void Meet()
+  {
+    waiting.fetch_add(1);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (waiting.load() < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::yield();
+    }
+    overlapped = overlapped || waiting.load() >= 2;
+  }
+};
+
+class MovementSystem final : public four::System
+{
+public:
+  static constexpr std::string_view Name = "Movement";
+  using Reads                            = four::ComponentList<>;
+  using Writes                           = four::ComponentList<four::CTransform>;
+
+  explicit MovementSystem(RunLog& log) : m_Log{log}
+  {
+  }
+
+  void Update(four::SystemContext& context) final
+  {
+    m_Log.Add(Name);
+    m_Log.Meet();
+    context.scene.View<four::CTransform>().Each([&context](four::CTransform& transform)
+                                                { transform.position += transform.velocity * context.deltaTime; });
+  }
+
+private:
+  RunLog& m_Log;
+};
+
+class LifeSpanSystem final : public four::System
+{
+public:
+  static constexpr std::string_view Name = "LifeSpan";
+  using Reads                            = four::ComponentList<>;
+  using Writes                           = four::ComponentList<four::CLifeSpan>;
+
+  explicit LifeSpanSystem(RunLog& log) : m_Log{log}
+  {
+  }
+
+  void Update(four::SystemContext& context) final
+  {
+    m_Log.Add(Name);
+    m_Log.Meet();
+    context.scene.View<four::CLifeSpan>().Each(
+      [&context](four::Entity entity, four::CLifeSpan& lifeSpan)
+      {
+        if (--lifeSpan.remaining <= 0)
+        {
+          context.commands.DestroyEntity(entity);
+        }
+      });
+  }
+
+private:
+  RunLog& m_Log;
+};
+
+// reads what both systems above write, has to run after them
+class RenderPrepSystem final : public four::System
+{
+public:
+  static constexpr std::string_view Name = "RenderPrep";
+  using Reads                            = four::ComponentList<four::CTransform, four::CLifeSpan>;
+  using Writes                           = four::ComponentList<four::CShape>;
+
+  explicit RenderPrepSystem(RunLog& log) : m_Log{log}
+  {
+  }
+
+  void Update(four::SystemContext& context) final
+  {
+    m_Log.Add(Name);
+    context.scene.View<const four::CTransform, const four::CLifeSpan, four::CShape>().Each(
+      [](const four::CTransform& transform, const four::CLifeSpan& lifeSpan, four::CShape& shape)
+      { shape.radius = transform.position.x + static_cast<float>(lifeSpan.remaining); });
+  }
+
+private:
+  RunLog& m_Log;
+};
+} // namespace
+
+TEST_CASE("System scheduler orders conflicting systems and overlaps the others")
+{
+  four::Log::Init();
+
+  four::JobSystem jobs{4};
+  four::Scene     scene;
+  for (int i = 0; i < 100; ++i)
+  {
+    scene.CreateEntity(four::CTransform{.velocity = {1.0F, 0.0F}}, four::CLifeSpan{i % 2 == 0 ? 1 : 10}, four::CShape{});
+  }
+
+  RunLog                log;
+  four::SystemScheduler scheduler;
+  scheduler.AddSystem<RenderPrepSystem>(log);
+  scheduler.AddSystem<MovementSystem>(log);
+  scheduler.AddSystem<LifeSpanSystem>(log);
+
+  SECTION("dependencies follow registration order")
+  {
+    scheduler.Run(scene, jobs, 1.0F);
+
+    // render prep was registered first, conflicting systems added later wait for it
+    REQUIRE(log.order.front() == RenderPrepSystem::Name);
+    REQUIRE(log.overlapped);
+
+    // entities with one frame left were destroyed by the played back command buffer
+    REQUIRE(scene.GetEntityCount() == 50);
+
+    const auto timings = scheduler.GetTimings();
+    REQUIRE(timings.size() == 3);
+    REQUIRE(timings[0].level == 0);
+    REQUIRE(timings[1].level == 1);
+    REQUIRE(timings[2].level == 1);
+
+    const std::string dump = scheduler.DumpSchedule();
+    REQUIRE(dump.find("Movement") != std::string::npos);
+    REQUIRE(dump.find("after RenderPrep") != std::string::npos);
+    LOG_INFO("{}", dump);
+  }
+
+  SECTION("disabled systems leave the graph")
+  {
+    REQUIRE(scheduler.SetEnabled(RenderPrepSystem::Name, false));
+    REQUIRE_FALSE(scheduler.SetEnabled("Missing", false));
+    scheduler.Run(scene, jobs, 1.0F);
+
+    REQUIRE(log.order.size() == 2);
+    REQUIRE(log.overlapped);
+    REQUIRE(scheduler.GetTimings().size() == 2);
+  }
+}
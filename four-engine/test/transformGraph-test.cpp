@@ -0,0 +1,186 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/jobSystem.hpp"
+#include "core/log.hpp"
+#include "scene/transformGraph.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+bool Near(glm::vec2 a, glm::vec2 b)
+{
+  return std::abs(a.x - b.x) <= 1e-4F && std::abs(a.y - b.y) <= 1e-4F;
+}
+
+// wide tree of depth levels, children per node
+std::vector<four::TransformNode> BuildTree(four::TransformGraph& graph, four::u32 depth, four::u32 children)
+{
+  std::vector<four::TransformNode> nodes{graph.CreateNode()};
+  four::u32                        levelBegin = 0;
+  for (four::u32 level = 1; level < depth; ++level)
+  {
+    const auto levelEnd = static_cast<four::u32>(nodes.size());
+    for (four::u32 parent = levelBegin; parent < levelEnd; ++parent)
+    {
+      for (four::u32 child = 0; child < children; ++child)
+      {
+        nodes.push_back(graph.CreateNode(
+          nodes[parent], {.position = {1.0F, static_cast<float>(child)}, .rotation = 0.1F, .scale = {1.0F, 1.0F}}));
+      }
+    }
+    levelBegin = levelEnd;
+  }
+  return nodes;
+}
+} // namespace
+
+TEST_CASE("Transform graph composes parent and child transforms")
+{
+  four::TransformGraph graph;
+  const auto root  = graph.CreateNode({}, {.position = {10.0F, 0.0F}, .rotation = std::numbers::pi_v<float> / 2});
+  const auto child = graph.CreateNode(root, {.position = {1.0F, 0.0F}, .scale = {2.0F, 2.0F}});
+  const auto leaf  = graph.CreateNode(child, {.position = {1.0F, 0.0F}});
+  graph.Update();
+
+  REQUIRE(graph.GetLevelCount() == 3);
+  REQUIRE(graph.GetUpdatedCount() == 3);
+  // the root turns everything a quarter, the child doubles the offset of the leaf
+  REQUIRE(Near(graph.GetWorld(root).translation, {10.0F, 0.0F}));
+  REQUIRE(Near(graph.GetWorld(child).translation, {10.0F, 1.0F}));
+  REQUIRE(Near(graph.GetWorld(leaf).translation, {10.0F, 3.0F}));
+  REQUIRE(Near(graph.GetWorld(leaf).Apply({1.0F, 0.0F}), {10.0F, 5.0F}));
+  REQUIRE(graph.GetParent(leaf) == child);
+  REQUIRE(graph.GetParent(root).IsNull());
+}
+
+TEST_CASE("Transform graph only recomputes dirty subtrees")
+{
+  four::TransformGraph graph;
+  const auto           root   = graph.CreateNode();
+  const auto           branch = graph.CreateNode(root);
+  const auto           other  = graph.CreateNode(root);
+  const auto           leaf   = graph.CreateNode(branch);
+  graph.CreateNode(other);
+  graph.Update();
+  REQUIRE(graph.GetUpdatedCount() == 5);
+
+  graph.Update();
+  REQUIRE(graph.GetUpdatedCount() == 0);
+  REQUIRE_FALSE(graph.IsWorldChanged(root));
+
+  graph.SetLocal(leaf, {.position = {0.0F, 1.0F}});
+  graph.Update();
+  REQUIRE(graph.GetUpdatedCount() == 1);
+  REQUIRE(graph.IsWorldChanged(leaf));
+  REQUIRE_FALSE(graph.IsWorldChanged(branch));
+
+  graph.SetLocal(branch, {.position = {2.0F, 0.0F}});
+  graph.Update();
+  REQUIRE(graph.GetUpdatedCount() == 2);
+  REQUIRE(Near(graph.GetWorld(leaf).translation, {2.0F, 1.0F}));
+  REQUIRE_FALSE(graph.IsWorldChanged(other));
+
+  // flags of the last update are cleared by the next one
+  graph.Update();
+  REQUIRE_FALSE(graph.IsWorldChanged(leaf));
+}
+
+TEST_CASE("Transform graph structural changes")
+{
+  four::TransformGraph graph;
+  const auto           a    = graph.CreateNode({}, {.position = {1.0F, 0.0F}});
+  const auto           b    = graph.CreateNode({}, {.position = {0.0F, 5.0F}});
+  const auto           leaf = graph.CreateNode(a, {.position = {1.0F, 0.0F}});
+  graph.Update();
+  REQUIRE(Near(graph.GetWorld(leaf).translation, {2.0F, 0.0F}));
+
+  SECTION("reparent moves the subtree")
+  {
+    graph.SetParent(leaf, b);
+    graph.Update();
+    REQUIRE(graph.GetParent(leaf) == b);
+    REQUIRE(Near(graph.GetWorld(leaf).translation, {1.0F, 5.0F}));
+    REQUIRE_THROWS(graph.SetParent(b, leaf));
+  }
+
+  SECTION("destroy removes the subtree")
+  {
+    graph.DestroyNode(a);
+    REQUIRE_FALSE(graph.IsAlive(a));
+    REQUIRE_FALSE(graph.IsAlive(leaf));
+    REQUIRE(graph.GetNodeCount() == 1);
+    graph.Update();
+    REQUIRE(graph.GetLevelCount() == 1);
+    REQUIRE(Near(graph.GetWorld(b).translation, {0.0F, 5.0F}));
+
+    // the slot is reused, the old handle stays dead
+    const auto reused = graph.CreateNode(b);
+    REQUIRE(reused.index == leaf.index);
+    REQUIRE_FALSE(graph.IsAlive(leaf));
+    REQUIRE_THROWS(graph.CreateNode(leaf));
+    graph.DestroyNode(leaf);
+    REQUIRE(graph.GetNodeCount() == 2);
+  }
+}
+
+TEST_CASE("Transform graph parallel update matches the serial one")
+{
+  four::Log::Init();
+  four::JobSystem      jobs(4);
+  four::TransformGraph serial;
+  four::TransformGraph parallel;
+  const auto           serialNodes   = BuildTree(serial, 6, 8); // 37449 nodes, deepest level 32768
+  const auto           parallelNodes = BuildTree(parallel, 6, 8);
+  serial.Update();
+  parallel.Update(jobs);
+
+  // animate a few branches, like a mostly static scene
+  for (size_t i = 1; i < serialNodes.size(); i += 997)
+  {
+    serial.SetLocal(serialNodes[i], {.position = {3.0F, 1.0F}, .rotation = 0.5F});
+    parallel.SetLocal(parallelNodes[i], {.position = {3.0F, 1.0F}, .rotation = 0.5F});
+  }
+  serial.Update();
+  parallel.Update(jobs);
+  REQUIRE(serial.GetUpdatedCount() == parallel.GetUpdatedCount());
+  REQUIRE(serial.GetUpdatedCount() < serialNodes.size() / 4);
+
+  bool same = true;
+  for (size_t i = 0; i < serialNodes.size(); ++i)
+  {
+    same = same && Near(serial.GetWorld(serialNodes[i]).translation, parallel.GetWorld(parallelNodes[i]).translation);
+  }
+  REQUIRE(same);
+
+  // full recompute against the incremental one
+  const auto time = [](auto&& function)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  const double full = time(
+    [&]
+    {
+      parallel.SetLocal(parallelNodes[0], {.rotation = 0.25F});
+      parallel.Update(jobs);
+    });
+  const double incremental = time(
+    [&]
+    {
+      for (size_t i = 1; i < parallelNodes.size(); i += 997)
+      {
+        parallel.SetLocal(parallelNodes[i], {.position = {3.0F, 1.0F}, .rotation = 0.75F});
+      }
+      parallel.Update(jobs);
+    });
+  const double idle = time([&] { parallel.Update(jobs); });
+  LOG_WARN("transform graph of {} nodes: full {:.3f} ms, few branches {:.3f} ms, static {:.3f} ms",
+           parallelNodes.size(),
+           full,
+           incremental,
+           idle);
+}
@@ -0,0 +1,136 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/log.hpp"
+#include "core/transformKernels.hpp"
+
+#include "glm/glm.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+constexpr int Runs = 5;
+
+// what each game object does today: Transform2DComponent::mat2 plus the position update, one object at a time
+struct ObjectTransform
+{
+  glm::vec2 translation{};
+  glm::vec2 velocity{};
+  glm::vec2 scale{1.0F, 1.0F};
+  float     rotation{};
+
+  [[nodiscard]] glm::mat2 mat2() const
+  {
+    const float sin_ = std::sin(rotation);
+    const float cos_ = std::cos(rotation);
+    glm::mat2   rotMat{{cos_, sin_}, {-sin_, cos_}};
+
+    glm::mat2 scaleMat{{scale.x, 0.0F}, {0.0F, scale.y}};
+    return rotMat * scaleMat;
+  }
+};
+
+// same data as the objects, one array per field
+struct Batch
+{
+  std::vector<float> positionX, positionY, velocityX, velocityY, rotation, scaleX, scaleY;
+  std::vector<float> c0x, c0y, c1x, c1y, tx, ty;
+
+  explicit Batch(four::u32 count)
+    : positionX(count), positionY(count), velocityX(count), velocityY(count), rotation(count), scaleX(count),
+      scaleY(count), c0x(count), c0y(count), c1x(count), c1y(count), tx(count), ty(count)
+  {
+  }
+};
+
+// best of several runs, in nanoseconds per entity
+template <typename Function>
+double MeasureNsPerEntity(four::u32 count, Function&& function)
+{
+  double best = 1e30;
+  for (int run = 0; run < Runs; ++run)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    best                 = std::min(best, seconds * 1e9 / count);
+  }
+  return best;
+}
+} // namespace
+
+TEST_CASE("Batch transform kernels against the per object path")
+{
+  four::Log::Init();
+  constexpr float deltaTime = 1.0F / 60.0F;
+
+  for (const four::u32 count : {10'000U, 100'000U, 1'000'000U})
+  {
+    std::vector<ObjectTransform> objects(count);
+    std::vector<glm::mat2>       objectMatrices(count);
+    Batch                        batch(count);
+    for (four::u32 i = 0; i < count; ++i)
+    {
+      const auto  value = static_cast<float>(i);
+      objects[i]        = {.translation = {value, -value},
+                           .velocity    = {1.0F, 2.0F},
+                           .scale       = {1.0F, 0.5F},
+                           .rotation    = value * 0.001F};
+      batch.positionX[i] = value;
+      batch.positionY[i] = -value;
+      batch.velocityX[i] = 1.0F;
+      batch.velocityY[i] = 2.0F;
+      batch.rotation[i]  = value * 0.001F;
+      batch.scaleX[i]    = 1.0F;
+      batch.scaleY[i]    = 0.5F;
+    }
+
+    const double perObject = MeasureNsPerEntity(count,
+                                                [&]
+                                                {
+                                                  for (four::u32 i = 0; i < count; ++i)
+                                                  {
+                                                    objects[i].translation += objects[i].velocity * deltaTime;
+                                                    objectMatrices[i] = objects[i].mat2();
+                                                  }
+                                                });
+
+    const four::TransformBatch   transforms{.positionX = batch.positionX.data(),
+                                            .positionY = batch.positionY.data(),
+                                            .velocityX = batch.velocityX.data(),
+                                            .velocityY = batch.velocityY.data(),
+                                            .rotation  = batch.rotation.data(),
+                                            .scaleX    = batch.scaleX.data(),
+                                            .scaleY    = batch.scaleY.data(),
+                                            .count     = count};
+    const four::WorldMatrixBatch matrices{.c0x = batch.c0x.data(),
+                                          .c0y = batch.c0y.data(),
+                                          .c1x = batch.c1x.data(),
+                                          .c1y = batch.c1y.data(),
+                                          .tx  = batch.tx.data(),
+                                          .ty  = batch.ty.data()};
+
+    std::array<double, 3> batched{};
+    for (const auto level : {four::SimdLevel::Scalar, four::SimdLevel::Sse2, four::SimdLevel::Avx2})
+    {
+      if (four::SetSimdLevel(level) == level)
+      {
+        batched[static_cast<size_t>(level)] =
+          MeasureNsPerEntity(count, [&] { four::UpdateTransforms(transforms, matrices, deltaTime); });
+      }
+    }
+    four::SetSimdLevel(four::GetSupportedSimdLevel());
+
+    // rotation and scale do not change between runs, both paths end with the same matrices
+    REQUIRE(std::abs(batch.c0x[count - 1] - objectMatrices[count - 1][0].x) <= 1e-5F);
+    REQUIRE(std::abs(batch.c1x[count - 1] - objectMatrices[count - 1][1].x) <= 1e-5F);
+
+    LOG_WARN("transforms of {} entities, ns per entity", count);
+    LOG_WARN("  per object glm: {:.2f}", perObject);
+    LOG_WARN("  batch scalar:   {:.2f}", batched[0]);
+    LOG_WARN("  batch sse2:     {:.2f}", batched[1]);
+    LOG_WARN("  batch avx2:     {:.2f}", batched[2]);
+  }
+}
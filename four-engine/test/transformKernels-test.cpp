@@ -0,0 +1,162 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/transformKernels.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// every level the machine can run, scalar first
+std::vector<four::SimdLevel> SupportedLevels()
+{
+  std::vector<four::SimdLevel> levels;
+  for (auto level : {four::SimdLevel::Scalar, four::SimdLevel::Sse2, four::SimdLevel::Avx2})
+  {
+    if (level <= four::GetSupportedSimdLevel())
+    {
+      levels.push_back(level);
+    }
+  }
+  return levels;
+}
+
+// largest error of SinCos against the double precision functions
+double MaxSinCosError(const std::vector<float>& angles)
+{
+  std::vector<float> sines(angles.size());
+  std::vector<float> cosines(angles.size());
+  four::SinCos(angles, sines, cosines);
+
+  double error = 0.0;
+  for (size_t i = 0; i < angles.size(); ++i)
+  {
+    error = std::max(error, std::abs(sines[i] - std::sin(static_cast<double>(angles[i]))));
+    error = std::max(error, std::abs(cosines[i] - std::cos(static_cast<double>(angles[i]))));
+  }
+  return error;
+}
+} // namespace
+
+TEST_CASE("SinCos stays within its documented error bound")
+{
+  // dense around the angles rotations usually have, sparse over the whole valid range
+  std::vector<float> angles;
+  for (int i = -2'000'000; i <= 2'000'000; ++i)
+  {
+    angles.push_back(static_cast<float>(i) * 1e-5F);
+  }
+  for (int i = -1'000'000; i <= 1'000'000; ++i)
+  {
+    angles.push_back(static_cast<float>(i) * (four::SINCOS_MAX_ANGLE / 1'000'000.0F));
+  }
+
+  for (const auto level : SupportedLevels())
+  {
+    REQUIRE(four::SetSimdLevel(level) == level);
+    REQUIRE(MaxSinCosError(angles) <= four::SINCOS_MAX_ERROR);
+  }
+  four::SetSimdLevel(four::GetSupportedSimdLevel());
+}
+
+TEST_CASE("Transform kernels match the per object math on every level")
+{
+  // odd count, every level leaves a tail for the next one
+  constexpr four::u32 count     = 37;
+  constexpr float     deltaTime = 1.0F / 60.0F;
+  constexpr float     tolerance = 1e-5F;
+
+  SECTION("integrate components")
+  {
+    for (const auto level : SupportedLevels())
+    {
+      four::SetSimdLevel(level);
+      std::vector<four::CTransform> transforms(count);
+      for (four::u32 i = 0; i < count; ++i)
+      {
+        transforms[i].position = {static_cast<float>(i), -static_cast<float>(i)};
+        transforms[i].velocity = {static_cast<float>(i) * 0.5F, 3.0F};
+      }
+
+      four::IntegrateTransforms(transforms, deltaTime);
+
+      for (four::u32 i = 0; i < count; ++i)
+      {
+        REQUIRE(std::abs(transforms[i].position.x - (i + i * 0.5F * deltaTime)) <= tolerance);
+        REQUIRE(std::abs(transforms[i].position.y - (-static_cast<float>(i) + 3.0F * deltaTime)) <= tolerance);
+        REQUIRE(transforms[i].velocity.x == static_cast<float>(i) * 0.5F);
+        REQUIRE(transforms[i].velocity.y == 3.0F);
+      }
+    }
+  }
+
+  SECTION("integrate and build world matrices")
+  {
+    for (const auto level : SupportedLevels())
+    {
+      four::SetSimdLevel(level);
+      std::vector<float> positionX(count);
+      std::vector<float> positionY(count);
+      std::vector<float> velocityX(count);
+      std::vector<float> velocityY(count);
+      std::vector<float> rotation(count);
+      std::vector<float> scaleX(count);
+      std::vector<float> scaleY(count);
+      for (four::u32 i = 0; i < count; ++i)
+      {
+        positionX[i] = static_cast<float>(i);
+        positionY[i] = 2.0F * static_cast<float>(i);
+        velocityX[i] = 1.0F;
+        velocityY[i] = -1.0F;
+        rotation[i]  = static_cast<float>(i) * 0.7F - 10.0F;
+        scaleX[i]    = 1.0F + static_cast<float>(i) * 0.1F;
+        scaleY[i]    = 0.5F;
+      }
+      std::vector<float> c0x(count);
+      std::vector<float> c0y(count);
+      std::vector<float> c1x(count);
+      std::vector<float> c1y(count);
+      std::vector<float> tx(count);
+      std::vector<float> ty(count);
+
+      four::UpdateTransforms({.positionX = positionX.data(),
+                              .positionY = positionY.data(),
+                              .velocityX = velocityX.data(),
+                              .velocityY = velocityY.data(),
+                              .rotation  = rotation.data(),
+                              .scaleX    = scaleX.data(),
+                              .scaleY    = scaleY.data(),
+                              .count     = count},
+                             {.c0x = c0x.data(), .c0y = c0y.data(), .c1x = c1x.data(), .c1y = c1y.data(),
+                              .tx = tx.data(), .ty = ty.data()},
+                             deltaTime);
+
+      for (four::u32 i = 0; i < count; ++i)
+      {
+        // rotation * scale like Transform2DComponent::mat2
+        const float sin = std::sin(rotation[i]);
+        const float cos = std::cos(rotation[i]);
+        REQUIRE(std::abs(positionX[i] - (static_cast<float>(i) + deltaTime)) <= tolerance);
+        REQUIRE(std::abs(positionY[i] - (2.0F * static_cast<float>(i) - deltaTime)) <= tolerance);
+        REQUIRE(std::abs(c0x[i] - cos * scaleX[i]) <= tolerance);
+        REQUIRE(std::abs(c0y[i] - sin * scaleX[i]) <= tolerance);
+        REQUIRE(std::abs(c1x[i] + sin * scaleY[i]) <= tolerance);
+        REQUIRE(std::abs(c1y[i] - cos * scaleY[i]) <= tolerance);
+        REQUIRE(tx[i] == positionX[i]);
+        REQUIRE(ty[i] == positionY[i]);
+      }
+    }
+  }
+
+  four::SetSimdLevel(four::GetSupportedSimdLevel());
+}
+
+TEST_CASE("SIMD level override is clamped to what the cpu supports")
+{
+  const four::SimdLevel supported = four::GetSupportedSimdLevel();
+  REQUIRE(four::SetSimdLevel(four::SimdLevel::Avx2) == supported);
+  REQUIRE(four::GetSimdLevel() == supported);
+  REQUIRE(four::SetSimdLevel(four::SimdLevel::Scalar) == four::SimdLevel::Scalar);
+  REQUIRE(four::GetSimdLevel() == four::SimdLevel::Scalar);
+  four::SetSimdLevel(supported);
+}
@@ -0,0 +1,72 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "core/tripleBuffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace
+{
+// every field carries the same value, a torn read shows up as a mismatch
+struct Packet
+{
+  std::array<four::u64, 32> values{};
+};
+} // namespace
+
+TEST_CASE("Triple buffer hands latest packet to consumer")
+{
+  SECTION("single thread")
+  {
+    four::TripleBuffer<Packet> buffer;
+    REQUIRE_FALSE(buffer.Consume());
+
+    buffer.GetWriteBuffer().values[0] = 1;
+    buffer.Publish();
+    buffer.GetWriteBuffer().values[0] = 2;
+    buffer.Publish();
+
+    // consumer skips to the newest packet
+    REQUIRE(buffer.HasFresh());
+    REQUIRE(buffer.Consume());
+    REQUIRE(buffer.GetReadBuffer().values[0] == 2);
+    REQUIRE_FALSE(buffer.HasFresh());
+    REQUIRE_FALSE(buffer.Consume());
+    REQUIRE(buffer.GetReadBuffer().values[0] == 2);
+  }
+
+  SECTION("producer and consumer threads")
+  {
+    constexpr four::u64        packetCount = 200'000;
+    four::TripleBuffer<Packet> buffer;
+
+    std::jthread producer(
+      [&buffer]
+      {
+        for (four::u64 i = 1; i <= packetCount; ++i)
+        {
+          buffer.GetWriteBuffer().values.fill(i);
+          buffer.Publish();
+        }
+      });
+
+    four::u64 last  = 0;
+    bool      torn  = false;
+    bool      order = true;
+    while (last != packetCount)
+    {
+      if (!buffer.Consume())
+      {
+        continue;
+      }
+      const Packet& packet = buffer.GetReadBuffer();
+      torn                 = torn || std::ranges::any_of(packet.values, [&packet](four::u64 v) { return v != packet.values[0]; });
+      order                = order && packet.values[0] > last;
+      last                 = packet.values[0];
+    }
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(order);
+  }
+}
@@ -0,0 +1,60 @@
+#include "core/log.hpp"
+#include "mesh/meshCooker.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+
+// mesh-cooker [--quantize] [--no-optimize] [--lods <count>] <input.obj> <output.fmesh>
+int main(int argc, char** argv)
+{
+  four::MeshCookOptions              options;
+  std::vector<std::filesystem::path> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string_view argument{argv[i]};
+    if (argument == "--quantize")
+    {
+      options.vertexFormat = four::MeshVertexFormat::Quantized;
+    }
+    else if (argument == "--no-optimize")
+    {
+      options.optimize = false;
+    }
+    else if (argument == "--lods" && i + 1 < argc)
+    {
+      const std::string_view count{argv[++i]};
+      if (std::from_chars(count.data(), count.data() + count.size(), options.lodCount).ec != std::errc{} ||
+          options.lodCount == 0 || options.lodCount > four::MESH_MAX_LODS)
+      {
+        std::fprintf(stderr, "--lods takes a count from 1 to %u\n", four::MESH_MAX_LODS);
+        return EXIT_FAILURE;
+      }
+    }
+    else
+    {
+      paths.emplace_back(argument);
+    }
+  }
+  if (paths.size() != 2)
+  {
+    std::fprintf(
+      stderr, "usage: %s [--quantize] [--no-optimize] [--lods <count>] <input.obj> <output.fmesh>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  four::Log::Init();
+
+  const std::filesystem::path& input = paths[0];
+  if (input.extension() != ".obj")
+  {
+    std::fprintf(stderr, "%s: only .obj files can be imported\n", input.string().c_str());
+    return EXIT_FAILURE;
+  }
+
+  four::MeshData mesh;
+  if (!four::ImportObj(input, mesh) || !four::CookMesh(mesh, paths[1], options))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}